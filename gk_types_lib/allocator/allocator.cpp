@@ -1,10 +1,20 @@
 #include "allocator.h"
+#include <atomic>
+
+#if defined(_WIN32) || defined(WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
 
 using gk::Result;
 using gk::AllocError;
 using gk::AllocatorRef;
 using gk::IAllocator;
 using gk::usize;
+using gk::Option;
 
 Result<void*, AllocError> gk::malloc(usize numBytes, usize alignment)
 {
@@ -33,6 +43,152 @@ void gk::free(void* memory, usize numBytes, usize alignment)
 	}
 }
 
+/// Huge page size on x86-64 Linux. Page mappings are aligned to this so transparent huge pages can back them.
+constexpr usize HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static usize roundUpToPages(usize numBytes) {
+	return (numBytes + (gk::internal::PAGE_ALLOCATION_ALIGNMENT - 1)) & ~(gk::internal::PAGE_ALLOCATION_ALIGNMENT - 1);
+}
+
+#if defined(_WIN32) || defined(WIN32)
+
+/// Large pages require SeLockMemoryPrivilege. If a large page allocation fails once, don't bother trying again.
+static std::atomic<bool> largePagesUnavailable = false;
+
+Result<void*, AllocError> gk::internal::mallocPages(usize numBytes)
+{
+	const usize largePageMinimum = GetLargePageMinimum();
+	if (largePageMinimum != 0 && numBytes >= largePageMinimum && !largePagesUnavailable.load(std::memory_order_relaxed)) {
+		const usize largeBytes = (numBytes + (largePageMinimum - 1)) & ~(largePageMinimum - 1);
+		void* mem = VirtualAlloc(nullptr, largeBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (mem != nullptr) {
+			return ResultOk<void*>(mem);
+		}
+		largePagesUnavailable.store(true, std::memory_order_relaxed);
+	}
+
+	void* mem = VirtualAlloc(nullptr, roundUpToPages(numBytes), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (mem == nullptr) {
+		return ResultErr<AllocError>(AllocError::OutOfMemory);
+	}
+	return ResultOk<void*>(mem);
+}
+
+void gk::internal::freePages(void* memory, usize numBytes)
+{
+	// MEM_RELEASE requires a size of 0, and frees the whole reservation.
+	(void)numBytes;
+	VirtualFree(memory, 0, MEM_RELEASE);
+}
+
+Option<void*> gk::internal::reallocPages(void* memory, usize oldNumBytes, usize newNumBytes)
+{
+	// Windows has no equivalent to mremap. Pages within the existing reservation can be reused though.
+	if (resizePagesInPlace(memory, oldNumBytes, newNumBytes)) {
+		return Option<void*>(memory);
+	}
+	return Option<void*>();
+}
+
+bool gk::internal::resizePagesInPlace(void* memory, usize oldNumBytes, usize newNumBytes)
+{
+	// The reservation can't be extended, and MEM_RELEASE always frees all of it, so only shrinking within it works.
+	(void)memory;
+	return roundUpToPages(newNumBytes) <= roundUpToPages(oldNumBytes);
+}
+
+#else
+
+Result<void*, AllocError> gk::internal::mallocPages(usize numBytes)
+{
+	const usize mapBytes = roundUpToPages(numBytes);
+	if (mapBytes < HUGE_PAGE_SIZE) {
+		void* mem = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mem == MAP_FAILED) {
+			return ResultErr<AllocError>(AllocError::OutOfMemory);
+		}
+		return ResultOk<void*>(mem);
+	}
+
+	// Over map so the start can be aligned to a huge page boundary, then trim the excess on either side.
+	const usize overBytes = mapBytes + HUGE_PAGE_SIZE;
+	void* mapped = mmap(nullptr, overBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapped == MAP_FAILED) {
+		return ResultErr<AllocError>(AllocError::OutOfMemory);
+	}
+
+	const usize mappedAddress = reinterpret_cast<usize>(mapped);
+	const usize alignedAddress = (mappedAddress + (HUGE_PAGE_SIZE - 1)) & ~(HUGE_PAGE_SIZE - 1);
+	const usize frontBytes = alignedAddress - mappedAddress;
+	const usize backBytes = overBytes - frontBytes - mapBytes;
+	if (frontBytes != 0) {
+		munmap(mapped, frontBytes);
+	}
+	if (backBytes != 0) {
+		munmap(reinterpret_cast<void*>(alignedAddress + mapBytes), backBytes);
+	}
+
+	void* mem = reinterpret_cast<void*>(alignedAddress);
+#if defined(MADV_HUGEPAGE)
+	// Only a hint. If transparent huge pages are disabled, this fails harmlessly.
+	(void)madvise(mem, mapBytes, MADV_HUGEPAGE);
+#endif
+	return ResultOk<void*>(mem);
+}
+
+void gk::internal::freePages(void* memory, usize numBytes)
+{
+	munmap(memory, roundUpToPages(numBytes));
+}
+
+Option<void*> gk::internal::reallocPages(void* memory, usize oldNumBytes, usize newNumBytes)
+{
+	const usize oldMapBytes = roundUpToPages(oldNumBytes);
+	const usize newMapBytes = roundUpToPages(newNumBytes);
+	if (oldMapBytes == newMapBytes) {
+		return Option<void*>(memory);
+	}
+
+#if defined(__linux__)
+	void* mem = mremap(memory, oldMapBytes, newMapBytes, MREMAP_MAYMOVE);
+	if (mem == MAP_FAILED) {
+		return Option<void*>();
+	}
+#if defined(MADV_HUGEPAGE)
+	(void)madvise(mem, newMapBytes, MADV_HUGEPAGE);
+#endif
+	return Option<void*>(mem);
+#else
+	if (newMapBytes < oldMapBytes) {
+		munmap(reinterpret_cast<char*>(memory) + newMapBytes, oldMapBytes - newMapBytes);
+		return Option<void*>(memory);
+	}
+	return Option<void*>();
+#endif
+}
+
+bool gk::internal::resizePagesInPlace(void* memory, usize oldNumBytes, usize newNumBytes)
+{
+	const usize oldMapBytes = roundUpToPages(oldNumBytes);
+	const usize newMapBytes = roundUpToPages(newNumBytes);
+	if (oldMapBytes == newMapBytes) {
+		return true;
+	}
+	if (newMapBytes < oldMapBytes) {
+		munmap(reinterpret_cast<char*>(memory) + newMapBytes, oldMapBytes - newMapBytes);
+		return true;
+	}
+
+#if defined(__linux__)
+	// Without MREMAP_MAYMOVE, this fails if the pages after the mapping are in use.
+	return mremap(memory, oldMapBytes, newMapBytes, 0) != MAP_FAILED;
+#else
+	return false;
+#endif
+}
+
+#endif
+
 AllocatorRef gk::IAllocator::toRef()
 {
 	return AllocatorRef(this);
@@ -40,14 +196,39 @@ AllocatorRef gk::IAllocator::toRef()
 
 Result<void*, AllocError> gk::HeapAllocator::mallocImpl(usize numBytes, usize alignment)
 {
+	if (internal::isLargeHeapAllocation(numBytes, alignment, largeAllocationThreshold)) {
+		return internal::mallocPages(numBytes);
+	}
 	return gk::malloc(numBytes, alignment);
 }
 
 void gk::HeapAllocator::freeImpl(void* buffer, usize numBytes, usize alignment)
 {
+	if (internal::isLargeHeapAllocation(numBytes, alignment, largeAllocationThreshold)) {
+		return internal::freePages(buffer, numBytes);
+	}
 	return gk::free(buffer, numBytes, alignment);
 }
 
+Option<void*> gk::HeapAllocator::reallocImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment)
+{
+	// Both sizes must be page mapped, otherwise the matching free would take a different path.
+	if (internal::isLargeHeapAllocation(oldNumBytes, alignment, largeAllocationThreshold)
+		&& internal::isLargeHeapAllocation(newNumBytes, alignment, largeAllocationThreshold)) {
+		return internal::reallocPages(buffer, oldNumBytes, newNumBytes);
+	}
+	return Option<void*>();
+}
+
+bool gk::HeapAllocator::resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment)
+{
+	if (internal::isLargeHeapAllocation(oldNumBytes, alignment, largeAllocationThreshold)
+		&& internal::isLargeHeapAllocation(newNumBytes, alignment, largeAllocationThreshold)) {
+		return internal::resizePagesInPlace(buffer, oldNumBytes, newNumBytes);
+	}
+	return false;
+}
+
 constexpr usize ALLOCATOR_USE_REF_COUNT_FLAG = (1ULL << 48);
 
 gk::AllocatorRef::AllocatorRef(IAllocator* inAllocator)
@@ -143,3 +324,103 @@ AllocatorRef gk::HeapAllocator::globalInstance()
 	static const usize GLOBAL_HEAP_ALLOCATOR_REF = reinterpret_cast<usize>(gk::globalHeapAllocator());
 	return AllocatorRef{ GLOBAL_HEAP_ALLOCATOR_REF };
 }
+
+#if GK_TYPES_LIB_TEST
+
+#include "../array/array_list.h"
+
+using gk::HeapAllocator;
+using gk::ArrayList;
+using gk::u8;
+
+test_case("HeapAllocator small allocation") {
+	HeapAllocator heap;
+	int* num = heap.mallocObject<int>().ok();
+	*num = 5;
+	check_eq(*num, 5);
+	heap.freeObject(num);
+}
+
+test_case("HeapAllocator large allocation is page aligned") {
+	HeapAllocator heap(64 * 1024);
+	u8* buffer = heap.mallocBuffer<u8>(100 * 1024).ok();
+	check_eq(reinterpret_cast<usize>(buffer) % gk::internal::PAGE_ALLOCATION_ALIGNMENT, 0);
+	buffer[0] = 1;
+	buffer[100 * 1024 - 1] = 2;
+	check_eq(buffer[0], 1);
+	check_eq(buffer[100 * 1024 - 1], 2);
+	heap.freeBuffer(buffer, 100 * 1024);
+}
+
+test_case("HeapAllocator large allocation stricter than page alignment") {
+	HeapAllocator heap(64 * 1024);
+	u8* buffer = heap.mallocAlignedBuffer<u8>(100 * 1024, 8192).ok();
+	check_eq(reinterpret_cast<usize>(buffer) % 8192, 0);
+	heap.freeAlignedBuffer(buffer, 100 * 1024, 8192);
+}
+
+test_case("HeapAllocator realloc small allocation is unsupported") {
+	HeapAllocator heap(64 * 1024);
+	u8* buffer = heap.mallocBuffer<u8>(100).ok();
+	check(heap.tryReallocAlignedBuffer<u8>(buffer, 100, 200, alignof(u8)).none());
+	heap.freeBuffer(buffer, 100);
+}
+
+test_case("HeapAllocator realloc large allocation keeps contents") {
+	HeapAllocator heap(64 * 1024);
+	usize* buffer = heap.mallocBuffer<usize>(16 * 1024).ok();
+	for (usize i = 0; i < 16 * 1024; i++) {
+		buffer[i] = i;
+	}
+
+	gk::Option<usize*> grown = heap.tryReallocAlignedBuffer<usize>(buffer, 16 * 1024, 64 * 1024, alignof(usize));
+	if (grown.none()) { // Not every platform can grow mappings.
+		heap.freeBuffer(buffer, 16 * 1024);
+		return;
+	}
+
+	buffer = grown.someCopy();
+	for (usize i = 0; i < 16 * 1024; i++) {
+		check_eq(buffer[i], i);
+	}
+	buffer[64 * 1024 - 1] = 1;
+	heap.freeBuffer(buffer, 64 * 1024);
+}
+
+test_case("HeapAllocator resize small allocation is unsupported") {
+	HeapAllocator heap(64 * 1024);
+	u8* buffer = heap.mallocBuffer<u8>(100).ok();
+	check(!heap.tryResizeAlignedBuffer<u8>(buffer, 100, 200, alignof(u8)));
+	heap.freeBuffer(buffer, 100);
+}
+
+test_case("HeapAllocator resize large allocation shrinks in place") {
+	HeapAllocator heap(64 * 1024);
+	u8* buffer = heap.mallocBuffer<u8>(256 * 1024).ok();
+	buffer[0] = 5;
+	check(heap.tryResizeAlignedBuffer<u8>(buffer, 256 * 1024, 128 * 1024, alignof(u8)));
+	check_eq(buffer[0], 5);
+	buffer[128 * 1024 - 1] = 1;
+	heap.freeBuffer(buffer, 128 * 1024);
+}
+
+test_case("HeapAllocator large ArrayList") {
+	HeapAllocator heap(64 * 1024);
+	auto a = ArrayList<usize>::init(heap.toRef());
+	for (usize i = 0; i < 100000; i++) {
+		a.push(i);
+	}
+	for (usize i = 0; i < 100000; i++) {
+		check_eq(a[i], i);
+	}
+}
+
+test_case("GlobalHeapStaticAllocator large allocation") {
+	constexpr usize count = HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD / sizeof(usize);
+	usize* buffer = gk::GlobalHeapStaticAllocator::mallocBuffer<usize>(count).ok();
+	buffer[count - 1] = 5;
+	check_eq(buffer[count - 1], 5);
+	gk::GlobalHeapStaticAllocator::freeBuffer(buffer, count);
+}
+
+#endif
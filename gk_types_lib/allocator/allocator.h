@@ -3,6 +3,7 @@
 #include "../basic_types.h"
 #include <type_traits>
 #include "../error/result.h"
+#include "../option/option.h"
 
 namespace gk
 {
@@ -37,6 +38,55 @@ namespace gk
 	*/
 	void free(void* memory, usize numBytes, usize alignment = alignof(usize));
 
+	namespace internal
+	{
+		/**
+		* Page mapped allocations have this alignment. Requests needing a stricter alignment can't use them.
+		*/
+		constexpr usize PAGE_ALLOCATION_ALIGNMENT = 4096;
+
+		/**
+		* Maps zeroed pages directly from the OS, bypassing the C heap.
+		* Where supported, the memory is backed by huge/large pages to reduce TLB misses.
+		* Linux uses mmap with MADV_HUGEPAGE. Windows uses VirtualAlloc, with large pages if the process has the privilege.
+		* 
+		* @param numBytes: Size of the allocation. Rounded up to whole pages internally.
+		*/
+		Result<void*, AllocError> mallocPages(usize numBytes);
+
+		/**
+		* Unmaps memory returned from `mallocPages()` or `reallocPages()`.
+		* 
+		* @param memory: Start of the mapping.
+		* @param numBytes: Size originally passed in to `mallocPages()` or `reallocPages()`.
+		*/
+		void freePages(void* memory, usize numBytes);
+
+		/**
+		* Resizes a page mapping without copying its contents. On Linux this uses mremap, which may move the mapping
+		* by remapping its pages. Other platforms don't support this, returning None.
+		* 
+		* @return The new start of the mapping, or None if it could not be resized, in which case `memory` is unchanged.
+		*/
+		Option<void*> reallocPages(void* memory, usize oldNumBytes, usize newNumBytes);
+
+		/**
+		* Resizes a page mapping without moving it. Growing only succeeds if the address range directly after
+		* the mapping is free (Linux only), or if the new size fits within the pages already mapped.
+		* 
+		* @return If the mapping now spans at least `newNumBytes`. If false, `memory` is unchanged.
+		*/
+		bool resizePagesInPlace(void* memory, usize oldNumBytes, usize newNumBytes);
+
+		/**
+		* Shared implementation of `HeapAllocator` and `GlobalHeapStaticAllocator`.
+		* Allocations of at least `largeAllocationThreshold` bytes are page mapped, and everything else uses `gk::malloc()`.
+		*/
+		constexpr bool isLargeHeapAllocation(usize numBytes, usize alignment, usize largeAllocationThreshold) {
+			return numBytes >= largeAllocationThreshold && alignment <= PAGE_ALLOCATION_ALIGNMENT;
+		}
+	}
+
 	class IAllocator {
 	public:
 
@@ -161,6 +211,38 @@ namespace gk
 		template<typename T>
 		void freeAlignedBuffer(T*& buffer, size_t numElements, usize byteAlignment);
 
+		/**
+		* Attempts to resize a buffer allocated with `mallocAlignedBuffer()` on this allocator to `newNumElements`,
+		* without the caller having to allocate, move, and free.
+		* The allocator may move the buffer's contents bitwise, so this must only be used with types that
+		* can be relocated with memcpy. See `gk::is_trivially_relocatable`.
+		* On success, the old buffer must no longer be used, and must not be freed.
+		* On failure, `buffer` remains valid and unchanged, and the caller should fall back to a normal reallocation.
+		* 
+		* @param buffer: Buffer to resize.
+		* @param oldNumElements: Number of T the buffer was allocated with.
+		* @param newNumElements: Number of T to resize to.
+		* @param byteAlignment: The byte alignment of the original allocation.
+		* @return Some with the resized buffer, or None if this allocator couldn't resize it.
+		*/
+		template<typename T>
+		Option<T*> tryReallocAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment);
+
+		/**
+		* Attempts to grow or shrink a buffer allocated with `mallocAlignedBuffer()` on this allocator to `newNumElements`
+		* without moving it. As the buffer never moves, this is valid for any T. Elements are not constructed or destroyed.
+		* On success, the buffer must later be freed with `newNumElements`.
+		* On failure, nothing changes, and the caller should fall back to allocating a new buffer.
+		* 
+		* @param buffer: Buffer to resize.
+		* @param oldNumElements: Number of T the buffer was allocated with.
+		* @param newNumElements: Number of T to resize to.
+		* @param byteAlignment: The byte alignment of the original allocation.
+		* @return If the buffer now holds `newNumElements`.
+		*/
+		template<typename T>
+		bool tryResizeAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment);
+
 	private:
 
 		friend struct AllocatorRef;
@@ -169,6 +251,16 @@ namespace gk
 
 		virtual void freeImpl(void* buffer, usize numBytes, usize alignment) = 0;
 
+		/**
+		* Optional. See `tryReallocAlignedBuffer()`. By default, no reallocation is supported.
+		*/
+		virtual Option<void*> reallocImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) { return Option<void*>(); }
+
+		/**
+		* Optional. See `tryResizeAlignedBuffer()`. By default, no in place resizing is supported.
+		*/
+		virtual bool resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) { return false; }
+
 		virtual bool trackRefCount() const = 0;
 
 		virtual void incrementRefCount() {}
@@ -176,15 +268,47 @@ namespace gk
 		virtual void decrementRefCount() {}
 	};
 	
+	/**
+	* General purpose allocator. Allocations at or above a configurable threshold are page mapped
+	* directly from the OS with huge page hints, and can be grown through `tryReallocAlignedBuffer()`
+	* and `tryResizeAlignedBuffer()` without copying where the OS supports it. See `internal::mallocPages()`.
+	*/
 	class HeapAllocator : public gk::IAllocator {
 		virtual Result<void*, AllocError> mallocImpl(usize numBytes, usize alignment) override;
 
 		virtual void freeImpl(void* buffer, usize numBytes, usize alignment) override;
 
+		virtual Option<void*> reallocImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) override;
+
+		virtual bool resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) override;
+
 		virtual bool trackRefCount() const override { return false; }
 
 	public:
+
+		/**
+		* Same as a 2MB huge page.
+		*/
+		static constexpr usize DEFAULT_LARGE_ALLOCATION_THRESHOLD = 2 * 1024 * 1024;
+
+		/**
+		* The threshold is fixed for the lifetime of the allocator, as frees must take the same path as their allocation.
+		* 
+		* @param inLargeAllocationThreshold: Allocations of at least this many bytes are page mapped.
+		*/
+		HeapAllocator(usize inLargeAllocationThreshold = DEFAULT_LARGE_ALLOCATION_THRESHOLD)
+			: largeAllocationThreshold(inLargeAllocationThreshold) {}
+
+		/**
+		* @return Allocations of at least this many bytes are page mapped.
+		*/
+		usize largeThreshold() const { return largeAllocationThreshold; }
+
 		static AllocatorRef globalInstance();
+
+	private:
+
+		const usize largeAllocationThreshold;
 	};
 	
 	/**
@@ -327,6 +451,22 @@ namespace gk
 		template<typename T>
 		void freeAlignedBuffer(T*& buffer, size_t numElements, size_t byteAlignment) { return getAllocatorObject()->freeAlignedBuffer<T>(buffer, numElements, byteAlignment); }
 
+		/**
+		* See `IAllocator::tryReallocAlignedBuffer()`.
+		*/
+		template<typename T>
+		forceinline Option<T*> tryReallocAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment) {
+			return getAllocatorObject()->tryReallocAlignedBuffer<T>(buffer, oldNumElements, newNumElements, byteAlignment);
+		}
+
+		/**
+		* See `IAllocator::tryResizeAlignedBuffer()`.
+		*/
+		template<typename T>
+		forceinline bool tryResizeAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment) {
+			return getAllocatorObject()->tryResizeAlignedBuffer<T>(buffer, oldNumElements, newNumElements, byteAlignment);
+		}
+
 		IAllocator* getAllocatorObject();
 
 		constexpr bool operator == (const AllocatorRef& other) const {
@@ -356,6 +496,139 @@ namespace gk
 		usize inner;
 
 	}; // struct AllocatorRef
+
+	/// Only holds a tagged pointer. The ref count lives on the allocator object.
+	template<>
+	struct is_trivially_relocatable<AllocatorRef> : std::true_type {};
+
+	/**
+	* Base for allocators that are resolved entirely at compile time. There is no allocator object
+	* to reference, so containers using one don't store an AllocatorRef, don't go through
+	* virtual dispatch, and don't reference count.
+	* Exposes the same allocation functions as AllocatorRef, allowing containers to be generic over either.
+	* 
+	* `Derived` must be an empty type implementing:
+	* static Result<void*, AllocError> mallocImpl(usize numBytes, usize alignment);
+	* static void freeImpl(void* buffer, usize numBytes, usize alignment);
+	*/
+	template<typename Derived>
+	struct IStaticAllocator {
+
+		/**
+		* See `IAllocator::mallocObject()`.
+		*/
+		template<typename T>
+		static Result<T*, AllocError> mallocObject();
+
+		/**
+		* See `IAllocator::mallocAlignedObject()`.
+		*/
+		template<typename T>
+		static Result<T*, AllocError> mallocAlignedObject(usize byteAlignment);
+
+		/**
+		* See `IAllocator::mallocBuffer()`.
+		*/
+		template<typename T>
+		static Result<T*, AllocError> mallocBuffer(usize numElements);
+
+		/**
+		* See `IAllocator::mallocAlignedBuffer()`.
+		*/
+		template<typename T>
+		static Result<T*, AllocError> mallocAlignedBuffer(usize numElements, usize byteAlignment);
+
+		/**
+		* See `IAllocator::freeObject()`.
+		*/
+		template<typename T>
+		static void freeObject(T*& object);
+
+		/**
+		* See `IAllocator::freeAlignedObject()`.
+		*/
+		template<typename T>
+		static void freeAlignedObject(T*& object, usize byteAlignment);
+
+		/**
+		* See `IAllocator::freeBuffer()`.
+		*/
+		template<typename T>
+		static void freeBuffer(T*& buffer, usize numElements);
+
+		/**
+		* See `IAllocator::freeAlignedBuffer()`.
+		*/
+		template<typename T>
+		static void freeAlignedBuffer(T*& buffer, usize numElements, usize byteAlignment);
+
+		/**
+		* See `IAllocator::tryReallocAlignedBuffer()`. Only supported if `Derived` also implements:
+		* static Option<void*> reallocImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment);
+		*/
+		template<typename T>
+		static Option<T*> tryReallocAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment);
+
+		/**
+		* See `IAllocator::tryResizeAlignedBuffer()`. Only supported if `Derived` also implements:
+		* static bool resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment);
+		*/
+		template<typename T>
+		static bool tryResizeAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment);
+
+		constexpr bool operator == (const IStaticAllocator&) const { return true; }
+	};
+
+	/**
+	* Compile time equivalent of the global heap allocator. Calls directly into `gk::malloc()` and `gk::free()`,
+	* or the page mapping functions for large allocations, using the same threshold as `globalHeapAllocator()`.
+	* Containers using this as their allocator policy have no allocator indirection or ref counting.
+	*/
+	struct GlobalHeapStaticAllocator : public IStaticAllocator<GlobalHeapStaticAllocator> {
+
+		static forceinline Result<void*, AllocError> mallocImpl(usize numBytes, usize alignment) {
+			if (internal::isLargeHeapAllocation(numBytes, alignment, HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD)) {
+				return internal::mallocPages(numBytes);
+			}
+			return gk::malloc(numBytes, alignment);
+		}
+
+		static forceinline void freeImpl(void* buffer, usize numBytes, usize alignment) {
+			if (internal::isLargeHeapAllocation(numBytes, alignment, HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD)) {
+				return internal::freePages(buffer, numBytes);
+			}
+			gk::free(buffer, numBytes, alignment);
+		}
+
+		static forceinline Option<void*> reallocImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) {
+			if (internal::isLargeHeapAllocation(oldNumBytes, alignment, HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD)
+				&& internal::isLargeHeapAllocation(newNumBytes, alignment, HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD)) {
+				return internal::reallocPages(buffer, oldNumBytes, newNumBytes);
+			}
+			return Option<void*>();
+		}
+
+		static forceinline bool resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) {
+			if (internal::isLargeHeapAllocation(oldNumBytes, alignment, HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD)
+				&& internal::isLargeHeapAllocation(newNumBytes, alignment, HeapAllocator::DEFAULT_LARGE_ALLOCATION_THRESHOLD)) {
+				return internal::resizePagesInPlace(buffer, oldNumBytes, newNumBytes);
+			}
+			return false;
+		}
+	};
+
+	/**
+	* Allocator that is known entirely at compile time. See `IStaticAllocator`.
+	*/
+	template<typename A>
+	concept StaticAllocator = std::is_empty_v<A> && std::is_base_of_v<IStaticAllocator<A>, A>;
+
+	/**
+	* An allocator type that containers can be templated on. Either the type erased, runtime
+	* `AllocatorRef`, or a compile time `StaticAllocator`.
+	*/
+	template<typename A>
+	concept AllocatorPolicy = std::is_same_v<A, AllocatorRef> || StaticAllocator<A>;
 } // namespace gk
 
 template<typename T>
@@ -463,6 +736,185 @@ inline void gk::IAllocator::freeAlignedBuffer(T*& buffer, size_t numElements, us
 	buffer = nullptr;
 }
 
+template<typename Derived>
+template<typename T>
+inline gk::Result<T*, gk::AllocError> gk::IStaticAllocator<Derived>::mallocObject()
+{
+	Result<void*, AllocError> allocResult = Derived::mallocImpl(sizeof(T), alignof(T));
+	if (allocResult.isError()) {
+		return ResultErr<AllocError>(allocResult.error());
+	}
+
+	T* mem = (T*)allocResult.okCopy();
+	check_message((usize(mem) % alignof(T)) == 0, "Allocator mallocObject returned a pointer not aligned to the alignment requirements of the type T");
+
+	return ResultOk<T*>(mem);
+}
+
+template<typename Derived>
+template<typename T>
+inline gk::Result<T*, gk::AllocError> gk::IStaticAllocator<Derived>::mallocAlignedObject(usize byteAlignment)
+{
+	check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+
+	Result<void*, AllocError> allocResult = Derived::mallocImpl(sizeof(T), byteAlignment);
+	if (allocResult.isError()) {
+		return ResultErr<AllocError>(allocResult.error());
+	}
+
+	T* mem = (T*)allocResult.okCopy();
+	check_message((usize(mem) % alignof(T)) == 0, "Allocator mallocObject returned a pointer not aligned to the alignment requirements of the type T");
+
+	return ResultOk<T*>(mem);
+}
+
+template<typename Derived>
+template<typename T>
+inline gk::Result<T*, gk::AllocError> gk::IStaticAllocator<Derived>::mallocBuffer(usize numElements)
+{
+	check_gt(numElements, 0);
+
+	Result<void*, AllocError> allocResult = Derived::mallocImpl(sizeof(T) * numElements, alignof(T));
+	if (allocResult.isError()) {
+		return ResultErr<AllocError>(allocResult.error());
+	}
+
+	T* mem = (T*)allocResult.okCopy();
+	check_message((usize(mem) % alignof(T)) == 0, "Allocator mallocObject returned a pointer not aligned to the alignment requirements of the type T");
+
+	return ResultOk<T*>(mem);
+}
+
+template<typename Derived>
+template<typename T>
+inline gk::Result<T*, gk::AllocError> gk::IStaticAllocator<Derived>::mallocAlignedBuffer(usize numElements, usize byteAlignment)
+{
+	check_gt(numElements, 0);
+	check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+
+	Result<void*, AllocError> allocResult = Derived::mallocImpl(sizeof(T) * numElements, byteAlignment);
+	if (allocResult.isError()) {
+		return ResultErr<AllocError>(allocResult.error());
+	}
+
+	T* mem = (T*)allocResult.okCopy();
+	check_message((usize(mem) % alignof(T)) == 0, "Allocator mallocObject returned a pointer not aligned to the alignment requirements of the type T");
+
+	return ResultOk<T*>(mem);
+}
+
+template<typename Derived>
+template<typename T>
+inline void gk::IStaticAllocator<Derived>::freeObject(T*& object)
+{
+	check_message(object != nullptr, "Cannot free nullptr");
+
+	Derived::freeImpl((void*)object, sizeof(T), alignof(T));
+	object = nullptr;
+}
+
+template<typename Derived>
+template<typename T>
+inline void gk::IStaticAllocator<Derived>::freeAlignedObject(T*& object, usize byteAlignment)
+{
+	check_message(object != nullptr, "Cannot free nullptr");
+	check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+	check_message((usize(object) % alignof(T)) == 0, "Cannot free a pointer that is not aligned to the alignment requirements of the type T");
+
+	Derived::freeImpl((void*)object, sizeof(T), byteAlignment);
+	object = nullptr;
+}
+
+template<typename Derived>
+template<typename T>
+inline void gk::IStaticAllocator<Derived>::freeBuffer(T*& buffer, usize numElements)
+{
+	check_message(buffer != nullptr, "Cannot free nullptr");
+	check_gt(numElements, 0);
+
+	Derived::freeImpl((void*)buffer, sizeof(T) * numElements, alignof(T));
+	buffer = nullptr;
+}
+
+template<typename Derived>
+template<typename T>
+inline void gk::IStaticAllocator<Derived>::freeAlignedBuffer(T*& buffer, usize numElements, usize byteAlignment)
+{
+	check_message(buffer != nullptr, "Cannot free nullptr");
+	check_gt(numElements, 0);
+	check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+	check_message((usize(buffer) % alignof(T)) == 0, "Cannot free a pointer that is not aligned to the alignment requirements of the type T");
+
+	Derived::freeImpl((void*)buffer, sizeof(T) * numElements, byteAlignment);
+	buffer = nullptr;
+}
+
+template<typename T>
+inline gk::Option<T*> gk::IAllocator::tryReallocAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment)
+{
+	check_message(buffer != nullptr, "Cannot reallocate nullptr");
+	check_gt(newNumElements, 0);
+	check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+
+	Option<void*> reallocResult = reallocImpl((void*)buffer, sizeof(T) * oldNumElements, sizeof(T) * newNumElements, byteAlignment);
+	if (reallocResult.none()) {
+		return Option<T*>();
+	}
+	return Option<T*>(reinterpret_cast<T*>(reallocResult.someCopy()));
+}
+
+template<typename Derived>
+template<typename T>
+inline gk::Option<T*> gk::IStaticAllocator<Derived>::tryReallocAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment)
+{
+	if constexpr (requires(void* p, usize n) { Derived::reallocImpl(p, n, n, n); }) {
+		check_message(buffer != nullptr, "Cannot reallocate nullptr");
+		check_gt(newNumElements, 0);
+		check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+
+		Option<void*> reallocResult = Derived::reallocImpl((void*)buffer, sizeof(T) * oldNumElements, sizeof(T) * newNumElements, byteAlignment);
+		if (reallocResult.none()) {
+			return Option<T*>();
+		}
+		return Option<T*>(reinterpret_cast<T*>(reallocResult.someCopy()));
+	}
+	else {
+		return Option<T*>();
+	}
+}
+
+template<typename T>
+inline bool gk::IAllocator::tryResizeAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment)
+{
+	check_message(buffer != nullptr, "Cannot resize nullptr");
+	check_gt(newNumElements, 0);
+	check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+
+	if (oldNumElements == newNumElements) {
+		return true;
+	}
+	return resizeInPlaceImpl((void*)buffer, sizeof(T) * oldNumElements, sizeof(T) * newNumElements, byteAlignment);
+}
+
+template<typename Derived>
+template<typename T>
+inline bool gk::IStaticAllocator<Derived>::tryResizeAlignedBuffer(T* buffer, usize oldNumElements, usize newNumElements, usize byteAlignment)
+{
+	if constexpr (requires(void* p, usize n) { Derived::resizeInPlaceImpl(p, n, n, n); }) {
+		check_message(buffer != nullptr, "Cannot resize nullptr");
+		check_gt(newNumElements, 0);
+		check_message(byteAlignment % alignof(T) == 0, "byteAlignment must be a multiple of the alignment of T");
+
+		if (oldNumElements == newNumElements) {
+			return true;
+		}
+		return Derived::resizeInPlaceImpl((void*)buffer, sizeof(T) * oldNumElements, sizeof(T) * newNumElements, byteAlignment);
+	}
+	else {
+		return false;
+	}
+}
+
 constexpr gk::AllocatorRef::AllocatorRef(AllocatorRef&& other) noexcept
 	: inner(other.inner)
 {
@@ -0,0 +1,342 @@
+#include "arena_allocator.h"
+
+using gk::Result;
+using gk::AllocError;
+using gk::usize;
+using gk::u8;
+using gk::u64;
+
+/// Size an allocation is accounted as in `bytesUsed()`. Freeing the same allocation subtracts the same size.
+static usize accountedBytes(usize numBytes, usize alignment) {
+	return (numBytes + alignment - 1) & ~(alignment - 1);
+}
+
+gk::ArenaAllocator::ArenaAllocator(usize inChunkSize)
+	: current(nullptr), chunkSize(inChunkSize), usedBytes(0), reservedBytes(0), refCount(0)
+{
+	check_gt(inChunkSize, 0);
+}
+
+gk::ArenaAllocator::~ArenaAllocator()
+{
+	check_message(this->refCount == 0, "References to this ArenaAllocator instance still exist. Cannot safely destroy");
+	this->releaseAll();
+}
+
+void gk::ArenaAllocator::reset()
+{
+	if (this->current == nullptr) {
+		return;
+	}
+
+	Chunk* largest = this->current;
+	Chunk* chunk = this->current->previous;
+	while (chunk != nullptr) {
+		Chunk* previous = chunk->previous;
+		if (chunk->capacity > largest->capacity) {
+			freeChunk(largest);
+			largest = chunk;
+		}
+		else {
+			freeChunk(chunk);
+		}
+		chunk = previous;
+	}
+
+	largest->previous = nullptr;
+	largest->offset = 0;
+	this->current = largest;
+	this->usedBytes = 0;
+	this->reservedBytes = largest->capacity;
+}
+
+void gk::ArenaAllocator::releaseAll()
+{
+	Chunk* chunk = this->current;
+	while (chunk != nullptr) {
+		Chunk* previous = chunk->previous;
+		freeChunk(chunk);
+		chunk = previous;
+	}
+	this->current = nullptr;
+	this->usedBytes = 0;
+	this->reservedBytes = 0;
+}
+
+usize gk::ArenaAllocator::chunkCount() const
+{
+	usize count = 0;
+	const Chunk* chunk = this->current;
+	while (chunk != nullptr) {
+		count++;
+		chunk = chunk->previous;
+	}
+	return count;
+}
+
+Result<void*, AllocError> gk::ArenaAllocator::mallocImpl(usize numBytes, usize alignment)
+{
+	if (this->current != nullptr) {
+		const usize start = reinterpret_cast<usize>(this->current->data()) + this->current->offset;
+		const usize alignedStart = (start + alignment - 1) & ~(alignment - 1);
+		const usize end = alignedStart + numBytes;
+		if (end <= reinterpret_cast<usize>(this->current->data()) + this->current->capacity) {
+			this->current->offset = end - reinterpret_cast<usize>(this->current->data());
+			this->usedBytes += accountedBytes(numBytes, alignment);
+			return ResultOk<void*>(reinterpret_cast<void*>(alignedStart));
+		}
+	}
+
+	Result<Chunk*, AllocError> chunkResult = this->allocateChunk(numBytes, alignment);
+	if (chunkResult.isError()) {
+		return ResultErr<AllocError>(chunkResult.error());
+	}
+
+	Chunk* chunk = chunkResult.okCopy();
+	chunk->previous = this->current;
+	this->current = chunk;
+	this->reservedBytes += chunk->capacity;
+
+	const usize start = reinterpret_cast<usize>(chunk->data());
+	const usize alignedStart = (start + alignment - 1) & ~(alignment - 1);
+	const usize end = alignedStart + numBytes;
+	chunk->offset = end - start;
+	this->usedBytes += accountedBytes(numBytes, alignment);
+	return ResultOk<void*>(reinterpret_cast<void*>(alignedStart));
+}
+
+void gk::ArenaAllocator::freeImpl(void* buffer, usize numBytes, usize alignment)
+{
+	// A buffer from before the last reset could end at the top of the reused chunk, so rolling back for it
+	// would hand out memory that is still in use. Such a free can't be told apart by address, only by the
+	// bytes it would give back being more than are in use.
+	const usize bytes = accountedBytes(numBytes, alignment);
+	check_message(bytes <= this->usedBytes, "ArenaAllocator buffer was freed after reset() or releaseAll(). Buffers allocated before a reset must not be freed");
+	if (bytes > this->usedBytes) {
+		return;
+	}
+	this->usedBytes -= bytes;
+
+	// Only the memory of the most recent allocation can be given back. Everything else lives until reset.
+	if (this->current == nullptr) {
+		return;
+	}
+
+	u8* bufferBytes = reinterpret_cast<u8*>(buffer);
+	u8* top = this->current->data() + this->current->offset;
+	if (bufferBytes + numBytes != top) {
+		return;
+	}
+
+	this->current->offset = static_cast<usize>(bufferBytes - this->current->data());
+}
+
+bool gk::ArenaAllocator::resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment)
+{
+	if (this->current != nullptr) {
+		u8* bufferBytes = reinterpret_cast<u8*>(buffer);
+		u8* top = this->current->data() + this->current->offset;
+		if (bufferBytes + oldNumBytes == top) {
+			const usize bufferOffset = static_cast<usize>(bufferBytes - this->current->data());
+			if (bufferOffset + newNumBytes > this->current->capacity) {
+				return false;
+			}
+			this->current->offset = bufferOffset + newNumBytes;
+			this->usedBytes = this->usedBytes - accountedBytes(oldNumBytes, alignment) + accountedBytes(newNumBytes, alignment);
+			return true;
+		}
+	}
+
+	if (newNumBytes > oldNumBytes) {
+		return false;
+	}
+	this->usedBytes = this->usedBytes - accountedBytes(oldNumBytes, alignment) + accountedBytes(newNumBytes, alignment);
+	return true;
+}
+
+void gk::ArenaAllocator::decrementRefCount()
+{
+	check_gt(this->refCount, 0);
+	this->refCount--;
+}
+
+Result<gk::ArenaAllocator::Chunk*, AllocError> gk::ArenaAllocator::allocateChunk(usize minCapacity, usize alignment)
+{
+	// Padding for alignments stricter than the chunk data start.
+	const usize requiredCapacity = minCapacity + (alignment > alignof(Chunk) ? alignment : 0);
+	const usize capacity = requiredCapacity > this->chunkSize ? requiredCapacity : this->chunkSize;
+
+	Result<void*, AllocError> allocResult = gk::malloc(sizeof(Chunk) + capacity, CHUNK_ALIGNMENT);
+	if (allocResult.isError()) {
+		return ResultErr<AllocError>(allocResult.error());
+	}
+
+	Chunk* chunk = reinterpret_cast<Chunk*>(allocResult.okCopy());
+	chunk->previous = nullptr;
+	chunk->capacity = capacity;
+	chunk->offset = 0;
+	return ResultOk<Chunk*>(chunk);
+}
+
+void gk::ArenaAllocator::freeChunk(Chunk* chunk)
+{
+	gk::free(chunk, sizeof(Chunk) + chunk->capacity, CHUNK_ALIGNMENT);
+}
+
+#if GK_TYPES_LIB_TEST
+
+#include "../array/array_list.h"
+#include "../string/string.h"
+
+using gk::ArenaAllocator;
+using gk::ArrayList;
+
+test_case("ArenaAllocator malloc and free") {
+	ArenaAllocator arena;
+	int* num = arena.mallocObject<int>().ok();
+	*num = 5;
+	check_eq(*num, 5);
+	check_eq(arena.bytesUsed(), sizeof(int));
+	arena.freeObject(num);
+	check_eq(arena.bytesUsed(), 0);
+}
+
+test_case("ArenaAllocator free rolls back last allocation only") {
+	ArenaAllocator arena;
+	u64* first = arena.mallocObject<u64>().ok();
+	u64* second = arena.mallocObject<u64>().ok();
+	u64* firstCopy = first;
+	arena.freeObject(first); // not the last allocation, so it's memory isn't reused
+	check_eq(arena.bytesUsed(), sizeof(u64));
+	arena.freeObject(second);
+	check_eq(arena.bytesUsed(), 0);
+	u64* third = arena.mallocObject<u64>().ok();
+	check_ne(third, firstCopy);
+	arena.freeObject(third);
+}
+
+test_case("ArenaAllocator resize last allocation in place") {
+	ArenaAllocator arena;
+	u64* buffer = arena.mallocAlignedBuffer<u64>(10, alignof(u64)).ok();
+	check(arena.tryResizeAlignedBuffer<u64>(buffer, 10, 100, alignof(u64)));
+	check_eq(arena.bytesUsed(), 100 * sizeof(u64));
+	buffer[99] = 5;
+	check(arena.tryResizeAlignedBuffer<u64>(buffer, 100, 20, alignof(u64)));
+	check_eq(arena.bytesUsed(), 20 * sizeof(u64));
+	check(!arena.tryResizeAlignedBuffer<u64>(buffer, 20, ArenaAllocator::DEFAULT_CHUNK_SIZE, alignof(u64)));
+	arena.freeAlignedBuffer(buffer, 20, alignof(u64));
+	check_eq(arena.bytesUsed(), 0);
+}
+
+test_case("ArenaAllocator resize older allocation can only shrink") {
+	ArenaAllocator arena;
+	u64* first = arena.mallocAlignedBuffer<u64>(10, alignof(u64)).ok();
+	u64* second = arena.mallocAlignedBuffer<u64>(10, alignof(u64)).ok();
+	check(!arena.tryResizeAlignedBuffer<u64>(first, 10, 11, alignof(u64)));
+	check(arena.tryResizeAlignedBuffer<u64>(first, 10, 5, alignof(u64)));
+	check_eq(arena.bytesUsed(), 15 * sizeof(u64));
+	arena.freeAlignedBuffer(second, 10, alignof(u64));
+	arena.freeAlignedBuffer(first, 5, alignof(u64));
+	check_eq(arena.bytesUsed(), 0);
+}
+
+test_case("ArenaAllocator ArrayList grows in place") {
+	ArenaAllocator arena;
+	auto a = ArrayList<gk::String>::init(arena.toRef());
+	a.push(gk::String::fromUint(0));
+	const gk::String* firstData = a.data();
+	for (int i = 1; i < 100; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	check_eq(a.data(), firstData);
+	check_eq(a[99], gk::String::fromUint(99));
+}
+
+test_case("ArenaAllocator alignment") {
+	ArenaAllocator arena;
+	(void)arena.mallocObject<u8>().ok();
+	u8* aligned = arena.mallocAlignedBuffer<u8>(100, 64).ok();
+	check_eq(reinterpret_cast<usize>(aligned) % 64, 0);
+	u8* moreAligned = arena.mallocAlignedBuffer<u8>(100, 4096).ok();
+	check_eq(reinterpret_cast<usize>(moreAligned) % 4096, 0);
+}
+
+test_case("ArenaAllocator bytes used returns to start after freeing mixed alignments") {
+	ArenaAllocator arena;
+	(void)arena.mallocObject<u8>().ok();
+	const usize startBytes = arena.bytesUsed();
+
+	u8* a = arena.mallocAlignedBuffer<u8>(3, 64).ok();
+	u64* b = arena.mallocAlignedBuffer<u64>(5, 16).ok();
+	u8* c = arena.mallocAlignedBuffer<u8>(7, 1).ok();
+	u8* d = arena.mallocAlignedBuffer<u8>(100, 4096).ok();
+	check_gt(arena.bytesUsed(), startBytes);
+
+	arena.freeAlignedBuffer(d, 100, 4096);
+	arena.freeAlignedBuffer(c, 7, 1);
+	arena.freeAlignedBuffer(b, 5, 16);
+	arena.freeAlignedBuffer(a, 3, 64);
+	check_eq(arena.bytesUsed(), startBytes);
+
+	// Repeating the same pattern must not drift.
+	for (int i = 0; i < 10; i++) {
+		u8* x = arena.mallocAlignedBuffer<u8>(13, 32).ok();
+		u8* y = arena.mallocAlignedBuffer<u8>(1, 8).ok();
+		arena.freeAlignedBuffer(y, 1, 8);
+		arena.freeAlignedBuffer(x, 13, 32);
+	}
+	check_eq(arena.bytesUsed(), startBytes);
+}
+
+test_case("ArenaAllocator large allocation gets own chunk") {
+	ArenaAllocator arena(256);
+	(void)arena.mallocObject<int>().ok();
+	u8* large = arena.mallocBuffer<u8>(1024).ok();
+	large[1023] = 1;
+	check_eq(arena.chunkCount(), 2);
+	check_ge(arena.bytesReserved(), 1024 + 256);
+}
+
+test_case("ArenaAllocator reset keeps one chunk") {
+	ArenaAllocator arena(256);
+	for (int i = 0; i < 100; i++) {
+		(void)arena.mallocBuffer<u64>(8).ok();
+	}
+	check_gt(arena.chunkCount(), 1);
+	arena.reset();
+	check_eq(arena.chunkCount(), 1);
+	check_eq(arena.bytesUsed(), 0);
+	(void)arena.mallocBuffer<u64>(8).ok();
+	check_eq(arena.chunkCount(), 1);
+	arena.releaseAll();
+	check_eq(arena.chunkCount(), 0);
+	check_eq(arena.bytesReserved(), 0);
+}
+
+test_case("ArenaAllocator ArrayList") {
+	ArenaAllocator arena;
+	{
+		auto a = ArrayList<int>::init(arena.toRef());
+		for (int i = 0; i < 1000; i++) {
+			a.push(i);
+		}
+		for (int i = 0; i < 1000; i++) {
+			check_eq(a[i], i);
+		}
+	}
+	arena.reset();
+	check_eq(arena.bytesUsed(), 0);
+}
+
+test_case("ArenaAllocator ArrayList of String") {
+	ArenaAllocator arena;
+	{
+		auto a = ArrayList<gk::String>::init(arena.toRef());
+		for (int i = 0; i < 100; i++) {
+			a.push(gk::String::fromUint(i));
+		}
+		check_eq(a[99], gk::String::fromUint(99));
+	}
+}
+
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "allocator.h"
+
+namespace gk {
+	/// Bump allocator that hands out memory from large chunks obtained from `gk::malloc()`.
+	/// Allocation is a pointer bump, and freeing is a no-op unless the memory being freed
+	/// was the most recent allocation, in which case the bump pointer is rolled back.
+	/// All memory is released at once through `reset()`, `releaseAll()`, or destruction.
+	/// Intended for short lived scratch memory, such as per-frame or per-request containers.
+	/// Is NOT multithread safe.
+	class ArenaAllocator : public gk::IAllocator {
+	public:
+
+		static constexpr usize DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		/// @param inChunkSize: Minimum number of bytes each chunk allocates. Allocations
+		/// larger than this will get their own dedicated chunk.
+		ArenaAllocator(usize inChunkSize = DEFAULT_CHUNK_SIZE);
+
+		ArenaAllocator(const ArenaAllocator&) = delete;
+		ArenaAllocator(ArenaAllocator&&) = delete;
+		ArenaAllocator& operator = (const ArenaAllocator&) = delete;
+		ArenaAllocator& operator = (ArenaAllocator&&) = delete;
+
+		virtual ~ArenaAllocator() noexcept(false) override;
+
+		/// Invalidates every allocation made by this arena, keeping the largest chunk
+		/// for reuse and freeing the rest. Objects allocated from this arena
+		/// will not have their destructors called.
+		/// Containers using this arena must be destroyed before calling `reset()`, or never destroyed at all.
+		/// Freeing a buffer allocated before the reset can roll the bump pointer back over live allocations.
+		void reset();
+
+		/// Invalidates every allocation made by this arena, and frees all chunks.
+		/// Objects allocated from this arena will not have their destructors called.
+		/// Like `reset()`, buffers allocated before this call must not be freed afterwards.
+		void releaseAll();
+
+		/// @return Bytes of the allocations that haven't been freed since the last reset, each rounded up to it's alignment.
+		/// Freeing subtracts the same rounded size. Only the memory of the most recent allocation is reused after a free,
+		/// so `bytesReserved()` can stay higher until `reset()`.
+		usize bytesUsed() const { return this->usedBytes; }
+
+		/// @return Total number of bytes owned by the arena across all chunks.
+		usize bytesReserved() const { return this->reservedBytes; }
+
+		/// @return The number of chunks currently owned by the arena.
+		usize chunkCount() const;
+
+	private:
+
+		virtual Result<void*, AllocError> mallocImpl(usize numBytes, usize alignment) override;
+
+		virtual void freeImpl(void* buffer, usize numBytes, usize alignment) override;
+
+		/// The most recent allocation can grow into the rest of its chunk, or shrink by rolling back the bump pointer.
+		/// Any other allocation can only shrink, with the tail being unused until reset.
+		virtual bool resizeInPlaceImpl(void* buffer, usize oldNumBytes, usize newNumBytes, usize alignment) override;
+
+		virtual bool trackRefCount() const override { return true; }
+
+		virtual void incrementRefCount() override { this->refCount++; }
+
+		virtual void decrementRefCount() override;
+
+		struct Chunk {
+			Chunk* previous;
+			usize capacity;
+			usize offset;
+
+			u8* data() { return reinterpret_cast<u8*>(this) + sizeof(Chunk); }
+		};
+
+		static constexpr usize CHUNK_ALIGNMENT = 64;
+
+		Result<Chunk*, AllocError> allocateChunk(usize minCapacity, usize alignment);
+
+		static void freeChunk(Chunk* chunk);
+
+	private:
+
+		Chunk* current;
+		usize chunkSize;
+		usize usedBytes;
+		usize reservedBytes;
+		usize refCount;
+	};
+} // namespace gk
@@ -0,0 +1,352 @@
+#include "slab_pool_allocator.h"
+#include "thread_local_registry.h"
+#include "../utility.h"
+#include <bit>
+
+using gk::Result;
+using gk::AllocError;
+using gk::usize;
+using gk::u8;
+using gk::u64;
+using gk::Option;
+
+gk::SlabPoolAllocator::SlabPoolAllocator()
+	: id(internal::newThreadLocalOwnerId()), caches(nullptr)
+{}
+
+gk::SlabPoolAllocator::~SlabPoolAllocator()
+{
+	for (usize i = 0; i < SIZE_CLASS_COUNT; i++) {
+		Slab* slab = depots[i].slabs;
+		while (slab != nullptr) {
+			Slab* next = slab->next;
+			gk::free(slab->memory, SLAB_SIZE, SLAB_ALIGNMENT);
+			gk::free(slab, sizeof(Slab), alignof(Slab));
+			slab = next;
+		}
+	}
+
+	ThreadCache* cache = this->caches;
+	while (cache != nullptr) {
+		ThreadCache* next = cache->next;
+		gk::free(cache, sizeof(ThreadCache), alignof(ThreadCache));
+		cache = next;
+	}
+}
+
+usize gk::SlabPoolAllocator::slabCount() const
+{
+	usize count = 0;
+	for (usize i = 0; i < SIZE_CLASS_COUNT; i++) {
+		depots[i].mutex.lock();
+		count += depots[i].slabCount;
+		depots[i].mutex.unlock();
+	}
+	return count;
+}
+
+usize gk::SlabPoolAllocator::threadCacheCount() const
+{
+	usize count = 0;
+	cachesMutex.lock();
+	for (const ThreadCache* cache = this->caches; cache != nullptr; cache = cache->next) {
+		count++;
+	}
+	cachesMutex.unlock();
+	return count;
+}
+
+Option<usize> gk::SlabPoolAllocator::sizeClassIndex(usize numBytes, usize alignment)
+{
+	usize size = numBytes > alignment ? numBytes : alignment;
+	if (size > MAX_BLOCK_SIZE) {
+		return Option<usize>();
+	}
+	if (size < MIN_BLOCK_SIZE) {
+		size = MIN_BLOCK_SIZE;
+	}
+	const usize blockSize = static_cast<usize>(gk::upperPowerOfTwo(size));
+	return Option<usize>(static_cast<usize>(std::countr_zero(blockSize) - std::countr_zero(MIN_BLOCK_SIZE)));
+}
+
+Result<void*, AllocError> gk::SlabPoolAllocator::mallocImpl(usize numBytes, usize alignment)
+{
+	Option<usize> sizeClass = sizeClassIndex(numBytes, alignment);
+	if (sizeClass.none()) {
+		return gk::malloc(numBytes, alignment);
+	}
+
+	Result<ThreadCache*, AllocError> cache = getThreadCache();
+	if (cache.isError()) {
+		return ResultErr<AllocError>(cache.error());
+	}
+
+	const usize index = sizeClass.someCopy();
+	Magazine& magazine = cache.okCopy()->magazines[index];
+	if (magazine.count == 0) {
+		Result<void, AllocError> refillResult = refillMagazine(magazine, index);
+		if (refillResult.isError()) {
+			return ResultErr<AllocError>(refillResult.error());
+		}
+	}
+
+	magazine.count--;
+	return ResultOk<void*>(magazine.blocks[magazine.count]);
+}
+
+void gk::SlabPoolAllocator::freeImpl(void* buffer, usize numBytes, usize alignment)
+{
+	Option<usize> sizeClass = sizeClassIndex(numBytes, alignment);
+	if (sizeClass.none()) {
+		return gk::free(buffer, numBytes, alignment);
+	}
+
+	const usize index = sizeClass.someCopy();
+	Result<ThreadCache*, AllocError> cache = getThreadCache();
+	if (cache.isError()) {
+		// No cache to hold the block, so give it straight back to the depot.
+		Depot& depot = depots[index];
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(buffer);
+		depot.mutex.lock();
+		block->next = depot.freeList;
+		depot.freeList = block;
+		depot.mutex.unlock();
+		return;
+	}
+
+	Magazine& magazine = cache.okCopy()->magazines[index];
+	if (magazine.count == MAGAZINE_CAPACITY) {
+		flushMagazine(magazine, index);
+	}
+
+	magazine.blocks[magazine.count] = buffer;
+	magazine.count++;
+}
+
+Result<gk::SlabPoolAllocator::ThreadCache*, AllocError> gk::SlabPoolAllocator::getThreadCache()
+{
+	void* existing = internal::findThreadLocalData(this->id);
+	if (existing != nullptr) {
+		return ResultOk<ThreadCache*>(reinterpret_cast<ThreadCache*>(existing));
+	}
+
+	const std::thread::id thisThread = std::this_thread::get_id();
+
+	// The thread local slot may have been evicted by other allocators used on this thread.
+	// In that case this thread's cache already exists, along with any blocks still in it's magazines.
+	cachesMutex.lock();
+	for (ThreadCache* cache = this->caches; cache != nullptr; cache = cache->next) {
+		if (cache->owner == thisThread) {
+			cachesMutex.unlock();
+			internal::setThreadLocalData(this->id, cache);
+			return ResultOk<ThreadCache*>(cache);
+		}
+	}
+	cachesMutex.unlock();
+
+	// Owned by this allocator rather than the thread, so that cached blocks stay valid
+	// for the allocator's lifetime regardless of when the thread exits.
+	Result<void*, AllocError> cacheMemory = gk::malloc(sizeof(ThreadCache), alignof(ThreadCache));
+	if (cacheMemory.isError()) {
+		return ResultErr<AllocError>(cacheMemory.error());
+	}
+
+	ThreadCache* cache = reinterpret_cast<ThreadCache*>(cacheMemory.okCopy());
+	for (usize i = 0; i < SIZE_CLASS_COUNT; i++) {
+		cache->magazines[i].count = 0;
+	}
+	new (&cache->owner) std::thread::id(thisThread);
+
+	cachesMutex.lock();
+	cache->next = this->caches;
+	this->caches = cache;
+	cachesMutex.unlock();
+
+	internal::setThreadLocalData(this->id, cache);
+	return ResultOk<ThreadCache*>(cache);
+}
+
+Result<void, AllocError> gk::SlabPoolAllocator::refillMagazine(Magazine& magazine, usize sizeClass)
+{
+	const usize blockSize = MIN_BLOCK_SIZE << sizeClass;
+	Depot& depot = depots[sizeClass];
+
+	depot.mutex.lock();
+	while (magazine.count < MAGAZINE_CAPACITY / 2) {
+		if (depot.freeList != nullptr) {
+			magazine.blocks[magazine.count] = depot.freeList;
+			magazine.count++;
+			depot.freeList = depot.freeList->next;
+			continue;
+		}
+
+		if (depot.bumpCurrent == depot.bumpEnd) {
+			Result<void*, AllocError> slabMemory = gk::malloc(SLAB_SIZE, SLAB_ALIGNMENT);
+			if (slabMemory.isError()) {
+				break;
+			}
+			Result<void*, AllocError> slabNode = gk::malloc(sizeof(Slab), alignof(Slab));
+			if (slabNode.isError()) {
+				gk::free(slabMemory.okCopy(), SLAB_SIZE, SLAB_ALIGNMENT);
+				break;
+			}
+
+			Slab* slab = reinterpret_cast<Slab*>(slabNode.okCopy());
+			slab->memory = slabMemory.okCopy();
+			slab->next = depot.slabs;
+			depot.slabs = slab;
+			depot.slabCount++;
+			depot.bumpCurrent = reinterpret_cast<u8*>(slab->memory);
+			depot.bumpEnd = depot.bumpCurrent + SLAB_SIZE;
+		}
+
+		magazine.blocks[magazine.count] = depot.bumpCurrent;
+		magazine.count++;
+		depot.bumpCurrent += blockSize;
+	}
+	depot.mutex.unlock();
+
+	if (magazine.count == 0) {
+		return ResultErr<AllocError>(AllocError::OutOfMemory);
+	}
+	return ResultOk<void>();
+}
+
+void gk::SlabPoolAllocator::flushMagazine(Magazine& magazine, usize sizeClass)
+{
+	Depot& depot = depots[sizeClass];
+
+	depot.mutex.lock();
+	while (magazine.count > MAGAZINE_CAPACITY / 2) {
+		magazine.count--;
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(magazine.blocks[magazine.count]);
+		block->next = depot.freeList;
+		depot.freeList = block;
+	}
+	depot.mutex.unlock();
+}
+
+#if GK_TYPES_LIB_TEST
+
+#include "../array/array_list.h"
+#include "../job/job_system.h"
+
+using gk::SlabPoolAllocator;
+using gk::ArrayList;
+
+test_case("SlabPoolAllocator size classes") {
+	check_eq(SlabPoolAllocator::sizeClassIndex(1, 1).someCopy(), 0);
+	check_eq(SlabPoolAllocator::sizeClassIndex(16, 8).someCopy(), 0);
+	check_eq(SlabPoolAllocator::sizeClassIndex(17, 8).someCopy(), 1);
+	check_eq(SlabPoolAllocator::sizeClassIndex(8, 64).someCopy(), 2);
+	check_eq(SlabPoolAllocator::sizeClassIndex(4096, 64).someCopy(), 8);
+	check(SlabPoolAllocator::sizeClassIndex(4097, 64).none());
+	check(SlabPoolAllocator::sizeClassIndex(64, 8192).none());
+}
+
+test_case("SlabPoolAllocator malloc and free") {
+	SlabPoolAllocator pool;
+	int* num = pool.mallocObject<int>().ok();
+	*num = 5;
+	check_eq(*num, 5);
+	pool.freeObject(num);
+	check_eq(pool.slabCount(), 1);
+}
+
+test_case("SlabPoolAllocator reuses freed blocks") {
+	SlabPoolAllocator pool;
+	u64* first = pool.mallocObject<u64>().ok();
+	u64* firstCopy = first;
+	pool.freeObject(first);
+	u64* second = pool.mallocObject<u64>().ok();
+	check_eq(second, firstCopy);
+	pool.freeObject(second);
+}
+
+test_case("SlabPoolAllocator block alignment") {
+	SlabPoolAllocator pool;
+	for (usize i = 0; i < 100; i++) {
+		u8* buffer = pool.mallocAlignedBuffer<u8>(64, 64).ok();
+		check_eq(reinterpret_cast<usize>(buffer) % 64, 0);
+		u8* pageAligned = pool.mallocAlignedBuffer<u8>(100, 4096).ok();
+		check_eq(reinterpret_cast<usize>(pageAligned) % 4096, 0);
+	}
+}
+
+test_case("SlabPoolAllocator large allocation passes through") {
+	SlabPoolAllocator pool;
+	u8* large = pool.mallocBuffer<u8>(SlabPoolAllocator::MAX_BLOCK_SIZE + 1).ok();
+	large[SlabPoolAllocator::MAX_BLOCK_SIZE] = 1;
+	check_eq(pool.slabCount(), 0);
+	pool.freeBuffer(large, SlabPoolAllocator::MAX_BLOCK_SIZE + 1);
+}
+
+test_case("SlabPoolAllocator many allocations across magazine flushes") {
+	SlabPoolAllocator pool;
+	u64* blocks[1000];
+	for (usize i = 0; i < 1000; i++) {
+		blocks[i] = pool.mallocObject<u64>().ok();
+		*blocks[i] = i;
+	}
+	for (usize i = 0; i < 1000; i++) {
+		check_eq(*blocks[i], i);
+		pool.freeObject(blocks[i]);
+	}
+}
+
+test_case("SlabPoolAllocator ArrayList") {
+	SlabPoolAllocator pool;
+	auto a = ArrayList<int>::init(pool.toRef());
+	for (int i = 0; i < 2000; i++) {
+		a.push(i);
+	}
+	for (int i = 0; i < 2000; i++) {
+		check_eq(a[i], i);
+	}
+}
+
+namespace gk {
+	namespace unitTests {
+		static void slabPoolAllocateOnThread(SlabPoolAllocator* pool) {
+			for (int iteration = 0; iteration < 100; iteration++) {
+				auto a = ArrayList<u64>::init(pool->toRef());
+				for (u64 i = 0; i < 100; i++) {
+					a.push(i);
+				}
+				check_eq(a[99], 99);
+			}
+		}
+	}
+}
+
+test_case("SlabPoolAllocator thread cache is reused after thread local eviction") {
+	constexpr usize POOL_COUNT = 20;
+	SlabPoolAllocator pools[POOL_COUNT];
+	u64* blocks[POOL_COUNT];
+	for (int round = 0; round < 10; round++) {
+		for (usize i = 0; i < POOL_COUNT; i++) {
+			blocks[i] = pools[i].mallocObject<u64>().ok();
+			*blocks[i] = i;
+		}
+		for (usize i = 0; i < POOL_COUNT; i++) {
+			check_eq(*blocks[i], i);
+			pools[i].freeObject(blocks[i]);
+		}
+	}
+	for (usize i = 0; i < POOL_COUNT; i++) {
+		check_eq(pools[i].threadCacheCount(), 1);
+		check_eq(pools[i].slabCount(), 1);
+	}
+}
+
+test_case("SlabPoolAllocator multithreaded") {
+	SlabPoolAllocator pool;
+	gk::JobSystem jobSystem(4);
+	for (int i = 0; i < 8; i++) {
+		(void)jobSystem.runJob(gk::unitTests::slabPoolAllocateOnThread, &pool);
+	}
+	jobSystem.wait();
+	check(pool.threadCacheCount() <= 4);
+}
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "allocator.h"
+#include "../sync/mutex.h"
+#include <thread>
+
+namespace gk {
+	/// Pool allocator that serves small allocations out of fixed power-of-two size classes.
+	/// Is multithread safe.
+	///
+	/// Size classes range from `MIN_BLOCK_SIZE` to `MAX_BLOCK_SIZE` bytes, which covers the 64 byte aligned
+	/// buffers used by String heap buffers, HashMap groups, and JSON object buckets. Blocks are carved
+	/// out of page aligned slabs, so every block is aligned to its own size class. Allocations that are
+	/// larger than `MAX_BLOCK_SIZE`, or need a stricter alignment than their size class, go directly to `gk::malloc()`.
+	///
+	/// Because `freeImpl()` receives the original size and alignment, no per-block headers are stored.
+	///
+	/// Each thread keeps a small magazine of free blocks per size class. Allocating and freeing only
+	/// touches the shared per size class depot (behind a mutex) when a magazine runs empty or full,
+	/// moving half a magazine at a time.
+	///
+	/// Each thread owns at most one cache per allocator. If the per-thread lookup slot gets evicted because
+	/// the thread uses many allocators, the cache is found again by thread id rather than recreated.
+	///
+	/// Slab memory is only returned to the system when the allocator is destroyed. Blocks
+	/// that are still cached by a thread that has exited are reclaimed at that point too.
+	/// The allocator does not track references, so it must outlive all containers using it.
+	class SlabPoolAllocator : public gk::IAllocator {
+	public:
+
+		static constexpr usize MIN_BLOCK_SIZE = 16;
+		static constexpr usize MAX_BLOCK_SIZE = 4096;
+		static constexpr usize SIZE_CLASS_COUNT = 9; // 16, 32, 64, 128, 256, 512, 1024, 2048, 4096
+		static constexpr usize SLAB_SIZE = 64 * 1024;
+		static constexpr usize SLAB_ALIGNMENT = 4096;
+		static constexpr usize MAGAZINE_CAPACITY = 32;
+
+		SlabPoolAllocator();
+
+		SlabPoolAllocator(const SlabPoolAllocator&) = delete;
+		SlabPoolAllocator(SlabPoolAllocator&&) = delete;
+		SlabPoolAllocator& operator = (const SlabPoolAllocator&) = delete;
+		SlabPoolAllocator& operator = (SlabPoolAllocator&&) = delete;
+
+		virtual ~SlabPoolAllocator() noexcept(false) override;
+
+		/// @return The number of slabs allocated from the system across all size classes.
+		usize slabCount() const;
+
+		/// @return The number of per-thread caches, which is at most the number of threads that have used this allocator.
+		usize threadCacheCount() const;
+
+		/// Get the size class index that an allocation would be served from.
+		/// @param numBytes: Allocation size in bytes.
+		/// @param alignment: Allocation alignment.
+		/// @return The size class index, or None if the allocation is passed through to `gk::malloc()`.
+		static Option<usize> sizeClassIndex(usize numBytes, usize alignment);
+
+	private:
+
+		virtual Result<void*, AllocError> mallocImpl(usize numBytes, usize alignment) override;
+
+		virtual void freeImpl(void* buffer, usize numBytes, usize alignment) override;
+
+		virtual bool trackRefCount() const override { return false; }
+
+		struct FreeBlock {
+			FreeBlock* next;
+		};
+
+		struct Magazine {
+			void* blocks[MAGAZINE_CAPACITY];
+			usize count;
+		};
+
+		struct ThreadCache {
+			Magazine magazines[SIZE_CLASS_COUNT];
+			std::thread::id owner;
+			ThreadCache* next;
+		};
+
+		struct Slab {
+			Slab* next;
+			void* memory;
+		};
+
+		struct Depot {
+			RawMutex mutex;
+			FreeBlock* freeList = nullptr;
+			u8* bumpCurrent = nullptr;
+			u8* bumpEnd = nullptr;
+			Slab* slabs = nullptr;
+			usize slabCount = 0;
+		};
+
+		Result<ThreadCache*, AllocError> getThreadCache();
+
+		/// Moves up to `MAGAZINE_CAPACITY / 2` blocks from the depot into `magazine`.
+		Result<void, AllocError> refillMagazine(Magazine& magazine, usize sizeClass);
+
+		/// Moves `MAGAZINE_CAPACITY / 2` blocks from `magazine` into the depot.
+		void flushMagazine(Magazine& magazine, usize sizeClass);
+
+	private:
+
+		const u64 id;
+		mutable Depot depots[SIZE_CLASS_COUNT];
+		mutable RawMutex cachesMutex;
+		ThreadCache* caches;
+	};
+} // namespace gk
@@ -0,0 +1,406 @@
+#include "stats_allocator.h"
+#include "thread_local_registry.h"
+#include "../json/json_object.h"
+#include <bit>
+
+#if defined(_WIN32) || defined(WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+using gk::Result;
+using gk::AllocError;
+using gk::usize;
+using gk::u8;
+using gk::i64;
+using gk::AllocationStats;
+using gk::AllocationSample;
+
+gk::StatsAllocator::StatsAllocator(AllocatorRef&& inBacking, usize inStackSampleRate)
+	: id(internal::newThreadLocalOwnerId()), backingAllocator(std::move(inBacking)), stackSampleRate(inStackSampleRate),
+	counters(nullptr), sampleWriteIndex(0)
+{}
+
+gk::StatsAllocator::~StatsAllocator()
+{
+	ThreadCounters* threadCounters = this->counters;
+	while (threadCounters != nullptr) {
+		ThreadCounters* next = threadCounters->next;
+		threadCounters->~ThreadCounters();
+		gk::free(threadCounters, sizeof(ThreadCounters), alignof(ThreadCounters));
+		threadCounters = next;
+	}
+}
+
+AllocationStats gk::StatsAllocator::stats() const
+{
+	AllocationStats out{};
+	usize totalBytesFreed = 0;
+
+	countersMutex.lock();
+	const ThreadCounters* threadCounters = this->counters;
+	while (threadCounters != nullptr) {
+		out.totalAllocations += threadCounters->allocations.load(std::memory_order_relaxed);
+		out.totalFrees += threadCounters->frees.load(std::memory_order_relaxed);
+		out.totalBytesAllocated += threadCounters->bytesAllocated.load(std::memory_order_relaxed);
+		totalBytesFreed += threadCounters->bytesFreed.load(std::memory_order_relaxed);
+		out.peakBytes += threadCounters->peakBytes.load(std::memory_order_relaxed);
+		for (usize i = 0; i < AllocationStats::SIZE_BUCKET_COUNT; i++) {
+			out.sizeBuckets[i] += threadCounters->sizeBuckets[i].load(std::memory_order_relaxed);
+		}
+		for (usize i = 0; i < AllocationStats::ALIGNMENT_BUCKET_COUNT; i++) {
+			out.alignmentBuckets[i] += threadCounters->alignmentBuckets[i].load(std::memory_order_relaxed);
+		}
+		threadCounters = threadCounters->next;
+	}
+	countersMutex.unlock();
+
+	// Per-thread counters are read one after the other, so a concurrent free may be seen without it's allocation.
+	out.liveBytes = out.totalBytesAllocated > totalBytesFreed ? out.totalBytesAllocated - totalBytesFreed : 0;
+	if (out.peakBytes < out.liveBytes) {
+		out.peakBytes = out.liveBytes;
+	}
+	return out;
+}
+
+usize gk::StatsAllocator::threadCount() const
+{
+	usize count = 0;
+	countersMutex.lock();
+	for (const ThreadCounters* threadCounters = this->counters; threadCounters != nullptr; threadCounters = threadCounters->next) {
+		count++;
+	}
+	countersMutex.unlock();
+	return count;
+}
+
+gk::ArrayList<AllocationSample> gk::StatsAllocator::samples() const
+{
+	ArrayList<AllocationSample> out;
+
+	samplesMutex.lock();
+	const usize sampleCount = this->sampleBuffer.len();
+	if (sampleCount > 0) {
+		out.reserve(sampleCount);
+		// Once the ring buffer is full, the write index points at the oldest sample.
+		const usize oldest = sampleCount < MAX_SAMPLES ? 0 : this->sampleWriteIndex % MAX_SAMPLES;
+		for (usize i = 0; i < sampleCount; i++) {
+			out.push(this->sampleBuffer[(oldest + i) % sampleCount]);
+		}
+	}
+	samplesMutex.unlock();
+
+	return out;
+}
+
+gk::JsonObject gk::StatsAllocator::toJson() const
+{
+	const AllocationStats current = this->stats();
+
+	JsonObject out;
+	out.addField(String("liveBytes"_str), JsonValue::makeNumber(static_cast<double>(current.liveBytes)));
+	out.addField(String("peakBytes"_str), JsonValue::makeNumber(static_cast<double>(current.peakBytes)));
+	out.addField(String("totalAllocations"_str), JsonValue::makeNumber(static_cast<double>(current.totalAllocations)));
+	out.addField(String("totalFrees"_str), JsonValue::makeNumber(static_cast<double>(current.totalFrees)));
+	out.addField(String("totalBytesAllocated"_str), JsonValue::makeNumber(static_cast<double>(current.totalBytesAllocated)));
+
+	ArrayList<JsonValue> sizeBuckets;
+	for (usize i = 0; i < AllocationStats::SIZE_BUCKET_COUNT; i++) {
+		if (current.sizeBuckets[i] == 0) continue;
+
+		JsonObject bucket;
+		bucket.addField(String("maxBytes"_str), JsonValue::makeNumber(static_cast<double>(1ULL << i)));
+		bucket.addField(String("allocations"_str), JsonValue::makeNumber(static_cast<double>(current.sizeBuckets[i])));
+		sizeBuckets.push(JsonValue::makeObject(std::move(bucket)));
+	}
+	out.addField(String("sizeBuckets"_str), JsonValue::makeArray(std::move(sizeBuckets)));
+
+	ArrayList<JsonValue> alignmentBuckets;
+	for (usize i = 0; i < AllocationStats::ALIGNMENT_BUCKET_COUNT; i++) {
+		if (current.alignmentBuckets[i] == 0) continue;
+
+		JsonObject bucket;
+		bucket.addField(String("alignment"_str), JsonValue::makeNumber(static_cast<double>(1ULL << i)));
+		bucket.addField(String("allocations"_str), JsonValue::makeNumber(static_cast<double>(current.alignmentBuckets[i])));
+		alignmentBuckets.push(JsonValue::makeObject(std::move(bucket)));
+	}
+	out.addField(String("alignmentBuckets"_str), JsonValue::makeArray(std::move(alignmentBuckets)));
+
+	samplesMutex.lock();
+	const usize sampleCount = this->sampleBuffer.len();
+	samplesMutex.unlock();
+	out.addField(String("stackSamples"_str), JsonValue::makeNumber(static_cast<double>(sampleCount)));
+
+	return out;
+}
+
+usize gk::StatsAllocator::sizeBucketIndex(usize numBytes)
+{
+	const usize index = numBytes <= 1 ? 0 : static_cast<usize>(std::bit_width(numBytes - 1));
+	return index < AllocationStats::SIZE_BUCKET_COUNT ? index : AllocationStats::SIZE_BUCKET_COUNT - 1;
+}
+
+usize gk::StatsAllocator::alignmentBucketIndex(usize alignment)
+{
+	const usize index = static_cast<usize>(std::countr_zero(alignment));
+	return index < AllocationStats::ALIGNMENT_BUCKET_COUNT ? index : AllocationStats::ALIGNMENT_BUCKET_COUNT - 1;
+}
+
+Result<void*, AllocError> gk::StatsAllocator::mallocImpl(usize numBytes, usize alignment)
+{
+	Result<u8*, AllocError> result = this->backingAllocator.getAllocatorObject()->mallocAlignedBuffer<u8>(numBytes, alignment);
+	if (result.isError()) {
+		return ResultErr<AllocError>(result.error());
+	}
+
+	// Only this thread writes to its counters, so a load and store is enough, avoiding locked instructions.
+	ThreadCounters* threadCounters = getThreadCounters();
+	threadCounters->allocations.store(threadCounters->allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	const usize bytesAllocated = threadCounters->bytesAllocated.load(std::memory_order_relaxed) + numBytes;
+	threadCounters->bytesAllocated.store(bytesAllocated, std::memory_order_relaxed);
+	std::atomic<usize>& sizeBucket = threadCounters->sizeBuckets[sizeBucketIndex(numBytes)];
+	sizeBucket.store(sizeBucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	std::atomic<usize>& alignmentBucket = threadCounters->alignmentBuckets[alignmentBucketIndex(alignment)];
+	alignmentBucket.store(alignmentBucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	const i64 threadLiveBytes = static_cast<i64>(bytesAllocated - threadCounters->bytesFreed.load(std::memory_order_relaxed));
+	if (threadLiveBytes > static_cast<i64>(threadCounters->peakBytes.load(std::memory_order_relaxed))) {
+		threadCounters->peakBytes.store(static_cast<usize>(threadLiveBytes), std::memory_order_relaxed);
+	}
+
+	if (this->stackSampleRate != 0) {
+		threadCounters->allocationsUntilSample--;
+		if (threadCounters->allocationsUntilSample == 0) {
+			threadCounters->allocationsUntilSample = this->stackSampleRate;
+			captureSample(numBytes, alignment);
+		}
+	}
+
+	return ResultOk<void*>(result.okCopy());
+}
+
+void gk::StatsAllocator::freeImpl(void* buffer, usize numBytes, usize alignment)
+{
+	u8* bufferBytes = reinterpret_cast<u8*>(buffer);
+	this->backingAllocator.getAllocatorObject()->freeAlignedBuffer<u8>(bufferBytes, numBytes, alignment);
+
+	ThreadCounters* threadCounters = getThreadCounters();
+	threadCounters->frees.store(threadCounters->frees.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	threadCounters->bytesFreed.store(threadCounters->bytesFreed.load(std::memory_order_relaxed) + numBytes, std::memory_order_relaxed);
+}
+
+gk::StatsAllocator::ThreadCounters* gk::StatsAllocator::getThreadCounters()
+{
+	void* existing = internal::findThreadLocalData(this->id);
+	if (existing != nullptr) {
+		return reinterpret_cast<ThreadCounters*>(existing);
+	}
+
+	const std::thread::id thisThread = std::this_thread::get_id();
+
+	// The thread local slot may have been evicted by other allocators used on this thread,
+	// in which case this thread's counters already exist.
+	countersMutex.lock();
+	for (ThreadCounters* threadCounters = this->counters; threadCounters != nullptr; threadCounters = threadCounters->next) {
+		if (threadCounters->owner == thisThread) {
+			countersMutex.unlock();
+			internal::setThreadLocalData(this->id, threadCounters);
+			return threadCounters;
+		}
+	}
+	countersMutex.unlock();
+
+	// Owned by this allocator, so that counts from threads that have exited are still merged.
+	ThreadCounters* threadCounters = reinterpret_cast<ThreadCounters*>(gk::malloc(sizeof(ThreadCounters), alignof(ThreadCounters)).ok());
+	new (threadCounters) ThreadCounters(); // value initialized, so all counters start at 0
+	threadCounters->allocationsUntilSample = this->stackSampleRate;
+	threadCounters->owner = thisThread;
+
+	countersMutex.lock();
+	threadCounters->next = this->counters;
+	this->counters = threadCounters;
+	countersMutex.unlock();
+
+	internal::setThreadLocalData(this->id, threadCounters);
+	return threadCounters;
+}
+
+void gk::StatsAllocator::captureSample(usize numBytes, usize alignment)
+{
+	AllocationSample sample;
+	sample.numBytes = numBytes;
+	sample.alignment = alignment;
+#if defined(_WIN32) || defined(WIN32)
+	// Skip this function and mallocImpl.
+	sample.frameCount = static_cast<usize>(CaptureStackBackTrace(2, static_cast<DWORD>(AllocationSample::MAX_FRAMES), sample.frames, nullptr));
+#else
+	sample.frameCount = 0;
+#endif
+
+	samplesMutex.lock();
+	if (this->sampleBuffer.len() < MAX_SAMPLES) {
+		this->sampleBuffer.push(sample);
+	}
+	else {
+		this->sampleBuffer[this->sampleWriteIndex % MAX_SAMPLES] = sample;
+	}
+	this->sampleWriteIndex++;
+	samplesMutex.unlock();
+}
+
+#if GK_TYPES_LIB_TEST
+
+#include "../job/job_system.h"
+
+using gk::StatsAllocator;
+using gk::ArrayList;
+
+test_case("StatsAllocator bucket indices") {
+	check_eq(StatsAllocator::sizeBucketIndex(0), 0);
+	check_eq(StatsAllocator::sizeBucketIndex(1), 0);
+	check_eq(StatsAllocator::sizeBucketIndex(2), 1);
+	check_eq(StatsAllocator::sizeBucketIndex(3), 2);
+	check_eq(StatsAllocator::sizeBucketIndex(4), 2);
+	check_eq(StatsAllocator::sizeBucketIndex(64), 6);
+	check_eq(StatsAllocator::sizeBucketIndex(65), 7);
+	check_eq(StatsAllocator::alignmentBucketIndex(1), 0);
+	check_eq(StatsAllocator::alignmentBucketIndex(8), 3);
+	check_eq(StatsAllocator::alignmentBucketIndex(64), 6);
+	check_eq(StatsAllocator::alignmentBucketIndex(1ULL << 20), AllocationStats::ALIGNMENT_BUCKET_COUNT - 1);
+}
+
+test_case("StatsAllocator live and peak bytes") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef());
+	gk::u64* first = statsAllocator.mallocObject<gk::u64>().ok();
+	gk::u8* second = statsAllocator.mallocAlignedBuffer<gk::u8>(100, 64).ok();
+	{
+		const AllocationStats current = statsAllocator.stats();
+		check_eq(current.liveBytes, 108);
+		check_eq(current.peakBytes, 108);
+		check_eq(current.totalAllocations, 2);
+		check_eq(current.totalFrees, 0);
+		check_eq(current.sizeBuckets[StatsAllocator::sizeBucketIndex(8)], 1);
+		check_eq(current.sizeBuckets[StatsAllocator::sizeBucketIndex(100)], 1);
+		check_eq(current.alignmentBuckets[StatsAllocator::alignmentBucketIndex(64)], 1);
+	}
+	statsAllocator.freeAlignedBuffer(second, 100, 64);
+	statsAllocator.freeObject(first);
+	{
+		const AllocationStats current = statsAllocator.stats();
+		check_eq(current.liveBytes, 0);
+		check_eq(current.peakBytes, 108);
+		check_eq(current.totalFrees, 2);
+		check_eq(current.totalBytesAllocated, 108);
+	}
+}
+
+test_case("StatsAllocator peak bytes after frees") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef());
+	gk::u8* first = statsAllocator.mallocBuffer<gk::u8>(100).ok();
+	statsAllocator.freeBuffer(first, 100);
+	gk::u8* second = statsAllocator.mallocBuffer<gk::u8>(60).ok();
+	gk::u8* third = statsAllocator.mallocBuffer<gk::u8>(30).ok();
+	const AllocationStats current = statsAllocator.stats();
+	check_eq(current.liveBytes, 90);
+	check_eq(current.peakBytes, 100);
+	statsAllocator.freeBuffer(third, 30);
+	statsAllocator.freeBuffer(second, 60);
+	check_eq(statsAllocator.stats().liveBytes, 0);
+}
+
+test_case("StatsAllocator thread counters are reused after thread local eviction") {
+	constexpr usize ALLOCATOR_COUNT = 20;
+	ArrayList<StatsAllocator*> statsAllocators;
+	for (usize i = 0; i < ALLOCATOR_COUNT; i++) {
+		statsAllocators.push(new StatsAllocator(gk::globalHeapAllocatorRef()));
+	}
+	for (int round = 0; round < 10; round++) {
+		for (StatsAllocator* statsAllocator : statsAllocators) {
+			int* num = statsAllocator->mallocObject<int>().ok();
+			statsAllocator->freeObject(num);
+		}
+	}
+	for (StatsAllocator* statsAllocator : statsAllocators) {
+		check_eq(statsAllocator->threadCount(), 1);
+		const AllocationStats current = statsAllocator->stats();
+		check_eq(current.totalAllocations, 10);
+		check_eq(current.peakBytes, sizeof(int));
+		delete statsAllocator;
+	}
+}
+
+test_case("StatsAllocator ArrayList") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef());
+	{
+		auto a = ArrayList<int>::init(statsAllocator.toRef());
+		for (int i = 0; i < 1000; i++) {
+			a.push(i);
+		}
+		check_gt(statsAllocator.stats().liveBytes, 1000 * sizeof(int) - 1);
+	}
+	const AllocationStats current = statsAllocator.stats();
+	check_eq(current.liveBytes, 0);
+	check_eq(current.totalAllocations, current.totalFrees);
+}
+
+test_case("StatsAllocator stack samples") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef(), 2);
+	for (int i = 0; i < 10; i++) {
+		int* num = statsAllocator.mallocObject<int>().ok();
+		statsAllocator.freeObject(num);
+	}
+	ArrayList<AllocationSample> samples = statsAllocator.samples();
+	check_eq(samples.len(), 5);
+	check_eq(samples[0].numBytes, sizeof(int));
+}
+
+test_case("StatsAllocator sample ring buffer keeps newest") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef(), 1);
+	for (usize i = 1; i <= StatsAllocator::MAX_SAMPLES + 10; i++) {
+		gk::u8* buffer = statsAllocator.mallocBuffer<gk::u8>(i).ok();
+		statsAllocator.freeBuffer(buffer, i);
+	}
+	ArrayList<AllocationSample> samples = statsAllocator.samples();
+	check_eq(samples.len(), StatsAllocator::MAX_SAMPLES);
+	check_eq(samples[0].numBytes, 11);
+	check_eq(samples[StatsAllocator::MAX_SAMPLES - 1].numBytes, StatsAllocator::MAX_SAMPLES + 10);
+}
+
+test_case("StatsAllocator to json") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef());
+	int* num = statsAllocator.mallocObject<int>().ok();
+	gk::JsonObject json = statsAllocator.toJson();
+	check_eq(json.findField(gk::String("liveBytes"_str)).some()->numberValue(), 4.0);
+	check_eq(json.findField(gk::String("totalAllocations"_str)).some()->numberValue(), 1.0);
+	check_eq(json.findField(gk::String("sizeBuckets"_str)).some()->arrayValue().len(), 1);
+	statsAllocator.freeObject(num);
+}
+
+namespace gk {
+	namespace unitTests {
+		static void statsAllocateOnThread(StatsAllocator* statsAllocator) {
+			for (int i = 0; i < 100; i++) {
+				u64* num = statsAllocator->mallocObject<u64>().ok();
+				statsAllocator->freeObject(num);
+			}
+		}
+	}
+}
+
+test_case("StatsAllocator merges thread counters") {
+	StatsAllocator statsAllocator(gk::globalHeapAllocatorRef());
+	{
+		gk::JobSystem jobSystem(4);
+		for (int i = 0; i < 8; i++) {
+			(void)jobSystem.runJob(gk::unitTests::statsAllocateOnThread, &statsAllocator);
+		}
+		jobSystem.wait();
+	}
+	const AllocationStats current = statsAllocator.stats();
+	check_eq(current.totalAllocations, 800);
+	check_eq(current.totalFrees, 800);
+	check_eq(current.liveBytes, 0);
+}
+
+#endif
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "allocator.h"
+#include "../sync/mutex.h"
+#include "../array/array_list.h"
+#include <atomic>
+#include <thread>
+
+namespace gk {
+	struct JsonObject;
+
+	/// Snapshot of the allocation statistics recorded by a `StatsAllocator`.
+	struct AllocationStats {
+		/// Bucket `i` counts allocations of size in the range (2^(i-1), 2^i]. Bucket 0 is 0 or 1 bytes.
+		static constexpr usize SIZE_BUCKET_COUNT = 48;
+		/// Bucket `i` counts allocations with an alignment of 2^i. The last bucket also holds anything larger.
+		static constexpr usize ALIGNMENT_BUCKET_COUNT = 16;
+
+		usize liveBytes;
+		/// Exact when only one thread uses the allocator. Otherwise it's the sum of every thread's own peak,
+		/// which is an upper bound of the real peak, as threads may not peak at the same time.
+		usize peakBytes;
+		usize totalAllocations;
+		usize totalFrees;
+		usize totalBytesAllocated;
+		usize sizeBuckets[SIZE_BUCKET_COUNT];
+		usize alignmentBuckets[ALIGNMENT_BUCKET_COUNT];
+	};
+
+	/// Stack trace captured from a sampled allocation.
+	struct AllocationSample {
+		static constexpr usize MAX_FRAMES = 16;
+
+		usize numBytes;
+		usize alignment;
+		usize frameCount;
+		void* frames[MAX_FRAMES];
+	};
+
+	/// Allocator decorator recording statistics about every allocation forwarded to a backing allocator.
+	/// Is multithread safe.
+	///
+	/// All counts, including live and peak bytes, are kept in per-thread counters that only the owning
+	/// thread writes to, and are merged when read through `stats()`. As such, the peak bytes of an allocator
+	/// used by multiple threads are approximate. See `AllocationStats::peakBytes`.
+	///
+	/// Optionally, one in every `stackSampleRate` allocations per thread has its stack trace
+	/// captured into a bounded ring buffer, readable through `samples()`. Stack capture
+	/// is only supported on Windows. On other platforms, samples have no frames.
+	///
+	/// The allocator does not track references, so it must outlive all containers using it.
+	class StatsAllocator : public gk::IAllocator {
+	public:
+
+		static constexpr usize MAX_SAMPLES = 1024;
+
+		/// @param inBacking: Allocator that the actual allocations are forwarded to.
+		/// @param inStackSampleRate: Capture the stack trace of one in every N allocations per thread. 0 disables sampling.
+		StatsAllocator(AllocatorRef&& inBacking, usize inStackSampleRate = 0);
+
+		StatsAllocator(const StatsAllocator&) = delete;
+		StatsAllocator(StatsAllocator&&) = delete;
+		StatsAllocator& operator = (const StatsAllocator&) = delete;
+		StatsAllocator& operator = (StatsAllocator&&) = delete;
+
+		virtual ~StatsAllocator() noexcept(false) override;
+
+		/// Merges every thread's counters. Counters from threads that are concurrently allocating
+		/// may be slightly out of date.
+		/// @return Snapshot of the current statistics.
+		AllocationStats stats() const;
+
+		/// @return The number of threads that have allocated or freed through this allocator.
+		usize threadCount() const;
+
+		/// @return Copy of the captured stack samples, oldest first.
+		ArrayList<AllocationSample> samples() const;
+
+		/// Serializes the current statistics. Only non-empty buckets are included.
+		/// Stack samples are not included, as their addresses are meaningless outside of this process.
+		/// @return Json object of the statistics from `stats()`.
+		JsonObject toJson() const;
+
+		/// @return The allocator that allocations are forwarded to.
+		const AllocatorRef& backing() const { return this->backingAllocator; }
+
+		/// @return Index into `AllocationStats::sizeBuckets` for an allocation of `numBytes`.
+		static usize sizeBucketIndex(usize numBytes);
+
+		/// @return Index into `AllocationStats::alignmentBuckets` for an allocation of `alignment`.
+		static usize alignmentBucketIndex(usize alignment);
+
+	private:
+
+		virtual Result<void*, AllocError> mallocImpl(usize numBytes, usize alignment) override;
+
+		virtual void freeImpl(void* buffer, usize numBytes, usize alignment) override;
+
+		virtual bool trackRefCount() const override { return false; }
+
+		struct ThreadCounters {
+			std::atomic<usize> allocations;
+			std::atomic<usize> frees;
+			std::atomic<usize> bytesAllocated;
+			std::atomic<usize> bytesFreed;
+			/// Highest `bytesAllocated - bytesFreed` of this thread. Memory freed by a thread other than
+			/// the one that allocated it makes the difference drop below 0 on the freeing thread.
+			std::atomic<usize> peakBytes;
+			std::atomic<usize> sizeBuckets[AllocationStats::SIZE_BUCKET_COUNT];
+			std::atomic<usize> alignmentBuckets[AllocationStats::ALIGNMENT_BUCKET_COUNT];
+			/// Only accessed by the owning thread.
+			usize allocationsUntilSample;
+			std::thread::id owner;
+			ThreadCounters* next;
+		};
+
+		ThreadCounters* getThreadCounters();
+
+		void captureSample(usize numBytes, usize alignment);
+
+	private:
+
+		const u64 id;
+		AllocatorRef backingAllocator;
+		const usize stackSampleRate;
+		mutable RawMutex countersMutex;
+		ThreadCounters* counters;
+		mutable RawMutex samplesMutex;
+		ArrayList<AllocationSample> sampleBuffer;
+		usize sampleWriteIndex;
+	};
+} // namespace gk
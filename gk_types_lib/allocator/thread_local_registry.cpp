@@ -0,0 +1,69 @@
+#include "thread_local_registry.h"
+#include <atomic>
+
+using gk::u64;
+using gk::usize;
+
+namespace {
+	struct ThreadLocalSlot {
+		u64 ownerId;
+		void* data;
+	};
+
+	constexpr usize THREAD_LOCAL_SLOT_COUNT = 8;
+
+	thread_local ThreadLocalSlot threadLocalSlots[THREAD_LOCAL_SLOT_COUNT] = {};
+	thread_local usize threadLocalNextSlot = 0;
+
+	std::atomic<u64> threadLocalOwnerIdCounter = 1;
+}
+
+u64 gk::internal::newThreadLocalOwnerId()
+{
+	return threadLocalOwnerIdCounter.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* gk::internal::findThreadLocalData(u64 ownerId)
+{
+	for (usize i = 0; i < THREAD_LOCAL_SLOT_COUNT; i++) {
+		if (threadLocalSlots[i].ownerId == ownerId) {
+			return threadLocalSlots[i].data;
+		}
+	}
+	return nullptr;
+}
+
+void gk::internal::setThreadLocalData(u64 ownerId, void* data)
+{
+	for (usize i = 0; i < THREAD_LOCAL_SLOT_COUNT; i++) {
+		if (threadLocalSlots[i].ownerId == ownerId) {
+			threadLocalSlots[i].data = data;
+			return;
+		}
+	}
+
+	ThreadLocalSlot& slot = threadLocalSlots[threadLocalNextSlot];
+	slot.ownerId = ownerId;
+	slot.data = data;
+	threadLocalNextSlot = (threadLocalNextSlot + 1) % THREAD_LOCAL_SLOT_COUNT;
+}
+
+#if GK_TYPES_LIB_TEST
+
+#include "../doctest/doctest_proxy.h"
+
+test_case("ThreadLocalRegistry owner ids are unique") {
+	const u64 first = gk::internal::newThreadLocalOwnerId();
+	const u64 second = gk::internal::newThreadLocalOwnerId();
+	check_ne(first, second);
+}
+
+test_case("ThreadLocalRegistry set and find") {
+	const u64 owner = gk::internal::newThreadLocalOwnerId();
+	int data = 5;
+	check_eq(gk::internal::findThreadLocalData(owner), nullptr);
+	gk::internal::setThreadLocalData(owner, &data);
+	check_eq(gk::internal::findThreadLocalData(owner), &data);
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "../basic_types.h"
+
+namespace gk
+{
+	namespace internal
+	{
+		/// Get a new unique id for an object that stores per-thread data through `findThreadLocalData()`
+		/// and `setThreadLocalData()`. Ids are never reused, so data belonging to a destroyed
+		/// object will never be returned for a new object at the same address.
+		u64 newThreadLocalOwnerId();
+
+		/// @param ownerId: Id from `newThreadLocalOwnerId()`.
+		/// @return The calling thread's data for `ownerId`, or nullptr if none was set, or it was evicted.
+		void* findThreadLocalData(u64 ownerId);
+
+		/// Sets the calling thread's data for `ownerId`. Each thread has a small fixed number of slots,
+		/// so the oldest entry is evicted once they are all used. The caller owns `data`,
+		/// as threads do not free anything on exit or eviction.
+		/// @param ownerId: Id from `newThreadLocalOwnerId()`.
+		/// @param data: Per-thread data.
+		void setThreadLocalData(u64 ownerId, void* data);
+	}
+}
@@ -0,0 +1,1118 @@
+#include "array_algorithms.h"
+#include "../cpu_features/cpu_feature_detector.h"
+#include <intrin.h>
+#include <bit>
+
+template<typename T>
+using Option = gk::Option<T>;
+using gk::ArrayCompare;
+using gk::usize;
+using gk::i8;
+using gk::i16;
+using gk::i32;
+using gk::i64;
+using gk::u8;
+using gk::u16;
+using gk::u32;
+using gk::u64;
+using gk::internal::ArraySumT;
+
+namespace
+{
+	template<ArrayCompare C>
+	consteval int intCompareImm() {
+		switch (C) {
+		case ArrayCompare::Equal:
+			return _MM_CMPINT_EQ;
+		case ArrayCompare::NotEqual:
+			return _MM_CMPINT_NE;
+		case ArrayCompare::Less:
+			return _MM_CMPINT_LT;
+		case ArrayCompare::LessEqual:
+			return _MM_CMPINT_LE;
+		case ArrayCompare::Greater:
+			return _MM_CMPINT_NLE;
+		default:
+			return _MM_CMPINT_NLT;
+		}
+	}
+
+	/// Ordered comparisons, except NotEqual, to match the C++ operators with NaN.
+	template<ArrayCompare C>
+	consteval int floatCompareImm() {
+		switch (C) {
+		case ArrayCompare::Equal:
+			return _CMP_EQ_OQ;
+		case ArrayCompare::NotEqual:
+			return _CMP_NEQ_UQ;
+		case ArrayCompare::Less:
+			return _CMP_LT_OQ;
+		case ArrayCompare::LessEqual:
+			return _CMP_LE_OQ;
+		case ArrayCompare::Greater:
+			return _CMP_GT_OQ;
+		default:
+			return _CMP_GE_OQ;
+		}
+	}
+
+	/**
+	* AVX-512 operations for integer types. Compare masks have 1 bit per element.
+	*/
+	template<typename T>
+	struct Avx512Ops
+	{
+		using Vec = __m512i;
+		constexpr static usize LANES = 64 / sizeof(T);
+		constexpr static u32 BITS_PER_LANE = 1;
+
+		static Vec load(const T* data) { return _mm512_loadu_si512(data); }
+
+		static void store(T* out, Vec vec) { _mm512_storeu_si512(out, vec); }
+
+		static Vec set1(T value) {
+			if constexpr (sizeof(T) == 1) return _mm512_set1_epi8(static_cast<char>(value));
+			else if constexpr (sizeof(T) == 2) return _mm512_set1_epi16(static_cast<short>(value));
+			else if constexpr (sizeof(T) == 4) return _mm512_set1_epi32(static_cast<int>(value));
+			else return _mm512_set1_epi64(static_cast<long long>(value));
+		}
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			constexpr int IMM = intCompareImm<C>();
+			if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm512_cmp_epi8_mask(a, b, IMM);
+				else if constexpr (sizeof(T) == 2) return _mm512_cmp_epi16_mask(a, b, IMM);
+				else if constexpr (sizeof(T) == 4) return _mm512_cmp_epi32_mask(a, b, IMM);
+				else return _mm512_cmp_epi64_mask(a, b, IMM);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm512_cmp_epu8_mask(a, b, IMM);
+				else if constexpr (sizeof(T) == 2) return _mm512_cmp_epu16_mask(a, b, IMM);
+				else if constexpr (sizeof(T) == 4) return _mm512_cmp_epu32_mask(a, b, IMM);
+				else return _mm512_cmp_epu64_mask(a, b, IMM);
+			}
+		}
+
+		static Vec min(Vec a, Vec b) {
+			if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm512_min_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm512_min_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_min_epi32(a, b);
+				else return _mm512_min_epi64(a, b);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm512_min_epu8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm512_min_epu16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_min_epu32(a, b);
+				else return _mm512_min_epu64(a, b);
+			}
+		}
+
+		static Vec max(Vec a, Vec b) {
+			if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm512_max_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm512_max_epi16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_max_epi32(a, b);
+				else return _mm512_max_epi64(a, b);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm512_max_epu8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm512_max_epu16(a, b);
+				else if constexpr (sizeof(T) == 4) return _mm512_max_epu32(a, b);
+				else return _mm512_max_epu64(a, b);
+			}
+		}
+	};
+
+	template<>
+	struct Avx512Ops<float>
+	{
+		using Vec = __m512;
+		constexpr static usize LANES = 16;
+		constexpr static u32 BITS_PER_LANE = 1;
+
+		static Vec load(const float* data) { return _mm512_loadu_ps(data); }
+		static void store(float* out, Vec vec) { _mm512_storeu_ps(out, vec); }
+		static Vec set1(float value) { return _mm512_set1_ps(value); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, floatCompareImm<C>()); }
+
+		static Vec min(Vec a, Vec b) { return _mm512_min_ps(a, b); }
+		static Vec max(Vec a, Vec b) { return _mm512_max_ps(a, b); }
+	};
+
+	template<>
+	struct Avx512Ops<double>
+	{
+		using Vec = __m512d;
+		constexpr static usize LANES = 8;
+		constexpr static u32 BITS_PER_LANE = 1;
+
+		static Vec load(const double* data) { return _mm512_loadu_pd(data); }
+		static void store(double* out, Vec vec) { _mm512_storeu_pd(out, vec); }
+		static Vec set1(double value) { return _mm512_set1_pd(value); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, floatCompareImm<C>()); }
+
+		static Vec min(Vec a, Vec b) { return _mm512_min_pd(a, b); }
+		static Vec max(Vec a, Vec b) { return _mm512_max_pd(a, b); }
+	};
+
+	/**
+	* AVX-2 operations for integer types. AVX-2 has no mask registers, so compare masks come from
+	* movemask, which has 1 bit per byte, meaning `sizeof(T)` bits per element.
+	* AVX-2 only has signed greater than comparisons. Unsigned comparisons flip the sign bit of both sides first.
+	*/
+	template<typename T>
+	struct Avx2Ops
+	{
+		using Vec = __m256i;
+		constexpr static usize LANES = 32 / sizeof(T);
+		constexpr static u32 BITS_PER_LANE = sizeof(T);
+		constexpr static u64 FULL_MASK = 0xFFFFFFFFULL;
+
+		static Vec load(const T* data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data)); }
+
+		static void store(T* out, Vec vec) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), vec); }
+
+		static Vec set1(T value) {
+			if constexpr (sizeof(T) == 1) return _mm256_set1_epi8(static_cast<char>(value));
+			else if constexpr (sizeof(T) == 2) return _mm256_set1_epi16(static_cast<short>(value));
+			else if constexpr (sizeof(T) == 4) return _mm256_set1_epi32(static_cast<int>(value));
+			else return _mm256_set1_epi64x(static_cast<long long>(value));
+		}
+
+		static Vec equal(Vec a, Vec b) {
+			if constexpr (sizeof(T) == 1) return _mm256_cmpeq_epi8(a, b);
+			else if constexpr (sizeof(T) == 2) return _mm256_cmpeq_epi16(a, b);
+			else if constexpr (sizeof(T) == 4) return _mm256_cmpeq_epi32(a, b);
+			else return _mm256_cmpeq_epi64(a, b);
+		}
+
+		static Vec greater(Vec a, Vec b) {
+			if constexpr (!std::is_signed_v<T>) {
+				const Vec signBit = set1(static_cast<T>(T(1) << (sizeof(T) * 8 - 1)));
+				a = _mm256_xor_si256(a, signBit);
+				b = _mm256_xor_si256(b, signBit);
+			}
+			if constexpr (sizeof(T) == 1) return _mm256_cmpgt_epi8(a, b);
+			else if constexpr (sizeof(T) == 2) return _mm256_cmpgt_epi16(a, b);
+			else if constexpr (sizeof(T) == 4) return _mm256_cmpgt_epi32(a, b);
+			else return _mm256_cmpgt_epi64(a, b);
+		}
+
+		static u64 movemask(Vec vec) { return static_cast<u32>(_mm256_movemask_epi8(vec)); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			if constexpr (C == ArrayCompare::Equal) return movemask(equal(a, b));
+			else if constexpr (C == ArrayCompare::NotEqual) return ~movemask(equal(a, b)) & FULL_MASK;
+			else if constexpr (C == ArrayCompare::Less) return movemask(greater(b, a));
+			else if constexpr (C == ArrayCompare::LessEqual) return ~movemask(greater(a, b)) & FULL_MASK;
+			else if constexpr (C == ArrayCompare::Greater) return movemask(greater(a, b));
+			else return ~movemask(greater(b, a)) & FULL_MASK;
+		}
+
+		static Vec min(Vec a, Vec b) {
+			if constexpr (sizeof(T) == 8) return _mm256_blendv_epi8(a, b, greater(a, b));
+			else if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm256_min_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_min_epi16(a, b);
+				else return _mm256_min_epi32(a, b);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm256_min_epu8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_min_epu16(a, b);
+				else return _mm256_min_epu32(a, b);
+			}
+		}
+
+		static Vec max(Vec a, Vec b) {
+			if constexpr (sizeof(T) == 8) return _mm256_blendv_epi8(b, a, greater(a, b));
+			else if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm256_max_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_max_epi16(a, b);
+				else return _mm256_max_epi32(a, b);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm256_max_epu8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm256_max_epu16(a, b);
+				else return _mm256_max_epu32(a, b);
+			}
+		}
+	};
+
+	template<>
+	struct Avx2Ops<float>
+	{
+		using Vec = __m256;
+		constexpr static usize LANES = 8;
+		constexpr static u32 BITS_PER_LANE = sizeof(float);
+
+		static Vec load(const float* data) { return _mm256_loadu_ps(data); }
+		static void store(float* out, Vec vec) { _mm256_storeu_ps(out, vec); }
+		static Vec set1(float value) { return _mm256_set1_ps(value); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			return static_cast<u32>(_mm256_movemask_epi8(_mm256_castps_si256(_mm256_cmp_ps(a, b, floatCompareImm<C>()))));
+		}
+
+		static Vec min(Vec a, Vec b) { return _mm256_min_ps(a, b); }
+		static Vec max(Vec a, Vec b) { return _mm256_max_ps(a, b); }
+	};
+
+	template<>
+	struct Avx2Ops<double>
+	{
+		using Vec = __m256d;
+		constexpr static usize LANES = 4;
+		constexpr static u32 BITS_PER_LANE = sizeof(double);
+
+		static Vec load(const double* data) { return _mm256_loadu_pd(data); }
+		static void store(double* out, Vec vec) { _mm256_storeu_pd(out, vec); }
+		static Vec set1(double value) { return _mm256_set1_pd(value); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			return static_cast<u32>(_mm256_movemask_epi8(_mm256_castpd_si256(_mm256_cmp_pd(a, b, floatCompareImm<C>()))));
+		}
+
+		static Vec min(Vec a, Vec b) { return _mm256_min_pd(a, b); }
+		static Vec max(Vec a, Vec b) { return _mm256_max_pd(a, b); }
+	};
+
+	/**
+	* SSE4.2 operations, mirroring `Avx2Ops` with 128 bit vectors. Requires SSE4.1 for the 64 bit equality
+	* comparison and most of the min and max instructions, and SSE4.2 for the 64 bit greater than comparison.
+	*/
+	template<typename T>
+	struct Sse42Ops
+	{
+		using Vec = __m128i;
+		constexpr static usize LANES = 16 / sizeof(T);
+		constexpr static u32 BITS_PER_LANE = sizeof(T);
+		constexpr static u64 FULL_MASK = 0xFFFFULL;
+
+		static Vec load(const T* data) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+
+		static void store(T* out, Vec vec) { _mm_storeu_si128(reinterpret_cast<__m128i*>(out), vec); }
+
+		static Vec set1(T value) {
+			if constexpr (sizeof(T) == 1) return _mm_set1_epi8(static_cast<char>(value));
+			else if constexpr (sizeof(T) == 2) return _mm_set1_epi16(static_cast<short>(value));
+			else if constexpr (sizeof(T) == 4) return _mm_set1_epi32(static_cast<int>(value));
+			else return _mm_set1_epi64x(static_cast<long long>(value));
+		}
+
+		static Vec equal(Vec a, Vec b) {
+			if constexpr (sizeof(T) == 1) return _mm_cmpeq_epi8(a, b);
+			else if constexpr (sizeof(T) == 2) return _mm_cmpeq_epi16(a, b);
+			else if constexpr (sizeof(T) == 4) return _mm_cmpeq_epi32(a, b);
+			else return _mm_cmpeq_epi64(a, b);
+		}
+
+		static Vec greater(Vec a, Vec b) {
+			if constexpr (!std::is_signed_v<T>) {
+				const Vec signBit = set1(static_cast<T>(T(1) << (sizeof(T) * 8 - 1)));
+				a = _mm_xor_si128(a, signBit);
+				b = _mm_xor_si128(b, signBit);
+			}
+			if constexpr (sizeof(T) == 1) return _mm_cmpgt_epi8(a, b);
+			else if constexpr (sizeof(T) == 2) return _mm_cmpgt_epi16(a, b);
+			else if constexpr (sizeof(T) == 4) return _mm_cmpgt_epi32(a, b);
+			else return _mm_cmpgt_epi64(a, b);
+		}
+
+		static u64 movemask(Vec vec) { return static_cast<u32>(_mm_movemask_epi8(vec)); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			if constexpr (C == ArrayCompare::Equal) return movemask(equal(a, b));
+			else if constexpr (C == ArrayCompare::NotEqual) return ~movemask(equal(a, b)) & FULL_MASK;
+			else if constexpr (C == ArrayCompare::Less) return movemask(greater(b, a));
+			else if constexpr (C == ArrayCompare::LessEqual) return ~movemask(greater(a, b)) & FULL_MASK;
+			else if constexpr (C == ArrayCompare::Greater) return movemask(greater(a, b));
+			else return ~movemask(greater(b, a)) & FULL_MASK;
+		}
+
+		static Vec min(Vec a, Vec b) {
+			if constexpr (sizeof(T) == 8) return _mm_blendv_epi8(a, b, greater(a, b));
+			else if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm_min_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_min_epi16(a, b);
+				else return _mm_min_epi32(a, b);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm_min_epu8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_min_epu16(a, b);
+				else return _mm_min_epu32(a, b);
+			}
+		}
+
+		static Vec max(Vec a, Vec b) {
+			if constexpr (sizeof(T) == 8) return _mm_blendv_epi8(b, a, greater(a, b));
+			else if constexpr (std::is_signed_v<T>) {
+				if constexpr (sizeof(T) == 1) return _mm_max_epi8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_max_epi16(a, b);
+				else return _mm_max_epi32(a, b);
+			}
+			else {
+				if constexpr (sizeof(T) == 1) return _mm_max_epu8(a, b);
+				else if constexpr (sizeof(T) == 2) return _mm_max_epu16(a, b);
+				else return _mm_max_epu32(a, b);
+			}
+		}
+	};
+
+	template<ArrayCompare C>
+	__m128 sse42CompareFloat(__m128 a, __m128 b) {
+		if constexpr (C == ArrayCompare::Equal) return _mm_cmpeq_ps(a, b);
+		else if constexpr (C == ArrayCompare::NotEqual) return _mm_cmpneq_ps(a, b);
+		else if constexpr (C == ArrayCompare::Less) return _mm_cmplt_ps(a, b);
+		else if constexpr (C == ArrayCompare::LessEqual) return _mm_cmple_ps(a, b);
+		else if constexpr (C == ArrayCompare::Greater) return _mm_cmpgt_ps(a, b);
+		else return _mm_cmpge_ps(a, b);
+	}
+
+	template<ArrayCompare C>
+	__m128d sse42CompareDouble(__m128d a, __m128d b) {
+		if constexpr (C == ArrayCompare::Equal) return _mm_cmpeq_pd(a, b);
+		else if constexpr (C == ArrayCompare::NotEqual) return _mm_cmpneq_pd(a, b);
+		else if constexpr (C == ArrayCompare::Less) return _mm_cmplt_pd(a, b);
+		else if constexpr (C == ArrayCompare::LessEqual) return _mm_cmple_pd(a, b);
+		else if constexpr (C == ArrayCompare::Greater) return _mm_cmpgt_pd(a, b);
+		else return _mm_cmpge_pd(a, b);
+	}
+
+	template<>
+	struct Sse42Ops<float>
+	{
+		using Vec = __m128;
+		constexpr static usize LANES = 4;
+		constexpr static u32 BITS_PER_LANE = sizeof(float);
+
+		static Vec load(const float* data) { return _mm_loadu_ps(data); }
+		static void store(float* out, Vec vec) { _mm_storeu_ps(out, vec); }
+		static Vec set1(float value) { return _mm_set1_ps(value); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			return static_cast<u32>(_mm_movemask_epi8(_mm_castps_si128(sse42CompareFloat<C>(a, b))));
+		}
+
+		static Vec min(Vec a, Vec b) { return _mm_min_ps(a, b); }
+		static Vec max(Vec a, Vec b) { return _mm_max_ps(a, b); }
+	};
+
+	template<>
+	struct Sse42Ops<double>
+	{
+		using Vec = __m128d;
+		constexpr static usize LANES = 2;
+		constexpr static u32 BITS_PER_LANE = sizeof(double);
+
+		static Vec load(const double* data) { return _mm_loadu_pd(data); }
+		static void store(double* out, Vec vec) { _mm_storeu_pd(out, vec); }
+		static Vec set1(double value) { return _mm_set1_pd(value); }
+
+		template<ArrayCompare C>
+		static u64 compare(Vec a, Vec b) {
+			return static_cast<u32>(_mm_movemask_epi8(_mm_castpd_si128(sse42CompareDouble<C>(a, b))));
+		}
+
+		static Vec min(Vec a, Vec b) { return _mm_min_pd(a, b); }
+		static Vec max(Vec a, Vec b) { return _mm_max_pd(a, b); }
+	};
+
+	Option<usize> offsetIndex(Option<usize>&& index, usize offset) {
+		if (index.none()) {
+			return Option<usize>();
+		}
+		return Option<usize>(index.someCopy() + offset);
+	}
+
+	// Generic kernels. Whole vectors are processed with `Ops`, and the remaining tail uses the scalar implementation.
+	// Unaligned loads are used so the kernels work on any buffer, which only needs to be aligned to `T`.
+
+	template<typename Ops, ArrayCompare C, typename T>
+	Option<usize> findIfKernel(const T* data, usize length, T value) {
+		const usize vecEnd = length - (length % Ops::LANES);
+		const auto valueVec = Ops::set1(value);
+		for (usize i = 0; i < vecEnd; i += Ops::LANES) {
+			const u64 mask = Ops::template compare<C>(Ops::load(data + i), valueVec);
+			if (mask != 0) {
+				return Option<usize>(i + (std::countr_zero(mask) / Ops::BITS_PER_LANE));
+			}
+		}
+		return offsetIndex(gk::internal::scalarArrayFindIf(data + vecEnd, length - vecEnd, C, value), vecEnd);
+	}
+
+	template<typename Ops, typename T>
+	Option<usize> findIfImpl(const T* data, usize length, ArrayCompare compare, T value) {
+		switch (compare) {
+		case ArrayCompare::Equal:
+			return findIfKernel<Ops, ArrayCompare::Equal>(data, length, value);
+		case ArrayCompare::NotEqual:
+			return findIfKernel<Ops, ArrayCompare::NotEqual>(data, length, value);
+		case ArrayCompare::Less:
+			return findIfKernel<Ops, ArrayCompare::Less>(data, length, value);
+		case ArrayCompare::LessEqual:
+			return findIfKernel<Ops, ArrayCompare::LessEqual>(data, length, value);
+		case ArrayCompare::Greater:
+			return findIfKernel<Ops, ArrayCompare::Greater>(data, length, value);
+		default:
+			return findIfKernel<Ops, ArrayCompare::GreaterEqual>(data, length, value);
+		}
+	}
+
+	template<typename Ops, typename T>
+	Option<usize> findInRangeImpl(const T* data, usize length, T low, T high) {
+		const usize vecEnd = length - (length % Ops::LANES);
+		const auto lowVec = Ops::set1(low);
+		const auto highVec = Ops::set1(high);
+		for (usize i = 0; i < vecEnd; i += Ops::LANES) {
+			const auto elements = Ops::load(data + i);
+			const u64 mask = Ops::template compare<ArrayCompare::GreaterEqual>(elements, lowVec)
+				& Ops::template compare<ArrayCompare::LessEqual>(elements, highVec);
+			if (mask != 0) {
+				return Option<usize>(i + (std::countr_zero(mask) / Ops::BITS_PER_LANE));
+			}
+		}
+		return offsetIndex(gk::internal::scalarArrayFindInRange(data + vecEnd, length - vecEnd, low, high), vecEnd);
+	}
+
+	template<typename Ops, typename T>
+	Option<usize> findLastImpl(const T* data, usize length, T value) {
+		const usize vecEnd = length - (length % Ops::LANES);
+		Option<usize> tailIndex = gk::internal::scalarArrayFindLast(data + vecEnd, length - vecEnd, value);
+		if (tailIndex.isSome()) {
+			return Option<usize>(tailIndex.someCopy() + vecEnd);
+		}
+
+		const auto valueVec = Ops::set1(value);
+		usize i = vecEnd;
+		while (i > 0) {
+			i -= Ops::LANES;
+			const u64 mask = Ops::template compare<ArrayCompare::Equal>(Ops::load(data + i), valueVec);
+			if (mask != 0) {
+				const usize highestBit = 63 - std::countl_zero(mask);
+				return Option<usize>(i + (highestBit / Ops::BITS_PER_LANE));
+			}
+		}
+		return Option<usize>();
+	}
+
+	template<typename Ops, ArrayCompare C, typename T>
+	usize countIfKernel(const T* data, usize length, T value) {
+		const usize vecEnd = length - (length % Ops::LANES);
+		const auto valueVec = Ops::set1(value);
+		usize bitCount = 0;
+		for (usize i = 0; i < vecEnd; i += Ops::LANES) {
+			bitCount += std::popcount(Ops::template compare<C>(Ops::load(data + i), valueVec));
+		}
+		return (bitCount / Ops::BITS_PER_LANE) + gk::internal::scalarArrayCountIf(data + vecEnd, length - vecEnd, C, value);
+	}
+
+	template<typename Ops, typename T>
+	usize countIfImpl(const T* data, usize length, ArrayCompare compare, T value) {
+		switch (compare) {
+		case ArrayCompare::Equal:
+			return countIfKernel<Ops, ArrayCompare::Equal>(data, length, value);
+		case ArrayCompare::NotEqual:
+			return countIfKernel<Ops, ArrayCompare::NotEqual>(data, length, value);
+		case ArrayCompare::Less:
+			return countIfKernel<Ops, ArrayCompare::Less>(data, length, value);
+		case ArrayCompare::LessEqual:
+			return countIfKernel<Ops, ArrayCompare::LessEqual>(data, length, value);
+		case ArrayCompare::Greater:
+			return countIfKernel<Ops, ArrayCompare::Greater>(data, length, value);
+		default:
+			return countIfKernel<Ops, ArrayCompare::GreaterEqual>(data, length, value);
+		}
+	}
+
+	template<typename Ops, typename T>
+	Option<usize> findAnyOfImpl(const T* data, usize length, const T* values, usize valuesLength) {
+		const usize vecEnd = length - (length % Ops::LANES);
+		for (usize i = 0; i < vecEnd; i += Ops::LANES) {
+			const auto elements = Ops::load(data + i);
+			u64 mask = 0;
+			for (usize j = 0; j < valuesLength; j++) {
+				mask |= Ops::template compare<ArrayCompare::Equal>(elements, Ops::set1(values[j]));
+			}
+			if (mask != 0) {
+				return Option<usize>(i + (std::countr_zero(mask) / Ops::BITS_PER_LANE));
+			}
+		}
+		return offsetIndex(gk::internal::scalarArrayFindAnyOf(data + vecEnd, length - vecEnd, values, valuesLength), vecEnd);
+	}
+
+	template<typename Ops, typename T>
+	T minImpl(const T* data, usize length) {
+		if (length < Ops::LANES) {
+			return gk::internal::scalarArrayMin(data, length);
+		}
+
+		const usize vecEnd = length - (length % Ops::LANES);
+		auto minVec = Ops::load(data);
+		for (usize i = Ops::LANES; i < vecEnd; i += Ops::LANES) {
+			minVec = Ops::min(minVec, Ops::load(data + i));
+		}
+
+		T lanes[Ops::LANES];
+		Ops::store(lanes, minVec);
+		T out = gk::internal::scalarArrayMin(lanes, Ops::LANES);
+		for (usize i = vecEnd; i < length; i++) {
+			if (data[i] < out) {
+				out = data[i];
+			}
+		}
+		return out;
+	}
+
+	template<typename Ops, typename T>
+	T maxImpl(const T* data, usize length) {
+		if (length < Ops::LANES) {
+			return gk::internal::scalarArrayMax(data, length);
+		}
+
+		const usize vecEnd = length - (length % Ops::LANES);
+		auto maxVec = Ops::load(data);
+		for (usize i = Ops::LANES; i < vecEnd; i += Ops::LANES) {
+			maxVec = Ops::max(maxVec, Ops::load(data + i));
+		}
+
+		T lanes[Ops::LANES];
+		Ops::store(lanes, maxVec);
+		T out = gk::internal::scalarArrayMax(lanes, Ops::LANES);
+		for (usize i = vecEnd; i < length; i++) {
+			if (data[i] > out) {
+				out = data[i];
+			}
+		}
+		return out;
+	}
+
+	// Integer sums are accumulated in 64 bit lanes, so they wrap exactly like the scalar 64 bit sum.
+	// 8 bit elements use the sum of absolute differences against zero. Signed 8 bit elements are
+	// biased to unsigned by flipping the sign bit, and the bias is subtracted at the end.
+
+	template<typename T>
+	ArraySumT<T> avx512SumImpl(const T* data, usize length) {
+		constexpr usize LANES = 64 / sizeof(T);
+		const usize vecEnd = length - (length % LANES);
+		ArraySumT<T> out;
+
+		if constexpr (std::is_same_v<T, float>) {
+			__m512 sumVec = _mm512_setzero_ps();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				sumVec = _mm512_add_ps(sumVec, _mm512_loadu_ps(data + i));
+			}
+			out = _mm512_reduce_add_ps(sumVec);
+		}
+		else if constexpr (std::is_same_v<T, double>) {
+			__m512d sumVec = _mm512_setzero_pd();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				sumVec = _mm512_add_pd(sumVec, _mm512_loadu_pd(data + i));
+			}
+			out = _mm512_reduce_add_pd(sumVec);
+		}
+		else {
+			__m512i sumVec = _mm512_setzero_si512();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				if constexpr (sizeof(T) == 1) {
+					__m512i elements = _mm512_loadu_si512(data + i);
+					if constexpr (std::is_signed_v<T>) {
+						elements = _mm512_xor_si512(elements, _mm512_set1_epi8(static_cast<char>(0x80)));
+					}
+					sumVec = _mm512_add_epi64(sumVec, _mm512_sad_epu8(elements, _mm512_setzero_si512()));
+				}
+				else if constexpr (sizeof(T) == 2) {
+					for (usize j = 0; j < LANES; j += 8) {
+						const __m128i part = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + j));
+						sumVec = _mm512_add_epi64(sumVec, std::is_signed_v<T> ? _mm512_cvtepi16_epi64(part) : _mm512_cvtepu16_epi64(part));
+					}
+				}
+				else if constexpr (sizeof(T) == 4) {
+					for (usize j = 0; j < LANES; j += 8) {
+						const __m256i part = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + j));
+						sumVec = _mm512_add_epi64(sumVec, std::is_signed_v<T> ? _mm512_cvtepi32_epi64(part) : _mm512_cvtepu32_epi64(part));
+					}
+				}
+				else {
+					sumVec = _mm512_add_epi64(sumVec, _mm512_loadu_si512(data + i));
+				}
+			}
+			out = static_cast<ArraySumT<T>>(_mm512_reduce_add_epi64(sumVec));
+			if constexpr (sizeof(T) == 1 && std::is_signed_v<T>) {
+				out -= static_cast<i64>(vecEnd) * 128;
+			}
+		}
+		return out + gk::internal::scalarArraySum(data + vecEnd, length - vecEnd);
+	}
+
+	template<typename T>
+	ArraySumT<T> avx2SumImpl(const T* data, usize length) {
+		constexpr usize LANES = 32 / sizeof(T);
+		const usize vecEnd = length - (length % LANES);
+		ArraySumT<T> out = 0;
+
+		if constexpr (std::is_same_v<T, float>) {
+			__m256 sumVec = _mm256_setzero_ps();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				sumVec = _mm256_add_ps(sumVec, _mm256_loadu_ps(data + i));
+			}
+			float lanes[8];
+			_mm256_storeu_ps(lanes, sumVec);
+			out = gk::internal::scalarArraySum(lanes, 8);
+		}
+		else if constexpr (std::is_same_v<T, double>) {
+			__m256d sumVec = _mm256_setzero_pd();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				sumVec = _mm256_add_pd(sumVec, _mm256_loadu_pd(data + i));
+			}
+			double lanes[4];
+			_mm256_storeu_pd(lanes, sumVec);
+			out = gk::internal::scalarArraySum(lanes, 4);
+		}
+		else {
+			__m256i sumVec = _mm256_setzero_si256();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				if constexpr (sizeof(T) == 1) {
+					__m256i elements = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+					if constexpr (std::is_signed_v<T>) {
+						elements = _mm256_xor_si256(elements, _mm256_set1_epi8(static_cast<char>(0x80)));
+					}
+					sumVec = _mm256_add_epi64(sumVec, _mm256_sad_epu8(elements, _mm256_setzero_si256()));
+				}
+				else if constexpr (sizeof(T) == 2) {
+					for (usize j = 0; j < LANES; j += 4) {
+						const __m128i part = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + i + j));
+						sumVec = _mm256_add_epi64(sumVec, std::is_signed_v<T> ? _mm256_cvtepi16_epi64(part) : _mm256_cvtepu16_epi64(part));
+					}
+				}
+				else if constexpr (sizeof(T) == 4) {
+					for (usize j = 0; j < LANES; j += 4) {
+						const __m128i part = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + j));
+						sumVec = _mm256_add_epi64(sumVec, std::is_signed_v<T> ? _mm256_cvtepi32_epi64(part) : _mm256_cvtepu32_epi64(part));
+					}
+				}
+				else {
+					sumVec = _mm256_add_epi64(sumVec, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+				}
+			}
+			u64 lanes[4];
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), sumVec);
+			out = static_cast<ArraySumT<T>>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+			if constexpr (sizeof(T) == 1 && std::is_signed_v<T>) {
+				out -= static_cast<i64>(vecEnd) * 128;
+			}
+		}
+		return out + gk::internal::scalarArraySum(data + vecEnd, length - vecEnd);
+	}
+
+	template<typename T>
+	ArraySumT<T> sse42SumImpl(const T* data, usize length) {
+		constexpr usize LANES = 16 / sizeof(T);
+		const usize vecEnd = length - (length % LANES);
+		ArraySumT<T> out = 0;
+
+		if constexpr (std::is_same_v<T, float>) {
+			__m128 sumVec = _mm_setzero_ps();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				sumVec = _mm_add_ps(sumVec, _mm_loadu_ps(data + i));
+			}
+			float lanes[4];
+			_mm_storeu_ps(lanes, sumVec);
+			out = gk::internal::scalarArraySum(lanes, 4);
+		}
+		else if constexpr (std::is_same_v<T, double>) {
+			__m128d sumVec = _mm_setzero_pd();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				sumVec = _mm_add_pd(sumVec, _mm_loadu_pd(data + i));
+			}
+			double lanes[2];
+			_mm_storeu_pd(lanes, sumVec);
+			out = lanes[0] + lanes[1];
+		}
+		else {
+			__m128i sumVec = _mm_setzero_si128();
+			for (usize i = 0; i < vecEnd; i += LANES) {
+				__m128i elements = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+				if constexpr (sizeof(T) == 1) {
+					if constexpr (std::is_signed_v<T>) {
+						elements = _mm_xor_si128(elements, _mm_set1_epi8(static_cast<char>(0x80)));
+					}
+					sumVec = _mm_add_epi64(sumVec, _mm_sad_epu8(elements, _mm_setzero_si128()));
+				}
+				else if constexpr (sizeof(T) == 2) {
+					// Each conversion widens the lowest 2 elements, so shift the next pair down each time.
+					sumVec = _mm_add_epi64(sumVec, std::is_signed_v<T> ? _mm_cvtepi16_epi64(elements) : _mm_cvtepu16_epi64(elements));
+					elements = _mm_srli_si128(elements, 4);
+					sumVec = _mm_add_epi64(sumVec, std::is_signed_v<T> ? _mm_cvtepi16_epi64(elements) : _mm_cvtepu16_epi64(elements));
+					elements = _mm_srli_si128(elements, 4);
+					sumVec = _mm_add_epi64(sumVec, std::is_signed_v<T> ? _mm_cvtepi16_epi64(elements) : _mm_cvtepu16_epi64(elements));
+					elements = _mm_srli_si128(elements, 4);
+					sumVec = _mm_add_epi64(sumVec, std::is_signed_v<T> ? _mm_cvtepi16_epi64(elements) : _mm_cvtepu16_epi64(elements));
+				}
+				else if constexpr (sizeof(T) == 4) {
+					sumVec = _mm_add_epi64(sumVec, std::is_signed_v<T> ? _mm_cvtepi32_epi64(elements) : _mm_cvtepu32_epi64(elements));
+					elements = _mm_srli_si128(elements, 8);
+					sumVec = _mm_add_epi64(sumVec, std::is_signed_v<T> ? _mm_cvtepi32_epi64(elements) : _mm_cvtepu32_epi64(elements));
+				}
+				else {
+					sumVec = _mm_add_epi64(sumVec, elements);
+				}
+			}
+			u64 lanes[2];
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sumVec);
+			out = static_cast<ArraySumT<T>>(lanes[0] + lanes[1]);
+			if constexpr (sizeof(T) == 1 && std::is_signed_v<T>) {
+				out -= static_cast<i64>(vecEnd) * 128;
+			}
+		}
+		return out + gk::internal::scalarArraySum(data + vecEnd, length - vecEnd);
+	}
+
+	enum class ArraySimdLevel : u8 {
+		Scalar,
+		Sse42,
+		Avx2,
+		Avx512,
+	};
+
+	/// Detected once, on first use.
+	ArraySimdLevel arraySimdLevel() {
+		static const ArraySimdLevel level = []() {
+			if (gk::x86::isAvx512Supported()) {
+				return ArraySimdLevel::Avx512;
+			}
+			else if (gk::x86::isAvx2Supported()) {
+				return ArraySimdLevel::Avx2;
+			}
+			else if (gk::x86::isSse42Supported()) {
+				return ArraySimdLevel::Sse42;
+			}
+			return ArraySimdLevel::Scalar;
+		}();
+		return level;
+	}
+
+	/**
+	* Every algorithm for one element type, for one instruction set.
+	*/
+	template<typename T>
+	struct ArrayAlgorithmTable
+	{
+		Option<usize>(*findIf)(const T*, usize, ArrayCompare, T);
+		Option<usize>(*findInRange)(const T*, usize, T, T);
+		Option<usize>(*findLast)(const T*, usize, T);
+		usize(*countIf)(const T*, usize, ArrayCompare, T);
+		Option<usize>(*findAnyOf)(const T*, usize, const T*, usize);
+		T(*min)(const T*, usize);
+		T(*max)(const T*, usize);
+		ArraySumT<T>(*sum)(const T*, usize);
+	};
+
+	template<typename Ops, typename T>
+	ArrayAlgorithmTable<T> makeSimdAlgorithmTable(ArraySumT<T>(*sum)(const T*, usize)) {
+		return ArrayAlgorithmTable<T>{
+			findIfImpl<Ops, T>,
+			findInRangeImpl<Ops, T>,
+			findLastImpl<Ops, T>,
+			countIfImpl<Ops, T>,
+			findAnyOfImpl<Ops, T>,
+			minImpl<Ops, T>,
+			maxImpl<Ops, T>,
+			sum
+		};
+	}
+
+	template<typename T>
+	ArrayAlgorithmTable<T> makeScalarAlgorithmTable() {
+		return ArrayAlgorithmTable<T>{
+			gk::internal::scalarArrayFindIf<T>,
+			gk::internal::scalarArrayFindInRange<T>,
+			[](const T* data, usize length, T value) { return gk::internal::scalarArrayFindLast(data, length, value); },
+			gk::internal::scalarArrayCountIf<T>,
+			gk::internal::scalarArrayFindAnyOf<T>,
+			gk::internal::scalarArrayMin<T>,
+			gk::internal::scalarArrayMax<T>,
+			gk::internal::scalarArraySum<T>
+		};
+	}
+
+	/// The dispatch table for `T`, chosen once based on the instruction sets available at runtime.
+	/// Falls back to scalar code if no supported instruction set is available.
+	template<typename T>
+	const ArrayAlgorithmTable<T>& arrayAlgorithms() {
+		static const ArrayAlgorithmTable<T> table = []() {
+			switch (arraySimdLevel()) {
+			case ArraySimdLevel::Avx512:
+				return makeSimdAlgorithmTable<Avx512Ops<T>, T>(avx512SumImpl<T>);
+			case ArraySimdLevel::Avx2:
+				return makeSimdAlgorithmTable<Avx2Ops<T>, T>(avx2SumImpl<T>);
+			case ArraySimdLevel::Sse42:
+				return makeSimdAlgorithmTable<Sse42Ops<T>, T>(sse42SumImpl<T>);
+			default:
+				return makeScalarAlgorithmTable<T>();
+			}
+		}();
+		return table;
+	}
+}
+
+template<typename T>
+Option<usize> gk::internal::simdArrayFindIf(const T* data, usize length, ArrayCompare compare, T value)
+{
+	return arrayAlgorithms<T>().findIf(data, length, compare, value);
+}
+
+template<typename T>
+Option<usize> gk::internal::simdArrayFindInRange(const T* data, usize length, T low, T high)
+{
+	return arrayAlgorithms<T>().findInRange(data, length, low, high);
+}
+
+template<typename T>
+Option<usize> gk::internal::simdArrayFindLast(const T* data, usize length, T value)
+{
+	return arrayAlgorithms<T>().findLast(data, length, value);
+}
+
+template<typename T>
+usize gk::internal::simdArrayCountIf(const T* data, usize length, ArrayCompare compare, T value)
+{
+	return arrayAlgorithms<T>().countIf(data, length, compare, value);
+}
+
+template<typename T>
+Option<usize> gk::internal::simdArrayFindAnyOf(const T* data, usize length, const T* values, usize valuesLength)
+{
+	return arrayAlgorithms<T>().findAnyOf(data, length, values, valuesLength);
+}
+
+template<typename T>
+T gk::internal::simdArrayMin(const T* data, usize length)
+{
+	return arrayAlgorithms<T>().min(data, length);
+}
+
+template<typename T>
+T gk::internal::simdArrayMax(const T* data, usize length)
+{
+	return arrayAlgorithms<T>().max(data, length);
+}
+
+template<typename T>
+ArraySumT<T> gk::internal::simdArraySum(const T* data, usize length)
+{
+	return arrayAlgorithms<T>().sum(data, length);
+}
+
+#define GK_INSTANTIATE_ARRAY_ALGORITHMS(T) \
+template Option<usize> gk::internal::simdArrayFindIf<T>(const T*, usize, ArrayCompare, T); \
+template Option<usize> gk::internal::simdArrayFindInRange<T>(const T*, usize, T, T); \
+template Option<usize> gk::internal::simdArrayFindLast<T>(const T*, usize, T); \
+template usize gk::internal::simdArrayCountIf<T>(const T*, usize, ArrayCompare, T); \
+template Option<usize> gk::internal::simdArrayFindAnyOf<T>(const T*, usize, const T*, usize); \
+template T gk::internal::simdArrayMin<T>(const T*, usize); \
+template T gk::internal::simdArrayMax<T>(const T*, usize); \
+template ArraySumT<T> gk::internal::simdArraySum<T>(const T*, usize)
+
+GK_INSTANTIATE_ARRAY_ALGORITHMS(i8);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(u8);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(i16);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(u16);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(i32);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(u32);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(i64);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(u64);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(float);
+GK_INSTANTIATE_ARRAY_ALGORITHMS(double);
+
+#undef GK_INSTANTIATE_ARRAY_ALGORITHMS
+
+#if GK_TYPES_LIB_TEST
+#include "array_list.h"
+#include <limits>
+
+using gk::ArrayList;
+using gk::ArrayListUnmanaged;
+
+static constexpr void algorithmsSmallList() {
+	ArrayList<int> a;
+	a.appendList({ 5, -3, 8, 8, 0, -3, 7 });
+	check_eq(a.findIf(ArrayCompare::Greater, 5).someCopy(), 2);
+	check_eq(a.findIf(ArrayCompare::Less, 0).someCopy(), 1);
+	check(a.findIf(ArrayCompare::Greater, 8).none());
+	check_eq(a.findInRange(6, 7).someCopy(), 6);
+	check_eq(a.findLast(-3).someCopy(), 5);
+	check_eq(a.count(8), 2);
+	check_eq(a.countIf(ArrayCompare::GreaterEqual, 5), 4);
+	const int values[] = { 100, 0 };
+	check_eq(a.findAnyOf(values, 2).someCopy(), 4);
+	check_eq(a.min().someCopy(), -3);
+	check_eq(a.max().someCopy(), 8);
+	check_eq(a.argMin().someCopy(), 1);
+	check_eq(a.argMax().someCopy(), 2);
+	check_eq(a.sum(), 22);
+}
+
+test_case("ArrayList algorithms small list") { algorithmsSmallList(); }
+comptime_test_case(array_list_algorithms_small_list, { algorithmsSmallList(); })
+
+static constexpr void algorithmsEmptyList() {
+	ArrayList<double> a;
+	check(a.findIf(ArrayCompare::NotEqual, 0.0).none());
+	check(a.findLast(0.0).none());
+	check_eq(a.count(0.0), 0);
+	check(a.findAnyOf(nullptr, 0).none());
+	check(a.min().none());
+	check(a.argMax().none());
+	check_eq(a.sum(), 0.0);
+}
+
+test_case("ArrayList algorithms empty list") { algorithmsEmptyList(); }
+comptime_test_case(array_list_algorithms_empty_list, { algorithmsEmptyList(); })
+
+/// Compares every algorithm against the scalar implementation, for lengths that cover
+/// partial vectors, whole vectors, and tails for both AVX-512 and AVX-2.
+template<typename T>
+static void checkAlgorithmsMatchScalar() {
+	for (usize length = 0; length < 200; length += 13) {
+		ArrayList<T> a;
+		for (usize i = 0; i < length; i++) {
+			// Mix of small positive and negative values (wrapping for unsigned), with duplicates.
+			a.push(static_cast<T>(static_cast<i64>((i * 37) % 23) - 11));
+		}
+		const T* data = a.data();
+		const T value = static_cast<T>(3);
+		const T values[] = { static_cast<T>(-7), static_cast<T>(9), static_cast<T>(100) };
+
+		for (u8 c = 0; c <= static_cast<u8>(ArrayCompare::GreaterEqual); c++) {
+			const ArrayCompare compare = static_cast<ArrayCompare>(c);
+			gk::Option<usize> found = a.findIf(compare, value);
+			gk::Option<usize> expected = gk::internal::scalarArrayFindIf(data, length, compare, value);
+			check_eq(found.none(), expected.none());
+			if (found.isSome()) {
+				check_eq(found.someCopy(), expected.someCopy());
+			}
+			check_eq(a.countIf(compare, value), gk::internal::scalarArrayCountIf(data, length, compare, value));
+		}
+
+		gk::Option<usize> inRange = a.findInRange(static_cast<T>(4), static_cast<T>(6));
+		gk::Option<usize> expectedInRange = gk::internal::scalarArrayFindInRange(data, length, static_cast<T>(4), static_cast<T>(6));
+		check_eq(inRange.none(), expectedInRange.none());
+		if (inRange.isSome()) {
+			check_eq(inRange.someCopy(), expectedInRange.someCopy());
+		}
+
+		gk::Option<usize> last = a.findLast(value);
+		gk::Option<usize> expectedLast = gk::internal::scalarArrayFindLast(data, length, value);
+		check_eq(last.none(), expectedLast.none());
+		if (last.isSome()) {
+			check_eq(last.someCopy(), expectedLast.someCopy());
+		}
+
+		gk::Option<usize> anyOf = a.findAnyOf(values, 3);
+		gk::Option<usize> expectedAnyOf = gk::internal::scalarArrayFindAnyOf(data, length, values, 3);
+		check_eq(anyOf.none(), expectedAnyOf.none());
+		if (anyOf.isSome()) {
+			check_eq(anyOf.someCopy(), expectedAnyOf.someCopy());
+		}
+
+		if (length > 0) {
+			check_eq(a.min().someCopy(), gk::internal::scalarArrayMin(data, length));
+			check_eq(a.max().someCopy(), gk::internal::scalarArrayMax(data, length));
+		}
+		check_eq(a.sum(), gk::internal::scalarArraySum(data, length));
+	}
+}
+
+test_case("ArrayList algorithms match scalar i8") { checkAlgorithmsMatchScalar<i8>(); }
+test_case("ArrayList algorithms match scalar u8") { checkAlgorithmsMatchScalar<u8>(); }
+test_case("ArrayList algorithms match scalar i16") { checkAlgorithmsMatchScalar<i16>(); }
+test_case("ArrayList algorithms match scalar u16") { checkAlgorithmsMatchScalar<u16>(); }
+test_case("ArrayList algorithms match scalar i32") { checkAlgorithmsMatchScalar<i32>(); }
+test_case("ArrayList algorithms match scalar u32") { checkAlgorithmsMatchScalar<u32>(); }
+test_case("ArrayList algorithms match scalar i64") { checkAlgorithmsMatchScalar<i64>(); }
+test_case("ArrayList algorithms match scalar u64") { checkAlgorithmsMatchScalar<u64>(); }
+test_case("ArrayList algorithms match scalar float") { checkAlgorithmsMatchScalar<float>(); }
+test_case("ArrayList algorithms match scalar double") { checkAlgorithmsMatchScalar<double>(); }
+
+test_case("ArrayList algorithms find last in whole vector") {
+	ArrayList<i32> a;
+	for (i32 i = 0; i < 64; i++) {
+		a.push(i % 4);
+	}
+	check_eq(a.findLast(1).someCopy(), 61);
+	check_eq(a.findLast(3).someCopy(), 63);
+	check(a.findLast(4).none());
+}
+
+test_case("ArrayList algorithms i8 sum does not overflow") {
+	ArrayList<i8> a;
+	for (usize i = 0; i < 1000; i++) {
+		a.push(i % 2 == 0 ? i8(-128) : i8(127));
+	}
+	check_eq(a.sum(), -500);
+	check_eq(a.min().someCopy(), -128);
+	check_eq(a.max().someCopy(), 127);
+}
+
+test_case("ArrayList algorithms unsigned compare") {
+	ArrayList<u32> a;
+	for (u32 i = 0; i < 40; i++) {
+		a.push(i);
+	}
+	a.push(0xFFFFFFFFu);
+	check_eq(a.findIf(ArrayCompare::Greater, 0x7FFFFFFFu).someCopy(), 40);
+	check_eq(a.countIf(ArrayCompare::Less, 10u), 10);
+	check_eq(a.argMax().someCopy(), 40);
+}
+
+test_case("ArrayList algorithms long and long long") {
+	ArrayList<long> a;
+	ArrayList<long long> b;
+	for (long i = 0; i < 20; i++) {
+		a.push(i);
+		b.push(static_cast<long long>(i));
+	}
+	check_eq(a.sum(), 190);
+	check_eq(b.sum(), 190);
+	check_eq(a.findIf(ArrayCompare::GreaterEqual, 17).someCopy(), 17);
+}
+
+test_case("ArrayList algorithms float NaN compare") {
+	ArrayList<float> a;
+	for (usize i = 0; i < 20; i++) {
+		a.push(1.f);
+	}
+	a[17] = std::numeric_limits<float>::quiet_NaN();
+	check_eq(a.findIf(ArrayCompare::NotEqual, 1.f).someCopy(), 17);
+	check_eq(a.countIf(ArrayCompare::Equal, 1.f), 19);
+}
+
+test_case("ArrayListUnmanaged algorithms") {
+	gk::IAllocator* allocator = gk::globalHeapAllocator();
+	ArrayListUnmanaged<u16> a;
+	for (u16 i = 0; i < 100; i++) {
+		(void)a.push(allocator, i);
+	}
+	const u16 values[] = { 1000, 99 };
+	check_eq(a.findIf(ArrayCompare::GreaterEqual, 50).someCopy(), 50);
+	check_eq(a.findInRange(70, 80).someCopy(), 70);
+	check(a.containsAnyOf(values, 2));
+	check_eq(a.findLast(3).someCopy(), 3);
+	check_eq(a.count(3), 1);
+	check_eq(a.argMin().someCopy(), 0);
+	check_eq(a.sum(), 4950);
+	a.deinit(allocator);
+}
+
+#endif
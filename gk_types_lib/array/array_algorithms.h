@@ -0,0 +1,295 @@
+#pragma once
+
+#include "../basic_types.h"
+#include "../option/option.h"
+#include <type_traits>
+
+namespace gk
+{
+	/**
+	* Comparison used by the predicate based ArrayList algorithms, such as `ArrayList::findIf()`.
+	* The element is always the left hand side, so `Less` matches elements that are less than the value.
+	* Follows the same NaN semantics as the C++ comparison operators.
+	*/
+	enum class ArrayCompare : u8 {
+		Equal,
+		NotEqual,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+	};
+
+	namespace internal
+	{
+		/**
+		* Element types supported by the SIMD bulk algorithms, such as `ArrayList::findIf()` and `ArrayList::sum()`.
+		*/
+		template<typename T>
+		concept SimdArrayElement = std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double>;
+
+		template<typename T>
+		struct SimdArrayCanonical {
+			using type = T;
+		};
+
+		template<typename T>
+			requires (std::is_integral_v<T>)
+		struct SimdArrayCanonical<T> {
+			using type =
+				std::conditional_t<sizeof(T) == 1, std::conditional_t<std::is_signed_v<T>, i8, u8>,
+				std::conditional_t<sizeof(T) == 2, std::conditional_t<std::is_signed_v<T>, i16, u16>,
+				std::conditional_t<sizeof(T) == 4, std::conditional_t<std::is_signed_v<T>, i32, u32>,
+				std::conditional_t<std::is_signed_v<T>, i64, u64>>>>;
+		};
+
+		/**
+		* Maps equivalent integer types (such as `long` and `long long`) to one of the fixed size integer types,
+		* so the runtime dispatched algorithms only need to exist for 10 types.
+		*/
+		template<typename T>
+		using SimdArrayCanonicalT = typename SimdArrayCanonical<T>::type;
+
+		/**
+		* Integers are summed into 64 bits, and floating point types are summed as themselves.
+		*/
+		template<typename T>
+		using ArraySumT = std::conditional_t<std::is_floating_point_v<T>, T, std::conditional_t<std::is_signed_v<T>, i64, u64>>;
+
+		template<typename T>
+		constexpr bool arrayCompare(T element, ArrayCompare compare, T value) {
+			switch (compare) {
+			case ArrayCompare::Equal:
+				return element == value;
+			case ArrayCompare::NotEqual:
+				return element != value;
+			case ArrayCompare::Less:
+				return element < value;
+			case ArrayCompare::LessEqual:
+				return element <= value;
+			case ArrayCompare::Greater:
+				return element > value;
+			default:
+				return element >= value;
+			}
+		}
+
+		// Scalar implementations. Used at compile time, when SIMD is not supported, and for the tails of SIMD loops.
+
+		template<typename T>
+		constexpr Option<usize> scalarArrayFindIf(const T* data, usize length, ArrayCompare compare, T value) {
+			for (usize i = 0; i < length; i++) {
+				if (arrayCompare(data[i], compare, value)) {
+					return Option<usize>(i);
+				}
+			}
+			return Option<usize>();
+		}
+
+		template<typename T>
+		constexpr Option<usize> scalarArrayFindInRange(const T* data, usize length, T low, T high) {
+			for (usize i = 0; i < length; i++) {
+				if (data[i] >= low && data[i] <= high) {
+					return Option<usize>(i);
+				}
+			}
+			return Option<usize>();
+		}
+
+		template<typename T>
+		constexpr Option<usize> scalarArrayFindLast(const T* data, usize length, const T& value) {
+			usize i = length;
+			while (i > 0) {
+				i--;
+				if (data[i] == value) {
+					return Option<usize>(i);
+				}
+			}
+			return Option<usize>();
+		}
+
+		template<typename T>
+		constexpr usize scalarArrayCountIf(const T* data, usize length, ArrayCompare compare, T value) {
+			usize count = 0;
+			for (usize i = 0; i < length; i++) {
+				if (arrayCompare(data[i], compare, value)) {
+					count++;
+				}
+			}
+			return count;
+		}
+
+		template<typename T>
+		constexpr Option<usize> scalarArrayFindAnyOf(const T* data, usize length, const T* values, usize valuesLength) {
+			for (usize i = 0; i < length; i++) {
+				for (usize j = 0; j < valuesLength; j++) {
+					if (data[i] == values[j]) {
+						return Option<usize>(i);
+					}
+				}
+			}
+			return Option<usize>();
+		}
+
+		/// Requires `length` > 0.
+		template<typename T>
+		constexpr T scalarArrayMin(const T* data, usize length) {
+			T out = data[0];
+			for (usize i = 1; i < length; i++) {
+				if (data[i] < out) {
+					out = data[i];
+				}
+			}
+			return out;
+		}
+
+		/// Requires `length` > 0.
+		template<typename T>
+		constexpr T scalarArrayMax(const T* data, usize length) {
+			T out = data[0];
+			for (usize i = 1; i < length; i++) {
+				if (data[i] > out) {
+					out = data[i];
+				}
+			}
+			return out;
+		}
+
+		template<typename T>
+		constexpr ArraySumT<T> scalarArraySum(const T* data, usize length) {
+			ArraySumT<T> out = 0;
+			for (usize i = 0; i < length; i++) {
+				out += static_cast<ArraySumT<T>>(data[i]);
+			}
+			return out;
+		}
+
+		// Runtime dispatched to AVX-512, AVX-2, SSE4.2, or scalar implementations.
+		// Only instantiated for the canonical types. See `SimdArrayCanonicalT`.
+
+		template<typename T>
+		Option<usize> simdArrayFindIf(const T* data, usize length, ArrayCompare compare, T value);
+
+		template<typename T>
+		Option<usize> simdArrayFindInRange(const T* data, usize length, T low, T high);
+
+		template<typename T>
+		Option<usize> simdArrayFindLast(const T* data, usize length, T value);
+
+		template<typename T>
+		usize simdArrayCountIf(const T* data, usize length, ArrayCompare compare, T value);
+
+		template<typename T>
+		Option<usize> simdArrayFindAnyOf(const T* data, usize length, const T* values, usize valuesLength);
+
+		/// Requires `length` > 0.
+		template<typename T>
+		T simdArrayMin(const T* data, usize length);
+
+		/// Requires `length` > 0.
+		template<typename T>
+		T simdArrayMax(const T* data, usize length);
+
+		template<typename T>
+		ArraySumT<T> simdArraySum(const T* data, usize length);
+
+		// Shared by the ArrayList variants. Uses the scalar implementations at compile time.
+
+		template<SimdArrayElement T>
+		constexpr Option<usize> arrayFindIf(const T* data, usize length, ArrayCompare compare, T value) {
+			if (std::is_constant_evaluated()) {
+				return scalarArrayFindIf(data, length, compare, value);
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return simdArrayFindIf<C>(reinterpret_cast<const C*>(data), length, compare, static_cast<C>(value));
+		}
+
+		template<SimdArrayElement T>
+		constexpr Option<usize> arrayFindInRange(const T* data, usize length, T low, T high) {
+			if (std::is_constant_evaluated()) {
+				return scalarArrayFindInRange(data, length, low, high);
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return simdArrayFindInRange<C>(reinterpret_cast<const C*>(data), length, static_cast<C>(low), static_cast<C>(high));
+		}
+
+		template<typename T>
+		constexpr Option<usize> arrayFindLast(const T* data, usize length, const T& value) {
+			if constexpr (SimdArrayElement<T>) {
+				if (!std::is_constant_evaluated()) {
+					using C = SimdArrayCanonicalT<T>;
+					return simdArrayFindLast<C>(reinterpret_cast<const C*>(data), length, static_cast<C>(value));
+				}
+			}
+			return scalarArrayFindLast(data, length, value);
+		}
+
+		template<typename T>
+		constexpr usize arrayCount(const T* data, usize length, const T& value) {
+			if constexpr (SimdArrayElement<T>) {
+				if (!std::is_constant_evaluated()) {
+					using C = SimdArrayCanonicalT<T>;
+					return simdArrayCountIf<C>(reinterpret_cast<const C*>(data), length, ArrayCompare::Equal, static_cast<C>(value));
+				}
+			}
+			usize count = 0;
+			for (usize i = 0; i < length; i++) {
+				if (data[i] == value) {
+					count++;
+				}
+			}
+			return count;
+		}
+
+		template<SimdArrayElement T>
+		constexpr usize arrayCountIf(const T* data, usize length, ArrayCompare compare, T value) {
+			if (std::is_constant_evaluated()) {
+				return scalarArrayCountIf(data, length, compare, value);
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return simdArrayCountIf<C>(reinterpret_cast<const C*>(data), length, compare, static_cast<C>(value));
+		}
+
+		template<SimdArrayElement T>
+		constexpr Option<usize> arrayFindAnyOf(const T* data, usize length, const T* values, usize valuesLength) {
+			if (std::is_constant_evaluated()) {
+				return scalarArrayFindAnyOf(data, length, values, valuesLength);
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return simdArrayFindAnyOf<C>(reinterpret_cast<const C*>(data), length, reinterpret_cast<const C*>(values), valuesLength);
+		}
+
+		template<SimdArrayElement T>
+		constexpr Option<T> arrayMin(const T* data, usize length) {
+			if (length == 0) {
+				return Option<T>();
+			}
+			if (std::is_constant_evaluated()) {
+				return Option<T>(scalarArrayMin(data, length));
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return Option<T>(static_cast<T>(simdArrayMin<C>(reinterpret_cast<const C*>(data), length)));
+		}
+
+		template<SimdArrayElement T>
+		constexpr Option<T> arrayMax(const T* data, usize length) {
+			if (length == 0) {
+				return Option<T>();
+			}
+			if (std::is_constant_evaluated()) {
+				return Option<T>(scalarArrayMax(data, length));
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return Option<T>(static_cast<T>(simdArrayMax<C>(reinterpret_cast<const C*>(data), length)));
+		}
+
+		template<SimdArrayElement T>
+		constexpr ArraySumT<T> arraySum(const T* data, usize length) {
+			if (std::is_constant_evaluated()) {
+				return scalarArraySum(data, length);
+			}
+			using C = SimdArrayCanonicalT<T>;
+			return simdArraySum<C>(reinterpret_cast<const C*>(data), length);
+		}
+	} // namespace internal
+} // namespace gk
@@ -1,11 +1,4 @@
 #include "array_list.h"
-#include "../cpu_features/cpu_feature_detector.h"
-#include <intrin.h>
-
-#pragma intrinsic(_BitScanForward64)
-#pragma intrinsic(_BitScanForward)
-
-constexpr bool SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS = false;
 
 template<typename T>
 using Option = gk::Option<T>;
@@ -19,287 +12,11 @@ using gk::u16;
 using gk::u32;
 using gk::u64;
 
-using Find1ByteInArrayListFunc = gk::Option<usize>(*)(const i8*, usize, i8);
-using Find2ByteInArrayListFunc = gk::Option<usize>(*)(const i16*, usize, i16);
-using Find4ByteInArrayListFunc = gk::Option<usize>(*)(const i32*, usize, i32);
-using Find8ByteInArrayListFunc = gk::Option<usize>(*)(const i64*, usize, i64);
-
-static gk::Option<usize> avx512Find1ByteInArrayList(const i8* arrayListData, usize length, i8 toFind) {
-	constexpr usize NUM_PER_VEC = 64;
-
-	const __m512i findVec = _mm512_set1_epi8(toFind);
-	const __m512i* arrayListVec = reinterpret_cast<const __m512i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u64 bitmask = _mm512_cmpeq_epi8_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward64(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx2Find1ByteInArrayList(const i8* arrayListData, usize length, i8 toFind) {
-	constexpr usize NUM_PER_VEC = 32;
-
-	const __m256i findVec = _mm256_set1_epi8(toFind);
-	const __m256i* arrayListVec = reinterpret_cast<const __m256i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm256_cmpeq_epi8_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx512Find2ByteInArrayList(const i16* arrayListData, usize length, i16 toFind) {
-	constexpr usize NUM_PER_VEC = 32;
-
-	const __m512i findVec = _mm512_set1_epi16(toFind);
-	const __m512i* arrayListVec = reinterpret_cast<const __m512i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm512_cmpeq_epi16_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx2Find2ByteInArrayList(const i16* arrayListData, usize length, i16 toFind) {
-	constexpr usize NUM_PER_VEC = 16;
-
-	const __m256i findVec = _mm256_set1_epi16(toFind);
-	const __m256i* arrayListVec = reinterpret_cast<const __m256i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm256_cmpeq_epi16_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx512Find4ByteInArrayList(const i32* arrayListData, usize length, i32 toFind) {
-	constexpr usize NUM_PER_VEC = 16;
-
-	const __m512i findVec = _mm512_set1_epi32(toFind);
-	const __m512i* arrayListVec = reinterpret_cast<const __m512i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm512_cmpeq_epi32_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx2Find4ByteInArrayList(const i32* arrayListData, usize length, i32 toFind) {
-	constexpr usize NUM_PER_VEC = 8;
-
-	const __m256i findVec = _mm256_set1_epi32(toFind);
-	const __m256i* arrayListVec = reinterpret_cast<const __m256i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm256_cmpeq_epi32_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx512Find8ByteInArrayList(const i64* arrayListData, usize length, i64 toFind) {
-	constexpr usize NUM_PER_VEC = 8;
-
-	const __m512i findVec = _mm512_set1_epi64(toFind);
-	const __m512i* arrayListVec = reinterpret_cast<const __m512i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm512_cmpeq_epi64_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-static gk::Option<usize> avx2Find8ByteInArrayList(const i64* arrayListData, usize length, i64 toFind) {
-	constexpr usize NUM_PER_VEC = 4;
-
-	const __m256i findVec = _mm256_set1_epi64x(toFind);
-	const __m256i* arrayListVec = reinterpret_cast<const __m256i*>(arrayListData);
-	const usize iterationToDo = (length % NUM_PER_VEC == 0 ? length : length + (NUM_PER_VEC - (length % NUM_PER_VEC))) / NUM_PER_VEC;
-	for (usize i = 0; i < iterationToDo; i++) {
-		const u32 bitmask = _mm256_cmpeq_epi64_mask(findVec, arrayListVec[i]);
-
-		unsigned long index;
-		if (_BitScanForward(&index, bitmask) == 0) {
-			continue;
-		}
-		const usize actualIndex = (i * NUM_PER_VEC) + index;
-		if (index >= length) {
-			return gk::Option<usize>(); // out of range
-		}
-		return gk::Option<usize>(actualIndex);
-	}
-	return gk::Option<usize>(); // didnt find
-}
-
-Option<usize> gk::internal::doSimdArrayElementFind1Byte(const i8* arrayListData, usize length, i8 toFind)
-{
-	static Find1ByteInArrayListFunc func = []() {
-		if (gk::x86::isAvx512Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-512 1 byte find\n";
-			}
-			return avx512Find1ByteInArrayList;
-		}
-		else if (gk::x86::isAvx2Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-2 1 byte find\n";
-			}
-			return avx2Find1ByteInArrayList; // CHANGE THIS
-		}
-		else {
-			std::cout << "[gk::HashMap function loader]: ERROR\nCannot load array list 1 byte find function if AVX-512 or AVX-2 aren't supported\n";
-			abort();
-		}
-	}();
-
-	return func(arrayListData, length, toFind);
-}
-
-Option<usize> gk::internal::doSimdArrayElementFind2Byte(const i16* arrayListData, usize length, i16 toFind)
-{
-	static Find2ByteInArrayListFunc func = []() {
-		if (gk::x86::isAvx512Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-512 2 byte find\n";
-			}
-			return avx512Find2ByteInArrayList;
-		}
-		else if (gk::x86::isAvx2Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-2 2 byte find\n";
-			}
-			return avx2Find2ByteInArrayList; // CHANGE THIS
-		}
-		else {
-			std::cout << "[gk::HashMap function loader]: ERROR\nCannot load array list 2 byte find function if AVX-512 or AVX-2 aren't supported\n";
-			abort();
-		}
-	}();
-
-	return func(arrayListData, length, toFind);
-}
-
-Option<usize> gk::internal::doSimdArrayElementFind4Byte(const i32* arrayListData, usize length, i32 toFind)
-{
-	static Find4ByteInArrayListFunc func = []() {
-		if (gk::x86::isAvx512Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-512 4 byte find\n";
-			}
-			return avx512Find4ByteInArrayList;
-		}
-		else if (gk::x86::isAvx2Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-2 4 byte find\n";
-			}
-			return avx2Find4ByteInArrayList; // CHANGE THIS
-		}
-		else {
-			std::cout << "[gk::HashMap function loader]: ERROR\nCannot load array list 4 byte find function if AVX-512 or AVX-2 aren't supported\n";
-			abort();
-		}
-	}();
-
-	return func(arrayListData, length, toFind);
-}
-
-Option<usize> gk::internal::doSimdArrayElementFind8Byte(const i64* arrayListData, usize length, i64 toFind)
-{
-	static Find8ByteInArrayListFunc func = []() {
-		if (gk::x86::isAvx512Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-512 8 byte find\n";
-			}
-			return avx512Find8ByteInArrayList;
-		}
-		else if (gk::x86::isAvx2Supported()) {
-			if (SHOULD_LOG_ARRAYLIST_DYNAMICALLY_LOADED_FUNCTIONS) {
-				std::cout << "[gk::ArrayList function loader]: Using AVX-2 8 byte find\n";
-			}
-			return avx2Find8ByteInArrayList; // CHANGE THIS
-		}
-		else {
-			std::cout << "[gk::HashMap function loader]: ERROR\nCannot load array list 8 byte find function if AVX-512 or AVX-2 aren't supported\n";
-			abort();
-		}
-	}();
-
-	return func(arrayListData, length, toFind);
-}
-
 #if GK_TYPES_LIB_TEST
 #include <string>
 #include "../allocator/testing_allocator.h"
 #include "../ptr/unique_ptr.h"
+#include "../string/string.h"
 
 using gk::ArrayList;
 using gk::ArrayListUnmanaged;
@@ -895,6 +612,56 @@ comptime_test_case(find_end, {
 	check_eq(a.find(9).some(), 9);
 });
 
+template<typename T>
+static void testFindEveryIndex() {
+	for (usize length = 1; length < 150; length += 7) {
+		ArrayList<T> a;
+		for (usize i = 0; i < length; i++) {
+			a.push(static_cast<T>(i + 1));
+		}
+		for (usize i = 0; i < length; i++) {
+			check_eq(a.find(static_cast<T>(i + 1)).some(), i);
+		}
+		check(a.find(static_cast<T>(0)).none());
+	}
+}
+
+test_case("find every index 1 byte") { testFindEveryIndex<i8>(); }
+test_case("find every index 2 byte") { testFindEveryIndex<u16>(); }
+test_case("find every index 4 byte") { testFindEveryIndex<i32>(); }
+test_case("find every index 8 byte") { testFindEveryIndex<u64>(); }
+test_case("find every index float") { testFindEveryIndex<float>(); }
+test_case("find every index double") { testFindEveryIndex<double>(); }
+
+test_case("find does not match past length") {
+	ArrayList<i32> a;
+	a.reserve(64);
+	for (i32 i = 0; i < 20; i++) {
+		a.push(i);
+	}
+	a.truncate(3);
+	check(a.find(10).none());
+}
+
+test_case("find float compares values") {
+	ArrayList<float> a;
+	a.push(1.f);
+	a.push(1.5f);
+	a.push(-0.f);
+	check_eq(a.find(1.5f).some(), 1);
+	check_eq(a.find(0.f).some(), 2);
+}
+
+test_case("find pointer") {
+	int values[4] = { 0, 1, 2, 3 };
+	ArrayList<int*> a;
+	for (int i = 0; i < 4; i++) {
+		a.push(&values[i]);
+	}
+	check_eq(a.find(&values[2]).some(), 2);
+	check(a.find(nullptr).none());
+}
+
 static constexpr void testArrayListRemoveContainsOneElement() {
 	ArrayList<int> a;
 	a.push(50);
@@ -1665,6 +1432,85 @@ static constexpr void testArrayListReverseConstIteratorNotEmpty() {
 test_case("reverse const iterator not empty") { testArrayListReverseConstIteratorNotEmpty(); }
 comptime_test_case(reverse_const_iterator_not_empty, { testArrayListReverseConstIteratorNotEmpty(); });
 
-#endif
+static_assert(sizeof(ArrayList<int, gk::GlobalHeapStaticAllocator>) == 24);
+
+static constexpr void testArrayListStaticAllocatorPushAndCopy() {
+	ArrayList<std::string, gk::GlobalHeapStaticAllocator> a;
+	for (int i = 0; i < 100; i++) {
+		a.push(":D");
+	}
+	ArrayList<std::string, gk::GlobalHeapStaticAllocator> b = a;
+	ArrayList<std::string, gk::GlobalHeapStaticAllocator> c = std::move(a);
+	check_eq(b.len(), 100);
+	check_eq(c.len(), 100);
+	check_eq(c[99], ":D");
+}
+
+test_case("static allocator push and copy") { testArrayListStaticAllocatorPushAndCopy(); }
+comptime_test_case(static_allocator_push_and_copy, { testArrayListStaticAllocatorPushAndCopy(); });
+
+test_case("static allocator simd find") {
+	auto a = ArrayList<int, gk::GlobalHeapStaticAllocator>::init(gk::GlobalHeapStaticAllocator());
+	for (int i = 0; i < 100; i++) {
+		a.push(i);
+	}
+	check_eq(a.find(50).someCopy(), 50);
+}
+
+static_assert(std::is_same_v<ArrayList<int>, ArrayList<int, gk::AllocatorRef>>);
+static_assert(std::is_same_v<gk::GlobalHeapArrayList<int>, ArrayList<int, gk::GlobalHeapStaticAllocator>>);
+
+static_assert(gk::is_trivially_relocatable_v<int>);
+static_assert(gk::is_trivially_relocatable_v<gk::String>);
+static_assert(gk::is_trivially_relocatable_v<ArrayList<gk::String>>);
+static_assert(gk::is_trivially_relocatable_v<gk::Option<gk::String>>);
+static_assert(!gk::is_trivially_relocatable_v<std::string>);
 
+test_case("relocatable reallocate keeps elements") {
+	ArrayList<gk::String> a;
+	for (usize i = 0; i < 1000; i++) {
+		a.push(gk::String("some string that's too long to fit in sso "_str) + gk::String::fromUint(i));
+	}
+	check_eq(a.len(), 1000);
+	check_eq(a[0], gk::String("some string that's too long to fit in sso 0"_str));
+	check_eq(a[999], gk::String("some string that's too long to fit in sso 999"_str));
+}
+
+test_case("relocatable remove middle element") {
+	ArrayList<gk::String> a;
+	a.push(gk::String::fromUint(0));
+	a.push(gk::String("some string that's too long to fit in sso"_str));
+	a.push(gk::String::fromUint(2));
+	a.push(gk::String::fromUint(3));
+	check_eq(a.remove(1), gk::String("some string that's too long to fit in sso"_str));
+	check_eq(a.len(), 3);
+	check_eq(a[0], gk::String::fromUint(0));
+	check_eq(a[1], gk::String::fromUint(2));
+	check_eq(a[2], gk::String::fromUint(3));
+}
+
+test_case("relocatable insert middle element") {
+	ArrayList<gk::String> a;
+	a.push(gk::String::fromUint(0));
+	a.push(gk::String::fromUint(2));
+	a.push(gk::String::fromUint(3));
+	a.insert(1, gk::String("some string that's too long to fit in sso"_str));
+	check_eq(a.len(), 4);
+	check_eq(a[0], gk::String::fromUint(0));
+	check_eq(a[1], gk::String("some string that's too long to fit in sso"_str));
+	check_eq(a[2], gk::String::fromUint(2));
+	check_eq(a[3], gk::String::fromUint(3));
+}
+
+test_case("relocatable nested ArrayList reallocate") {
+	ArrayList<ArrayList<gk::String>> a;
+	for (usize i = 0; i < 100; i++) {
+		ArrayList<gk::String> inner;
+		inner.push(gk::String::fromUint(i));
+		a.push(std::move(inner));
+	}
+	check_eq(a[0][0], gk::String::fromUint(0));
+	check_eq(a[99][0], gk::String::fromUint(99));
+}
 
+#endif
@@ -4,43 +4,43 @@
 #include "../utility.h"
 #include "../allocator/allocator.h"
 #include "../option/option.h"
+#include "array_algorithms.h"
+#include "array_sort.h"
 #include <type_traits>
+#include <bit>
 #include "../error/result.h"
 
 namespace gk
 {
 	namespace internal 
 	{
-		constexpr static usize ARRAY_LIST_SIMD_T_MALLOC_ALIGN = 64;
-
-		constexpr AllocatorRef arrayListDefaultAllocator() {
-			if (std::is_constant_evaluated()) {
+		template<typename Allocator>
+		constexpr Allocator arrayListDefaultAllocator() {
+			if constexpr (StaticAllocator<Allocator>) {
+				return Allocator();
+			}
+			else if (std::is_constant_evaluated()) {
 				return AllocatorRef();
 			}
 			else {
 				return gk::globalHeapAllocatorRef();
 			}
-
 		}
 
-		Option<usize> doSimdArrayElementFind1Byte(const i8* arrayListData, usize length, i8 toFind);
-		Option<usize> doSimdArrayElementFind2Byte(const i16* arrayListData, usize length, i16 toFind);
-		Option<usize> doSimdArrayElementFind4Byte(const i32* arrayListData, usize length, i32 toFind);
-		Option<usize> doSimdArrayElementFind8Byte(const i64* arrayListData, usize length, i64 toFind);
-
+		/// Equality find for any SIMD element type, using the runtime dispatched kernels in array_algorithms.
+		/// Integers, enums, and pointers compare their bits. Floating point types compare with `==`.
 		template<typename T>
 		forceinline static gk::Option<usize> doSimdArrayElementFind(const T* arrayListData, usize length, T toFind) {
-			if constexpr (sizeof(T) == 1) {
-				return doSimdArrayElementFind1Byte(reinterpret_cast<const i8*>(arrayListData), length, static_cast<i8>(toFind));
-			}
-			else if constexpr (sizeof(T) == 2) {
-				return doSimdArrayElementFind2Byte(reinterpret_cast<const i16*>(arrayListData), length, static_cast<i16>(toFind));
-			}
-			else if constexpr (sizeof(T) == 4) {
-				return doSimdArrayElementFind4Byte(reinterpret_cast<const i32*>(arrayListData), length, static_cast<i32>(toFind));
+			if constexpr (std::is_floating_point_v<T>) {
+				static_assert(sizeof(T) == sizeof(float) || sizeof(T) == sizeof(double), "Unsupported floating point size for SIMD find");
+				using Float = std::conditional_t<sizeof(T) == sizeof(float), float, double>;
+				return simdArrayFindIf<Float>(reinterpret_cast<const Float*>(arrayListData), length, ArrayCompare::Equal, static_cast<Float>(toFind));
 			}
 			else {
-				return doSimdArrayElementFind8Byte(reinterpret_cast<const i64*>(arrayListData), length, static_cast<i64>(toFind));
+				using Bits = std::conditional_t<sizeof(T) == 1, i8,
+					std::conditional_t<sizeof(T) == 2, i16,
+					std::conditional_t<sizeof(T) == 4, i32, i64>>>;
+				return simdArrayFindIf<Bits>(reinterpret_cast<const Bits*>(arrayListData), length, ArrayCompare::Equal, std::bit_cast<Bits>(toFind));
 			}
 		}
 
@@ -65,6 +65,9 @@ namespace gk
 
 		constexpr static bool IS_T_SIMD = (std::is_arithmetic_v<T> || std::is_pointer_v<T> || std::is_enum_v<T>);
 
+		/// Elements can be moved around in bulk with memcpy/memmove at runtime. See `gk::is_trivially_relocatable`.
+		constexpr static bool IS_T_RELOCATABLE = gk::is_trivially_relocatable_v<T>;
+
 	public:
 
 		using ValueType = T;
@@ -179,6 +182,92 @@ namespace gk
 		/// @return The found index, or None
 		[[nodiscard]] constexpr gk::Option<usize> find(const T& element) const;
 
+		/// Finds the last index of an element in the ArrayList. For arithmetic types, will use SIMD to find.
+		/// @param element: Element to check if in the ArrayList.
+		/// @return The found index, or None
+		[[nodiscard]] constexpr gk::Option<usize> findLast(const T& element) const;
+
+		/// Counts how many elements in the ArrayList are equal to `element`. For arithmetic types, will use SIMD to count.
+		/// @param element: Element to count.
+		/// @return Number of equal elements.
+		[[nodiscard]] constexpr usize count(const T& element) const;
+
+		/// Finds the first index of an element satisfying `element <compare> value`, using SIMD.
+		/// @param compare: The comparison, with the element on the left hand side.
+		/// @param value: Right hand side of the comparison.
+		/// @return The found index, or None
+		[[nodiscard]] constexpr gk::Option<usize> findIf(ArrayCompare compare, T value) const requires internal::SimdArrayElement<T>;
+
+		/// Finds the first index of an element within the inclusive range [`low`, `high`], using SIMD.
+		/// @return The found index, or None
+		[[nodiscard]] constexpr gk::Option<usize> findInRange(T low, T high) const requires internal::SimdArrayElement<T>;
+
+		/// Counts how many elements satisfy `element <compare> value`, using SIMD.
+		/// @param compare: The comparison, with the element on the left hand side.
+		/// @param value: Right hand side of the comparison.
+		/// @return Number of matching elements.
+		[[nodiscard]] constexpr usize countIf(ArrayCompare compare, T value) const requires internal::SimdArrayElement<T>;
+
+		/// Finds the first index of an element that is equal to any of `values`, using SIMD.
+		/// Intended for small sets of values, as every element is compared against every value.
+		/// @param values: Values to search for. Can be null if `valuesLength` is 0.
+		/// @param valuesLength: Number of values.
+		/// @return The found index, or None
+		[[nodiscard]] constexpr gk::Option<usize> findAnyOf(const T* values, usize valuesLength) const requires internal::SimdArrayElement<T>;
+
+		/// See `findAnyOf()`.
+		/// @return If any element is equal to any of `values`.
+		[[nodiscard]] constexpr bool containsAnyOf(const T* values, usize valuesLength) const requires internal::SimdArrayElement<T>;
+
+		/// Get the smallest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		/// @return The smallest element, or None if the ArrayList is empty.
+		[[nodiscard]] constexpr gk::Option<T> min() const requires internal::SimdArrayElement<T>;
+
+		/// Get the largest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		/// @return The largest element, or None if the ArrayList is empty.
+		[[nodiscard]] constexpr gk::Option<T> max() const requires internal::SimdArrayElement<T>;
+
+		/// Get the first index of the smallest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		/// @return The index of the smallest element, or None if the ArrayList is empty.
+		[[nodiscard]] constexpr gk::Option<usize> argMin() const requires internal::SimdArrayElement<T>;
+
+		/// Get the first index of the largest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		/// @return The index of the largest element, or None if the ArrayList is empty.
+		[[nodiscard]] constexpr gk::Option<usize> argMax() const requires internal::SimdArrayElement<T>;
+
+		/// Sums all elements using SIMD. Integers are summed into 64 bits, wrapping on overflow.
+		/// Floating point sums may differ in the last bits from a sequential sum, due to a different order of additions.
+		/// @return The sum of all elements, or 0 if the ArrayList is empty.
+		[[nodiscard]] constexpr internal::ArraySumT<T> sum() const requires internal::SimdArrayElement<T>;
+
+		/// Sorts the elements in ascending order using `operator<`. Not stable.
+		/// At runtime, arithmetic types with at least `internal::RADIX_SORT_THRESHOLD` elements use an LSD radix sort,
+		/// temporarily allocating a buffer of `len()` elements from `allocator`. If that allocation fails,
+		/// or for any other type, uses pattern defeating quicksort, which does not allocate.
+		/// Floats are radix sorted by their bits, so -0.0 sorts before 0.0.
+		/// @param allocator: Use nullptr for constexpr contexts. Cannot be null at runtime.
+		constexpr void sort(IAllocator* allocator);
+
+		/// Sorts the elements using pattern defeating quicksort, which does not allocate. Not stable.
+		/// @param less: Callable as `bool(const T&, const T&)`, returning if the left element goes before the right element.
+		template<typename Less>
+		constexpr void sortBy(Less less);
+
+		/// Sorts the elements in ascending order using `operator<`, keeping equal elements in their original order.
+		/// At runtime, integer types with at least `internal::RADIX_SORT_THRESHOLD` elements use an LSD radix sort. Otherwise uses a merge sort,
+		/// temporarily allocating a buffer of `len()` / 2 elements.
+		/// @param allocator: Use nullptr for constexpr contexts. Cannot be null at runtime.
+		/// @return An error if the temporary buffer failed to allocate, in which case the ArrayList is unmodified.
+		constexpr Result<void, AllocError> stableSort(IAllocator* allocator);
+
+		/// Sorts the elements with a merge sort, keeping equal elements in their original order.
+		/// Temporarily allocates a buffer of `len()` / 2 elements.
+		/// @param allocator: Use nullptr for constexpr contexts. Cannot be null at runtime.
+		/// @param less: Callable as `bool(const T&, const T&)`, returning if the left element goes before the right element.
+		/// @return An error if the temporary buffer failed to allocate, in which case the ArrayList is unmodified.
+		template<typename Less>
+		constexpr Result<void, AllocError> stableSortBy(IAllocator* allocator, Less less);
+
 		/// Removes the element at `index` and returns it, shuffling down all subsequent elements
 		/// to maintain order. If order is not required, use `swapRemove()` as it will perform better in general.
 		/// @param index: The element to remove. Asserts that is less than `len()`.
@@ -386,17 +475,28 @@ namespace gk
 	};
 
 	template<typename T>
+	struct is_trivially_relocatable<ArrayListUnmanaged<T>> : std::true_type {};
+
+	/// Dynamically sized array that owns it's elements and allocator.
+	/// @param Allocator: Defaults to `AllocatorRef`, chosen at runtime through `init()`. A `StaticAllocator`
+	/// such as `GlobalHeapStaticAllocator` removes the virtual dispatch and ref counting. See `GlobalHeapArrayList`.
+	template<typename T, typename Allocator = AllocatorRef>
 	struct ArrayList
 	{
+		static_assert(AllocatorPolicy<Allocator>, "ArrayList Allocator must be either AllocatorRef, or satisfy gk::StaticAllocator");
+
 	private:
 
 		constexpr static bool IS_T_SIMD = (std::is_arithmetic_v<T> || std::is_pointer_v<T> || std::is_enum_v<T>);
 
+		/// Elements can be moved around in bulk with memcpy/memmove at runtime. See `gk::is_trivially_relocatable`.
+		constexpr static bool IS_T_RELOCATABLE = gk::is_trivially_relocatable_v<T>;
+
 		/**
 		* Simple constructor to initialize the ArrayList with a specified allocator.
 		* For actual use, call ArrayList::init() for whichever overload necessary.
 		*/
-		ArrayList(AllocatorRef&& inAllocator) : _data(nullptr), _length(0), _capacity(0), _allocator(std::move(inAllocator)) {}
+		ArrayList(Allocator&& inAllocator) : _data(nullptr), _length(0), _capacity(0), _allocator(std::move(inAllocator)) {}
 
 	public:
 
@@ -453,7 +553,7 @@ namespace gk
 		* 
 		* @param inAllocator: Allocator to own
 		*/
-		[[nodiscard]] static ArrayList init(AllocatorRef&& inAllocator) { return ArrayList(std::move(inAllocator)); }
+		[[nodiscard]] static ArrayList init(Allocator&& inAllocator) { return ArrayList(std::move(inAllocator)); }
 
 		/**
 		* Creates a new ArrayList given an allocator to take ownership of, and another ArrayList to copy elements.
@@ -461,7 +561,7 @@ namespace gk
 		* @param inAllocator: Allocator to own
 		* @param other: other ArrayList to copy from
 		*/
-		[[nodiscard]] static ArrayList initCopy(AllocatorRef&& inAllocator, const ArrayList& other);
+		[[nodiscard]] static ArrayList initCopy(Allocator&& inAllocator, const ArrayList& other);
 
 		/**
 		* Creates a new ArrayList given an allocator to take ownership of, and an initializer list to copy elements.
@@ -469,7 +569,7 @@ namespace gk
 		* @param inAllocator: Allocator to own
 		* @param initializerList: Elements to copy
 		*/
-		[[nodiscard]] static ArrayList initList(AllocatorRef&& inAllocator, const std::initializer_list<T>& initializerList);
+		[[nodiscard]] static ArrayList initList(Allocator&& inAllocator, const std::initializer_list<T>& initializerList);
 
 		/**
 		* Creates a new ArrayList given an allocator to take ownership of, 
@@ -479,7 +579,7 @@ namespace gk
 		* @param ptr: Start of buffer of elements to copy
 		* @param elementsToCopy: Number to copy. Accessing beyond the bounds of `ptr` is undefined behaviour.
 		*/
-		[[nodiscard]] static ArrayList initBufferCopy(AllocatorRef&& inAllocator, const T* buffer, usize elementsToCopy);
+		[[nodiscard]] static ArrayList initBufferCopy(Allocator&& inAllocator, const T* buffer, usize elementsToCopy);
 		
 		/**
 		* Create a new ArrayList given an allocator to take ownership of, and a pre reserved minimum capacity.
@@ -488,7 +588,7 @@ namespace gk
 		* @param inAllocator: Allocator to to take ownership of
 		* @param minCapacity: Minimum allocation size
 		*/
-		[[nodiscard]] static ArrayList withCapacity(AllocatorRef&& inAllocator, usize minCapacity);
+		[[nodiscard]] static ArrayList withCapacity(Allocator&& inAllocator, usize minCapacity);
 
 		/**
 		* Create a new ArrayList given an allocator to take ownership of, a pre reserved minimum capacity,
@@ -500,7 +600,7 @@ namespace gk
 		* @param minCapacity: Minimum allocation size
 		* @param other: other ArrayList to copy from
 		*/
-		[[nodiscard]] static ArrayList withCapacityCopy(AllocatorRef&& inAllocator, usize minCapacity, const ArrayList& other);
+		[[nodiscard]] static ArrayList withCapacityCopy(Allocator&& inAllocator, usize minCapacity, const ArrayList& other);
 
 		/**
 		* Create a new ArrayList given an allocator to take ownership of, a pre reserved minimum capacity,
@@ -512,7 +612,7 @@ namespace gk
 		* @param minCapacity: Minimum allocation size
 		* @param initializerList: Elements to copy
 		*/
-		[[nodiscard]] static ArrayList withCapacityList(AllocatorRef&& inAllocator, usize minCapacity, const std::initializer_list<T>& initializerList);
+		[[nodiscard]] static ArrayList withCapacityList(Allocator&& inAllocator, usize minCapacity, const std::initializer_list<T>& initializerList);
 
 		/**
 		* Create a new ArrayList given an allocator to take ownership of, a pre reserved minimum capacity,
@@ -525,7 +625,7 @@ namespace gk
 		* @param ptr: Start of buffer of elements to copy
 		* @param elementsToCopy: Number to copy. Accessing beyond the bounds of `ptr` is undefined behaviour.
 		*/
-		[[nodiscard]] static ArrayList withCapacityBufferCopy(AllocatorRef&& inAllocator, usize minCapacity, const T* buffer, usize elementsToCopy);
+		[[nodiscard]] static ArrayList withCapacityBufferCopy(Allocator&& inAllocator, usize minCapacity, const T* buffer, usize elementsToCopy);
 
 		/**
 		* The number of elements contained in the ArrayList.
@@ -553,7 +653,7 @@ namespace gk
 		* 
 		* @return The allocator used by the ArrayList. Can be copied.
 		*/
-		[[nodiscard]] const AllocatorRef& allocator() const { return _allocator; }
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
 
 		/**
 		* Get a mutable reference to an element in the array at a specified index.
@@ -614,6 +714,134 @@ namespace gk
 		*/
 		[[nodiscard]] constexpr gk::Option<usize> find(const T& element) const;
 
+		/**
+		* Finds the last index of an element in the ArrayList. For arithmetic types, will use SIMD to find.
+		*
+		* @param element: Element to check if in the ArrayList.
+		* @return The found index, or None
+		*/
+		[[nodiscard]] constexpr gk::Option<usize> findLast(const T& element) const;
+
+		/**
+		* Counts how many elements in the ArrayList are equal to `element`. For arithmetic types, will use SIMD to count.
+		*
+		* @param element: Element to count.
+		* @return Number of equal elements.
+		*/
+		[[nodiscard]] constexpr usize count(const T& element) const;
+
+		/**
+		* Finds the first index of an element satisfying `element <compare> value`, using SIMD.
+		*
+		* @param compare: The comparison, with the element on the left hand side.
+		* @param value: Right hand side of the comparison.
+		* @return The found index, or None
+		*/
+		[[nodiscard]] constexpr gk::Option<usize> findIf(ArrayCompare compare, T value) const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Finds the first index of an element within the inclusive range [`low`, `high`], using SIMD.
+		*
+		* @return The found index, or None
+		*/
+		[[nodiscard]] constexpr gk::Option<usize> findInRange(T low, T high) const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Counts how many elements satisfy `element <compare> value`, using SIMD.
+		*
+		* @param compare: The comparison, with the element on the left hand side.
+		* @param value: Right hand side of the comparison.
+		* @return Number of matching elements.
+		*/
+		[[nodiscard]] constexpr usize countIf(ArrayCompare compare, T value) const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Finds the first index of an element that is equal to any of `values`, using SIMD.
+		* Intended for small sets of values, as every element is compared against every value.
+		*
+		* @param values: Values to search for. Can be null if `valuesLength` is 0.
+		* @param valuesLength: Number of values.
+		* @return The found index, or None
+		*/
+		[[nodiscard]] constexpr gk::Option<usize> findAnyOf(const T* values, usize valuesLength) const requires internal::SimdArrayElement<T>;
+
+		/**
+		* See `findAnyOf()`.
+		*
+		* @return If any element is equal to any of `values`.
+		*/
+		[[nodiscard]] constexpr bool containsAnyOf(const T* values, usize valuesLength) const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Get the smallest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		*
+		* @return The smallest element, or None if the ArrayList is empty.
+		*/
+		[[nodiscard]] constexpr gk::Option<T> min() const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Get the largest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		*
+		* @return The largest element, or None if the ArrayList is empty.
+		*/
+		[[nodiscard]] constexpr gk::Option<T> max() const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Get the first index of the smallest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		*
+		* @return The index of the smallest element, or None if the ArrayList is empty.
+		*/
+		[[nodiscard]] constexpr gk::Option<usize> argMin() const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Get the first index of the largest element using SIMD. The result is unspecified if the ArrayList contains NaN.
+		*
+		* @return The index of the largest element, or None if the ArrayList is empty.
+		*/
+		[[nodiscard]] constexpr gk::Option<usize> argMax() const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Sums all elements using SIMD. Integers are summed into 64 bits, wrapping on overflow.
+		* Floating point sums may differ in the last bits from a sequential sum, due to a different order of additions.
+		*
+		* @return The sum of all elements, or 0 if the ArrayList is empty.
+		*/
+		[[nodiscard]] constexpr internal::ArraySumT<T> sum() const requires internal::SimdArrayElement<T>;
+
+		/**
+		* Sorts the elements in ascending order using `operator<`. Not stable.
+		* At runtime, arithmetic types with at least `internal::RADIX_SORT_THRESHOLD` elements use an LSD radix sort,
+		* temporarily allocating a buffer of `len()` elements. If that allocation fails, or for any other type,
+		* uses pattern defeating quicksort, which does not allocate.
+		* Floats are radix sorted by their bits, so -0.0 sorts before 0.0.
+		* For large lists, see `gk::parallelSort()`.
+		*/
+		constexpr void sort();
+
+		/**
+		* Sorts the elements using pattern defeating quicksort, which does not allocate. Not stable.
+		*
+		* @param less: Callable as `bool(const T&, const T&)`, returning if the left element goes before the right element.
+		*/
+		template<typename Less>
+		constexpr void sortBy(Less less);
+
+		/**
+		* Sorts the elements in ascending order using `operator<`, keeping equal elements in their original order.
+		* At runtime, integer types with at least `internal::RADIX_SORT_THRESHOLD` elements use an LSD radix sort. Otherwise uses a merge sort,
+		* temporarily allocating a buffer of `len()` / 2 elements.
+		*/
+		constexpr void stableSort();
+
+		/**
+		* Sorts the elements with a merge sort, keeping equal elements in their original order.
+		* Temporarily allocates a buffer of `len()` / 2 elements.
+		*
+		* @param less: Callable as `bool(const T&, const T&)`, returning if the left element goes before the right element.
+		*/
+		template<typename Less>
+		constexpr void stableSortBy(Less less);
+
 		/**
 		* Removes the element at `index` and returns it, shuffling down all subsequent elements
 		* to maintain order. If order is not required, use `swapRemove()` as it will perform better in general.
@@ -854,55 +1082,91 @@ namespace gk
 		* At runtime, creates a 0 initialized buffer.
 		* At comptime, just makes a new heap array.
 		*/
-		constexpr static T* mallocArrayListBuffer(usize* requiredCapacity, AllocatorRef& allocatorToUse) {
+		constexpr static T* mallocArrayListBuffer(usize* requiredCapacity, Allocator& allocatorToUse) {
 			if (std::is_constant_evaluated()) {
 				const usize capacity = *requiredCapacity;
 				return new T[capacity];
 			}
 
-			T* outBuffer;
-			if constexpr (IS_T_SIMD) {
-				constexpr usize numPerSimd = 64 / sizeof(T);
-				const usize remainder = *requiredCapacity % numPerSimd;
-				if (remainder != 0) {
-					*requiredCapacity = *requiredCapacity + (numPerSimd - remainder);
-				}
-				outBuffer = allocatorToUse.mallocAlignedBuffer<T>(*requiredCapacity, internal::ARRAY_LIST_SIMD_T_MALLOC_ALIGN).ok();
-				// Likely dont need to memset cause no constructor tomfoolery
-				//memset(outBuffer, 0, (*requiredCapacity) * sizeof(T));
-				return outBuffer;
+			T* outBuffer = allocatorToUse.template mallocBuffer<T>(*requiredCapacity).ok();
+			if constexpr (!IS_T_SIMD) {
+				// Likely dont need to memset SIMD types cause no constructor tomfoolery
+				memset(outBuffer, 0, (*requiredCapacity) * sizeof(T));
 			}
-
-			outBuffer = allocatorToUse.mallocBuffer<T>(*requiredCapacity).ok();
-			memset(outBuffer, 0, (*requiredCapacity) * sizeof(T));
 			return outBuffer;
 		}
 
-		constexpr static void freeArrayListBuffer(T*& buffer, usize bufferCapacity, AllocatorRef& allocatorToUse) {
+		constexpr static void freeArrayListBuffer(T*& buffer, usize bufferCapacity, Allocator& allocatorToUse) {
 			if (std::is_constant_evaluated()) {
 				delete[] buffer;
 				return;
 			}
 
-			if constexpr (IS_T_SIMD) {
-				allocatorToUse.freeAlignedBuffer(buffer, bufferCapacity, internal::ARRAY_LIST_SIMD_T_MALLOC_ALIGN);
-				return;
-			}
 			allocatorToUse.freeBuffer(buffer, bufferCapacity);
 		}
 
+		/**
+		* Asks the allocator to resize the existing buffer rather than allocating a new one.
+		* Any T can be resized in place, see `IAllocator::tryResizeAlignedBuffer()`.
+		* Trivially relocatable T can also be moved by the allocator, see `IAllocator::tryReallocAlignedBuffer()`.
+		* @return If the buffer was resized. If false, `_data` is unchanged.
+		*/
+		bool tryReallocateExistingBuffer(usize* requiredCapacity) {
+			if (_data == nullptr) {
+				return false;
+			}
+
+			const usize capacity = *requiredCapacity;
+			constexpr usize alignment = alignof(T);
+
+			if (_allocator.template tryResizeAlignedBuffer<T>(_data, _capacity, capacity, alignment)) {
+				*requiredCapacity = capacity;
+				return true;
+			}
+
+			if constexpr (IS_T_RELOCATABLE) {
+				Option<T*> reallocResult = _allocator.template tryReallocAlignedBuffer<T>(_data, _capacity, capacity, alignment);
+				if (reallocResult.isSome()) {
+					_data = reallocResult.someCopy();
+					*requiredCapacity = capacity;
+					return true;
+				}
+			}
+			return false;
+		}
+
 		constexpr void reallocate(usize capacity) {
+			if (!std::is_constant_evaluated()) {
+				if (tryReallocateExistingBuffer(&capacity)) {
+					if constexpr (!IS_T_SIMD) {
+						// Keep the same guarantee as mallocArrayListBuffer() of unused capacity being 0 initialized.
+						if (capacity > _capacity) {
+							memset((void*)(_data + _capacity), 0, (capacity - _capacity) * sizeof(T));
+						}
+					}
+					_capacity = capacity;
+					return;
+				}
+			}
+
 			const usize currentLength = _length;
 			T* newData = mallocArrayListBuffer(&capacity, _allocator);
 
-			for (usize i = 0; i < currentLength; i++) {
-				// TODO see if assignment is better.
-				if (std::is_constant_evaluated()) {
-					newData[i] = std::move(_data[i]);
-					//_data[i] = T(); // ensure upon delete[], no weird destructor stuff happens.
+			if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+				if (currentLength > 0) {
+					memcpy((void*)newData, (const void*)_data, currentLength * sizeof(T));
 				}
-				else {
-					new (newData + i) T(std::move(_data[i]));
+			}
+			else {
+				for (usize i = 0; i < currentLength; i++) {
+					// TODO see if assignment is better.
+					if (std::is_constant_evaluated()) {
+						newData[i] = std::move(_data[i]);
+						//_data[i] = T(); // ensure upon delete[], no weird destructor stuff happens.
+					}
+					else {
+						new (newData + i) T(std::move(_data[i]));
+					}
 				}
 			}
 			if (_data != nullptr) {
@@ -918,9 +1182,16 @@ namespace gk
 		T* _data;
 		usize _length;
 		usize _capacity;
-		AllocatorRef _allocator;
+		no_unique_address_member Allocator _allocator;
 		
 	}; // struct ArrayList
+
+	template<typename T, typename Allocator>
+	struct is_trivially_relocatable<ArrayList<T, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+	/// ArrayList that always uses the global heap, without virtual dispatch or ref counting.
+	template<typename T>
+	using GlobalHeapArrayList = ArrayList<T, GlobalHeapStaticAllocator>;
 } // namespace gk
 
 template<typename T>
@@ -1231,18 +1502,136 @@ inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::find(const T&
 	return internal::doSimdArrayElementFind(this->_data, this->_length, element);
 }
 
+template<typename T>
+inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::findLast(const T& element) const
+{
+	return internal::arrayFindLast(this->_data, this->_length, element);
+}
+
+template<typename T>
+inline constexpr gk::usize gk::ArrayListUnmanaged<T>::count(const T& element) const
+{
+	return internal::arrayCount(this->_data, this->_length, element);
+}
+
+template<typename T>
+inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::findIf(ArrayCompare compare, T value) const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayFindIf(this->_data, this->_length, compare, value);
+}
+
+template<typename T>
+inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::findInRange(T low, T high) const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayFindInRange(this->_data, this->_length, low, high);
+}
+
+template<typename T>
+inline constexpr gk::usize gk::ArrayListUnmanaged<T>::countIf(ArrayCompare compare, T value) const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayCountIf(this->_data, this->_length, compare, value);
+}
+
+template<typename T>
+inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::findAnyOf(const T* values, usize valuesLength) const requires gk::internal::SimdArrayElement<T>
+{
+	if (valuesLength > 0) {
+		check_message(values != nullptr, "Values to find cannot be null unless there are no values");
+	}
+	return internal::arrayFindAnyOf(this->_data, this->_length, values, valuesLength);
+}
+
+template<typename T>
+inline constexpr bool gk::ArrayListUnmanaged<T>::containsAnyOf(const T* values, usize valuesLength) const requires gk::internal::SimdArrayElement<T>
+{
+	return findAnyOf(values, valuesLength).isSome();
+}
+
+template<typename T>
+inline constexpr gk::Option<T> gk::ArrayListUnmanaged<T>::min() const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayMin(this->_data, this->_length);
+}
+
+template<typename T>
+inline constexpr gk::Option<T> gk::ArrayListUnmanaged<T>::max() const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayMax(this->_data, this->_length);
+}
+
+template<typename T>
+inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::argMin() const requires gk::internal::SimdArrayElement<T>
+{
+	gk::Option<T> minElement = min();
+	if (minElement.none()) {
+		return gk::Option<usize>();
+	}
+	return findIf(ArrayCompare::Equal, minElement.someCopy());
+}
+
+template<typename T>
+inline constexpr gk::Option<gk::usize> gk::ArrayListUnmanaged<T>::argMax() const requires gk::internal::SimdArrayElement<T>
+{
+	gk::Option<T> maxElement = max();
+	if (maxElement.none()) {
+		return gk::Option<usize>();
+	}
+	return findIf(ArrayCompare::Equal, maxElement.someCopy());
+}
+
+template<typename T>
+inline constexpr gk::internal::ArraySumT<T> gk::ArrayListUnmanaged<T>::sum() const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arraySum(this->_data, this->_length);
+}
+
+template<typename T>
+inline constexpr void gk::ArrayListUnmanaged<T>::sort(IAllocator* allocator)
+{
+	check_message(this->isValidAllocator(allocator), "Allocator passed is invalid. For constexpr, must be null. For runtime, must be non-null, and the same allocator used on this instance previously");
+	internal::sortAscending(this->_data, this->_length, allocator);
+}
+
+template<typename T>
+template<typename Less>
+inline constexpr void gk::ArrayListUnmanaged<T>::sortBy(Less less)
+{
+	internal::patternDefeatingQuickSort(this->_data, this->_length, less);
+}
+
+template<typename T>
+inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::stableSort(IAllocator* allocator)
+{
+	check_message(this->isValidAllocator(allocator), "Allocator passed is invalid. For constexpr, must be null. For runtime, must be non-null, and the same allocator used on this instance previously");
+	return internal::stableSortAscending(this->_data, this->_length, allocator);
+}
+
+template<typename T>
+template<typename Less>
+inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::stableSortBy(IAllocator* allocator, Less less)
+{
+	check_message(this->isValidAllocator(allocator), "Allocator passed is invalid. For constexpr, must be null. For runtime, must be non-null, and the same allocator used on this instance previously");
+	return internal::stableSortBy(this->_data, this->_length, allocator, less);
+}
+
 template<typename T>
 inline constexpr T gk::ArrayListUnmanaged<T>::removeOrdered(const usize index)
 {
 	check_message(index < this->_length, "Index out of bounds! Attempted to removed element index ", index, " from array of length ", this->_length);
 
 	T temp = std::move(this->_data[index]);
-	for (usize i = index; i < _length - 1; i++) {
-		if (std::is_constant_evaluated()) {
-			this->_data[i] = std::move(this->_data[i + 1]);
-		}
-		else {
-			new (this->_data + i) T(std::move(this->_data[i + 1]));
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		this->_data[index].~T();
+		memmove((void*)(this->_data + index), (const void*)(this->_data + index + 1), (this->_length - index - 1) * sizeof(T));
+	}
+	else {
+		for (usize i = index; i < _length - 1; i++) {
+			if (std::is_constant_evaluated()) {
+				this->_data[i] = std::move(this->_data[i + 1]);
+			}
+			else {
+				new (this->_data + i) T(std::move(this->_data[i + 1]));
+			}
 		}
 	}
 
@@ -1284,15 +1673,20 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::ins
 		}
 	}
 
-	usize i = this->_length;
-	while (i > index) {
-		if (std::is_constant_evaluated()) {
-			this->_data[i] = std::move(this->_data[i - 1]);
-		}
-		else {
-			new (this->_data + i) T(std::move(this->_data[i - 1]));
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		memmove((void*)(this->_data + index + 1), (const void*)(this->_data + index), (this->_length - index) * sizeof(T));
+	}
+	else {
+		usize i = this->_length;
+		while (i > index) {
+			if (std::is_constant_evaluated()) {
+				this->_data[i] = std::move(this->_data[i - 1]);
+			}
+			else {
+				new (this->_data + i) T(std::move(this->_data[i - 1]));
+			}
+			i--;
 		}
-		i--;
 	}
 
 	if (std::is_constant_evaluated()) {
@@ -1320,15 +1714,20 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::ins
 		}
 	}
 
-	usize i = this->_length;
-	while (i > index) {
-		if (std::is_constant_evaluated()) {
-			this->_data[i] = std::move(this->_data[i - 1]);
-		}
-		else {
-			new (this->_data + i) T(std::move(this->_data[i - 1]));
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		memmove((void*)(this->_data + index + 1), (const void*)(this->_data + index), (this->_length - index) * sizeof(T));
+	}
+	else {
+		usize i = this->_length;
+		while (i > index) {
+			if (std::is_constant_evaluated()) {
+				this->_data[i] = std::move(this->_data[i - 1]);
+			}
+			else {
+				new (this->_data + i) T(std::move(this->_data[i - 1]));
+			}
+			i--;
 		}
-		i--;
 	}
 
 	if (std::is_constant_evaluated()) {
@@ -1453,12 +1852,19 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::app
 		}
 	}
 
-	for (usize i = 0; i < other._length; i++) {
-		if (std::is_constant_evaluated()) {
-			this->_data[this->_length + i] = other[i];
+	if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+		if (other._length > 0) {
+			memcpy((void*)(this->_data + this->_length), (const void*)other._data, other._length * sizeof(T));
 		}
-		else {
-			new (this->_data + this->_length + i) T(other[i]);
+	}
+	else {
+		for (usize i = 0; i < other._length; i++) {
+			if (std::is_constant_evaluated()) {
+				this->_data[this->_length + i] = other[i];
+			}
+			else {
+				new (this->_data + this->_length + i) T(other[i]);
+			}
 		}
 	}
 	this->_length = this->_length + other._length;
@@ -1477,15 +1883,22 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::app
 		}
 	}
 
-	usize i = 0;
-	for (const auto& elem : initializerList) {
-		if (std::is_constant_evaluated()) {
-			this->_data[this->_length + i] = elem;
+	if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+		if (initializerList.size() > 0) {
+			memcpy((void*)(this->_data + this->_length), (const void*)initializerList.begin(), initializerList.size() * sizeof(T));
 		}
-		else {
-			new (this->_data + this->_length + i) T(elem);
+	}
+	else {
+		usize i = 0;
+		for (const auto& elem : initializerList) {
+			if (std::is_constant_evaluated()) {
+				this->_data[this->_length + i] = elem;
+			}
+			else {
+				new (this->_data + this->_length + i) T(elem);
+			}
+			i++;
 		}
-		i++;
 	}
 	this->_length = this->_length + initializerList.size();
 	return ResultOk<void>();
@@ -1505,12 +1918,19 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::app
 		}
 	}
 
-	for (usize i = 0; i < elementsToCopy; i++) {
-		if (std::is_constant_evaluated()) {
-			this->_data[this->_length + i] = buffer[i];
+	if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+		if (elementsToCopy > 0) {
+			memcpy((void*)(this->_data + this->_length), (const void*)buffer, elementsToCopy * sizeof(T));
 		}
-		else {
-			new (this->_data + this->_length + i) T(buffer[i]);
+	}
+	else {
+		for (usize i = 0; i < elementsToCopy; i++) {
+			if (std::is_constant_evaluated()) {
+				this->_data[this->_length + i] = buffer[i];
+			}
+			else {
+				new (this->_data + this->_length + i) T(buffer[i]);
+			}
 		}
 	}
 	this->_length = this->_length + elementsToCopy;
@@ -1572,6 +1992,13 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::rea
 	const usize currentLength = this->_length;
 
 	usize actualAllocCapacity = minCapacity;
+	if (!std::is_constant_evaluated() && this->_data != nullptr) {
+		if (allocator->tryResizeAlignedBuffer<T>(this->_data, this->_capacity, actualAllocCapacity, alignof(T))) {
+			this->_capacity = actualAllocCapacity;
+			return ResultOk<void>();
+		}
+	}
+
 	Result<T*, AllocError> res = mallocBuffer(allocator, &actualAllocCapacity);
 	if (res.isError()) {
 		return ResultErr<AllocError>(res.error());
@@ -1579,13 +2006,20 @@ inline constexpr gk::Result<void, gk::AllocError> gk::ArrayListUnmanaged<T>::rea
 
 	T* newData = res.ok();
 
-	for (usize i = 0; i < currentLength; i++) {
-		if (std::is_constant_evaluated()) {
-			newData[i] = std::move(this->_data[i]);
-			//_data[i] = T(); // ensure upon delete[], no weird destructor stuff happens.
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		if (currentLength > 0) {
+			memcpy((void*)newData, (const void*)this->_data, currentLength * sizeof(T));
 		}
-		else {
-			new (newData + i) T(std::move(this->_data[i]));
+	}
+	else {
+		for (usize i = 0; i < currentLength; i++) {
+			if (std::is_constant_evaluated()) {
+				newData[i] = std::move(this->_data[i]);
+				//_data[i] = T(); // ensure upon delete[], no weird destructor stuff happens.
+			}
+			else {
+				new (newData + i) T(std::move(this->_data[i]));
+			}
 		}
 	}
 	if (this->_data != nullptr) {
@@ -1605,16 +2039,6 @@ inline constexpr gk::Result<T*, gk::AllocError> gk::ArrayListUnmanaged<T>::mallo
 		return gk::ResultOk<T*>(new T[capacity]);
 	}
 
-	if constexpr (IS_T_SIMD) {
-		constexpr usize numPerSimd = 64 / sizeof(T);
-		const usize remainder = *requiredCapacity % numPerSimd;
-		if (remainder != 0) {
-			*requiredCapacity = *requiredCapacity + (numPerSimd - remainder);
-		}
-
-		return allocator->mallocAlignedBuffer<T>(*requiredCapacity, internal::ARRAY_LIST_SIMD_T_MALLOC_ALIGN);
-	}
-
 	return allocator->mallocBuffer<T>(*requiredCapacity);
 }
 
@@ -1627,10 +2051,6 @@ inline constexpr void gk::ArrayListUnmanaged<T>::freeBuffer(IAllocator* allocato
 		return;
 	}
 
-	if constexpr (IS_T_SIMD) {
-		allocator->freeAlignedBuffer(buffer, bufferCapacity, internal::ARRAY_LIST_SIMD_T_MALLOC_ALIGN);
-		return;
-	}
 	allocator->freeBuffer(buffer, bufferCapacity);
 }
 
@@ -1693,13 +2113,13 @@ inline constexpr gk::ArrayListUnmanaged<T>::ReverseConstIterator gk::ArrayListUn
 	return ReverseConstIterator(this->data());
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ArrayList()
-	: _data(nullptr), _length(0), _capacity(0), _allocator(internal::arrayListDefaultAllocator())
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ArrayList()
+	: _data(nullptr), _length(0), _capacity(0), _allocator(internal::arrayListDefaultAllocator<Allocator>())
 {}
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ArrayList(const ArrayList& other)
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ArrayList(const ArrayList& other)
 	: _length(other._length), _allocator(other._allocator)
 {
 	if (_length == 0) {
@@ -1717,21 +2137,21 @@ inline constexpr gk::ArrayList<T>::ArrayList(const ArrayList& other)
 	}
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ArrayList(ArrayList&& other) noexcept
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ArrayList(ArrayList&& other) noexcept
 	: _data(other._data), _length(other._length), _capacity(other._capacity), _allocator(std::move(other._allocator))
 {
 	other._data = nullptr;
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::~ArrayList()
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::~ArrayList()
 {
 	deleteExistingBuffer();
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>& gk::ArrayList<T>::operator=(const ArrayList& other)
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>& gk::ArrayList<T, Allocator>::operator=(const ArrayList& other)
 {
 	deleteExistingBuffer();
 	check_eq(_data, nullptr);
@@ -1753,8 +2173,8 @@ inline constexpr gk::ArrayList<T>& gk::ArrayList<T>::operator=(const ArrayList&
 	return *this;
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>& gk::ArrayList<T>::operator=(ArrayList&& other) noexcept
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>& gk::ArrayList<T, Allocator>::operator=(ArrayList&& other) noexcept
 {
 	deleteExistingBuffer();
 	_data = other._data;
@@ -1765,8 +2185,8 @@ inline constexpr gk::ArrayList<T>& gk::ArrayList<T>::operator=(ArrayList&& other
 	return *this;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::initCopy(AllocatorRef&& inAllocator, const ArrayList& other)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::initCopy(Allocator&& inAllocator, const ArrayList& other)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 	out._length = other._length;
@@ -1785,8 +2205,8 @@ inline gk::ArrayList<T> gk::ArrayList<T>::initCopy(AllocatorRef&& inAllocator, c
 	return out;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::initList(AllocatorRef&& inAllocator, const std::initializer_list<T>& initializerList)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::initList(Allocator&& inAllocator, const std::initializer_list<T>& initializerList)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 	out._length = initializerList.size();
@@ -1808,8 +2228,8 @@ inline gk::ArrayList<T> gk::ArrayList<T>::initList(AllocatorRef&& inAllocator, c
 	return out;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::initBufferCopy(AllocatorRef&& inAllocator, const T* buffer, usize elementsToCopy)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::initBufferCopy(Allocator&& inAllocator, const T* buffer, usize elementsToCopy)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 
@@ -1830,8 +2250,8 @@ inline gk::ArrayList<T> gk::ArrayList<T>::initBufferCopy(AllocatorRef&& inAlloca
 	return out;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::withCapacity(AllocatorRef&& inAllocator, usize minCapacity)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::withCapacity(Allocator&& inAllocator, usize minCapacity)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 	if (minCapacity == 0) [[unlikely]] {
@@ -1843,8 +2263,8 @@ inline gk::ArrayList<T> gk::ArrayList<T>::withCapacity(AllocatorRef&& inAllocato
 	return out;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::withCapacityCopy(AllocatorRef&& inAllocator, usize minCapacity, const ArrayList& other)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::withCapacityCopy(Allocator&& inAllocator, usize minCapacity, const ArrayList& other)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 	out._length = other._length;
@@ -1864,8 +2284,8 @@ inline gk::ArrayList<T> gk::ArrayList<T>::withCapacityCopy(AllocatorRef&& inAllo
 	return out;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::withCapacityList(AllocatorRef&& inAllocator, usize minCapacity, const std::initializer_list<T>& initializerList)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::withCapacityList(Allocator&& inAllocator, usize minCapacity, const std::initializer_list<T>& initializerList)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 	out._length = initializerList.size();
@@ -1888,8 +2308,8 @@ inline gk::ArrayList<T> gk::ArrayList<T>::withCapacityList(AllocatorRef&& inAllo
 	return out;
 }
 
-template<typename T>
-inline gk::ArrayList<T> gk::ArrayList<T>::withCapacityBufferCopy(AllocatorRef&& inAllocator, usize minCapacity, const T* buffer, usize elementsToCopy)
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ArrayList<T, Allocator>::withCapacityBufferCopy(Allocator&& inAllocator, usize minCapacity, const T* buffer, usize elementsToCopy)
 {
 	ArrayList out = ArrayList(std::move(inAllocator));
 	out._length = elementsToCopy;
@@ -1910,22 +2330,22 @@ inline gk::ArrayList<T> gk::ArrayList<T>::withCapacityBufferCopy(AllocatorRef&&
 	return out;
 }
 
-template<typename T>
-inline constexpr T& gk::ArrayList<T>::operator[](usize index)
+template<typename T, typename Allocator>
+inline constexpr T& gk::ArrayList<T, Allocator>::operator[](usize index)
 {
 	check_message(index < _length, "Index out of bounds! Attempted to access index ", index, " from ArrayList of length ", _length);
 	return _data[index];
 }
 
-template<typename T>
-inline constexpr const T& gk::ArrayList<T>::operator[](usize index) const
+template<typename T, typename Allocator>
+inline constexpr const T& gk::ArrayList<T, Allocator>::operator[](usize index) const
 {
 	check_message(index < _length, "Index out of bounds! Attempted to access index ", index, " from ArrayList of length ", _length);
 	return _data[index];
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::push(const T& element)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::push(const T& element)
 {
 	if (_length == _capacity) {
 		reallocate((_capacity + 1) * 2);
@@ -1940,8 +2360,8 @@ inline constexpr void gk::ArrayList<T>::push(const T& element)
 	_length++;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::push(T&& element)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::push(T&& element)
 {
 	if (_length == _capacity) {
 		reallocate((_capacity + 1) * 2);
@@ -1956,8 +2376,8 @@ inline constexpr void gk::ArrayList<T>::push(T&& element)
 	_length++;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::reserve(usize additional)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::reserve(usize additional)
 {
 	const usize addedLength = _length + additional;
 	if (addedLength <= _capacity || addedLength == 0) return;
@@ -1968,8 +2388,8 @@ inline constexpr void gk::ArrayList<T>::reserve(usize additional)
 	reallocate(newCapacity);
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::reserveExact(usize additional)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::reserveExact(usize additional)
 {
 	const usize newCapacity = _length + additional;
 	if (newCapacity <= _capacity || newCapacity == 0) return;
@@ -1977,8 +2397,8 @@ inline constexpr void gk::ArrayList<T>::reserveExact(usize additional)
 	reallocate(newCapacity);
 }
 
-template<typename T>
-inline constexpr gk::Option<gk::usize> gk::ArrayList<T>::find(const T& element) const
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::find(const T& element) const
 {
 	if (std::is_constant_evaluated() || !IS_T_SIMD) { // constexpr and/or NOT simd
 		for (usize i = 0; i < _length; i++) {
@@ -1992,18 +2412,135 @@ inline constexpr gk::Option<gk::usize> gk::ArrayList<T>::find(const T& element)
 	return internal::doSimdArrayElementFind(_data, _length, element);
 }
 
-template<typename T>
-inline constexpr T gk::ArrayList<T>::remove(usize index)
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::findLast(const T& element) const
+{
+	return internal::arrayFindLast(_data, _length, element);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::usize gk::ArrayList<T, Allocator>::count(const T& element) const
+{
+	return internal::arrayCount(_data, _length, element);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::findIf(ArrayCompare compare, T value) const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayFindIf(_data, _length, compare, value);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::findInRange(T low, T high) const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayFindInRange(_data, _length, low, high);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::usize gk::ArrayList<T, Allocator>::countIf(ArrayCompare compare, T value) const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayCountIf(_data, _length, compare, value);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::findAnyOf(const T* values, usize valuesLength) const requires gk::internal::SimdArrayElement<T>
+{
+	if (valuesLength > 0) {
+		check_message(values != nullptr, "Values to find cannot be null unless there are no values");
+	}
+	return internal::arrayFindAnyOf(_data, _length, values, valuesLength);
+}
+
+template<typename T, typename Allocator>
+inline constexpr bool gk::ArrayList<T, Allocator>::containsAnyOf(const T* values, usize valuesLength) const requires gk::internal::SimdArrayElement<T>
+{
+	return findAnyOf(values, valuesLength).isSome();
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<T> gk::ArrayList<T, Allocator>::min() const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayMin(_data, _length);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<T> gk::ArrayList<T, Allocator>::max() const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arrayMax(_data, _length);
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::argMin() const requires gk::internal::SimdArrayElement<T>
+{
+	gk::Option<T> minElement = min();
+	if (minElement.none()) {
+		return gk::Option<usize>();
+	}
+	return findIf(ArrayCompare::Equal, minElement.someCopy());
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::Option<gk::usize> gk::ArrayList<T, Allocator>::argMax() const requires gk::internal::SimdArrayElement<T>
+{
+	gk::Option<T> maxElement = max();
+	if (maxElement.none()) {
+		return gk::Option<usize>();
+	}
+	return findIf(ArrayCompare::Equal, maxElement.someCopy());
+}
+
+template<typename T, typename Allocator>
+inline constexpr gk::internal::ArraySumT<T> gk::ArrayList<T, Allocator>::sum() const requires gk::internal::SimdArrayElement<T>
+{
+	return internal::arraySum(_data, _length);
+}
+
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::sort()
+{
+	internal::sortAscending(_data, _length, &_allocator);
+}
+
+template<typename T, typename Allocator>
+template<typename Less>
+inline constexpr void gk::ArrayList<T, Allocator>::sortBy(Less less)
+{
+	internal::patternDefeatingQuickSort(_data, _length, less);
+}
+
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::stableSort()
+{
+	Result<void, AllocError> result = internal::stableSortAscending(_data, _length, &_allocator);
+	check_message(result.isOk(), "Failed to allocate the temporary buffer for a stable sort");
+}
+
+template<typename T, typename Allocator>
+template<typename Less>
+inline constexpr void gk::ArrayList<T, Allocator>::stableSortBy(Less less)
+{
+	Result<void, AllocError> result = internal::stableSortBy(_data, _length, &_allocator, less);
+	check_message(result.isOk(), "Failed to allocate the temporary buffer for a stable sort");
+}
+
+template<typename T, typename Allocator>
+inline constexpr T gk::ArrayList<T, Allocator>::remove(usize index)
 {
 	check_message(index < _length, "Index out of bounds! Attempted to removed element index ", index, " from ArrayList of length ", _length);
 
 	T temp = std::move(_data[index]);
-	for (usize i = index; i < _length - 1; i++) {
-		if (std::is_constant_evaluated()) {
-			_data[i] = std::move(_data[i + 1]);
-		}
-		else {
-			new (_data + i) T(std::move(_data[i + 1]));
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		_data[index].~T();
+		memmove((void*)(_data + index), (const void*)(_data + index + 1), (_length - index - 1) * sizeof(T));
+	}
+	else {
+		for (usize i = index; i < _length - 1; i++) {
+			if (std::is_constant_evaluated()) {
+				_data[i] = std::move(_data[i + 1]);
+			}
+			else {
+				new (_data + i) T(std::move(_data[i + 1]));
+			}
 		}
 	}
 
@@ -2011,8 +2548,8 @@ inline constexpr T gk::ArrayList<T>::remove(usize index)
 	return temp;
 }
 
-template<typename T>
-inline constexpr T gk::ArrayList<T>::removeSwap(usize index)
+template<typename T, typename Allocator>
+inline constexpr T gk::ArrayList<T, Allocator>::removeSwap(usize index)
 {
 	check_message(index < _length, "Index out of bounds! Attempted to removed element index ", index, " from ArrayList of length ", _length);
 
@@ -2030,8 +2567,8 @@ inline constexpr T gk::ArrayList<T>::removeSwap(usize index)
 	return temp;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::insert(usize index, const T& element)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::insert(usize index, const T& element)
 {
 	check_message(index <= _length, "Index out of bounds! Attempted to removed element index ", index, " from ArrayList of length ", _length);
 
@@ -2040,15 +2577,20 @@ inline constexpr void gk::ArrayList<T>::insert(usize index, const T& element)
 		reallocate((_capacity + 1) * 2);
 	}
 
-	usize i = _length;
-	while (i > index) {
-		if (std::is_constant_evaluated()) {
-			_data[i] = std::move(_data[i - 1]);
-		}
-		else {
-			new (_data + i) T(std::move(_data[i - 1]));
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		memmove((void*)(_data + index + 1), (const void*)(_data + index), (_length - index) * sizeof(T));
+	}
+	else {
+		usize i = _length;
+		while (i > index) {
+			if (std::is_constant_evaluated()) {
+				_data[i] = std::move(_data[i - 1]);
+			}
+			else {
+				new (_data + i) T(std::move(_data[i - 1]));
+			}
+			i--;
 		}
-		i--;
 	}
 
 	if (std::is_constant_evaluated()) {
@@ -2060,8 +2602,8 @@ inline constexpr void gk::ArrayList<T>::insert(usize index, const T& element)
 	_length++;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::insert(usize index, T&& element)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::insert(usize index, T&& element)
 {
 	check_message(index <= _length, "Index out of bounds! Attempted to removed element index ", index, " from ArrayList of length ", _length);
 
@@ -2070,15 +2612,20 @@ inline constexpr void gk::ArrayList<T>::insert(usize index, T&& element)
 		reallocate((_capacity + 1) * 2);
 	}
 
-	usize i = _length;
-	while (i > index) {
-		if (std::is_constant_evaluated()) {
-			_data[i] = std::move(_data[i - 1]);
-		}
-		else {
-			new (_data + i) T(std::move(_data[i - 1]));
+	if (!std::is_constant_evaluated() && IS_T_RELOCATABLE) {
+		memmove((void*)(_data + index + 1), (const void*)(_data + index), (_length - index) * sizeof(T));
+	}
+	else {
+		usize i = _length;
+		while (i > index) {
+			if (std::is_constant_evaluated()) {
+				_data[i] = std::move(_data[i - 1]);
+			}
+			else {
+				new (_data + i) T(std::move(_data[i - 1]));
+			}
+			i--;
 		}
-		i--;
 	}
 
 	if (std::is_constant_evaluated()) {
@@ -2090,8 +2637,8 @@ inline constexpr void gk::ArrayList<T>::insert(usize index, T&& element)
 	_length++;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::insertSwap(usize index, const T& element)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::insertSwap(usize index, const T& element)
 {
 	check_message(index <= _length, "Index out of bounds! Attempted to removed element index ", index, " from ArrayList of length ", _length);
 
@@ -2116,8 +2663,8 @@ inline constexpr void gk::ArrayList<T>::insertSwap(usize index, const T& element
 	_length++;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::insertSwap(usize index, T&& element)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::insertSwap(usize index, T&& element)
 {
 	check_message(index <= _length, "Index out of bounds! Attempted to removed element index ", index, " from ArrayList of length ", _length);
 
@@ -2142,14 +2689,14 @@ inline constexpr void gk::ArrayList<T>::insertSwap(usize index, T&& element)
 	_length++;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::shrinkToFit()
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::shrinkToFit()
 {
 	reallocate(_length);
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::shrinkTo(usize minCapacity)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::shrinkTo(usize minCapacity)
 {
 	if (minCapacity > _length) {
 		reallocate(minCapacity);
@@ -2159,8 +2706,8 @@ inline constexpr void gk::ArrayList<T>::shrinkTo(usize minCapacity)
 	}
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::truncate(usize newLength)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::truncate(usize newLength)
 {
 	if (newLength >= _length) {
 		return;
@@ -2175,46 +2722,60 @@ inline constexpr void gk::ArrayList<T>::truncate(usize newLength)
 	_length = newLength;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::appendCopy(const ArrayList& other)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::appendCopy(const ArrayList& other)
 {
 	if (_length + other._length >= _capacity) {
 		reallocate(gk::upperPowerOfTwo(_length + other._length));
 	}
 
-	for (usize i = 0; i < other._length; i++) {
-		if (std::is_constant_evaluated()) {
-			_data[_length + i] = other[i];
+	if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+		if (other._length > 0) {
+			memcpy((void*)(_data + _length), (const void*)other._data, other._length * sizeof(T));
 		}
-		else {
-			new (_data + _length + i) T(other[i]);
+	}
+	else {
+		for (usize i = 0; i < other._length; i++) {
+			if (std::is_constant_evaluated()) {
+				_data[_length + i] = other[i];
+			}
+			else {
+				new (_data + _length + i) T(other[i]);
+			}
 		}
 	}
 	_length = _length + other._length;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::appendList(const std::initializer_list<T>& initializerList)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::appendList(const std::initializer_list<T>& initializerList)
 {
 	if (_length + initializerList.size() >= _capacity) {
 		reallocate(gk::upperPowerOfTwo(_length + initializerList.size()));
 	}
 
-	usize i = 0;
-	for (const auto& elem : initializerList) {
-		if (std::is_constant_evaluated()) {
-			_data[_length + i] = elem;
+	if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+		if (initializerList.size() > 0) {
+			memcpy((void*)(_data + _length), (const void*)initializerList.begin(), initializerList.size() * sizeof(T));
 		}
-		else {
-			new (_data + _length + i) T(elem);
+	}
+	else {
+		usize i = 0;
+		for (const auto& elem : initializerList) {
+			if (std::is_constant_evaluated()) {
+				_data[_length + i] = elem;
+			}
+			else {
+				new (_data + _length + i) T(elem);
+			}
+			i++;
 		}
-		i++;
 	}
 	_length = _length + initializerList.size();
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::appendBufferCopy(const T* buffer, usize elementsToCopy)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::appendBufferCopy(const T* buffer, usize elementsToCopy)
 {
 	check_ne(buffer, nullptr);
 
@@ -2222,19 +2783,26 @@ inline constexpr void gk::ArrayList<T>::appendBufferCopy(const T* buffer, usize
 		reallocate(gk::upperPowerOfTwo(_length + elementsToCopy));
 	}
 
-	for (usize i = 0; i < elementsToCopy; i++) {
-		if (std::is_constant_evaluated()) {
-			_data[_length + i] = buffer[i];
+	if (!std::is_constant_evaluated() && std::is_trivially_copyable_v<T>) {
+		if (elementsToCopy > 0) {
+			memcpy((void*)(_data + _length), (const void*)buffer, elementsToCopy * sizeof(T));
 		}
-		else {
-			new (_data + _length + i) T(buffer[i]);
+	}
+	else {
+		for (usize i = 0; i < elementsToCopy; i++) {
+			if (std::is_constant_evaluated()) {
+				_data[_length + i] = buffer[i];
+			}
+			else {
+				new (_data + _length + i) T(buffer[i]);
+			}
 		}
 	}
 	_length = _length + elementsToCopy;
 }
 
-template<typename T>
-inline constexpr void gk::ArrayList<T>::resize(usize newLength, const T& fill)
+template<typename T, typename Allocator>
+inline constexpr void gk::ArrayList<T, Allocator>::resize(usize newLength, const T& fill)
 {
 	if (newLength == _length) {
 		return;
@@ -2260,50 +2828,50 @@ inline constexpr void gk::ArrayList<T>::resize(usize newLength, const T& fill)
 	_length = newLength;
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::Iterator gk::ArrayList<T>::begin()
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::Iterator gk::ArrayList<T, Allocator>::begin()
 {
 	return Iterator(_data);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::Iterator gk::ArrayList<T>::end()
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::Iterator gk::ArrayList<T, Allocator>::end()
 {
 	return Iterator(_data + _length);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ConstIterator gk::ArrayList<T>::begin() const
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ConstIterator gk::ArrayList<T, Allocator>::begin() const
 {
 	return ConstIterator(_data);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ConstIterator gk::ArrayList<T>::end() const
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ConstIterator gk::ArrayList<T, Allocator>::end() const
 {
 	return ConstIterator(_data + _length);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ReverseIterator gk::ArrayList<T>::rbegin()
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ReverseIterator gk::ArrayList<T, Allocator>::rbegin()
 {
 	return ReverseIterator(_data + _length);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ReverseIterator gk::ArrayList<T>::rend()
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ReverseIterator gk::ArrayList<T, Allocator>::rend()
 {
 	return ReverseIterator(_data);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ReverseConstIterator gk::ArrayList<T>::rbegin() const
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ReverseConstIterator gk::ArrayList<T, Allocator>::rbegin() const
 {
 	return ReverseConstIterator(_data + _length);
 }
 
-template<typename T>
-inline constexpr gk::ArrayList<T>::ReverseConstIterator gk::ArrayList<T>::rend() const
+template<typename T, typename Allocator>
+inline constexpr gk::ArrayList<T, Allocator>::ReverseConstIterator gk::ArrayList<T, Allocator>::rend() const
 {
 	return ReverseConstIterator(_data);
 }
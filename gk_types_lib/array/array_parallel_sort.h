@@ -0,0 +1,200 @@
+#pragma once
+
+#include "array_list.h"
+#include "../job/job_system.h"
+#include "../cpu_features/cpu_feature_detector.h"
+#include <atomic>
+#include <thread>
+
+namespace gk
+{
+	namespace internal
+	{
+		/// Below this, parallel sorts run on the calling thread.
+		constexpr usize PARALLEL_SORT_THRESHOLD = 1 << 16;
+		/// Minimum number of elements sorted by each job.
+		constexpr usize PARALLEL_SORT_MIN_CHUNK_LENGTH = 1 << 14;
+
+		/// One chunk sort or merge of a parallel sort, run as a job.
+		template<typename T, typename Less>
+		struct ParallelSortJob
+		{
+			T* data;
+			T* buffer;
+			usize low;
+			usize mid;
+			usize high;
+			const Less* less;
+			std::atomic<usize>* remainingJobs;
+		};
+
+		/// Sorts [low, high), using the buffer starting at `low`.
+		template<typename T, typename Less, bool USE_RADIX>
+		void runParallelSortChunkJob(ParallelSortJob<T, Less>* job) {
+			if constexpr (USE_RADIX) {
+				radixSort(job->data + job->low, job->high - job->low, job->buffer + job->low);
+			}
+			else {
+				Less less = *job->less;
+				mergeSort(job->data + job->low, job->high - job->low, job->buffer + job->low, less);
+			}
+			job->remainingJobs->fetch_sub(1, std::memory_order::release);
+		}
+
+		/// Merges the sorted [low, mid) and [mid, high), using the buffer starting at `low`.
+		template<typename T, typename Less>
+		void runParallelSortMergeJob(ParallelSortJob<T, Less>* job) {
+			Less less = *job->less;
+			mergeSortedRanges(job->data, job->low, job->mid, job->high, job->buffer + job->low, less);
+			job->remainingJobs->fetch_sub(1, std::memory_order::release);
+		}
+
+		/// Spins until every job of a sort stage has finished.
+		/// Must not be called from a worker thread of the job system running the jobs, which could then never run.
+		inline void waitForSortJobs(const std::atomic<usize>& remainingJobs) {
+			while (remainingJobs.load(std::memory_order::acquire) != 0) {
+				std::this_thread::yield();
+			}
+		}
+
+		/**
+		* Stable parallel merge sort. The list is split into a power of two number of chunks, at most one per thread,
+		* which are sorted as separate jobs. Adjacent sorted chunks are then merged in parallel, one level at a time.
+		* Chunks are radix sorted if `USE_RADIX`, otherwise merge sorted.
+		* `buffer` is uninitialized memory for at least `length` elements. Every job uses a disjoint section of it.
+		*/
+		template<typename T, typename Less, bool USE_RADIX>
+		void parallelMergeSort(T* data, usize length, T* buffer, JobSystem& jobSystem, const Less& less) {
+			using JobT = ParallelSortJob<T, Less>;
+
+			const usize maxChunkCount = systemThreadCount();
+			usize chunkCount = 1;
+			while (chunkCount * 2 <= maxChunkCount && length / (chunkCount * 2) >= PARALLEL_SORT_MIN_CHUNK_LENGTH) {
+				chunkCount *= 2;
+			}
+			const usize chunkLength = (length + chunkCount - 1) / chunkCount;
+
+			std::atomic<usize> remainingJobs = 0;
+			ArrayList<JobT> jobs;
+			jobs.reserve(chunkCount);
+			for (usize low = 0; low < length; low += chunkLength) {
+				const usize high = low + chunkLength < length ? low + chunkLength : length;
+				jobs.push(JobT{ data, buffer, low, high, high, &less, &remainingJobs });
+			}
+			remainingJobs.store(jobs.len(), std::memory_order::relaxed);
+			for (JobT& job : jobs) {
+				(void)jobSystem.runJob(runParallelSortChunkJob<T, Less, USE_RADIX>, &job);
+			}
+			waitForSortJobs(remainingJobs);
+
+			// Each merge of [low, low + width * 2) uses at most `width` elements of the buffer, starting at `low`.
+			for (usize width = chunkLength; width < length; width *= 2) {
+				jobs.truncate(0);
+				for (usize low = 0; low + width < length; low += width * 2) {
+					const usize high = low + (width * 2) < length ? low + (width * 2) : length;
+					jobs.push(JobT{ data, buffer, low, low + width, high, &less, &remainingJobs });
+				}
+				remainingJobs.store(jobs.len(), std::memory_order::relaxed);
+				for (JobT& job : jobs) {
+					(void)jobSystem.runJob(runParallelSortMergeJob<T, Less>, &job);
+				}
+				waitForSortJobs(remainingJobs);
+			}
+		}
+
+		template<typename T, typename Less, typename AllocatorT>
+		Result<void, AllocError> parallelStableSortBy(T* data, usize length, AllocatorT* allocator, JobSystem& jobSystem, Less less) {
+			if (length < PARALLEL_SORT_THRESHOLD || jobSystem.isWorkerThread()) {
+				return stableSortBy(data, length, allocator, less);
+			}
+
+			Result<T*, AllocError> bufferResult = allocator->template mallocBuffer<T>(length);
+			if (bufferResult.isError()) {
+				return ResultErr<AllocError>(bufferResult.error());
+			}
+			T* buffer = bufferResult.ok();
+			parallelMergeSort<T, Less, false>(data, length, buffer, jobSystem, less);
+			allocator->freeBuffer(buffer, length);
+			return ResultOk<void>();
+		}
+
+		template<typename T, typename AllocatorT>
+		Result<void, AllocError> parallelStableSortAscending(T* data, usize length, AllocatorT* allocator, JobSystem& jobSystem) {
+			if (length < PARALLEL_SORT_THRESHOLD || jobSystem.isWorkerThread()) {
+				return stableSortAscending(data, length, allocator);
+			}
+
+			Result<T*, AllocError> bufferResult = allocator->template mallocBuffer<T>(length);
+			if (bufferResult.isError()) {
+				return ResultErr<AllocError>(bufferResult.error());
+			}
+			T* buffer = bufferResult.ok();
+			parallelMergeSort<T, SortAscending, IS_STABLE_RADIX_SORTABLE<T>>(data, length, buffer, jobSystem, SortAscending());
+			allocator->freeBuffer(buffer, length);
+			return ResultOk<void>();
+		}
+	} // namespace internal
+
+	/**
+	* Sorts `list` in ascending order using `operator<`, keeping equal elements in their original order.
+	* Lists with at least `internal::PARALLEL_SORT_THRESHOLD` elements are split into chunks sorted as jobs
+	* on `jobSystem`, then merged in parallel. Integer chunks are radix sorted, and floats are merge sorted,
+	* so -0.0 and 0.0 keep their order. Smaller lists use `ArrayList::stableSort()`.
+	* Temporarily allocates a buffer of `len()` elements. Blocks until the sort is finished.
+	* When called from one of `jobSystem`'s own worker threads, sorts on the calling thread instead,
+	* as waiting for jobs queued behind the caller would never finish.
+	*
+	* @param list: ArrayList to sort.
+	* @param jobSystem: Job system to run the sorting jobs on.
+	*/
+	template<typename T, typename Allocator>
+	void parallelSort(ArrayList<T, Allocator>& list, JobSystem& jobSystem) {
+		Allocator allocator = list.allocator();
+		Result<void, AllocError> result = internal::parallelStableSortAscending(list.data(), list.len(), &allocator, jobSystem);
+		check_message(result.isOk(), "Failed to allocate the temporary buffer for a parallel sort");
+	}
+
+	/**
+	* Sorts `list` using `less`, keeping equal elements in their original order.
+	* See `parallelSort()`. `less` is copied into every job, so it must be safe to call concurrently.
+	*
+	* @param list: ArrayList to sort.
+	* @param jobSystem: Job system to run the sorting jobs on.
+	* @param less: Callable as `bool(const T&, const T&)`, returning if the left element goes before the right element.
+	*/
+	template<typename T, typename Allocator, typename Less>
+	void parallelSortBy(ArrayList<T, Allocator>& list, JobSystem& jobSystem, Less less) {
+		Allocator allocator = list.allocator();
+		Result<void, AllocError> result = internal::parallelStableSortBy(list.data(), list.len(), &allocator, jobSystem, less);
+		check_message(result.isOk(), "Failed to allocate the temporary buffer for a parallel sort");
+	}
+
+	/**
+	* See `parallelSort()`.
+	*
+	* @param list: ArrayList to sort.
+	* @param allocator: The allocator used by `list`. Cannot be null.
+	* @param jobSystem: Job system to run the sorting jobs on.
+	* @return An error if the temporary buffer failed to allocate, in which case the ArrayList is unmodified.
+	*/
+	template<typename T>
+	Result<void, AllocError> parallelSort(ArrayListUnmanaged<T>& list, IAllocator* allocator, JobSystem& jobSystem) {
+		check_message(allocator != nullptr, "Allocator cannot be null");
+		return internal::parallelStableSortAscending(list.data(), list.len(), allocator, jobSystem);
+	}
+
+	/**
+	* See `parallelSortBy()`.
+	*
+	* @param list: ArrayList to sort.
+	* @param allocator: The allocator used by `list`. Cannot be null.
+	* @param jobSystem: Job system to run the sorting jobs on.
+	* @param less: Callable as `bool(const T&, const T&)`, returning if the left element goes before the right element.
+	* @return An error if the temporary buffer failed to allocate, in which case the ArrayList is unmodified.
+	*/
+	template<typename T, typename Less>
+	Result<void, AllocError> parallelSortBy(ArrayListUnmanaged<T>& list, IAllocator* allocator, JobSystem& jobSystem, Less less) {
+		check_message(allocator != nullptr, "Allocator cannot be null");
+		return internal::parallelStableSortBy(list.data(), list.len(), allocator, jobSystem, less);
+	}
+} // namespace gk
@@ -0,0 +1,325 @@
+#include "array_sort.h"
+
+using gk::usize;
+using gk::i8;
+using gk::i16;
+using gk::i32;
+using gk::i64;
+using gk::u8;
+using gk::u16;
+using gk::u32;
+using gk::u64;
+
+#if GK_TYPES_LIB_TEST
+#include "array_list.h"
+#include "array_parallel_sort.h"
+#include <string>
+#include <limits>
+#include <cmath>
+
+using gk::ArrayList;
+using gk::ArrayListUnmanaged;
+
+namespace gk
+{
+	namespace unitTests
+	{
+		/// Element with a sort key, and the index it was pushed at to check stability.
+		struct SortKeyValue
+		{
+			i32 key;
+			usize index;
+		};
+
+		constexpr bool sortKeyLess(const SortKeyValue& lhs, const SortKeyValue& rhs) {
+			return lhs.key < rhs.key;
+		}
+
+		template<typename T>
+		constexpr bool isSortedAscending(const ArrayList<T>& a) {
+			for (usize i = 1; i < a.len(); i++) {
+				if (a[i] < a[i - 1]) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// Deterministic values with duplicates, and negative values for signed types.
+		template<typename T>
+		constexpr ArrayList<T> makeUnsortedList(usize length) {
+			ArrayList<T> a;
+			u64 state = 0x9E3779B97F4A7C15ULL;
+			for (usize i = 0; i < length; i++) {
+				state ^= state << 13;
+				state ^= state >> 7;
+				state ^= state << 17;
+				if constexpr (std::is_floating_point_v<T>) {
+					a.push(static_cast<T>(static_cast<i64>(state % 2001) - 1000) / static_cast<T>(8));
+				}
+				else {
+					a.push(static_cast<T>(state));
+				}
+			}
+			return a;
+		}
+
+		/// Checks `sort()` and `stableSort()` against each other for lengths below and above the radix sort threshold.
+		template<typename T>
+		void checkSortArithmetic() {
+			const usize lengths[] = { 0, 1, 2, 23, 24, 25, 100, 255, 256, 1000, 5000 };
+			for (usize length : lengths) {
+				ArrayList<T> a = makeUnsortedList<T>(length);
+				ArrayList<T> b = a;
+				a.sort();
+				b.stableSort();
+				check(isSortedAscending(a));
+				check_eq(a.len(), length);
+				for (usize i = 0; i < length; i++) {
+					check_eq(a[i], b[i]);
+				}
+			}
+		}
+
+		static constexpr void sortSmallList() {
+			ArrayList<int> a;
+			a.appendList({ 5, -3, 8, 8, 0, -3, 7 });
+			a.sort();
+			check_eq(a[0], -3);
+			check_eq(a[1], -3);
+			check_eq(a[2], 0);
+			check_eq(a[3], 5);
+			check_eq(a[4], 7);
+			check_eq(a[5], 8);
+			check_eq(a[6], 8);
+		}
+
+		static constexpr void stableSortSmallList() {
+			ArrayList<int> a;
+			a.appendList({ 5, -3, 8, 8, 0, -3, 7 });
+			a.stableSort();
+			check_eq(a[0], -3);
+			check_eq(a[1], -3);
+			check_eq(a[2], 0);
+			check_eq(a[3], 5);
+			check_eq(a[4], 7);
+			check_eq(a[5], 8);
+			check_eq(a[6], 8);
+		}
+
+		static constexpr void sortByDescending() {
+			ArrayList<int> a;
+			for (int i = 0; i < 100; i++) {
+				a.push((i * 37) % 100);
+			}
+			a.sortBy([](const int& lhs, const int& rhs) { return lhs > rhs; });
+			for (int i = 0; i < 100; i++) {
+				check_eq(a[i], 99 - i);
+			}
+		}
+
+		static constexpr void stableSortByKeepsOrder() {
+			ArrayList<SortKeyValue> a;
+			for (usize i = 0; i < 300; i++) {
+				a.push(SortKeyValue{ static_cast<i32>((i * 7) % 5), i });
+			}
+			a.stableSortBy(sortKeyLess);
+			for (usize i = 1; i < a.len(); i++) {
+				check(a[i - 1].key <= a[i].key);
+				if (a[i - 1].key == a[i].key) {
+					check(a[i - 1].index < a[i].index);
+				}
+			}
+		}
+
+		static void sortStdStrings() {
+			ArrayList<std::string> a;
+			for (int i = 0; i < 60; i++) {
+				a.push(std::string("string value ") + std::to_string((i * 13) % 60));
+			}
+			ArrayList<std::string> b = a;
+			a.sort();
+			b.stableSort();
+			check(isSortedAscending(a));
+			for (usize i = 0; i < a.len(); i++) {
+				check_eq(a[i], b[i]);
+			}
+		}
+	}
+}
+
+using namespace gk::unitTests;
+
+test_case("sort small list") { sortSmallList(); }
+comptime_test_case(sort_small_list, { sortSmallList(); })
+
+test_case("stable sort small list") { stableSortSmallList(); }
+comptime_test_case(stable_sort_small_list, { stableSortSmallList(); })
+
+test_case("sortBy descending") { sortByDescending(); }
+comptime_test_case(sort_by_descending, { sortByDescending(); })
+
+test_case("stableSortBy keeps equal elements in order") { stableSortByKeepsOrder(); }
+comptime_test_case(stable_sort_by_keeps_order, { stableSortByKeepsOrder(); })
+
+test_case("sort std strings") { sortStdStrings(); }
+
+test_case("sort i8") { checkSortArithmetic<i8>(); }
+test_case("sort u8") { checkSortArithmetic<u8>(); }
+test_case("sort i16") { checkSortArithmetic<i16>(); }
+test_case("sort u32") { checkSortArithmetic<u32>(); }
+test_case("sort i32") { checkSortArithmetic<i32>(); }
+test_case("sort i64") { checkSortArithmetic<i64>(); }
+test_case("sort u64") { checkSortArithmetic<u64>(); }
+test_case("sort float") { checkSortArithmetic<float>(); }
+test_case("sort double") { checkSortArithmetic<double>(); }
+
+test_case("sort float extremes") {
+	ArrayList<float> a;
+	for (int i = 0; i < 300; i++) {
+		a.push(static_cast<float>(i % 7) - 3.5f);
+	}
+	a.push(std::numeric_limits<float>::infinity());
+	a.push(-std::numeric_limits<float>::infinity());
+	a.push(std::numeric_limits<float>::lowest());
+	a.push(std::numeric_limits<float>::max());
+	a.sort();
+	check(isSortedAscending(a));
+	check_eq(a[0], -std::numeric_limits<float>::infinity());
+	check_eq(a[a.len() - 1], std::numeric_limits<float>::infinity());
+}
+
+test_case("sort patterns") {
+	constexpr usize length = 2000;
+	ArrayList<u64> ascending;
+	ArrayList<u64> descending;
+	ArrayList<u64> equal;
+	ArrayList<u64> sawtooth;
+	for (usize i = 0; i < length; i++) {
+		ascending.push(i);
+		descending.push(length - i);
+		equal.push(4);
+		sawtooth.push(i % 50);
+	}
+	auto greater = [](const u64& lhs, const u64& rhs) { return lhs > rhs; };
+	// sortBy never radix sorts, so this exercises the quicksort.
+	ascending.sortBy(greater);
+	descending.sortBy(greater);
+	equal.sortBy(greater);
+	sawtooth.sortBy(greater);
+	for (usize i = 1; i < length; i++) {
+		check(ascending[i - 1] >= ascending[i]);
+		check(descending[i - 1] >= descending[i]);
+		check_eq(equal[i], 4);
+		check(sawtooth[i - 1] >= sawtooth[i]);
+	}
+}
+
+test_case("stableSortBy large list keeps equal elements in order") {
+	ArrayList<SortKeyValue> a;
+	for (usize i = 0; i < 5000; i++) {
+		a.push(SortKeyValue{ static_cast<i32>((i * 7919) % 101), i });
+	}
+	a.stableSortBy(sortKeyLess);
+	for (usize i = 1; i < a.len(); i++) {
+		check(a[i - 1].key <= a[i].key);
+		if (a[i - 1].key == a[i].key) {
+			check(a[i - 1].index < a[i].index);
+		}
+	}
+}
+
+test_case("ArrayListUnmanaged sort") {
+	gk::IAllocator* allocator = gk::globalHeapAllocator();
+	ArrayListUnmanaged<i32> a;
+	for (i32 i = 0; i < 1000; i++) {
+		a.push(allocator, (i * 7919) % 1000).ok();
+	}
+	ArrayListUnmanaged<i32> b = a.clone(allocator).ok();
+	a.sort(allocator);
+	check(b.stableSort(allocator).isOk());
+	for (i32 i = 0; i < 1000; i++) {
+		check_eq(a[i], i);
+		check_eq(b[i], i);
+	}
+	a.deinit(allocator);
+	b.deinit(allocator);
+}
+
+test_case("stableSort keeps signed zeros in order") {
+	ArrayList<double> a;
+	for (usize i = 0; i < 1000; i++) {
+		a.push(i % 2 == 0 ? 0.0 : -0.0);
+	}
+	a.stableSort();
+	for (usize i = 0; i < a.len(); i++) {
+		check_eq(std::signbit(a[i]), i % 2 == 1);
+	}
+}
+
+namespace gk
+{
+	namespace unitTests
+	{
+		struct NestedParallelSortJob
+		{
+			JobSystem* jobSystem;
+			ArrayList<i32>* list;
+		};
+
+		static void runNestedParallelSort(NestedParallelSortJob* job) {
+			gk::parallelSort(*job->list, *job->jobSystem);
+		}
+	}
+}
+
+test_case("parallelSort") {
+	gk::JobSystem jobSystem(4);
+	ArrayList<i32> a = makeUnsortedList<i32>(200000);
+	ArrayList<i32> b = a;
+	gk::parallelSort(a, jobSystem);
+	b.sort();
+	for (usize i = 0; i < a.len(); i++) {
+		check_eq(a[i], b[i]);
+	}
+}
+
+test_case("parallelSortBy keeps equal elements in order") {
+	gk::JobSystem jobSystem(4);
+	ArrayList<SortKeyValue> a;
+	for (usize i = 0; i < 100000; i++) {
+		a.push(SortKeyValue{ static_cast<i32>((i * 7919) % 1009), i });
+	}
+	gk::parallelSortBy(a, jobSystem, sortKeyLess);
+	check_eq(a.len(), 100000);
+	for (usize i = 1; i < a.len(); i++) {
+		check(a[i - 1].key <= a[i].key);
+		if (a[i - 1].key == a[i].key) {
+			check(a[i - 1].index < a[i].index);
+		}
+	}
+}
+
+test_case("parallelSort keeps signed zeros in order") {
+	gk::JobSystem jobSystem(4);
+	ArrayList<float> a;
+	for (usize i = 0; i < 200000; i++) {
+		a.push(i % 2 == 0 ? 0.f : -0.f);
+	}
+	gk::parallelSort(a, jobSystem);
+	for (usize i = 0; i < a.len(); i++) {
+		check_eq(std::signbit(a[i]), i % 2 == 1);
+	}
+}
+
+test_case("parallelSort from within a job of the same job system") {
+	// With a single worker, waiting on queued sort jobs from inside a job would never finish.
+	gk::JobSystem jobSystem(1);
+	ArrayList<i32> a = makeUnsortedList<i32>(200000);
+	gk::unitTests::NestedParallelSortJob job{ &jobSystem, &a };
+	jobSystem.runJob(gk::unitTests::runNestedParallelSort, &job).wait();
+	check_eq(a.len(), 200000);
+	check(isSortedAscending(a));
+}
+
+#endif
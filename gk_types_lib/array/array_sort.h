@@ -0,0 +1,526 @@
+#pragma once
+
+#include "../basic_types.h"
+#include "../allocator/allocator.h"
+#include "../error/result.h"
+#include "array_algorithms.h"
+#include <type_traits>
+#include <memory>
+#include <bit>
+#include <utility>
+
+namespace gk
+{
+	namespace internal
+	{
+		/// Below this, sorts use insertion sort.
+		constexpr usize SORT_INSERTION_THRESHOLD = 24;
+		/// Above this, quicksort uses the pseudomedian of 9 as the pivot, rather than the median of 3.
+		constexpr usize SORT_NINTHER_THRESHOLD = 128;
+		/// Maximum number of elements moved by an optimistic insertion sort before giving up.
+		constexpr usize SORT_PARTIAL_INSERTION_LIMIT = 8;
+		/// Length of the insertion sorted runs that merge sort starts from.
+		constexpr usize MERGE_SORT_RUN_LENGTH = 32;
+		/// At or above this, arithmetic types are radix sorted at runtime.
+		constexpr usize RADIX_SORT_THRESHOLD = 256;
+
+		/// Types that stable sorts may radix sort. Floats are excluded, as radix sorting orders -0.0 before 0.0,
+		/// which `operator<` considers equal, so their original order would not be kept.
+		template<typename T>
+		constexpr bool IS_STABLE_RADIX_SORTABLE = SimdArrayElement<T> && !std::is_floating_point_v<T>;
+
+		/// Ascending order using `operator<`.
+		struct SortAscending
+		{
+			template<typename T>
+			constexpr bool operator()(const T& lhs, const T& rhs) const {
+				return lhs < rhs;
+			}
+		};
+
+		template<typename T, typename Less>
+		constexpr void insertionSort(T* data, usize begin, usize end, Less& less) {
+			if (begin == end) {
+				return;
+			}
+			for (usize i = begin + 1; i < end; i++) {
+				if (less(data[i], data[i - 1])) {
+					T temp = std::move(data[i]);
+					usize j = i;
+					do {
+						data[j] = std::move(data[j - 1]);
+						j--;
+					} while (j > begin && less(temp, data[j - 1]));
+					data[j] = std::move(temp);
+				}
+			}
+		}
+
+		/// Requires an element before `begin` that is not greater than any element in the range.
+		template<typename T, typename Less>
+		constexpr void unguardedInsertionSort(T* data, usize begin, usize end, Less& less) {
+			for (usize i = begin + 1; i < end; i++) {
+				if (less(data[i], data[i - 1])) {
+					T temp = std::move(data[i]);
+					usize j = i;
+					do {
+						data[j] = std::move(data[j - 1]);
+						j--;
+					} while (less(temp, data[j - 1]));
+					data[j] = std::move(temp);
+				}
+			}
+		}
+
+		/// Insertion sort that gives up after moving `SORT_PARTIAL_INSERTION_LIMIT` elements.
+		/// @return If the range was sorted.
+		template<typename T, typename Less>
+		constexpr bool partialInsertionSort(T* data, usize begin, usize end, Less& less) {
+			if (begin == end) {
+				return true;
+			}
+			usize moved = 0;
+			for (usize i = begin + 1; i < end; i++) {
+				if (less(data[i], data[i - 1])) {
+					T temp = std::move(data[i]);
+					usize j = i;
+					do {
+						data[j] = std::move(data[j - 1]);
+						j--;
+					} while (j > begin && less(temp, data[j - 1]));
+					data[j] = std::move(temp);
+					moved += i - j;
+				}
+				if (moved > SORT_PARTIAL_INSERTION_LIMIT) {
+					return false;
+				}
+			}
+			return true;
+		}
+
+		template<typename T, typename Less>
+		constexpr void siftDown(T* data, usize root, usize length, Less& less) {
+			T value = std::move(data[root]);
+			while (true) {
+				usize child = (root * 2) + 1;
+				if (child >= length) {
+					break;
+				}
+				if (child + 1 < length && less(data[child], data[child + 1])) {
+					child++;
+				}
+				if (!less(value, data[child])) {
+					break;
+				}
+				data[root] = std::move(data[child]);
+				root = child;
+			}
+			data[root] = std::move(value);
+		}
+
+		template<typename T, typename Less>
+		constexpr void heapSort(T* data, usize length, Less& less) {
+			for (usize i = length / 2; i > 0; i--) {
+				siftDown(data, i - 1, length, less);
+			}
+			for (usize end = length; end > 1; end--) {
+				std::swap(data[0], data[end - 1]);
+				siftDown(data, 0, end - 1, less);
+			}
+		}
+
+		template<typename T, typename Less>
+		constexpr void sortTwo(T* data, usize a, usize b, Less& less) {
+			if (less(data[b], data[a])) {
+				std::swap(data[a], data[b]);
+			}
+		}
+
+		template<typename T, typename Less>
+		constexpr void sortThree(T* data, usize a, usize b, usize c, Less& less) {
+			sortTwo(data, a, b, less);
+			sortTwo(data, b, c, less);
+			sortTwo(data, a, b, less);
+		}
+
+		struct SortPartition
+		{
+			usize pivot;
+			bool alreadyPartitioned;
+		};
+
+		/// Partitions around the pivot at `begin`. Elements equal to the pivot go to the right.
+		/// Requires an element in the range that is not less than the pivot, which the pivot selection guarantees.
+		template<typename T, typename Less>
+		constexpr SortPartition partitionRight(T* data, usize begin, usize end, Less& less) {
+			T pivot = std::move(data[begin]);
+			usize first = begin;
+			usize last = end;
+
+			while (less(data[++first], pivot));
+
+			if (first - 1 == begin) {
+				while (first < last && !less(data[--last], pivot));
+			}
+			else {
+				while (!less(data[--last], pivot));
+			}
+
+			const bool alreadyPartitioned = first >= last;
+			while (first < last) {
+				std::swap(data[first], data[last]);
+				while (less(data[++first], pivot));
+				while (!less(data[--last], pivot));
+			}
+
+			const usize pivotIndex = first - 1;
+			data[begin] = std::move(data[pivotIndex]);
+			data[pivotIndex] = std::move(pivot);
+			return SortPartition{ pivotIndex, alreadyPartitioned };
+		}
+
+		/// Partitions around the pivot at `begin`. Elements equal to the pivot go to the left.
+		/// Used when the pivot equals the element before the range, meaning the range has many equal elements.
+		template<typename T, typename Less>
+		constexpr usize partitionLeft(T* data, usize begin, usize end, Less& less) {
+			T pivot = std::move(data[begin]);
+			usize first = begin;
+			usize last = end;
+
+			while (less(pivot, data[--last]));
+
+			if (last + 1 == end) {
+				while (first < last && !less(pivot, data[++first]));
+			}
+			else {
+				while (!less(pivot, data[++first]));
+			}
+
+			while (first < last) {
+				std::swap(data[first], data[last]);
+				while (less(pivot, data[--last]));
+				while (!less(pivot, data[++first]));
+			}
+
+			data[begin] = std::move(data[last]);
+			data[last] = std::move(pivot);
+			return last;
+		}
+
+		/// Swaps some elements around to break up patterns that caused a bad partition.
+		template<typename T>
+		constexpr void breakSortPatterns(T* data, usize begin, usize pivot, usize end) {
+			const usize leftLength = pivot - begin;
+			const usize rightLength = end - (pivot + 1);
+			if (leftLength >= SORT_INSERTION_THRESHOLD) {
+				std::swap(data[begin], data[begin + leftLength / 4]);
+				std::swap(data[pivot - 1], data[pivot - leftLength / 4]);
+				if (leftLength > SORT_NINTHER_THRESHOLD) {
+					std::swap(data[begin + 1], data[begin + (leftLength / 4 + 1)]);
+					std::swap(data[begin + 2], data[begin + (leftLength / 4 + 2)]);
+					std::swap(data[pivot - 2], data[pivot - (leftLength / 4 + 1)]);
+					std::swap(data[pivot - 3], data[pivot - (leftLength / 4 + 2)]);
+				}
+			}
+			if (rightLength >= SORT_INSERTION_THRESHOLD) {
+				std::swap(data[pivot + 1], data[pivot + (1 + rightLength / 4)]);
+				std::swap(data[end - 1], data[end - rightLength / 4]);
+				if (rightLength > SORT_NINTHER_THRESHOLD) {
+					std::swap(data[pivot + 2], data[pivot + (2 + rightLength / 4)]);
+					std::swap(data[pivot + 3], data[pivot + (3 + rightLength / 4)]);
+					std::swap(data[end - 2], data[end - (1 + rightLength / 4)]);
+					std::swap(data[end - 3], data[end - (2 + rightLength / 4)]);
+				}
+			}
+		}
+
+		template<typename T, typename Less>
+		constexpr void patternDefeatingQuickSortLoop(T* data, usize begin, usize end, Less& less, u32 badPartitionsAllowed, bool leftmost) {
+			while (true) {
+				const usize length = end - begin;
+				if (length < SORT_INSERTION_THRESHOLD) {
+					if (leftmost) {
+						insertionSort(data, begin, end, less);
+					}
+					else {
+						unguardedInsertionSort(data, begin, end, less);
+					}
+					return;
+				}
+
+				const usize half = length / 2;
+				if (length > SORT_NINTHER_THRESHOLD) {
+					sortThree(data, begin, begin + half, end - 1, less);
+					sortThree(data, begin + 1, begin + (half - 1), end - 2, less);
+					sortThree(data, begin + 2, begin + (half + 1), end - 3, less);
+					sortThree(data, begin + (half - 1), begin + half, begin + (half + 1), less);
+					std::swap(data[begin], data[begin + half]);
+				}
+				else {
+					sortThree(data, begin + half, begin, end - 1, less);
+				}
+
+				// The element before this range is a previous pivot. If it's equal to this pivot,
+				// every element equal to the pivot can be skipped.
+				if (!leftmost && !less(data[begin - 1], data[begin])) {
+					begin = partitionLeft(data, begin, end, less) + 1;
+					continue;
+				}
+
+				const SortPartition partition = partitionRight(data, begin, end, less);
+				const usize pivot = partition.pivot;
+				const usize leftLength = pivot - begin;
+				const usize rightLength = end - (pivot + 1);
+				const bool highlyUnbalanced = leftLength < length / 8 || rightLength < length / 8;
+
+				if (highlyUnbalanced) {
+					badPartitionsAllowed--;
+					if (badPartitionsAllowed == 0) {
+						heapSort(data + begin, length, less);
+						return;
+					}
+					breakSortPatterns(data, begin, pivot, end);
+				}
+				else if (partition.alreadyPartitioned
+					&& partialInsertionSort(data, begin, pivot, less)
+					&& partialInsertionSort(data, pivot + 1, end, less)) {
+					return;
+				}
+
+				patternDefeatingQuickSortLoop(data, begin, pivot, less, badPartitionsAllowed, leftmost);
+				begin = pivot + 1;
+				leftmost = false;
+			}
+		}
+
+		/**
+		* Pattern defeating quicksort. An introsort that runs in linear time for sorted, reverse sorted,
+		* and all equal input, and falls back to heapsort after too many bad partitions. Not stable, does not allocate.
+		*/
+		template<typename T, typename Less>
+		constexpr void patternDefeatingQuickSort(T* data, usize length, Less& less) {
+			if (length < 2) {
+				return;
+			}
+			patternDefeatingQuickSortLoop(data, 0, length, less, static_cast<u32>(std::bit_width(length)), true);
+		}
+
+		/// Merges the sorted ranges [low, mid) and [mid, high), moving the smaller range into `buffer`.
+		/// `buffer` is uninitialized memory for at least min(mid - low, high - mid) elements.
+		template<typename T, typename Less>
+		constexpr void mergeSortedRanges(T* data, usize low, usize mid, usize high, T* buffer, Less& less) {
+			if (!less(data[mid], data[mid - 1])) {
+				return; // already in order
+			}
+
+			const usize leftLength = mid - low;
+			const usize rightLength = high - mid;
+			if (leftLength <= rightLength) {
+				for (usize i = 0; i < leftLength; i++) {
+					std::construct_at(buffer + i, std::move(data[low + i]));
+				}
+				usize left = 0;
+				usize right = mid;
+				usize out = low;
+				while (left < leftLength && right < high) {
+					if (less(data[right], buffer[left])) {
+						data[out++] = std::move(data[right++]);
+					}
+					else {
+						data[out++] = std::move(buffer[left++]);
+					}
+				}
+				while (left < leftLength) {
+					data[out++] = std::move(buffer[left++]);
+				}
+				std::destroy(buffer, buffer + leftLength);
+			}
+			else {
+				for (usize i = 0; i < rightLength; i++) {
+					std::construct_at(buffer + i, std::move(data[mid + i]));
+				}
+				usize left = mid;
+				usize right = rightLength;
+				usize out = high;
+				while (left > low && right > 0) {
+					if (less(buffer[right - 1], data[left - 1])) {
+						data[--out] = std::move(data[--left]);
+					}
+					else {
+						data[--out] = std::move(buffer[--right]);
+					}
+				}
+				while (right > 0) {
+					data[--out] = std::move(buffer[--right]);
+				}
+				std::destroy(buffer, buffer + rightLength);
+			}
+		}
+
+		/// Bottom up stable merge sort.
+		/// `buffer` is uninitialized memory for at least `length / 2` elements.
+		template<typename T, typename Less>
+		constexpr void mergeSort(T* data, usize length, T* buffer, Less& less) {
+			for (usize i = 0; i < length; i += MERGE_SORT_RUN_LENGTH) {
+				const usize end = i + MERGE_SORT_RUN_LENGTH < length ? i + MERGE_SORT_RUN_LENGTH : length;
+				insertionSort(data, i, end, less);
+			}
+			for (usize width = MERGE_SORT_RUN_LENGTH; width < length; width *= 2) {
+				for (usize low = 0; low + width < length; low += width * 2) {
+					const usize high = low + (width * 2) < length ? low + (width * 2) : length;
+					mergeSortedRanges(data, low, low + width, high, buffer, less);
+				}
+			}
+		}
+
+		template<typename T>
+		using RadixKeyT =
+			std::conditional_t<sizeof(T) == 1, u8,
+			std::conditional_t<sizeof(T) == 2, u16,
+			std::conditional_t<sizeof(T) == 4, u32, u64>>>;
+
+		/// Maps `value` to an unsigned integer with the same ascending order.
+		/// Signed integers flip the sign bit. Negative floats flip every bit, and positive floats flip the sign bit.
+		template<typename T>
+		constexpr RadixKeyT<T> radixKey(T value) {
+			using Key = RadixKeyT<T>;
+			constexpr Key SIGN_BIT = static_cast<Key>(Key(1) << (sizeof(T) * 8 - 1));
+			if constexpr (std::is_floating_point_v<T>) {
+				const Key bits = std::bit_cast<Key>(value);
+				return (bits & SIGN_BIT) ? static_cast<Key>(~bits) : static_cast<Key>(bits | SIGN_BIT);
+			}
+			else if constexpr (std::is_signed_v<T>) {
+				return static_cast<Key>(static_cast<Key>(value) ^ SIGN_BIT);
+			}
+			else {
+				return value;
+			}
+		}
+
+		/**
+		* Stable LSD radix sort, one byte per pass. Passes where every element has the same byte are skipped.
+		* Floats are ordered by their bits, so -0.0 sorts before 0.0, and NaN sorts to either end depending on its sign.
+		* `buffer` is memory for at least `length` elements.
+		*/
+		template<SimdArrayElement T>
+		void radixSort(T* data, usize length, T* buffer) {
+			constexpr usize PASSES = sizeof(T);
+			usize counts[PASSES][256] = {};
+			for (usize i = 0; i < length; i++) {
+				const RadixKeyT<T> key = radixKey(data[i]);
+				for (usize pass = 0; pass < PASSES; pass++) {
+					counts[pass][(key >> (pass * 8)) & 0xFF]++;
+				}
+			}
+
+			T* source = data;
+			T* dest = buffer;
+			for (usize pass = 0; pass < PASSES; pass++) {
+				const usize shift = pass * 8;
+				usize* passCounts = counts[pass];
+				if (passCounts[(radixKey(source[0]) >> shift) & 0xFF] == length) {
+					continue;
+				}
+
+				usize offset = 0;
+				for (usize digit = 0; digit < 256; digit++) {
+					const usize count = passCounts[digit];
+					passCounts[digit] = offset;
+					offset += count;
+				}
+				for (usize i = 0; i < length; i++) {
+					dest[passCounts[(radixKey(source[i]) >> shift) & 0xFF]++] = source[i];
+				}
+				std::swap(source, dest);
+			}
+
+			if (source != data) {
+				memcpy((void*)data, (const void*)source, length * sizeof(T));
+			}
+		}
+
+		/**
+		* Allocates uninitialized memory for sort buffers. Uses `std::allocator` at compile time.
+		* `AllocatorT` is `IAllocator`, `AllocatorRef`, or a static allocator.
+		*/
+		template<typename T, typename AllocatorT>
+		constexpr Result<T*, AllocError> mallocSortBuffer(AllocatorT* allocator, usize length) {
+			if (std::is_constant_evaluated()) {
+				return ResultOk<T*>(std::allocator<T>().allocate(length));
+			}
+			return allocator->template mallocBuffer<T>(length);
+		}
+
+		template<typename T, typename AllocatorT>
+		constexpr void freeSortBuffer(AllocatorT* allocator, T* buffer, usize length) {
+			if (std::is_constant_evaluated()) {
+				std::allocator<T>().deallocate(buffer, length);
+				return;
+			}
+			allocator->freeBuffer(buffer, length);
+		}
+
+		/**
+		* Ascending sort shared by the ArrayList variants. Arithmetic types at runtime are radix sorted,
+		* allocating a temporary buffer, and fall back to pattern defeating quicksort if allocation fails.
+		*/
+		template<typename T, typename AllocatorT>
+		constexpr void sortAscending(T* data, usize length, AllocatorT* allocator) {
+			if constexpr (SimdArrayElement<T>) {
+				if (!std::is_constant_evaluated() && length >= RADIX_SORT_THRESHOLD) {
+					Result<T*, AllocError> bufferResult = allocator->template mallocBuffer<T>(length);
+					if (bufferResult.isOk()) {
+						T* buffer = bufferResult.ok();
+						radixSort(data, length, buffer);
+						allocator->freeBuffer(buffer, length);
+						return;
+					}
+				}
+			}
+			SortAscending less;
+			patternDefeatingQuickSort(data, length, less);
+		}
+
+		/**
+		* Stable sort shared by the ArrayList variants. Short lists are insertion sorted without allocating.
+		*/
+		template<typename T, typename Less, typename AllocatorT>
+		constexpr Result<void, AllocError> stableSortBy(T* data, usize length, AllocatorT* allocator, Less& less) {
+			if (length <= MERGE_SORT_RUN_LENGTH) {
+				insertionSort(data, 0, length, less);
+				return ResultOk<void>();
+			}
+
+			const usize bufferLength = length / 2;
+			Result<T*, AllocError> bufferResult = mallocSortBuffer<T>(allocator, bufferLength);
+			if (bufferResult.isError()) {
+				return ResultErr<AllocError>(bufferResult.error());
+			}
+			T* buffer = bufferResult.ok();
+			mergeSort(data, length, buffer, less);
+			freeSortBuffer(allocator, buffer, bufferLength);
+			return ResultOk<void>();
+		}
+
+		/**
+		* Stable ascending sort shared by the ArrayList variants. Integer types at runtime are radix sorted.
+		*/
+		template<typename T, typename AllocatorT>
+		constexpr Result<void, AllocError> stableSortAscending(T* data, usize length, AllocatorT* allocator) {
+			if constexpr (IS_STABLE_RADIX_SORTABLE<T>) {
+				if (!std::is_constant_evaluated() && length >= RADIX_SORT_THRESHOLD) {
+					Result<T*, AllocError> bufferResult = allocator->template mallocBuffer<T>(length);
+					if (bufferResult.isError()) {
+						return ResultErr<AllocError>(bufferResult.error());
+					}
+					T* buffer = bufferResult.ok();
+					radixSort(data, length, buffer);
+					allocator->freeBuffer(buffer, length);
+					return ResultOk<void>();
+				}
+			}
+			SortAscending less;
+			return stableSortBy(data, length, allocator, less);
+		}
+	} // namespace internal
+} // namespace gk
@@ -0,0 +1,388 @@
+#include "bit_array_list.h"
+#include "../cpu_features/cpu_feature_detector.h"
+#include <intrin.h>
+
+using gk::usize;
+using gk::u8;
+using gk::u64;
+
+namespace
+{
+	enum class BitOp : u8 {
+		And,
+		Or,
+		Xor,
+		AndNot,
+	};
+
+	template<BitOp OP>
+	u64 scalarBitOp(u64 a, u64 b) {
+		if constexpr (OP == BitOp::And) return a & b;
+		else if constexpr (OP == BitOp::Or) return a | b;
+		else if constexpr (OP == BitOp::Xor) return a ^ b;
+		else return a & ~b;
+	}
+
+	usize scalarPopcountImpl(const u64* words, usize wordCount) {
+		usize count = 0;
+		for (usize i = 0; i < wordCount; i++) {
+			count += static_cast<usize>(std::popcount(words[i]));
+		}
+		return count;
+	}
+
+	template<BitOp OP>
+	void scalarBitOpImpl(u64* dst, const u64* src, usize wordCount) {
+		for (usize i = 0; i < wordCount; i++) {
+			dst[i] = scalarBitOp<OP>(dst[i], src[i]);
+		}
+	}
+
+	// Popcount uses a 4 bit lookup table with byte shuffles, then sums the bytes with SAD against zero.
+	// This only needs AVX-512 BW rather than the VPOPCNTDQ extension.
+
+	usize avx512PopcountImpl(const u64* words, usize wordCount) {
+		constexpr usize WORDS_PER_VEC = 8;
+		const usize vecEnd = wordCount - (wordCount % WORDS_PER_VEC);
+		const __m512i lookup = _mm512_set_epi8(
+			4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0,
+			4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0,
+			4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0,
+			4, 3, 3, 2, 3, 2, 2, 1, 3, 2, 2, 1, 2, 1, 1, 0);
+		const __m512i lowNibbles = _mm512_set1_epi8(0x0F);
+		__m512i sumVec = _mm512_setzero_si512();
+		for (usize i = 0; i < vecEnd; i += WORDS_PER_VEC) {
+			const __m512i vec = _mm512_loadu_si512(words + i);
+			const __m512i low = _mm512_and_si512(vec, lowNibbles);
+			const __m512i high = _mm512_and_si512(_mm512_srli_epi16(vec, 4), lowNibbles);
+			const __m512i byteCounts = _mm512_add_epi8(_mm512_shuffle_epi8(lookup, low), _mm512_shuffle_epi8(lookup, high));
+			sumVec = _mm512_add_epi64(sumVec, _mm512_sad_epu8(byteCounts, _mm512_setzero_si512()));
+		}
+		return static_cast<usize>(_mm512_reduce_add_epi64(sumVec)) + scalarPopcountImpl(words + vecEnd, wordCount - vecEnd);
+	}
+
+	usize avx2PopcountImpl(const u64* words, usize wordCount) {
+		constexpr usize WORDS_PER_VEC = 4;
+		const usize vecEnd = wordCount - (wordCount % WORDS_PER_VEC);
+		const __m256i lookup = _mm256_setr_epi8(
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i lowNibbles = _mm256_set1_epi8(0x0F);
+		__m256i sumVec = _mm256_setzero_si256();
+		for (usize i = 0; i < vecEnd; i += WORDS_PER_VEC) {
+			const __m256i vec = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+			const __m256i low = _mm256_and_si256(vec, lowNibbles);
+			const __m256i high = _mm256_and_si256(_mm256_srli_epi16(vec, 4), lowNibbles);
+			const __m256i byteCounts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+			sumVec = _mm256_add_epi64(sumVec, _mm256_sad_epu8(byteCounts, _mm256_setzero_si256()));
+		}
+		alignas(32) u64 lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sumVec);
+		return static_cast<usize>(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + scalarPopcountImpl(words + vecEnd, wordCount - vecEnd);
+	}
+
+	template<BitOp OP>
+	void avx512BitOpImpl(u64* dst, const u64* src, usize wordCount) {
+		constexpr usize WORDS_PER_VEC = 8;
+		const usize vecEnd = wordCount - (wordCount % WORDS_PER_VEC);
+		for (usize i = 0; i < vecEnd; i += WORDS_PER_VEC) {
+			const __m512i a = _mm512_loadu_si512(dst + i);
+			const __m512i b = _mm512_loadu_si512(src + i);
+			__m512i result;
+			if constexpr (OP == BitOp::And) result = _mm512_and_si512(a, b);
+			else if constexpr (OP == BitOp::Or) result = _mm512_or_si512(a, b);
+			else if constexpr (OP == BitOp::Xor) result = _mm512_xor_si512(a, b);
+			else result = _mm512_andnot_si512(b, a);
+			_mm512_storeu_si512(dst + i, result);
+		}
+		scalarBitOpImpl<OP>(dst + vecEnd, src + vecEnd, wordCount - vecEnd);
+	}
+
+	template<BitOp OP>
+	void avx2BitOpImpl(u64* dst, const u64* src, usize wordCount) {
+		constexpr usize WORDS_PER_VEC = 4;
+		const usize vecEnd = wordCount - (wordCount % WORDS_PER_VEC);
+		for (usize i = 0; i < vecEnd; i += WORDS_PER_VEC) {
+			const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			__m256i result;
+			if constexpr (OP == BitOp::And) result = _mm256_and_si256(a, b);
+			else if constexpr (OP == BitOp::Or) result = _mm256_or_si256(a, b);
+			else if constexpr (OP == BitOp::Xor) result = _mm256_xor_si256(a, b);
+			else result = _mm256_andnot_si256(b, a);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), result);
+		}
+		scalarBitOpImpl<OP>(dst + vecEnd, src + vecEnd, wordCount - vecEnd);
+	}
+
+	/**
+	* Every bit array kernel for one instruction set.
+	*/
+	struct BitArrayKernelTable
+	{
+		usize(*popcount)(const u64*, usize);
+		void(*bitAnd)(u64*, const u64*, usize);
+		void(*bitOr)(u64*, const u64*, usize);
+		void(*bitXor)(u64*, const u64*, usize);
+		void(*bitAndNot)(u64*, const u64*, usize);
+	};
+
+	/// Chosen once, based on the instruction sets available at runtime.
+	const BitArrayKernelTable& bitArrayKernels() {
+		static const BitArrayKernelTable table = []() {
+			if (gk::x86::isAvx512Supported()) {
+				return BitArrayKernelTable{
+					avx512PopcountImpl,
+					avx512BitOpImpl<BitOp::And>,
+					avx512BitOpImpl<BitOp::Or>,
+					avx512BitOpImpl<BitOp::Xor>,
+					avx512BitOpImpl<BitOp::AndNot>
+				};
+			}
+			else if (gk::x86::isAvx2Supported()) {
+				return BitArrayKernelTable{
+					avx2PopcountImpl,
+					avx2BitOpImpl<BitOp::And>,
+					avx2BitOpImpl<BitOp::Or>,
+					avx2BitOpImpl<BitOp::Xor>,
+					avx2BitOpImpl<BitOp::AndNot>
+				};
+			}
+			return BitArrayKernelTable{
+				scalarPopcountImpl,
+				scalarBitOpImpl<BitOp::And>,
+				scalarBitOpImpl<BitOp::Or>,
+				scalarBitOpImpl<BitOp::Xor>,
+				scalarBitOpImpl<BitOp::AndNot>
+			};
+		}();
+		return table;
+	}
+}
+
+usize gk::internal::bitArrayPopcount(const u64* words, usize wordCount)
+{
+	return bitArrayKernels().popcount(words, wordCount);
+}
+
+void gk::internal::bitArrayAnd(u64* dst, const u64* src, usize wordCount)
+{
+	bitArrayKernels().bitAnd(dst, src, wordCount);
+}
+
+void gk::internal::bitArrayOr(u64* dst, const u64* src, usize wordCount)
+{
+	bitArrayKernels().bitOr(dst, src, wordCount);
+}
+
+void gk::internal::bitArrayXor(u64* dst, const u64* src, usize wordCount)
+{
+	bitArrayKernels().bitXor(dst, src, wordCount);
+}
+
+void gk::internal::bitArrayAndNot(u64* dst, const u64* src, usize wordCount)
+{
+	bitArrayKernels().bitAndNot(dst, src, wordCount);
+}
+
+#if GK_TYPES_LIB_TEST
+
+#include "../allocator/stats_allocator.h"
+
+using gk::BitArrayList;
+
+namespace gk
+{
+	namespace unitTests
+	{
+		/// Deterministic pseudo random bits, roughly 1 in `density` set.
+		static BitArrayList<> makeBitPattern(usize length, u64 seed, u64 density) {
+			BitArrayList<> bits;
+			u64 state = seed;
+			for (usize i = 0; i < length; i++) {
+				state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+				bits.push(((state >> 33) % density) == 0);
+			}
+			return bits;
+		}
+	}
+}
+
+using gk::unitTests::makeBitPattern;
+
+test_case("BitArrayList default construct") {
+	BitArrayList<> a;
+	check_eq(a.len(), 0);
+	check_eq(a.capacity(), 0);
+	check_eq(a.popcount(), 0);
+	check(a.findFirstSet().none());
+	check(a.select(0).none());
+}
+
+test_case("BitArrayList push and test") {
+	BitArrayList<> a;
+	for (usize i = 0; i < 300; i++) {
+		a.push(i % 3 == 0);
+	}
+	check_eq(a.len(), 300);
+	check_eq(a.wordCount(), 5);
+	check_eq(a.capacity() % 512, 0);
+	for (usize i = 0; i < 300; i++) {
+		check_eq(a.test(i), i % 3 == 0);
+		check_eq(a[i], i % 3 == 0);
+	}
+	check_eq(a.popcount(), 100);
+}
+
+test_case("BitArrayList set and clear") {
+	BitArrayList<> a = BitArrayList<>::filled(gk::GlobalHeapStaticAllocator(), 130, false);
+	check_eq(a.len(), 130);
+	check_eq(a.popcount(), 0);
+	a.set(0);
+	a.set(64);
+	a.set(129, true);
+	check_eq(a.popcount(), 3);
+	a.clear(64);
+	a.set(0, false);
+	check_eq(a.popcount(), 1);
+	check(a.test(129));
+	check_eq(a.words()[2], 2ULL);
+}
+
+test_case("BitArrayList pop, truncate, and resize keep unused bits zero") {
+	BitArrayList<> a = BitArrayList<>::filled(gk::GlobalHeapStaticAllocator(), 200, true);
+	check_eq(a.popcount(), 200);
+	check(a.pop());
+	check_eq(a.len(), 199);
+	check_eq(a.popcount(), 199);
+	a.truncate(70);
+	check_eq(a.popcount(), 70);
+	check_eq(a.words()[1], (1ULL << 6) - 1);
+	a.resize(140);
+	check_eq(a.popcount(), 70);
+	check(!a.test(100));
+	a.resize(150, true);
+	check_eq(a.popcount(), 80);
+	check(a.test(145));
+	check(!a.test(139));
+}
+
+test_case("BitArrayList fill") {
+	BitArrayList<> a = BitArrayList<>::filled(gk::GlobalHeapStaticAllocator(), 1000, false);
+	a.fill(true);
+	check_eq(a.popcount(), 1000);
+	check_eq(a.words()[15], (1ULL << 40) - 1);
+	a.fill(false);
+	check_eq(a.popcount(), 0);
+}
+
+test_case("BitArrayList findFirstSet and findNextSet") {
+	BitArrayList<> a = BitArrayList<>::filled(gk::GlobalHeapStaticAllocator(), 1000, false);
+	check(a.findFirstSet().none());
+	a.set(5);
+	a.set(63);
+	a.set(64);
+	a.set(999);
+	check_eq(a.findFirstSet().some(), 5);
+	check_eq(a.findNextSet(5).some(), 5);
+	check_eq(a.findNextSet(6).some(), 63);
+	check_eq(a.findNextSet(64).some(), 64);
+	check_eq(a.findNextSet(65).some(), 999);
+	check(a.findNextSet(1000).none());
+
+	usize found = 0;
+	gk::Option<usize> next = a.findFirstSet();
+	while (next.isSome()) {
+		found++;
+		next = a.findNextSet(next.some() + 1);
+	}
+	check_eq(found, 4);
+}
+
+test_case("BitArrayList rank and select") {
+	BitArrayList<> a = makeBitPattern(5000, 7, 3);
+	usize expectedRank = 0;
+	for (usize i = 0; i < a.len(); i++) {
+		check_eq(a.rank(i), expectedRank);
+		if (a.test(i)) {
+			check_eq(a.select(expectedRank).some(), i);
+			expectedRank++;
+		}
+	}
+	check_eq(a.rank(a.len()), expectedRank);
+	check_eq(a.popcount(), expectedRank);
+	check(a.select(expectedRank).none());
+}
+
+test_case("BitArrayList popcount matches scalar") {
+	for (usize length : { 1, 63, 64, 65, 255, 256, 257, 1000, 4099 }) {
+		BitArrayList<> a = makeBitPattern(length, length, 2);
+		usize expected = 0;
+		for (usize i = 0; i < a.len(); i++) {
+			expected += a.test(i) ? 1 : 0;
+		}
+		check_eq(a.popcount(), expected);
+	}
+}
+
+test_case("BitArrayList bulk operations") {
+	for (usize length : { 10, 64, 300, 1027, 4096 }) {
+		const BitArrayList<> a = makeBitPattern(length, 1, 2);
+		const BitArrayList<> b = makeBitPattern(length, 2, 3);
+
+		BitArrayList<> andBits = a;
+		andBits.andWith(b);
+		BitArrayList<> orBits = a;
+		orBits.orWith(b);
+		BitArrayList<> xorBits = a;
+		xorBits.xorWith(b);
+		BitArrayList<> andNotBits = a;
+		andNotBits.andNotWith(b);
+
+		for (usize i = 0; i < length; i++) {
+			check_eq(andBits.test(i), a.test(i) && b.test(i));
+			check_eq(orBits.test(i), a.test(i) || b.test(i));
+			check_eq(xorBits.test(i), a.test(i) != b.test(i));
+			check_eq(andNotBits.test(i), a.test(i) && !b.test(i));
+		}
+		check_eq(andBits.popcount() + orBits.popcount(), a.popcount() + b.popcount());
+	}
+}
+
+test_case("BitArrayList copy, move, and equality") {
+	BitArrayList<> a = makeBitPattern(500, 3, 2);
+	BitArrayList<> b = a;
+	check(a == b);
+	b.set(499, !b.test(499));
+	check(!(a == b));
+	b.set(499, a.test(499));
+	check(a == b);
+	b.pop();
+	check(!(a == b));
+
+	const u64* words = a.words().data();
+	BitArrayList<> c = std::move(a);
+	check_eq(a.len(), 0);
+	check_eq(c.words().data(), words);
+	a = c;
+	check(a == c);
+	b = std::move(c);
+	check_eq(c.len(), 0);
+	check(a == b);
+}
+
+test_case("BitArrayList uses an eighth of the memory of bools") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	{
+		auto a = BitArrayList<gk::AllocatorRef>::withCapacity(allocator.toRef(), 4096);
+		check_eq(allocator.stats().totalAllocations, 1);
+		check_eq(allocator.stats().liveBytes, 4096 / 8);
+		for (usize i = 0; i < 4096; i++) {
+			a.push(true);
+		}
+		check_eq(allocator.stats().totalAllocations, 1);
+	}
+	check_eq(allocator.stats().liveBytes, 0);
+}
+
+#endif
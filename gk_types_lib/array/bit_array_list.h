@@ -0,0 +1,645 @@
+#pragma once
+
+#include "array_list.h"
+#include "../utility.h"
+#include <bit>
+#include <span>
+
+namespace gk
+{
+	namespace internal
+	{
+		// Runtime dispatched to AVX-512, AVX-2, or scalar implementations.
+
+		/// Total number of set bits in `wordCount` words.
+		usize bitArrayPopcount(const u64* words, usize wordCount);
+
+		/// `dst[i] &= src[i]` for `wordCount` words.
+		void bitArrayAnd(u64* dst, const u64* src, usize wordCount);
+
+		/// `dst[i] |= src[i]` for `wordCount` words.
+		void bitArrayOr(u64* dst, const u64* src, usize wordCount);
+
+		/// `dst[i] ^= src[i]` for `wordCount` words.
+		void bitArrayXor(u64* dst, const u64* src, usize wordCount);
+
+		/// `dst[i] &= ~src[i]` for `wordCount` words.
+		void bitArrayAndNot(u64* dst, const u64* src, usize wordCount);
+	}
+
+	/**
+	* Dynamic array of bools, packed one bit per element into 64 bit words.
+	* Uses 1/8th the memory of `gk::ArrayList<bool>`, and supports word level operations,
+	* such as counting set bits, scanning for the next set bit, and bulk AND/OR/XOR/ANDNOT with another BitArrayList,
+	* which use AVX-512 or AVX-2 when available.
+	*
+	* The words are 64 byte aligned, and every bit at or past `len()` is always 0.
+	*
+	* Unlike `gk::ArrayList`, it's not usable in constexpr contexts.
+	*
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	*/
+	template<typename Allocator = GlobalHeapStaticAllocator>
+	struct BitArrayList
+	{
+		static_assert(AllocatorPolicy<Allocator>, "BitArrayList Allocator must be either AllocatorRef, or satisfy gk::StaticAllocator");
+
+	private:
+
+		constexpr static usize WORD_ALIGNMENT = 64;
+
+		/// Word capacity is always a multiple of this, so the allocation is a multiple of 64 bytes.
+		constexpr static usize WORD_CAPACITY_MULTIPLE = WORD_ALIGNMENT / sizeof(u64);
+
+		/**
+		* Simple constructor to initialize the BitArrayList with a specified allocator.
+		* For actual use, call BitArrayList::init() for whichever overload necessary.
+		*/
+		BitArrayList(Allocator&& inAllocator);
+
+	public:
+
+		constexpr static usize BITS_PER_WORD = 64;
+
+		/**
+		* Default constructor uses gk::globalHeapAllocator().
+		*/
+		BitArrayList();
+
+		/**
+		* The copy constructor of BitArrayList will make a clone of the other's allocator.
+		*
+		* @param other: Other BitArrayList to copy bits and allocator from.
+		*/
+		BitArrayList(const BitArrayList& other);
+
+		/**
+		* During move construction, the other BitArrayList will be left empty.
+		*
+		* @param other: Other BitArrayList to take ownership of it's words.
+		*/
+		BitArrayList(BitArrayList&& other) noexcept;
+
+		/**
+		* Frees the held words.
+		*/
+		~BitArrayList();
+
+		/**
+		* The copy assignment operator of BitArrayList will make a clone of the other's allocator.
+		*
+		* @param other: Other BitArrayList to copy bits and allocator from.
+		*/
+		BitArrayList& operator = (const BitArrayList& other);
+
+		/**
+		* During move assignment, the other BitArrayList will be left empty.
+		*
+		* @param other: Other BitArrayList to take ownership of it's words.
+		*/
+		BitArrayList& operator = (BitArrayList&& other) noexcept;
+
+		/**
+		* Create a new BitArrayList given an allocator to take ownership of.
+		*
+		* @param inAllocator: Allocator to own
+		*/
+		[[nodiscard]] static BitArrayList init(Allocator&& inAllocator) { return BitArrayList(std::move(inAllocator)); }
+
+		/**
+		* Create a new BitArrayList given an allocator to take ownership of, with enough words for at least `minCapacity` bits.
+		*
+		* @param inAllocator: Allocator to own
+		* @param minCapacity: Minimum number of bits to hold without reallocating.
+		*/
+		[[nodiscard]] static BitArrayList withCapacity(Allocator&& inAllocator, usize minCapacity);
+
+		/**
+		* Create a new BitArrayList with `length` bits, all set to `value`.
+		*
+		* @param inAllocator: Allocator to own
+		* @param length: Number of bits.
+		* @param value: Value for every bit.
+		*/
+		[[nodiscard]] static BitArrayList filled(Allocator&& inAllocator, usize length, bool value);
+
+		/**
+		* @return The number of bits.
+		*/
+		[[nodiscard]] usize len() const { return _length; }
+
+		/**
+		* @return The number of bits that can be held without reallocating.
+		*/
+		[[nodiscard]] usize capacity() const { return _capacityWords * BITS_PER_WORD; }
+
+		/**
+		* @return The allocator used by the BitArrayList. Can be copied.
+		*/
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
+
+		/**
+		* @return The number of words holding bits, which is `len()` divided by 64, rounded up.
+		*/
+		[[nodiscard]] usize wordCount() const { return (_length + BITS_PER_WORD - 1) / BITS_PER_WORD; }
+
+		/**
+		* Bit `n` is bit `n % 64` of word `n / 64`. Bits at or past `len()` in the last word are 0.
+		*
+		* @return The words holding the bits.
+		*/
+		[[nodiscard]] std::span<const u64> words() const { return std::span<const u64>(_words, wordCount()); }
+
+		/**
+		* @param index: The bit to get. Asserts that is less than `len()`.
+		* @return If the bit is set.
+		*/
+		[[nodiscard]] bool test(usize index) const;
+
+		/**
+		* See `test()`.
+		*/
+		[[nodiscard]] bool operator [] (usize index) const { return test(index); }
+
+		/**
+		* @param index: The bit to change. Asserts that is less than `len()`.
+		* @param value: Value to set the bit to.
+		*/
+		void set(usize index, bool value = true);
+
+		/**
+		* Sets a bit to 0.
+		*
+		* @param index: The bit to clear. Asserts that is less than `len()`.
+		*/
+		void clear(usize index);
+
+		/**
+		* Sets every bit to `value`.
+		*
+		* @param value: Value for every bit.
+		*/
+		void fill(bool value);
+
+		/**
+		* Appends a bit to the end. May reallocate.
+		*
+		* @param value: Value of the new bit.
+		*/
+		void push(bool value);
+
+		/**
+		* Removes the last bit. Asserts that `len()` is not 0.
+		*
+		* @return The value of the removed bit.
+		*/
+		bool pop();
+
+		/**
+		* Reallocates if necessary to hold at least `capacity` bits.
+		*
+		* @param capacity: Minimum number of bits to hold.
+		*/
+		void reserve(usize capacity);
+
+		/**
+		* Changes the number of bits. New bits are set to `value`.
+		*
+		* @param newLength: Number of bits.
+		* @param value: Value of any added bits.
+		*/
+		void resize(usize newLength, bool value = false);
+
+		/**
+		* Removes every bit at or past `newLength`. Does not reallocate.
+		*
+		* @param newLength: Number of bits to keep. Asserts that is less than or equal to `len()`.
+		*/
+		void truncate(usize newLength);
+
+		/**
+		* @return The total number of set bits.
+		*/
+		[[nodiscard]] usize popcount() const;
+
+		/**
+		* @param index: Asserts that is less than or equal to `len()`.
+		* @return The number of set bits before `index`, not including `index` itself.
+		*/
+		[[nodiscard]] usize rank(usize index) const;
+
+		/**
+		* Inverse of `rank()`.
+		*
+		* @param nth: Zero based count of set bits to skip.
+		* @return The index of the `nth` set bit, or None if there are `nth` or fewer set bits.
+		*/
+		[[nodiscard]] Option<usize> select(usize nth) const;
+
+		/**
+		* @return The index of the first set bit, or None if no bits are set.
+		*/
+		[[nodiscard]] Option<usize> findFirstSet() const { return findNextSet(0); }
+
+		/**
+		* @param start: First bit to check.
+		* @return The index of the first set bit at or after `start`, or None if there are none.
+		*/
+		[[nodiscard]] Option<usize> findNextSet(usize start) const;
+
+		/**
+		* Bitwise AND with another BitArrayList of the same length.
+		*
+		* @param other: Asserts that has the same `len()` as this.
+		*/
+		void andWith(const BitArrayList& other);
+
+		/**
+		* Bitwise OR with another BitArrayList of the same length.
+		*
+		* @param other: Asserts that has the same `len()` as this.
+		*/
+		void orWith(const BitArrayList& other);
+
+		/**
+		* Bitwise XOR with another BitArrayList of the same length.
+		*
+		* @param other: Asserts that has the same `len()` as this.
+		*/
+		void xorWith(const BitArrayList& other);
+
+		/**
+		* Clears every bit that is set in another BitArrayList of the same length. `this & ~other`.
+		*
+		* @param other: Asserts that has the same `len()` as this.
+		*/
+		void andNotWith(const BitArrayList& other);
+
+		/**
+		* @return If both have the same length and bits.
+		*/
+		[[nodiscard]] bool operator == (const BitArrayList& other) const;
+
+	private:
+
+		/**
+		* Frees the words, leaving this empty with no capacity.
+		*/
+		void deleteExistingBuffer();
+
+		/**
+		* Moves the words into a new allocation of at least `minWords`. Unused words are zeroed.
+		*/
+		void reallocate(usize minWords);
+
+		/**
+		* Sets or clears bits in the range `[start, end)`. Requires `end` <= `capacity()`.
+		*/
+		void fillRange(usize start, usize end, bool value);
+
+	private:
+
+		u64* _words;
+		usize _length;
+		usize _capacityWords;
+		no_unique_address_member Allocator _allocator;
+
+	}; // struct BitArrayList
+
+	template<typename Allocator>
+	struct is_trivially_relocatable<BitArrayList<Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace gk
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>::BitArrayList(Allocator&& inAllocator)
+	: _words(nullptr), _length(0), _capacityWords(0), _allocator(std::move(inAllocator))
+{}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>::BitArrayList()
+	: _words(nullptr), _length(0), _capacityWords(0), _allocator(internal::arrayListDefaultAllocator<Allocator>())
+{}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>::BitArrayList(const BitArrayList& other)
+	: _words(nullptr), _length(0), _capacityWords(0), _allocator(other._allocator)
+{
+	if (other._length == 0) {
+		return;
+	}
+	reallocate(other.wordCount());
+	std::memcpy(_words, other._words, other.wordCount() * sizeof(u64));
+	_length = other._length;
+}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>::BitArrayList(BitArrayList&& other) noexcept
+	: _words(other._words), _length(other._length), _capacityWords(other._capacityWords), _allocator(std::move(other._allocator))
+{
+	other._words = nullptr;
+	other._length = 0;
+	other._capacityWords = 0;
+}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>::~BitArrayList()
+{
+	deleteExistingBuffer();
+}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>& gk::BitArrayList<Allocator>::operator=(const BitArrayList& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = other._allocator;
+	if (other._length == 0) {
+		return *this;
+	}
+	reallocate(other.wordCount());
+	std::memcpy(_words, other._words, other.wordCount() * sizeof(u64));
+	_length = other._length;
+	return *this;
+}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator>& gk::BitArrayList<Allocator>::operator=(BitArrayList&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = std::move(other._allocator);
+	_words = other._words;
+	_length = other._length;
+	_capacityWords = other._capacityWords;
+	other._words = nullptr;
+	other._length = 0;
+	other._capacityWords = 0;
+	return *this;
+}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator> gk::BitArrayList<Allocator>::withCapacity(Allocator&& inAllocator, usize minCapacity)
+{
+	BitArrayList newList = BitArrayList(std::move(inAllocator));
+	newList.reserve(minCapacity);
+	return newList;
+}
+
+template<typename Allocator>
+inline gk::BitArrayList<Allocator> gk::BitArrayList<Allocator>::filled(Allocator&& inAllocator, usize length, bool value)
+{
+	BitArrayList newList = BitArrayList(std::move(inAllocator));
+	newList.resize(length, value);
+	return newList;
+}
+
+template<typename Allocator>
+inline bool gk::BitArrayList<Allocator>::test(usize index) const
+{
+	check_message(index < _length, "Index out of bounds! Attempted to access bit ", index, " from BitArrayList of length ", _length);
+	return (_words[index / BITS_PER_WORD] >> (index % BITS_PER_WORD)) & 1;
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::set(usize index, bool value)
+{
+	check_message(index < _length, "Index out of bounds! Attempted to set bit ", index, " from BitArrayList of length ", _length);
+	const u64 mask = 1ULL << (index % BITS_PER_WORD);
+	if (value) {
+		_words[index / BITS_PER_WORD] |= mask;
+	}
+	else {
+		_words[index / BITS_PER_WORD] &= ~mask;
+	}
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::clear(usize index)
+{
+	set(index, false);
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::fill(bool value)
+{
+	fillRange(0, _length, value);
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::push(bool value)
+{
+	if (_length == capacity()) {
+		reallocate(internal::arrayGrowCapacity(_capacityWords, _capacityWords + 1));
+	}
+	// The bits past the length are always 0.
+	if (value) {
+		_words[_length / BITS_PER_WORD] |= 1ULL << (_length % BITS_PER_WORD);
+	}
+	_length++;
+}
+
+template<typename Allocator>
+inline bool gk::BitArrayList<Allocator>::pop()
+{
+	check_message(_length > 0, "Cannot pop from BitArrayList with no bits");
+	_length--;
+	const u64 mask = 1ULL << (_length % BITS_PER_WORD);
+	const bool value = (_words[_length / BITS_PER_WORD] & mask) != 0;
+	_words[_length / BITS_PER_WORD] &= ~mask;
+	return value;
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::reserve(usize capacity)
+{
+	if (capacity <= this->capacity()) {
+		return;
+	}
+	reallocate((capacity + BITS_PER_WORD - 1) / BITS_PER_WORD);
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::resize(usize newLength, bool value)
+{
+	if (newLength <= _length) {
+		truncate(newLength);
+		return;
+	}
+	reserve(newLength);
+	if (value) {
+		fillRange(_length, newLength, true);
+	}
+	_length = newLength;
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::truncate(usize newLength)
+{
+	check_message(newLength <= _length, "Cannot truncate BitArrayList to a length greater than it's current length. Current length is ", _length, ", tried to truncate to ", newLength);
+	fillRange(newLength, _length, false);
+	_length = newLength;
+}
+
+template<typename Allocator>
+inline gk::usize gk::BitArrayList<Allocator>::popcount() const
+{
+	return internal::bitArrayPopcount(_words, wordCount());
+}
+
+template<typename Allocator>
+inline gk::usize gk::BitArrayList<Allocator>::rank(usize index) const
+{
+	check_message(index <= _length, "Index out of bounds! Attempted to rank bit ", index, " from BitArrayList of length ", _length);
+	const usize fullWords = index / BITS_PER_WORD;
+	usize count = internal::bitArrayPopcount(_words, fullWords);
+	const usize remainingBits = index % BITS_PER_WORD;
+	if (remainingBits != 0) {
+		count += static_cast<usize>(std::popcount(_words[fullWords] & ((1ULL << remainingBits) - 1)));
+	}
+	return count;
+}
+
+template<typename Allocator>
+inline gk::Option<gk::usize> gk::BitArrayList<Allocator>::select(usize nth) const
+{
+	const usize words = wordCount();
+	for (usize i = 0; i < words; i++) {
+		u64 word = _words[i];
+		const usize setBits = static_cast<usize>(std::popcount(word));
+		if (nth >= setBits) {
+			nth -= setBits;
+			continue;
+		}
+
+		for (usize skip = 0; skip < nth; skip++) {
+			word &= word - 1;
+		}
+		return Option<usize>(i * BITS_PER_WORD + static_cast<usize>(std::countr_zero(word)));
+	}
+	return Option<usize>();
+}
+
+template<typename Allocator>
+inline gk::Option<gk::usize> gk::BitArrayList<Allocator>::findNextSet(usize start) const
+{
+	if (start >= _length) {
+		return Option<usize>();
+	}
+
+	const usize words = wordCount();
+	usize wordIndex = start / BITS_PER_WORD;
+	u64 word = _words[wordIndex] & (~0ULL << (start % BITS_PER_WORD));
+	while (true) {
+		// Bits past the length are always 0, so any found bit is in bounds.
+		Option<usize> found = bitscanForwardNext(&word);
+		if (found.isSome()) {
+			return Option<usize>(wordIndex * BITS_PER_WORD + found.some());
+		}
+
+		wordIndex++;
+		if (wordIndex == words) {
+			return Option<usize>();
+		}
+		word = _words[wordIndex];
+	}
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::andWith(const BitArrayList& other)
+{
+	check_message(_length == other._length, "BitArrayList AND requires equal lengths. This length is ", _length, ", other length is ", other._length);
+	internal::bitArrayAnd(_words, other._words, wordCount());
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::orWith(const BitArrayList& other)
+{
+	check_message(_length == other._length, "BitArrayList OR requires equal lengths. This length is ", _length, ", other length is ", other._length);
+	internal::bitArrayOr(_words, other._words, wordCount());
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::xorWith(const BitArrayList& other)
+{
+	check_message(_length == other._length, "BitArrayList XOR requires equal lengths. This length is ", _length, ", other length is ", other._length);
+	internal::bitArrayXor(_words, other._words, wordCount());
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::andNotWith(const BitArrayList& other)
+{
+	check_message(_length == other._length, "BitArrayList ANDNOT requires equal lengths. This length is ", _length, ", other length is ", other._length);
+	internal::bitArrayAndNot(_words, other._words, wordCount());
+}
+
+template<typename Allocator>
+inline bool gk::BitArrayList<Allocator>::operator==(const BitArrayList& other) const
+{
+	if (_length != other._length) {
+		return false;
+	}
+	if (_length == 0) {
+		return true;
+	}
+	return std::memcmp(_words, other._words, wordCount() * sizeof(u64)) == 0;
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::deleteExistingBuffer()
+{
+	if (_words != nullptr) {
+		_allocator.freeAlignedBuffer(_words, _capacityWords, WORD_ALIGNMENT);
+	}
+	_words = nullptr;
+	_length = 0;
+	_capacityWords = 0;
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::reallocate(usize minWords)
+{
+	const usize newCapacityWords = ((minWords + WORD_CAPACITY_MULTIPLE - 1) / WORD_CAPACITY_MULTIPLE) * WORD_CAPACITY_MULTIPLE;
+	u64* newWords = _allocator.template mallocAlignedBuffer<u64>(newCapacityWords, WORD_ALIGNMENT).ok();
+	const usize usedWords = wordCount();
+	if (_words != nullptr) {
+		std::memcpy(newWords, _words, usedWords * sizeof(u64));
+		_allocator.freeAlignedBuffer(_words, _capacityWords, WORD_ALIGNMENT);
+	}
+	std::memset(newWords + usedWords, 0, (newCapacityWords - usedWords) * sizeof(u64));
+	_words = newWords;
+	_capacityWords = newCapacityWords;
+}
+
+template<typename Allocator>
+inline void gk::BitArrayList<Allocator>::fillRange(usize start, usize end, bool value)
+{
+	if (start >= end) {
+		return;
+	}
+
+	const usize firstWord = start / BITS_PER_WORD;
+	const usize lastWord = (end - 1) / BITS_PER_WORD;
+	const u64 firstMask = ~0ULL << (start % BITS_PER_WORD);
+	const u64 lastMask = ~0ULL >> (BITS_PER_WORD - 1 - ((end - 1) % BITS_PER_WORD));
+	const u64 fillWord = value ? ~0ULL : 0;
+
+	if (firstWord == lastWord) {
+		const u64 mask = firstMask & lastMask;
+		_words[firstWord] = (_words[firstWord] & ~mask) | (fillWord & mask);
+		return;
+	}
+
+	_words[firstWord] = (_words[firstWord] & ~firstMask) | (fillWord & firstMask);
+	if (lastWord > firstWord + 1) {
+		std::memset(_words + firstWord + 1, value ? 0xFF : 0, (lastWord - firstWord - 1) * sizeof(u64));
+	}
+	_words[lastWord] = (_words[lastWord] & ~lastMask) | (fillWord & lastMask);
+}
@@ -0,0 +1,176 @@
+#include "concurrent_array_list.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../allocator/stats_allocator.h"
+#include "../job/job_system.h"
+#include "../string/string.h"
+
+using gk::ConcurrentArrayList;
+using gk::ArrayList;
+using gk::usize;
+using gk::u64;
+
+namespace gk
+{
+	namespace unitTests
+	{
+		constexpr usize CONCURRENT_PUSH_JOB_COUNT = 8;
+		constexpr usize CONCURRENT_PUSHES_PER_JOB = 10000;
+
+		struct ConcurrentPushJob {
+			ConcurrentArrayList<u64>* list;
+			u64 firstValue;
+			std::atomic<usize>* remainingJobs;
+		};
+
+		static void runConcurrentPushJob(ConcurrentPushJob* job) {
+			for (u64 i = 0; i < CONCURRENT_PUSHES_PER_JOB; i++) {
+				job->list->push(job->firstValue + i);
+			}
+			job->remainingJobs->fetch_sub(1, std::memory_order::release);
+		}
+
+		static void runConcurrentPushBufferJob(ConcurrentPushJob* job) {
+			u64 values[100];
+			for (u64 i = 0; i < CONCURRENT_PUSHES_PER_JOB; i += 100) {
+				for (u64 j = 0; j < 100; j++) {
+					values[j] = job->firstValue + i + j;
+				}
+				job->list->pushBufferCopy(values, 100);
+			}
+			job->remainingJobs->fetch_sub(1, std::memory_order::release);
+		}
+
+		static void checkConcurrentPushes(ArrayList<u64>& frozen) {
+			check_eq(frozen.len(), CONCURRENT_PUSH_JOB_COUNT * CONCURRENT_PUSHES_PER_JOB);
+			frozen.sort();
+			for (usize i = 0; i < frozen.len(); i++) {
+				check_eq(frozen[i], i);
+			}
+		}
+	}
+}
+
+using gk::unitTests::ConcurrentPushJob;
+
+test_case("ConcurrentArrayList default construct") {
+	ConcurrentArrayList<int> a;
+	check_eq(a.len(), 0);
+	ArrayList<int> frozen = a.freeze();
+	check_eq(frozen.len(), 0);
+}
+
+test_case("ConcurrentArrayList push and freeze single thread") {
+	ConcurrentArrayList<gk::String> a;
+	for (u64 i = 0; i < 500; i++) {
+		check_eq(a.push(gk::String::fromUint(i)), i);
+	}
+	check_eq(a.len(), 500);
+	check_eq(a[321], gk::String::fromUint(321));
+
+	ArrayList<gk::String> frozen = a.freeze();
+	check_eq(a.len(), 0);
+	check_eq(frozen.len(), 500);
+	for (u64 i = 0; i < 500; i++) {
+		check_eq(frozen[i], gk::String::fromUint(i));
+	}
+
+	a.push(gk::String::fromUint(1000));
+	check_eq(a.len(), 1);
+	check_eq(a[0], gk::String::fromUint(1000));
+}
+
+test_case("ConcurrentArrayList pushBufferCopy spans segments") {
+	ConcurrentArrayList<u64> a;
+	a.push(0);
+	u64 values[200];
+	for (u64 i = 0; i < 200; i++) {
+		values[i] = i + 1;
+	}
+	check_eq(a.pushBufferCopy(values, 200), 1);
+	ArrayList<u64> frozen = a.freeze();
+	check_eq(frozen.len(), 201);
+	for (u64 i = 0; i < 201; i++) {
+		check_eq(frozen[i], i);
+	}
+}
+
+test_case("ConcurrentArrayList reserve allocates up front") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	{
+		auto a = ConcurrentArrayList<u64>::init(allocator.toRef());
+		a.reserve(1000);
+		const usize allocations = allocator.stats().totalAllocations;
+		for (u64 i = 0; i < 1000; i++) {
+			a.push(i);
+		}
+		check_eq(allocator.stats().totalAllocations, allocations);
+		ArrayList<u64> frozen = a.freeze();
+		check_eq(frozen.len(), 1000);
+		check_eq(frozen[999], 999);
+	}
+	check_eq(allocator.stats().liveBytes, 0);
+}
+
+test_case("ConcurrentArrayList push from many jobs") {
+	gk::JobSystem jobSystem(4);
+	ConcurrentArrayList<u64> a;
+	std::atomic<usize> remainingJobs = gk::unitTests::CONCURRENT_PUSH_JOB_COUNT;
+	ConcurrentPushJob jobs[gk::unitTests::CONCURRENT_PUSH_JOB_COUNT];
+	for (usize i = 0; i < gk::unitTests::CONCURRENT_PUSH_JOB_COUNT; i++) {
+		jobs[i] = ConcurrentPushJob{ &a, i * gk::unitTests::CONCURRENT_PUSHES_PER_JOB, &remainingJobs };
+		(void)jobSystem.runJob(gk::unitTests::runConcurrentPushJob, &jobs[i]);
+	}
+	while (remainingJobs.load(std::memory_order::acquire) != 0) {
+		std::this_thread::yield();
+	}
+
+	ArrayList<u64> frozen = a.freeze();
+	gk::unitTests::checkConcurrentPushes(frozen);
+}
+
+test_case("ConcurrentArrayList pushBufferCopy from many jobs") {
+	gk::JobSystem jobSystem(4);
+	ConcurrentArrayList<u64> a;
+	std::atomic<usize> remainingJobs = gk::unitTests::CONCURRENT_PUSH_JOB_COUNT;
+	ConcurrentPushJob jobs[gk::unitTests::CONCURRENT_PUSH_JOB_COUNT];
+	for (usize i = 0; i < gk::unitTests::CONCURRENT_PUSH_JOB_COUNT; i++) {
+		jobs[i] = ConcurrentPushJob{ &a, i * gk::unitTests::CONCURRENT_PUSHES_PER_JOB, &remainingJobs };
+		(void)jobSystem.runJob(gk::unitTests::runConcurrentPushBufferJob, &jobs[i]);
+	}
+	while (remainingJobs.load(std::memory_order::acquire) != 0) {
+		std::this_thread::yield();
+	}
+
+	ArrayList<u64> frozen = a.freeze();
+	// Every buffer is kept adjacent.
+	for (usize i = 0; i < frozen.len(); i++) {
+		check_eq(frozen[i], frozen[i - (i % 100)] + (i % 100));
+	}
+	gk::unitTests::checkConcurrentPushes(frozen);
+}
+
+test_case("ConcurrentArrayList allocates each segment once from many jobs") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	{
+		gk::JobSystem jobSystem(4);
+		auto a = ConcurrentArrayList<u64>::init(allocator.toRef());
+		std::atomic<usize> remainingJobs = gk::unitTests::CONCURRENT_PUSH_JOB_COUNT;
+		ConcurrentPushJob jobs[gk::unitTests::CONCURRENT_PUSH_JOB_COUNT];
+		for (usize i = 0; i < gk::unitTests::CONCURRENT_PUSH_JOB_COUNT; i++) {
+			jobs[i] = ConcurrentPushJob{ &a, i * gk::unitTests::CONCURRENT_PUSHES_PER_JOB, &remainingJobs };
+			(void)jobSystem.runJob(gk::unitTests::runConcurrentPushJob, &jobs[i]);
+		}
+		while (remainingJobs.load(std::memory_order::acquire) != 0) {
+			std::this_thread::yield();
+		}
+
+		const usize totalPushes = gk::unitTests::CONCURRENT_PUSH_JOB_COUNT * gk::unitTests::CONCURRENT_PUSHES_PER_JOB;
+		const usize segmentCount = gk::internal::SegmentLayout<u64>::segmentOf(totalPushes - 1) + 1;
+		check_eq(allocator.stats().totalAllocations, segmentCount);
+	}
+	check_eq(allocator.stats().liveBytes, 0);
+}
+
+#endif
@@ -0,0 +1,322 @@
+#pragma once
+
+#include "segmented_array_list.h"
+#include <atomic>
+#include <thread>
+
+namespace gk
+{
+	/**
+	* Append only list that many threads can push into at once without a lock.
+	* Each push reserves it's index with a single atomic increment, then constructs the element in place
+	* within power of two sized segments (see `gk::SegmentedArrayList`), so existing elements are never moved.
+	* The first thread to reach an unallocated segment claims it and allocates it. Other threads that reach
+	* the same segment wait for it to be published, rather than allocating their own copy.
+	*
+	* Once every push has finished, and the pushing threads have been synchronized with (such as with `gk::JobSystem::wait()`),
+	* call `freeze()` to move the elements into an ordinary `gk::ArrayList`.
+	* The order of the elements is the order the indices were reserved in.
+	*
+	* Cannot be copied or moved, as other threads may be pushing into it.
+	*
+	* @param T: Element type.
+	* @param Allocator: Either `AllocatorRef` for runtime chosen allocators, or a `StaticAllocator`.
+	* Defaults to `AllocatorRef`, matching the `ArrayList` returned by `freeze()`.
+	* Must be safe to allocate from on multiple threads at once.
+	*/
+	template<typename T, typename Allocator = AllocatorRef>
+	struct ConcurrentArrayList
+	{
+		static_assert(AllocatorPolicy<Allocator>, "ConcurrentArrayList Allocator must be either AllocatorRef, or satisfy gk::StaticAllocator");
+
+	private:
+
+		using Layout = internal::SegmentLayout<T>;
+
+		constexpr static usize SEGMENT_ALIGNMENT = alignof(T) > 64 ? alignof(T) : 64;
+
+		/**
+		* Simple constructor to initialize the ConcurrentArrayList with a specified allocator.
+		* For actual use, call ConcurrentArrayList::init().
+		*/
+		ConcurrentArrayList(Allocator&& inAllocator);
+
+	public:
+
+		using ValueType = T;
+
+		/**
+		* Default constructor uses gk::globalHeapAllocator().
+		*/
+		ConcurrentArrayList();
+
+		ConcurrentArrayList(const ConcurrentArrayList&) = delete;
+		ConcurrentArrayList(ConcurrentArrayList&&) = delete;
+		ConcurrentArrayList& operator = (const ConcurrentArrayList&) = delete;
+		ConcurrentArrayList& operator = (ConcurrentArrayList&&) = delete;
+
+		/**
+		* Destructs all held elements, freeing every segment. No pushes may be in progress.
+		*/
+		~ConcurrentArrayList();
+
+		/**
+		* Create a new ConcurrentArrayList given an allocator to take ownership of.
+		*
+		* @param inAllocator: Allocator to own
+		*/
+		[[nodiscard]] static ConcurrentArrayList init(Allocator&& inAllocator) { return ConcurrentArrayList(std::move(inAllocator)); }
+
+		/**
+		* The number of indices reserved by pushes. Is only the number of constructed elements
+		* once every push has returned.
+		*/
+		[[nodiscard]] usize len() const { return _length.load(std::memory_order::acquire); }
+
+		/**
+		* @return The allocator used by the ConcurrentArrayList. Can be copied.
+		*/
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
+
+		/**
+		* Get a mutable reference to an element. The element's push must have completed,
+		* and have been synchronized with by the calling thread.
+		*
+		* @param index: The element to get. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] T& operator [] (usize index);
+
+		/**
+		* Get an immutable reference to an element. The element's push must have completed,
+		* and have been synchronized with by the calling thread.
+		*
+		* @param index: The element to get. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] const T& operator [] (usize index) const;
+
+		/**
+		* Pushes a copy of `element`. Thread safe.
+		* Requires that T is copyable.
+		*
+		* @param element: Element to be copied into the ConcurrentArrayList.
+		* @return The index of the pushed element.
+		*/
+		usize push(const T& element);
+
+		/**
+		* Moves `element` into the ConcurrentArrayList. Thread safe.
+		*
+		* @param element: Element to be moved into the ConcurrentArrayList.
+		* @return The index of the pushed element.
+		*/
+		usize push(T&& element);
+
+		/**
+		* Pushes copies of `elementsToCopy` elements, keeping them adjacent, reserving
+		* all of their indices with a single atomic increment. Thread safe.
+		* `buffer` must be non-null, and be valid up to `buffer[elementsToCopy - 1]`.
+		*
+		* @param buffer: Non null pointer of T's to copy.
+		* @param elementsToCopy: Total number of elements to copy from `buffer`.
+		* @return The index of the first pushed element.
+		*/
+		usize pushBufferCopy(const T* buffer, usize elementsToCopy);
+
+		/**
+		* Allocates segments up front so that at least `capacity` elements can be pushed
+		* without allocating. Thread safe.
+		*
+		* @param capacity: Minimum number of elements to hold.
+		*/
+		void reserve(usize capacity);
+
+		/**
+		* Moves every element into an ArrayList, in index order, using a copy of this allocator.
+		* Leaves this ConcurrentArrayList empty, and reusable.
+		* No pushes may be in progress, and all completed pushes must have been synchronized with.
+		*
+		* @return ArrayList holding all pushed elements.
+		*/
+		[[nodiscard]] ArrayList<T, Allocator> freeze();
+
+	private:
+
+		T* elementAt(usize index) const;
+
+		/**
+		* Gets the segment, allocating it if it hasn't been already. Only the thread that claims the segment
+		* allocates it. Other threads reaching the same segment spin until it is published.
+		*/
+		T* acquireSegment(usize segmentIndex);
+
+		/**
+		* Destructs all elements, and frees every segment.
+		*/
+		void deleteExistingBuffer();
+
+	private:
+
+		std::atomic<T*> _segments[Layout::MAX_SEGMENT_COUNT];
+		/// Set by the thread that allocates the corresponding segment. Cleared once the segment is freed.
+		std::atomic<bool> _segmentsClaimed[Layout::MAX_SEGMENT_COUNT];
+		std::atomic<usize> _length;
+		no_unique_address_member Allocator _allocator;
+
+	}; // struct ConcurrentArrayList
+
+} // namespace gk
+
+template<typename T, typename Allocator>
+inline gk::ConcurrentArrayList<T, Allocator>::ConcurrentArrayList(Allocator&& inAllocator)
+	: _segments{}, _segmentsClaimed{}, _length(0), _allocator(std::move(inAllocator))
+{}
+
+template<typename T, typename Allocator>
+inline gk::ConcurrentArrayList<T, Allocator>::ConcurrentArrayList()
+	: _segments{}, _segmentsClaimed{}, _length(0), _allocator(internal::arrayListDefaultAllocator<Allocator>())
+{}
+
+template<typename T, typename Allocator>
+inline gk::ConcurrentArrayList<T, Allocator>::~ConcurrentArrayList()
+{
+	deleteExistingBuffer();
+}
+
+template<typename T, typename Allocator>
+inline T& gk::ConcurrentArrayList<T, Allocator>::operator[](usize index)
+{
+	check_message(index < len(), "Index out of bounds! Attempted to access index ", index, " from ConcurrentArrayList of length ", len());
+	return *elementAt(index);
+}
+
+template<typename T, typename Allocator>
+inline const T& gk::ConcurrentArrayList<T, Allocator>::operator[](usize index) const
+{
+	check_message(index < len(), "Index out of bounds! Attempted to access index ", index, " from ConcurrentArrayList of length ", len());
+	return *elementAt(index);
+}
+
+template<typename T, typename Allocator>
+inline gk::usize gk::ConcurrentArrayList<T, Allocator>::push(const T& element)
+{
+	const usize index = _length.fetch_add(1, std::memory_order::acq_rel);
+	const usize segmentIndex = Layout::segmentOf(index);
+	T* segment = acquireSegment(segmentIndex);
+	new (segment + (index - Layout::segmentStart(segmentIndex))) T(element);
+	return index;
+}
+
+template<typename T, typename Allocator>
+inline gk::usize gk::ConcurrentArrayList<T, Allocator>::push(T&& element)
+{
+	const usize index = _length.fetch_add(1, std::memory_order::acq_rel);
+	const usize segmentIndex = Layout::segmentOf(index);
+	T* segment = acquireSegment(segmentIndex);
+	new (segment + (index - Layout::segmentStart(segmentIndex))) T(std::move(element));
+	return index;
+}
+
+template<typename T, typename Allocator>
+inline gk::usize gk::ConcurrentArrayList<T, Allocator>::pushBufferCopy(const T* buffer, usize elementsToCopy)
+{
+	check_message(buffer != nullptr, "Cannot push copies of elements from a null buffer");
+	const usize start = _length.fetch_add(elementsToCopy, std::memory_order::acq_rel);
+	usize copied = 0;
+	while (copied < elementsToCopy) {
+		// Copy as much as fits in each segment at once.
+		const usize index = start + copied;
+		const usize segmentIndex = Layout::segmentOf(index);
+		T* segment = acquireSegment(segmentIndex);
+		const usize offset = index - Layout::segmentStart(segmentIndex);
+		const usize segmentRemaining = Layout::segmentCapacity(segmentIndex) - offset;
+		const usize count = (elementsToCopy - copied) < segmentRemaining ? (elementsToCopy - copied) : segmentRemaining;
+		for (usize i = 0; i < count; i++) {
+			new (segment + offset + i) T(buffer[copied + i]);
+		}
+		copied += count;
+	}
+	return start;
+}
+
+template<typename T, typename Allocator>
+inline void gk::ConcurrentArrayList<T, Allocator>::reserve(usize capacity)
+{
+	if (capacity == 0) return;
+
+	const usize lastSegment = Layout::segmentOf(capacity - 1);
+	for (usize i = 0; i <= lastSegment; i++) {
+		(void)acquireSegment(i);
+	}
+}
+
+template<typename T, typename Allocator>
+inline gk::ArrayList<T, Allocator> gk::ConcurrentArrayList<T, Allocator>::freeze()
+{
+	const usize length = len();
+	ArrayList<T, Allocator> out = ArrayList<T, Allocator>::withCapacity(Allocator(_allocator), length);
+	for (usize segmentIndex = 0; Layout::segmentStart(segmentIndex) < length; segmentIndex++) {
+		T* segment = _segments[segmentIndex].load(std::memory_order::acquire);
+		const usize segmentEnd = Layout::segmentStart(segmentIndex + 1);
+		const usize count = (segmentEnd < length ? segmentEnd : length) - Layout::segmentStart(segmentIndex);
+		for (usize i = 0; i < count; i++) {
+			out.push(std::move(segment[i]));
+		}
+	}
+	deleteExistingBuffer();
+	return out;
+}
+
+template<typename T, typename Allocator>
+inline T* gk::ConcurrentArrayList<T, Allocator>::elementAt(usize index) const
+{
+	const usize segmentIndex = Layout::segmentOf(index);
+	return _segments[segmentIndex].load(std::memory_order::acquire) + (index - Layout::segmentStart(segmentIndex));
+}
+
+template<typename T, typename Allocator>
+inline T* gk::ConcurrentArrayList<T, Allocator>::acquireSegment(usize segmentIndex)
+{
+	check_message(segmentIndex < Layout::MAX_SEGMENT_COUNT, "ConcurrentArrayList cannot allocate more than ", Layout::MAX_SEGMENT_COUNT, " segments");
+
+	T* segment = _segments[segmentIndex].load(std::memory_order::acquire);
+	if (segment != nullptr) {
+		return segment;
+	}
+
+	if (!_segmentsClaimed[segmentIndex].exchange(true, std::memory_order::acq_rel)) {
+		T* newSegment = _allocator.template mallocAlignedBuffer<T>(Layout::segmentCapacity(segmentIndex), SEGMENT_ALIGNMENT).ok();
+		_segments[segmentIndex].store(newSegment, std::memory_order::release);
+		return newSegment;
+	}
+
+	// Another thread claimed this segment first, and is allocating it.
+	while ((segment = _segments[segmentIndex].load(std::memory_order::acquire)) == nullptr) {
+		std::this_thread::yield();
+	}
+	return segment;
+}
+
+template<typename T, typename Allocator>
+inline void gk::ConcurrentArrayList<T, Allocator>::deleteExistingBuffer()
+{
+	const usize length = _length.load(std::memory_order::acquire);
+	for (usize segmentIndex = 0; segmentIndex < Layout::MAX_SEGMENT_COUNT; segmentIndex++) {
+		T* segment = _segments[segmentIndex].load(std::memory_order::acquire);
+		if (segment == nullptr) {
+			continue;
+		}
+
+		const usize segmentStart = Layout::segmentStart(segmentIndex);
+		if (segmentStart < length) {
+			const usize segmentEnd = Layout::segmentStart(segmentIndex + 1);
+			const usize count = (segmentEnd < length ? segmentEnd : length) - segmentStart;
+			for (usize i = 0; i < count; i++) {
+				segment[i].~T();
+			}
+		}
+		_allocator.freeAlignedBuffer(segment, Layout::segmentCapacity(segmentIndex), SEGMENT_ALIGNMENT);
+		_segments[segmentIndex].store(nullptr, std::memory_order::release);
+		_segmentsClaimed[segmentIndex].store(false, std::memory_order::release);
+	}
+	_length.store(0, std::memory_order::release);
+}
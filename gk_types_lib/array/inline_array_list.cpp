@@ -0,0 +1,178 @@
+#include "inline_array_list.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../allocator/stats_allocator.h"
+#include "../string/string.h"
+
+using gk::InlineArrayList;
+using gk::usize;
+using gk::i64;
+using gk::u64;
+
+static_assert(InlineArrayList<int, 8>::INLINE_CAPACITY == 8);
+static_assert(InlineArrayList<int, 4>::INLINE_CAPACITY == 4);
+static_assert(InlineArrayList<u64, 8>::INLINE_CAPACITY == 8);
+static_assert(InlineArrayList<gk::String, 3>::INLINE_CAPACITY == 3);
+static_assert(!gk::is_trivially_relocatable_v<InlineArrayList<int, 8>>);
+static_assert(alignof(InlineArrayList<int, 4>) == alignof(usize));
+
+test_case("InlineArrayList default construct") {
+	InlineArrayList<int, 8> a;
+	check_eq(a.len(), 0);
+	check_eq(a.capacity(), InlineArrayList<int, 8>::INLINE_CAPACITY);
+	check(a.isInline());
+}
+
+test_case("InlineArrayList push within inline capacity does not allocate") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	auto a = InlineArrayList<gk::String, 4, gk::AllocatorRef>::init(allocator.toRef());
+	for (usize i = 0; i < 4; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	check(a.isInline());
+	check_eq(allocator.stats().totalAllocations, 0);
+	check_eq(a[3], gk::String::fromUint(3));
+}
+
+test_case("InlineArrayList push spills to allocator") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	auto a = InlineArrayList<gk::String, 4, gk::AllocatorRef>::init(allocator.toRef());
+	for (usize i = 0; i < 5; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	check_not(a.isInline());
+	check_eq(allocator.stats().totalAllocations, 1);
+	for (usize i = 0; i < 5; i++) {
+		check_eq(a[i], gk::String::fromUint(i));
+	}
+}
+
+test_case("InlineArrayList shrink to fit moves back inline") {
+	InlineArrayList<gk::String, 4> a;
+	for (usize i = 0; i < 10; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	check_not(a.isInline());
+	a.truncate(2);
+	a.shrinkToFit();
+	check(a.isInline());
+	check_eq(a.len(), 2);
+	check_eq(a[1], gk::String::fromUint(1));
+}
+
+test_case("InlineArrayList simd find inline") {
+	InlineArrayList<int, 8> a;
+	for (int i = 0; i < 8; i++) {
+		a.push(i);
+	}
+	check(a.isInline());
+	check_eq(a.find(5).someCopy(), 5);
+	check(a.find(100).none());
+}
+
+test_case("InlineArrayList simd find on heap") {
+	InlineArrayList<i64, 4> a;
+	for (i64 i = 0; i < 100; i++) {
+		a.push(i);
+	}
+	check_not(a.isInline());
+	check_eq(a.find(75).someCopy(), 75);
+	check(a.find(-1).none());
+}
+
+test_case("InlineArrayList find non simd") {
+	InlineArrayList<gk::String, 2> a;
+	a.push(gk::String::fromUint(0));
+	a.push(gk::String::fromUint(1));
+	a.push(gk::String::fromUint(2));
+	check_eq(a.find(gk::String::fromUint(2)).someCopy(), 2);
+	check(a.find(gk::String::fromUint(3)).none());
+}
+
+test_case("InlineArrayList remove and insert") {
+	InlineArrayList<gk::String, 4> a;
+	a.push(gk::String::fromUint(0));
+	a.push(gk::String::fromUint(1));
+	a.push(gk::String::fromUint(2));
+	check_eq(a.remove(1), gk::String::fromUint(1));
+	check_eq(a.len(), 2);
+	check_eq(a[1], gk::String::fromUint(2));
+	a.insert(0, gk::String::fromUint(5));
+	check_eq(a[0], gk::String::fromUint(5));
+	check_eq(a[1], gk::String::fromUint(0));
+	check_eq(a[2], gk::String::fromUint(2));
+}
+
+test_case("InlineArrayList remove swap and insert swap") {
+	InlineArrayList<int, 4> a;
+	a.appendList({ 0, 1, 2, 3 });
+	check_eq(a.removeSwap(0), 0);
+	check_eq(a[0], 3);
+	a.insertSwap(0, 10);
+	check_eq(a[0], 10);
+	check_eq(a[3], 3);
+}
+
+test_case("InlineArrayList copy") {
+	InlineArrayList<gk::String, 2> a;
+	a.push(gk::String::fromUint(0));
+	InlineArrayList<gk::String, 2> b = a;
+	a.push(gk::String::fromUint(1));
+	a.push(gk::String::fromUint(2));
+	InlineArrayList<gk::String, 2> c = a;
+	check_eq(b.len(), 1);
+	check(b.isInline());
+	check_eq(c.len(), 3);
+	check_eq(c[2], gk::String::fromUint(2));
+}
+
+test_case("InlineArrayList move inline") {
+	InlineArrayList<gk::String, 4> a;
+	a.push(gk::String::fromUint(0));
+	InlineArrayList<gk::String, 4> b = std::move(a);
+	check_eq(a.len(), 0);
+	check_eq(b.len(), 1);
+	check(b.isInline());
+	check_eq(b[0], gk::String::fromUint(0));
+}
+
+test_case("InlineArrayList move heap") {
+	InlineArrayList<gk::String, 2> a;
+	for (usize i = 0; i < 10; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	const gk::String* heapData = a.data();
+	InlineArrayList<gk::String, 2> b;
+	b = std::move(a);
+	check_eq(b.data(), heapData);
+	check(a.isInline());
+	check_eq(a.len(), 0);
+	check_eq(b[9], gk::String::fromUint(9));
+}
+
+test_case("InlineArrayList resize") {
+	InlineArrayList<gk::String, 2> a;
+	a.resize(5, gk::String::fromUint(7));
+	check_eq(a.len(), 5);
+	check_eq(a[4], gk::String::fromUint(7));
+	a.resize(1, gk::String());
+	check_eq(a.len(), 1);
+}
+
+test_case("InlineArrayList iterators") {
+	InlineArrayList<int, 4> a;
+	a.appendList({ 1, 2, 3 });
+	int sum = 0;
+	for (int i : a) {
+		sum += i;
+	}
+	check_eq(sum, 6);
+	int last = 0;
+	for (auto it = a.rbegin(); it != a.rend(); ++it) {
+		last = *it;
+	}
+	check_eq(last, 1);
+}
+
+#endif
@@ -0,0 +1,711 @@
+#pragma once
+
+#include "array_list.h"
+
+namespace gk
+{
+	/**
+	* ArrayList that stores up to `N` elements inside the object itself, only allocating from its
+	* allocator once that overflows. Has the same API as `gk::ArrayList`, and uses the same SIMD find.
+	* The inline buffer holds exactly `N` elements, and is only aligned to `T`.
+	*
+	* Unlike `gk::ArrayList`, it's not usable in constexpr contexts.
+	* As `data()` may point into the object itself, it is not trivially relocatable.
+	*
+	* @param T: Element type.
+	* @param N: Number of elements stored inline. Must be greater than 0.
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	* Only used once more than `INLINE_CAPACITY` elements are required.
+	*/
+	template<typename T, usize N, typename Allocator = GlobalHeapStaticAllocator>
+	struct InlineArrayList
+	{
+		static_assert(N > 0, "InlineArrayList must have an inline capacity greater than 0. Use ArrayList instead");
+		static_assert(AllocatorPolicy<Allocator>, "InlineArrayList Allocator must be either AllocatorRef, or satisfy gk::StaticAllocator");
+
+	private:
+
+		constexpr static bool IS_T_SIMD = (std::is_arithmetic_v<T> || std::is_pointer_v<T> || std::is_enum_v<T>);
+
+		constexpr static bool IS_T_RELOCATABLE = gk::is_trivially_relocatable_v<T>;
+
+		/**
+		* Simple constructor to initialize the InlineArrayList with a specified allocator.
+		* For actual use, call InlineArrayList::init() for whichever overload necessary.
+		*/
+		InlineArrayList(Allocator&& inAllocator);
+
+	public:
+
+		using ValueType = T;
+		using Iterator = typename ArrayList<T, Allocator>::Iterator;
+		using ConstIterator = typename ArrayList<T, Allocator>::ConstIterator;
+		using ReverseIterator = typename ArrayList<T, Allocator>::ReverseIterator;
+		using ReverseConstIterator = typename ArrayList<T, Allocator>::ReverseConstIterator;
+
+		/**
+		* The number of elements that can be held without using the allocator. Always `N`.
+		*/
+		constexpr static usize INLINE_CAPACITY = N;
+
+		/**
+		* Default constructor uses gk::globalHeapAllocator() if the inline buffer overflows.
+		*/
+		InlineArrayList();
+
+		/**
+		* The copy constructor of InlineArrayList will make a clone of the other's allocator.
+		* Requires that T is copyable.
+		*
+		* @param other: Other InlineArrayList to copy elements and allocator from.
+		*/
+		InlineArrayList(const InlineArrayList& other);
+
+		/**
+		* If the other is using it's inline buffer, the elements are moved individually.
+		* Otherwise, ownership of it's heap buffer is taken.
+		* Either way, the other will be left empty.
+		*
+		* @param other: Other InlineArrayList to take ownership of it's held data.
+		*/
+		InlineArrayList(InlineArrayList&& other) noexcept;
+
+		/**
+		* Destructs all held elements, freeing the heap buffer if one is used.
+		*/
+		~InlineArrayList();
+
+		/**
+		* The copy assignment operator of InlineArrayList will make a clone of the other's allocator.
+		* Requires that T is copyable.
+		*
+		* @param other: Other InlineArrayList to copy elements and allocator from.
+		*/
+		InlineArrayList& operator = (const InlineArrayList& other);
+
+		/**
+		* If the other is using it's inline buffer, the elements are moved individually.
+		* Otherwise, ownership of it's heap buffer is taken.
+		* Either way, the other will be left empty.
+		*
+		* @param other: Other InlineArrayList to take ownership of it's held data.
+		*/
+		InlineArrayList& operator = (InlineArrayList&& other) noexcept;
+
+		/**
+		* Create a new InlineArrayList given an allocator to take ownership of.
+		*
+		* @param inAllocator: Allocator to own
+		*/
+		[[nodiscard]] static InlineArrayList init(Allocator&& inAllocator) { return InlineArrayList(std::move(inAllocator)); }
+
+		/**
+		* Creates a new InlineArrayList given an allocator to take ownership of, and an initializer list to copy elements.
+		*
+		* @param inAllocator: Allocator to own
+		* @param initializerList: Elements to copy
+		*/
+		[[nodiscard]] static InlineArrayList initList(Allocator&& inAllocator, const std::initializer_list<T>& initializerList);
+
+		/**
+		* The number of elements contained in the InlineArrayList.
+		*/
+		[[nodiscard]] usize len() const { return _length; }
+
+		/**
+		* The number of elements this InlineArrayList can store without reallocation.
+		* Is `INLINE_CAPACITY` while the inline buffer is in use.
+		*/
+		[[nodiscard]] usize capacity() const { return _capacity; }
+
+		/**
+		* Whether the elements are stored inside this object, rather than on the heap.
+		*/
+		[[nodiscard]] bool isInline() const { return _data == inlineData(); }
+
+		/**
+		* A mutable pointer to the data held by this InlineArrayList. Accessing beyond `len()`. is undefined behaviour.
+		* May point into this object, so it's invalidated by moves.
+		*/
+		[[nodiscard]] T* data() { return _data; }
+
+		/**
+		* An immutable pointer to the data held by this InlineArrayList. Accessing beyond `len()`. is undefined behaviour.
+		* May point into this object, so it's invalidated by moves.
+		*/
+		[[nodiscard]] const T* data() const { return _data; }
+
+		/**
+		* @return The allocator used by the InlineArrayList once the inline buffer overflows. Can be copied.
+		*/
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
+
+		/**
+		* Get a mutable reference to an element in the array at a specified index.
+		* Will assert if index is out of range.
+		*
+		* @param index: The element to get. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] T& operator [] (usize index);
+
+		/**
+		* Get an immutable reference to an element in the array at a specified index.
+		* Will assert if index is out of range.
+		*
+		* @param index: The element to get. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] const T& operator [] (usize index) const;
+
+		/**
+		* Pushes a copy of `element` onto the end of the InlineArrayList, increasing the length by 1.
+		* May move to the heap if there isn't enough capacity already. Requires that T is copyable.
+		*
+		* @param element: Element to be copied to the end of the InlineArrayList buffer.
+		*/
+		void push(const T& element);
+
+		/**
+		* Moves `element` onto the end of the InlineArrayList, increasing the length by 1.
+		* May move to the heap if there isn't enough capacity already.
+		*
+		* @param element: Element to be moved to the end of the InlineArrayList buffer.
+		*/
+		void push(T&& element);
+
+		/**
+		* Reserves additional capacity in the InlineArrayList. The new capacity will be greater than or equal to `len()` + `additional`.
+		* Does nothing if the inline buffer is large enough.
+		*
+		* @param additional: Minimum amount to increase the capacity by
+		*/
+		void reserve(usize additional);
+
+		/**
+		* Finds the first index of an element in the InlineArrayList. For data types that supports it, will use SIMD to find,
+		* including when the elements are inline.
+		*
+		* @param element: Element to check if in the InlineArrayList.
+		* @return The found index, or None
+		*/
+		[[nodiscard]] gk::Option<usize> find(const T& element) const;
+
+		/**
+		* Removes the element at `index` and returns it, shuffling down all subsequent elements
+		* to maintain order. If order is not required, use `removeSwap()` as it will perform better in general.
+		*
+		* @param index: The element to remove. Asserts that is less than `len()`.
+		* @return The removed element. Can be ingored.
+		*/
+		T remove(usize index);
+
+		/**
+		* Removes the element at `index`, swapping the last element in place.
+		* Does not maintain order. If order needs to be maintained, use `remove()`.
+		*
+		* @param index: The element to remove. Asserts that is less than `len()`.
+		* @return The removed element. Can be ingored.
+		*/
+		T removeSwap(usize index);
+
+		/**
+		* Insert a copy of `element` at `index`, shuffling up all subsequent elements to maintain order.
+		* If order is not required use `insertSwap()` as it will perform better in general.
+		*
+		* @param index: Where to insert a copy of `element`. Asserts that is less than or equal to `len()`.
+		* @param element: The element to copy and insert at `index`.
+		*/
+		void insert(usize index, const T& element);
+
+		/**
+		* Insert `element` at `index`, shuffling up all subsequent elements to maintain order.
+		* If order is not required use `insertSwap()` as it will perform better in general.
+		*
+		* @param index: Where to insert `element`. Asserts that is less than or equal to `len()`.
+		* @param element: The element to insert at `index`.
+		*/
+		void insert(usize index, T&& element);
+
+		/**
+		* Insert copy of `element` at `index`, swapping the current element at `index` to the
+		* end of the InlineArrayList if it's not the last element. Does not maintain order.
+		* If order is required, use `insert()`.
+		*
+		* @param index: Where to insert a copy of `element`. Asserts that is less than or equal to `len()`.
+		* @param element: The element to copy and insert at `index`.
+		*/
+		void insertSwap(usize index, const T& element);
+
+		/**
+		* Insert `element` at `index`, swapping the current element at `index` to the
+		* end of the InlineArrayList if it's not the last element. Does not maintain order.
+		* If order is required, use `insert()`.
+		*
+		* @param index: Where to insert `element`. Asserts that is less than or equal to `len()`.
+		* @param element: The element to insert at `index`.
+		*/
+		void insertSwap(usize index, T&& element);
+
+		/**
+		* Reallocates the InlineArrayList to occupy the minimum amount of memory required to store `len()` elements.
+		* If they fit within `INLINE_CAPACITY`, the elements are moved back inline and the heap buffer is freed.
+		*/
+		void shrinkToFit();
+
+		/**
+		* Shortens the length of the InlineArrayList, keeping the first `newLength` elements,
+		* and destructing the rest. If `newLength` is greater than or equal to the current
+		* `len()`, this function does nothing.
+		* This function has no effect on the allocated capacity.
+		*
+		* @param newLength: Number of elements to keep.
+		*/
+		void truncate(usize newLength);
+
+		/**
+		* Appends the elements in an initializer list to the end of this InlineArrayList.
+		*
+		* @param initializeList: Elements to copy.
+		*/
+		void appendList(const std::initializer_list<T>& initializerList);
+
+		/**
+		* Appends the data held at `buffer` to the end of this InlineArrayList.
+		* `buffer` must be non-null, and be valid up to `buffer[elementsToCopy - 1].
+		*
+		* @param buffer: Non null pointer of T's to copy.
+		* @param elementsToCopy: Total number of elements to copy from `buffer`.
+		*/
+		void appendBufferCopy(const T* buffer, usize elementsToCopy);
+
+		/**
+		* Resizes the InlineArrayList so that `len()` is equal to `newLength`.
+		* If `newLength` is greater than `len()`, each additional slot is filled with a copy of `fill`.
+		* If `newLength` is less than `len()`, the InlineArrayList is truncated.
+		*
+		* @param newLength: New length of the InlineArrayList.
+		* @param fill: Object to copy into all additional slots if `newLength` is greater than `len()`.
+		*/
+		void resize(usize newLength, const T& fill);
+
+		Iterator begin() { return Iterator(_data); }
+
+		Iterator end() { return Iterator(_data + _length); }
+
+		ConstIterator begin() const { return ConstIterator(_data); }
+
+		ConstIterator end() const { return ConstIterator(_data + _length); }
+
+		ReverseIterator rbegin() { return ReverseIterator(_data + _length); }
+
+		ReverseIterator rend() { return ReverseIterator(_data); }
+
+		ReverseConstIterator rbegin() const { return ReverseConstIterator(_data + _length); }
+
+		ReverseConstIterator rend() const { return ReverseConstIterator(_data); }
+
+	private:
+
+		T* inlineData() { return reinterpret_cast<T*>(_inlineBuffer); }
+
+		const T* inlineData() const { return reinterpret_cast<const T*>(_inlineBuffer); }
+
+		/**
+		* Destructs all elements, frees the heap buffer if used, and goes back to the empty inline buffer.
+		*/
+		void deleteExistingBuffer();
+
+		/**
+		* Moves all elements from `src` into the uninitialized `dst`, leaving `src` without live elements.
+		*/
+		static void moveElements(T* dst, T* src, usize count);
+
+		/**
+		* Moves the elements into a buffer holding at least `capacity` elements. If `capacity`
+		* fits within `INLINE_CAPACITY`, the inline buffer is used.
+		*/
+		void reallocate(usize capacity);
+
+		/**
+		* Takes the elements from `other`, which must use the same allocator as this, leaving it empty and inline.
+		* This InlineArrayList must have no elements and be inline.
+		*/
+		void takeElements(InlineArrayList& other);
+
+	private:
+
+		T* _data;
+		usize _length;
+		usize _capacity;
+		no_unique_address_member Allocator _allocator;
+		alignas(alignof(T)) u8 _inlineBuffer[INLINE_CAPACITY * sizeof(T)];
+
+	}; // struct InlineArrayList
+} // namespace gk
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>::InlineArrayList(Allocator&& inAllocator)
+	: _data(inlineData()), _length(0), _capacity(INLINE_CAPACITY), _allocator(std::move(inAllocator))
+{}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>::InlineArrayList()
+	: _data(inlineData()), _length(0), _capacity(INLINE_CAPACITY), _allocator(internal::arrayListDefaultAllocator<Allocator>())
+{}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>::InlineArrayList(const InlineArrayList& other)
+	: _data(inlineData()), _length(0), _capacity(INLINE_CAPACITY), _allocator(other._allocator)
+{
+	appendBufferCopy(other._data, other._length);
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>::InlineArrayList(InlineArrayList&& other) noexcept
+	: _data(inlineData()), _length(0), _capacity(INLINE_CAPACITY), _allocator(std::move(other._allocator))
+{
+	takeElements(other);
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>::~InlineArrayList()
+{
+	deleteExistingBuffer();
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>& gk::InlineArrayList<T, N, Allocator>::operator=(const InlineArrayList& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = other._allocator;
+	appendBufferCopy(other._data, other._length);
+	return *this;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator>& gk::InlineArrayList<T, N, Allocator>::operator=(InlineArrayList&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = std::move(other._allocator);
+	takeElements(other);
+	return *this;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::InlineArrayList<T, N, Allocator> gk::InlineArrayList<T, N, Allocator>::initList(Allocator&& inAllocator, const std::initializer_list<T>& initializerList)
+{
+	InlineArrayList out = InlineArrayList(std::move(inAllocator));
+	out.appendBufferCopy(initializerList.begin(), initializerList.size());
+	return out;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline T& gk::InlineArrayList<T, N, Allocator>::operator[](usize index)
+{
+	check_message(index < _length, "Index out of bounds! Attempted to access index ", index, " from InlineArrayList of length ", _length);
+	return _data[index];
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline const T& gk::InlineArrayList<T, N, Allocator>::operator[](usize index) const
+{
+	check_message(index < _length, "Index out of bounds! Attempted to access index ", index, " from InlineArrayList of length ", _length);
+	return _data[index];
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::push(const T& element)
+{
+	if (_length == _capacity) {
+		reallocate(_capacity * 2);
+	}
+
+	new (_data + _length) T(element);
+	_length++;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::push(T&& element)
+{
+	if (_length == _capacity) {
+		reallocate(_capacity * 2);
+	}
+
+	new (_data + _length) T(std::move(element));
+	_length++;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::reserve(usize additional)
+{
+	const usize addedLength = _length + additional;
+	if (addedLength <= _capacity) return;
+
+	const usize standardCapacityIncrease = _capacity * 2;
+	reallocate(addedLength < standardCapacityIncrease ? standardCapacityIncrease : addedLength);
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline gk::Option<gk::usize> gk::InlineArrayList<T, N, Allocator>::find(const T& element) const
+{
+	if constexpr (IS_T_SIMD) {
+		// The SIMD find uses unaligned loads and handles the tail itself, so neither buffer needs padding.
+		return internal::doSimdArrayElementFind(_data, _length, element);
+	}
+	else {
+		for (usize i = 0; i < _length; i++) {
+			if (_data[i] == element) {
+				return gk::Option<usize>(i);
+			}
+		}
+		return gk::Option<usize>();
+	}
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline T gk::InlineArrayList<T, N, Allocator>::remove(usize index)
+{
+	check_message(index < _length, "Index out of bounds! Attempted to removed element index ", index, " from InlineArrayList of length ", _length);
+
+	T temp = std::move(_data[index]);
+	_data[index].~T();
+	if constexpr (IS_T_RELOCATABLE) {
+		memmove((void*)(_data + index), (const void*)(_data + index + 1), (_length - index - 1) * sizeof(T));
+	}
+	else {
+		for (usize i = index; i < _length - 1; i++) {
+			new (_data + i) T(std::move(_data[i + 1]));
+			_data[i + 1].~T();
+		}
+	}
+
+	_length--;
+	return temp;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline T gk::InlineArrayList<T, N, Allocator>::removeSwap(usize index)
+{
+	check_message(index < _length, "Index out of bounds! Attempted to removed element index ", index, " from InlineArrayList of length ", _length);
+
+	T temp = std::move(_data[index]);
+	_data[index].~T();
+	if (index != (_length - 1)) { // swap the last element in place if it's not the one being removed
+		new (_data + index) T(std::move(_data[_length - 1]));
+		_data[_length - 1].~T();
+	}
+
+	_length--;
+	return temp;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::insert(usize index, const T& element)
+{
+	insert(index, T(element));
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::insert(usize index, T&& element)
+{
+	check_message(index <= _length, "Index out of bounds! Attempted to insert element at index ", index, " into InlineArrayList of length ", _length);
+
+	if (_length == _capacity) {
+		reallocate(_capacity * 2);
+	}
+
+	if constexpr (IS_T_RELOCATABLE) {
+		memmove((void*)(_data + index + 1), (const void*)(_data + index), (_length - index) * sizeof(T));
+	}
+	else {
+		usize i = _length;
+		while (i > index) {
+			new (_data + i) T(std::move(_data[i - 1]));
+			_data[i - 1].~T();
+			i--;
+		}
+	}
+
+	new (_data + index) T(std::move(element));
+	_length++;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::insertSwap(usize index, const T& element)
+{
+	insertSwap(index, T(element));
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::insertSwap(usize index, T&& element)
+{
+	check_message(index <= _length, "Index out of bounds! Attempted to insert element at index ", index, " into InlineArrayList of length ", _length);
+
+	if (index == _length) {
+		push(std::move(element));
+		return;
+	}
+
+	if (_length == _capacity) {
+		reallocate(_capacity * 2);
+	}
+
+	new (_data + _length) T(std::move(_data[index]));
+	_data[index].~T();
+	new (_data + index) T(std::move(element));
+	_length++;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::shrinkToFit()
+{
+	if (isInline()) {
+		return;
+	}
+	reallocate(_length);
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::truncate(usize newLength)
+{
+	if (newLength >= _length) {
+		return;
+	}
+
+	for (usize i = newLength; i < _length; i++) {
+		_data[i].~T();
+	}
+	_length = newLength;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::appendList(const std::initializer_list<T>& initializerList)
+{
+	appendBufferCopy(initializerList.begin(), initializerList.size());
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::appendBufferCopy(const T* buffer, usize elementsToCopy)
+{
+	if (elementsToCopy == 0) {
+		return;
+	}
+	check_ne(buffer, nullptr);
+
+	if (_length + elementsToCopy > _capacity) {
+		reallocate(gk::upperPowerOfTwo(_length + elementsToCopy));
+	}
+
+	if constexpr (std::is_trivially_copyable_v<T>) {
+		memcpy((void*)(_data + _length), (const void*)buffer, elementsToCopy * sizeof(T));
+	}
+	else {
+		for (usize i = 0; i < elementsToCopy; i++) {
+			new (_data + _length + i) T(buffer[i]);
+		}
+	}
+	_length += elementsToCopy;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::resize(usize newLength, const T& fill)
+{
+	if (newLength <= _length) {
+		truncate(newLength);
+		return;
+	}
+
+	if (newLength > _capacity) {
+		reallocate(gk::upperPowerOfTwo(newLength));
+	}
+
+	for (usize i = _length; i < newLength; i++) {
+		new (_data + i) T(fill);
+	}
+	_length = newLength;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::deleteExistingBuffer()
+{
+	for (usize i = 0; i < _length; i++) {
+		_data[i].~T();
+	}
+	_length = 0;
+
+	if (!isInline()) {
+		_allocator.freeBuffer(_data, _capacity);
+		_data = inlineData();
+		_capacity = INLINE_CAPACITY;
+	}
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::moveElements(T* dst, T* src, usize count)
+{
+	if constexpr (IS_T_RELOCATABLE) {
+		if (count > 0) {
+			memcpy((void*)dst, (const void*)src, count * sizeof(T));
+		}
+	}
+	else {
+		for (usize i = 0; i < count; i++) {
+			new (dst + i) T(std::move(src[i]));
+			src[i].~T();
+		}
+	}
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::reallocate(usize capacity)
+{
+	check_ge(capacity, _length);
+
+	T* newData;
+	if (capacity <= INLINE_CAPACITY) {
+		if (isInline()) {
+			return;
+		}
+		newData = inlineData();
+		capacity = INLINE_CAPACITY;
+	}
+	else {
+		newData = _allocator.template mallocBuffer<T>(capacity).ok();
+	}
+
+	moveElements(newData, _data, _length);
+
+	if (!isInline()) {
+		_allocator.freeBuffer(_data, _capacity);
+	}
+
+	_data = newData;
+	_capacity = capacity;
+}
+
+template<typename T, gk::usize N, typename Allocator>
+inline void gk::InlineArrayList<T, N, Allocator>::takeElements(InlineArrayList& other)
+{
+	check(isInline());
+	check_eq(_length, 0);
+
+	if (other.isInline()) {
+		moveElements(_data, other._data, other._length);
+	}
+	else {
+		_data = other._data;
+		_capacity = other._capacity;
+		other._data = other.inlineData();
+		other._capacity = INLINE_CAPACITY;
+	}
+	_length = other._length;
+	other._length = 0;
+}
@@ -0,0 +1,169 @@
+#include "segmented_array_list.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../allocator/stats_allocator.h"
+#include "../string/string.h"
+
+using gk::SegmentedArrayList;
+using gk::usize;
+using gk::i32;
+using gk::u8;
+using gk::u64;
+
+static_assert(SegmentedArrayList<u8>::FIRST_SEGMENT_CAPACITY == 64);
+static_assert(SegmentedArrayList<u64>::FIRST_SEGMENT_CAPACITY == 8);
+static_assert(SegmentedArrayList<gk::String>::FIRST_SEGMENT_CAPACITY == 2);
+
+test_case("SegmentedArrayList default construct") {
+	SegmentedArrayList<int> a;
+	check_eq(a.len(), 0);
+	check_eq(a.capacity(), 0);
+	check_eq(a.segmentCount(), 0);
+	check(a.find(0).none());
+}
+
+test_case("SegmentedArrayList push and index across segments") {
+	SegmentedArrayList<u64> a;
+	for (u64 i = 0; i < 1000; i++) {
+		a.push(i);
+	}
+	check_eq(a.len(), 1000);
+	for (u64 i = 0; i < 1000; i++) {
+		check_eq(a[i], i);
+	}
+	// 8 + 16 + 32 + 64 + 128 + 256 + 512 = 1016
+	check_eq(a.capacity(), 1016);
+	check_eq(a.segmentCount(), 7);
+	check_eq(a.segment(0).size(), 8);
+	check_eq(a.segment(6).size(), 1000 - 504);
+	check_eq(a.segment(3)[0], 56);
+}
+
+test_case("SegmentedArrayList push does not move existing elements") {
+	SegmentedArrayList<gk::String> a;
+	gk::String& first = a.push(gk::String::fromUint(0));
+	const gk::String* firstAddress = &first;
+	const gk::String* address100 = nullptr;
+	for (u64 i = 1; i < 5000; i++) {
+		gk::String& pushed = a.push(gk::String::fromUint(i));
+		if (i == 100) {
+			address100 = &pushed;
+		}
+	}
+	check_eq(&a[0], firstAddress);
+	check_eq(&a[100], address100);
+	check_eq(*firstAddress, gk::String::fromUint(0));
+	check_eq(*address100, gk::String::fromUint(100));
+}
+
+test_case("SegmentedArrayList push allocates one segment at a time") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	{
+		auto a = SegmentedArrayList<i32, gk::AllocatorRef>::init(allocator.toRef());
+		for (i32 i = 0; i < 16; i++) {
+			a.push(i);
+		}
+		check_eq(allocator.stats().totalAllocations, 1);
+		a.push(16);
+		check_eq(allocator.stats().totalAllocations, 2);
+		check_eq(allocator.stats().totalFrees, 0);
+	}
+	check_eq(allocator.stats().liveBytes, 0);
+}
+
+test_case("SegmentedArrayList iterate") {
+	SegmentedArrayList<i32> a;
+	for (i32 i = 0; i < 300; i++) {
+		a.push(i);
+	}
+	i32 expected = 0;
+	for (i32& element : a) {
+		check_eq(element, expected);
+		element *= 2;
+		expected++;
+	}
+	check_eq(expected, 300);
+
+	const SegmentedArrayList<i32>& constRef = a;
+	i32 sum = 0;
+	for (const i32& element : constRef) {
+		sum += element;
+	}
+	check_eq(sum, 299 * 300);
+
+	usize segmentedTotal = 0;
+	for (usize i = 0; i < a.segmentCount(); i++) {
+		segmentedTotal += a.segment(i).size();
+	}
+	check_eq(segmentedTotal, 300);
+}
+
+test_case("SegmentedArrayList find") {
+	SegmentedArrayList<i32> a;
+	for (i32 i = 0; i < 1000; i++) {
+		a.push(i);
+	}
+	check_eq(a.find(0).some(), 0);
+	check_eq(a.find(15).some(), 15);
+	check_eq(a.find(16).some(), 16);
+	check_eq(a.find(999).some(), 999);
+	check(a.find(1000).none());
+	a.truncate(500);
+	check(a.find(999).none());
+}
+
+test_case("SegmentedArrayList find non SIMD") {
+	SegmentedArrayList<gk::String> a;
+	for (u64 i = 0; i < 40; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	check_eq(a.find(gk::String::fromUint(33)).some(), 33);
+	check(a.find(gk::String::fromUint(40)).none());
+}
+
+test_case("SegmentedArrayList pop and removeSwap") {
+	SegmentedArrayList<gk::String> a;
+	for (u64 i = 0; i < 10; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	check_eq(a.pop(), gk::String::fromUint(9));
+	check_eq(a.removeSwap(1), gk::String::fromUint(1));
+	check_eq(a[1], gk::String::fromUint(8));
+	check_eq(a.len(), 8);
+}
+
+test_case("SegmentedArrayList reserve and shrinkToFit") {
+	SegmentedArrayList<i32> a;
+	a.reserve(100);
+	check(a.capacity() >= 100);
+	check_eq(a.len(), 0);
+	a.push(1);
+	a.shrinkToFit();
+	check_eq(a.capacity(), SegmentedArrayList<i32>::FIRST_SEGMENT_CAPACITY);
+	check_eq(a[0], 1);
+}
+
+test_case("SegmentedArrayList copy and move") {
+	SegmentedArrayList<gk::String> a;
+	for (u64 i = 0; i < 100; i++) {
+		a.push(gk::String::fromUint(i));
+	}
+	SegmentedArrayList<gk::String> b = a;
+	check_eq(b.len(), 100);
+	check_eq(b[77], gk::String::fromUint(77));
+	check_ne(&b[77], &a[77]);
+
+	const gk::String* address = &a[50];
+	SegmentedArrayList<gk::String> c = std::move(a);
+	check_eq(a.len(), 0);
+	check_eq(&c[50], address);
+
+	a = c;
+	check_eq(a[99], gk::String::fromUint(99));
+	b = std::move(c);
+	check_eq(c.len(), 0);
+	check_eq(&b[50], address);
+}
+
+#endif
@@ -0,0 +1,604 @@
+#pragma once
+
+#include "array_list.h"
+#include "../utility.h"
+#include <bit>
+#include <span>
+
+namespace gk
+{
+	namespace internal
+	{
+		/**
+		* Index math shared by the segmented lists. Segment `n` holds `FIRST_SEGMENT_CAPACITY << n` elements,
+		* so the segment holding any index is found with a single bit scan.
+		*/
+		template<typename T>
+		struct SegmentLayout
+		{
+			/// Always a power of two, and at least 64 bytes.
+			constexpr static usize FIRST_SEGMENT_CAPACITY = sizeof(T) >= 64 ? 1 : upperPowerOfTwo((64 + sizeof(T) - 1) / sizeof(T));
+
+			/// Enough segments for more elements than can be addressed.
+			constexpr static usize MAX_SEGMENT_COUNT = 48;
+
+			/// Index of the first element held by a segment. Also the total capacity of all prior segments.
+			constexpr static usize segmentStart(usize segmentIndex) {
+				return (FIRST_SEGMENT_CAPACITY << segmentIndex) - FIRST_SEGMENT_CAPACITY;
+			}
+
+			constexpr static usize segmentCapacity(usize segmentIndex) {
+				return FIRST_SEGMENT_CAPACITY << segmentIndex;
+			}
+
+			/// The segment holding the element at `index`. Index `i` lives in segment `floor(log2(i / FIRST_SEGMENT_CAPACITY + 1))`.
+			constexpr static usize segmentOf(usize index) {
+				return static_cast<usize>(std::bit_width(static_cast<u64>(index / FIRST_SEGMENT_CAPACITY + 1))) - 1;
+			}
+		};
+	} // namespace internal
+
+	/**
+	* ArrayList made of separately allocated segments, where each segment holds twice as many elements as the previous one.
+	* Growing allocates a new segment rather than moving existing elements, so pointers and references to elements
+	* stay valid until that element is removed, and pushing never copies the whole list.
+	* Element lookup maps the index to it's segment with a single bit scan.
+	*
+	* The elements are not contiguous. Use `segmentCount()` and `segment()`, or the iterators, to visit them segment by segment.
+	* For SIMD types, `find()` uses the same SIMD find as `gk::ArrayList` on each segment.
+	*
+	* Unlike `gk::ArrayList`, it's not usable in constexpr contexts.
+	*
+	* @param T: Element type.
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	*/
+	template<typename T, typename Allocator = GlobalHeapStaticAllocator>
+	struct SegmentedArrayList
+	{
+		static_assert(AllocatorPolicy<Allocator>, "SegmentedArrayList Allocator must be either AllocatorRef, or satisfy gk::StaticAllocator");
+
+	private:
+
+		constexpr static bool IS_T_SIMD = (std::is_arithmetic_v<T> || std::is_pointer_v<T> || std::is_enum_v<T>);
+
+		/**
+		* Simple constructor to initialize the SegmentedArrayList with a specified allocator.
+		* For actual use, call SegmentedArrayList::init() for whichever overload necessary.
+		*/
+		SegmentedArrayList(Allocator&& inAllocator);
+
+	public:
+
+		using ValueType = T;
+
+		/**
+		* Number of elements held by the first segment. Always a power of two, and at least 64 bytes.
+		* Segment `n` holds `FIRST_SEGMENT_CAPACITY << n` elements.
+		*/
+		constexpr static usize FIRST_SEGMENT_CAPACITY = internal::SegmentLayout<T>::FIRST_SEGMENT_CAPACITY;
+
+		/**
+		* The maximum number of segments. Enough for more elements than can be addressed.
+		*/
+		constexpr static usize MAX_SEGMENT_COUNT = internal::SegmentLayout<T>::MAX_SEGMENT_COUNT;
+
+		template<bool IS_CONST>
+		struct SegmentIterator;
+
+		using Iterator = SegmentIterator<false>;
+		using ConstIterator = SegmentIterator<true>;
+
+		/**
+		* Default constructor uses gk::globalHeapAllocator().
+		*/
+		SegmentedArrayList();
+
+		/**
+		* The copy constructor of SegmentedArrayList will make a clone of the other's allocator.
+		* Requires that T is copyable.
+		*
+		* @param other: Other SegmentedArrayList to copy elements and allocator from.
+		*/
+		SegmentedArrayList(const SegmentedArrayList& other);
+
+		/**
+		* During move construction, the other SegmentedArrayList will be left empty.
+		* Pointers to the other's elements remain valid, now pointing into this.
+		*
+		* @param other: Other SegmentedArrayList to take ownership of it's held segments.
+		*/
+		SegmentedArrayList(SegmentedArrayList&& other) noexcept;
+
+		/**
+		* Destructs all held elements, freeing every segment.
+		*/
+		~SegmentedArrayList();
+
+		/**
+		* The copy assignment operator of SegmentedArrayList will make a clone of the other's allocator.
+		* Requires that T is copyable.
+		*
+		* @param other: Other SegmentedArrayList to copy elements and allocator from.
+		*/
+		SegmentedArrayList& operator = (const SegmentedArrayList& other);
+
+		/**
+		* During move assignment, the other SegmentedArrayList will be left empty.
+		* Pointers to the other's elements remain valid, now pointing into this.
+		*
+		* @param other: Other SegmentedArrayList to take ownership of it's held segments.
+		*/
+		SegmentedArrayList& operator = (SegmentedArrayList&& other) noexcept;
+
+		/**
+		* Create a new SegmentedArrayList given an allocator to take ownership of.
+		*
+		* @param inAllocator: Allocator to own
+		*/
+		[[nodiscard]] static SegmentedArrayList init(Allocator&& inAllocator) { return SegmentedArrayList(std::move(inAllocator)); }
+
+		/**
+		* The number of elements contained in the SegmentedArrayList.
+		*/
+		[[nodiscard]] usize len() const { return _length; }
+
+		/**
+		* The number of elements that can be held by the currently allocated segments.
+		*/
+		[[nodiscard]] usize capacity() const { return segmentStart(_segmentCount); }
+
+		/**
+		* @return The allocator used by the SegmentedArrayList. Can be copied.
+		*/
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
+
+		/**
+		* The number of segments holding at least one element.
+		*/
+		[[nodiscard]] usize segmentCount() const;
+
+		/**
+		* A mutable span over the elements held by a segment.
+		*
+		* @param segmentIndex: Segment to get. Asserts that is less than `segmentCount()`.
+		*/
+		[[nodiscard]] std::span<T> segment(usize segmentIndex);
+
+		/**
+		* An immutable span over the elements held by a segment.
+		*
+		* @param segmentIndex: Segment to get. Asserts that is less than `segmentCount()`.
+		*/
+		[[nodiscard]] std::span<const T> segment(usize segmentIndex) const;
+
+		/**
+		* Get a mutable reference to an element at a specified index.
+		* The reference stays valid until the element is removed.
+		*
+		* @param index: The element to get. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] T& operator [] (usize index);
+
+		/**
+		* Get an immutable reference to an element at a specified index.
+		* The reference stays valid until the element is removed.
+		*
+		* @param index: The element to get. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] const T& operator [] (usize index) const;
+
+		/**
+		* Pushes a copy of `element` onto the end of the SegmentedArrayList, increasing the length by 1.
+		* If the last segment is full, allocates a new segment. No existing elements are moved.
+		* Requires that T is copyable.
+		*
+		* @param element: Element to be copied to the end of the SegmentedArrayList.
+		* @return A reference to the pushed element.
+		*/
+		T& push(const T& element);
+
+		/**
+		* Moves `element` onto the end of the SegmentedArrayList, increasing the length by 1.
+		* If the last segment is full, allocates a new segment. No existing elements are moved.
+		*
+		* @param element: Element to be moved to the end of the SegmentedArrayList.
+		* @return A reference to the pushed element.
+		*/
+		T& push(T&& element);
+
+		/**
+		* Removes the last element. Asserts that `len()` is greater than 0.
+		*
+		* @return The removed element.
+		*/
+		T pop();
+
+		/**
+		* Removes the element at `index`, moving the last element in place. Does not maintain order.
+		*
+		* @param index: The element to remove. Asserts that is less than `len()`.
+		* @return The removed element. Can be ignored.
+		*/
+		T removeSwap(usize index);
+
+		/**
+		* Allocates segments until the capacity is greater than or equal to `len()` + `additional`.
+		*
+		* @param additional: Minimum amount to increase the capacity by
+		*/
+		void reserve(usize additional);
+
+		/**
+		* Shortens the length of the SegmentedArrayList, keeping the first `newLength` elements,
+		* and destructing the rest. If `newLength` is greater than or equal to the current
+		* `len()`, this function does nothing.
+		* This function has no effect on the allocated segments.
+		*
+		* @param newLength: Number of elements to keep.
+		*/
+		void truncate(usize newLength);
+
+		/**
+		* Frees every segment that holds no elements.
+		*/
+		void shrinkToFit();
+
+		/**
+		* Finds the first index of an element. For data types that supports it, will use SIMD to find within each segment.
+		*
+		* @param element: Element to check if in the SegmentedArrayList.
+		* @return The found index, or None
+		*/
+		[[nodiscard]] gk::Option<usize> find(const T& element) const;
+
+		Iterator begin() { return Iterator(this, 0); }
+
+		Iterator end() { return Iterator(this, _length); }
+
+		ConstIterator begin() const { return ConstIterator(this, 0); }
+
+		ConstIterator end() const { return ConstIterator(this, _length); }
+
+		/**
+		* Forward iterator walking each segment contiguously, only locating the next segment at segment boundaries.
+		*/
+		template<bool IS_CONST>
+		struct SegmentIterator
+		{
+			using ListT = std::conditional_t<IS_CONST, const SegmentedArrayList, SegmentedArrayList>;
+			using ElementT = std::conditional_t<IS_CONST, const T, T>;
+
+			SegmentIterator(ListT* list, usize index)
+				: _list(list), _index(index), _current(nullptr), _segmentEnd(0)
+			{
+				if (index < list->_length) {
+					const usize segmentIndex = segmentOf(index);
+					_current = list->_segments[segmentIndex] + (index - segmentStart(segmentIndex));
+					_segmentEnd = segmentStart(segmentIndex + 1);
+				}
+			}
+
+			SegmentIterator& operator++() {
+				_index++;
+				_current++;
+				if (_index == _segmentEnd && _index < _list->_length) {
+					const usize segmentIndex = segmentOf(_index);
+					_current = _list->_segments[segmentIndex];
+					_segmentEnd = segmentStart(segmentIndex + 1);
+				}
+				return *this;
+			}
+
+			bool operator!=(const SegmentIterator& other) const { return _index != other._index; }
+
+			ElementT& operator*() const { return *_current; }
+
+			ElementT* operator->() const { return _current; }
+
+		private:
+
+			ListT* _list;
+			usize _index;
+			ElementT* _current;
+			usize _segmentEnd;
+		};
+
+	private:
+
+		constexpr static usize segmentStart(usize segmentIndex) { return internal::SegmentLayout<T>::segmentStart(segmentIndex); }
+
+		constexpr static usize segmentCapacity(usize segmentIndex) { return internal::SegmentLayout<T>::segmentCapacity(segmentIndex); }
+
+		constexpr static usize segmentOf(usize index) { return internal::SegmentLayout<T>::segmentOf(index); }
+
+		T* elementAt(usize index) const {
+			const usize segmentIndex = segmentOf(index);
+			return _segments[segmentIndex] + (index - segmentStart(segmentIndex));
+		}
+
+		/**
+		* Gets uninitialized memory for the element at `_length`, allocating the next segment if necessary.
+		*/
+		T* pushSlot();
+
+		void allocateSegment();
+
+		void freeSegment(usize segmentIndex);
+
+		/**
+		* Destructs all elements, and frees every segment.
+		*/
+		void deleteExistingBuffer();
+
+		/**
+		* Takes the segments from `other`, which must use the same allocator as this, leaving it empty.
+		* This SegmentedArrayList must have no segments.
+		*/
+		void takeSegments(SegmentedArrayList& other);
+
+	private:
+
+		T* _segments[MAX_SEGMENT_COUNT];
+		usize _segmentCount;
+		usize _length;
+		no_unique_address_member Allocator _allocator;
+
+	}; // struct SegmentedArrayList
+
+	template<typename T, typename Allocator>
+	struct is_trivially_relocatable<SegmentedArrayList<T, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace gk
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>::SegmentedArrayList(Allocator&& inAllocator)
+	: _segments{}, _segmentCount(0), _length(0), _allocator(std::move(inAllocator))
+{}
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>::SegmentedArrayList()
+	: _segments{}, _segmentCount(0), _length(0), _allocator(internal::arrayListDefaultAllocator<Allocator>())
+{}
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>::SegmentedArrayList(const SegmentedArrayList& other)
+	: _segments{}, _segmentCount(0), _length(0), _allocator(other._allocator)
+{
+	reserve(other._length);
+	for (const T& element : other) {
+		new (pushSlot()) T(element);
+		_length++;
+	}
+}
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>::SegmentedArrayList(SegmentedArrayList&& other) noexcept
+	: _segments{}, _segmentCount(0), _length(0), _allocator(std::move(other._allocator))
+{
+	takeSegments(other);
+}
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>::~SegmentedArrayList()
+{
+	deleteExistingBuffer();
+}
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>& gk::SegmentedArrayList<T, Allocator>::operator=(const SegmentedArrayList& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = other._allocator;
+	reserve(other._length);
+	for (const T& element : other) {
+		new (pushSlot()) T(element);
+		_length++;
+	}
+	return *this;
+}
+
+template<typename T, typename Allocator>
+inline gk::SegmentedArrayList<T, Allocator>& gk::SegmentedArrayList<T, Allocator>::operator=(SegmentedArrayList&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = std::move(other._allocator);
+	takeSegments(other);
+	return *this;
+}
+
+template<typename T, typename Allocator>
+inline gk::usize gk::SegmentedArrayList<T, Allocator>::segmentCount() const
+{
+	if (_length == 0) {
+		return 0;
+	}
+	return segmentOf(_length - 1) + 1;
+}
+
+template<typename T, typename Allocator>
+inline std::span<T> gk::SegmentedArrayList<T, Allocator>::segment(usize segmentIndex)
+{
+	check_message(segmentIndex < segmentCount(), "Segment index out of bounds! Attempted to access segment ", segmentIndex, " from SegmentedArrayList with segment count ", segmentCount());
+	const usize start = segmentStart(segmentIndex);
+	const usize end = segmentStart(segmentIndex + 1) < _length ? segmentStart(segmentIndex + 1) : _length;
+	return std::span<T>(_segments[segmentIndex], end - start);
+}
+
+template<typename T, typename Allocator>
+inline std::span<const T> gk::SegmentedArrayList<T, Allocator>::segment(usize segmentIndex) const
+{
+	check_message(segmentIndex < segmentCount(), "Segment index out of bounds! Attempted to access segment ", segmentIndex, " from SegmentedArrayList with segment count ", segmentCount());
+	const usize start = segmentStart(segmentIndex);
+	const usize end = segmentStart(segmentIndex + 1) < _length ? segmentStart(segmentIndex + 1) : _length;
+	return std::span<const T>(_segments[segmentIndex], end - start);
+}
+
+template<typename T, typename Allocator>
+inline T& gk::SegmentedArrayList<T, Allocator>::operator[](usize index)
+{
+	check_message(index < _length, "Index out of bounds! Attempted to access index ", index, " from SegmentedArrayList of length ", _length);
+	return *elementAt(index);
+}
+
+template<typename T, typename Allocator>
+inline const T& gk::SegmentedArrayList<T, Allocator>::operator[](usize index) const
+{
+	check_message(index < _length, "Index out of bounds! Attempted to access index ", index, " from SegmentedArrayList of length ", _length);
+	return *elementAt(index);
+}
+
+template<typename T, typename Allocator>
+inline T& gk::SegmentedArrayList<T, Allocator>::push(const T& element)
+{
+	T* slot = new (pushSlot()) T(element);
+	_length++;
+	return *slot;
+}
+
+template<typename T, typename Allocator>
+inline T& gk::SegmentedArrayList<T, Allocator>::push(T&& element)
+{
+	T* slot = new (pushSlot()) T(std::move(element));
+	_length++;
+	return *slot;
+}
+
+template<typename T, typename Allocator>
+inline T gk::SegmentedArrayList<T, Allocator>::pop()
+{
+	check_message(_length > 0, "Cannot pop from an empty SegmentedArrayList");
+	_length--;
+	T* last = elementAt(_length);
+	T temp = std::move(*last);
+	last->~T();
+	return temp;
+}
+
+template<typename T, typename Allocator>
+inline T gk::SegmentedArrayList<T, Allocator>::removeSwap(usize index)
+{
+	check_message(index < _length, "Index out of bounds! Attempted to removed element index ", index, " from SegmentedArrayList of length ", _length);
+
+	T* removed = elementAt(index);
+	T temp = std::move(*removed);
+	removed->~T();
+	if (index != (_length - 1)) { // swap the last element in place if it's not the one being removed
+		T* last = elementAt(_length - 1);
+		new (removed) T(std::move(*last));
+		last->~T();
+	}
+
+	_length--;
+	return temp;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::reserve(usize additional)
+{
+	const usize addedLength = _length + additional;
+	while (capacity() < addedLength) {
+		allocateSegment();
+	}
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::truncate(usize newLength)
+{
+	if (newLength >= _length) return;
+
+	for (usize i = newLength; i < _length; i++) {
+		elementAt(i)->~T();
+	}
+	_length = newLength;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::shrinkToFit()
+{
+	const usize usedSegments = segmentCount();
+	while (_segmentCount > usedSegments) {
+		freeSegment(_segmentCount - 1);
+		_segmentCount--;
+	}
+}
+
+template<typename T, typename Allocator>
+inline gk::Option<gk::usize> gk::SegmentedArrayList<T, Allocator>::find(const T& element) const
+{
+	const usize count = segmentCount();
+	for (usize segmentIndex = 0; segmentIndex < count; segmentIndex++) {
+		const std::span<const T> elements = segment(segmentIndex);
+		if constexpr (IS_T_SIMD) {
+			gk::Option<usize> found = internal::doSimdArrayElementFind(elements.data(), elements.size(), element);
+			if (found.isSome()) {
+				return gk::Option<usize>(segmentStart(segmentIndex) + found.someCopy());
+			}
+		}
+		else {
+			for (usize i = 0; i < elements.size(); i++) {
+				if (elements[i] == element) {
+					return gk::Option<usize>(segmentStart(segmentIndex) + i);
+				}
+			}
+		}
+	}
+	return gk::Option<usize>();
+}
+
+template<typename T, typename Allocator>
+inline T* gk::SegmentedArrayList<T, Allocator>::pushSlot()
+{
+	if (_length == capacity()) {
+		allocateSegment();
+	}
+	return elementAt(_length);
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::allocateSegment()
+{
+	check_message(_segmentCount < MAX_SEGMENT_COUNT, "SegmentedArrayList cannot allocate more than ", MAX_SEGMENT_COUNT, " segments");
+	_segments[_segmentCount] = _allocator.template mallocAlignedBuffer<T>(segmentCapacity(_segmentCount), alignof(T)).ok();
+	_segmentCount++;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::freeSegment(usize segmentIndex)
+{
+	_allocator.freeAlignedBuffer(_segments[segmentIndex], segmentCapacity(segmentIndex), alignof(T));
+	_segments[segmentIndex] = nullptr;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::deleteExistingBuffer()
+{
+	truncate(0);
+	for (usize i = 0; i < _segmentCount; i++) {
+		freeSegment(i);
+	}
+	_segmentCount = 0;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SegmentedArrayList<T, Allocator>::takeSegments(SegmentedArrayList& other)
+{
+	check_eq(_segmentCount, 0);
+
+	for (usize i = 0; i < other._segmentCount; i++) {
+		_segments[i] = other._segments[i];
+		other._segments[i] = nullptr;
+	}
+	_segmentCount = other._segmentCount;
+	_length = other._length;
+	other._segmentCount = 0;
+	other._length = 0;
+}
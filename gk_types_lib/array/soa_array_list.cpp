@@ -0,0 +1,164 @@
+#include "soa_array_list.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../allocator/stats_allocator.h"
+
+using gk::SoaArrayList;
+using gk::usize;
+using gk::u8;
+using gk::u32;
+using gk::u64;
+
+namespace gk
+{
+	namespace unitTests
+	{
+		enum class SoaTestKind : u8 {
+			Static,
+			Dynamic,
+		};
+
+		struct SoaTestEntity {
+			float x;
+			float y;
+			u32 id;
+			SoaTestKind kind;
+			const char* tag;
+		};
+
+		static SoaTestEntity makeSoaTestEntity(u32 i) {
+			return SoaTestEntity{ static_cast<float>(i), static_cast<float>(i) * 2.f, i, i % 2 == 0 ? SoaTestKind::Static : SoaTestKind::Dynamic, nullptr };
+		}
+	}
+}
+
+using gk::unitTests::SoaTestEntity;
+using gk::unitTests::SoaTestKind;
+using gk::unitTests::makeSoaTestEntity;
+
+static_assert(SoaArrayList<SoaTestEntity>::FIELD_COUNT == 5);
+static_assert(std::is_same_v<SoaArrayList<SoaTestEntity>::FieldType<2>, u32>);
+static_assert(std::is_same_v<SoaArrayList<SoaTestEntity>::FieldType<3>, SoaTestKind>);
+
+test_case("SoaArrayList default construct") {
+	SoaArrayList<SoaTestEntity> a;
+	check_eq(a.len(), 0);
+	check_eq(a.capacity(), 0);
+	check(a.findInColumn<2>(0).none());
+}
+
+test_case("SoaArrayList push and index rows") {
+	SoaArrayList<SoaTestEntity> a;
+	for (u32 i = 0; i < 100; i++) {
+		a.push(makeSoaTestEntity(i));
+	}
+	check_eq(a.len(), 100);
+	for (u32 i = 0; i < 100; i++) {
+		const SoaTestEntity entity = a[i];
+		check_eq(entity.x, static_cast<float>(i));
+		check_eq(entity.y, static_cast<float>(i) * 2.f);
+		check_eq(entity.id, i);
+		check_eq(a.field<2>(i), i);
+	}
+}
+
+test_case("SoaArrayList columns are contiguous and aligned") {
+	SoaArrayList<SoaTestEntity> a;
+	for (u32 i = 0; i < 70; i++) {
+		a.push(makeSoaTestEntity(i));
+	}
+	std::span<float> xs = a.column<0>();
+	std::span<const u32> ids = static_cast<const SoaArrayList<SoaTestEntity>&>(a).column<2>();
+	check_eq(xs.size(), 70);
+	check_eq(ids.size(), 70);
+	check_ge(a.capacity(), 70);
+	check_eq(reinterpret_cast<usize>(a.columnData<0>()) % alignof(float), 0);
+	check_eq(reinterpret_cast<usize>(a.columnData<3>()) % alignof(SoaArrayList<SoaTestEntity>::FieldType<3>), 0);
+	for (usize i = 0; i < xs.size(); i++) {
+		xs[i] += 1.f;
+	}
+	check_eq(a[69].x, 70.f);
+	check_eq(ids[69], 69);
+}
+
+test_case("SoaArrayList set overwrites every field") {
+	SoaArrayList<SoaTestEntity> a;
+	a.push(makeSoaTestEntity(1));
+	a.push(makeSoaTestEntity(2));
+	a.set(0, SoaTestEntity{ -1.f, -2.f, 50, SoaTestKind::Dynamic, "tag" });
+	const SoaTestEntity entity = a[0];
+	check_eq(entity.x, -1.f);
+	check_eq(entity.y, -2.f);
+	check_eq(entity.id, 50);
+	check(entity.kind == SoaTestKind::Dynamic);
+	check_eq(a[1].id, 2);
+}
+
+test_case("SoaArrayList pop and removeSwap") {
+	SoaArrayList<SoaTestEntity> a;
+	for (u32 i = 0; i < 10; i++) {
+		a.push(makeSoaTestEntity(i));
+	}
+	check_eq(a.pop().id, 9);
+	check_eq(a.len(), 9);
+	check_eq(a.removeSwap(2).id, 2);
+	check_eq(a.len(), 8);
+	check_eq(a[2].id, 8);
+	check_eq(a[2].y, 16.f);
+	check_eq(a.removeSwap(7).id, 7);
+	check_eq(a.len(), 7);
+}
+
+test_case("SoaArrayList findInColumn") {
+	SoaArrayList<SoaTestEntity> a;
+	for (u32 i = 0; i < 300; i++) {
+		a.push(makeSoaTestEntity(i));
+	}
+	check_eq(a.findInColumn<2>(257).some(), 257);
+	check_eq(a.findInColumn<0>(12.f).some(), 12);
+	check_eq(a.findInColumn<1>(12.f).some(), 6);
+	check_eq(a.findInColumn<3>(SoaTestKind::Dynamic).some(), 1);
+	check(a.findInColumn<2>(300).none());
+	a.truncate(100);
+	check(a.findInColumn<2>(257).none());
+}
+
+test_case("SoaArrayList copy and move") {
+	SoaArrayList<SoaTestEntity> a;
+	for (u32 i = 0; i < 20; i++) {
+		a.push(makeSoaTestEntity(i));
+	}
+	SoaArrayList<SoaTestEntity> b = a;
+	check_eq(b.len(), 20);
+	check_eq(b[19].id, 19);
+	check_ne(b.columnData<0>(), a.columnData<0>());
+
+	SoaArrayList<SoaTestEntity> c = std::move(a);
+	check_eq(a.len(), 0);
+	check_eq(c.len(), 20);
+	check_eq(c[5].x, 5.f);
+
+	a = c;
+	check_eq(a.len(), 20);
+	b = std::move(c);
+	check_eq(c.len(), 0);
+	check_eq(b[10].id, 10);
+}
+
+test_case("SoaArrayList reserve allocates one buffer per column") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	{
+		auto a = SoaArrayList<SoaTestEntity, gk::AllocatorRef>::init(allocator.toRef());
+		a.reserve(1000);
+		check_eq(allocator.stats().totalAllocations, SoaArrayList<SoaTestEntity>::FIELD_COUNT);
+		const usize capacity = a.capacity();
+		for (u32 i = 0; i < capacity; i++) {
+			a.push(makeSoaTestEntity(i));
+		}
+		check_eq(allocator.stats().totalAllocations, SoaArrayList<SoaTestEntity>::FIELD_COUNT);
+	}
+	check_eq(allocator.stats().liveBytes, 0);
+}
+
+#endif
@@ -0,0 +1,585 @@
+#pragma once
+
+#include "array_list.h"
+#include "../reflection/tie_fields.h"
+#include <span>
+
+namespace gk
+{
+	/**
+	* Structure of arrays list. Splits every aggregate `T` pushed into one contiguous column per member field,
+	* using reflection. Iterating a single field touches only that field's column, rather than striding over whole `T`'s.
+	* Rows are indexed the same way as `gk::ArrayList`, but are returned by value, as no `T` is ever stored.
+	*
+	* Every column is a separate buffer aligned to it's field type, so SIMD element types can use the same
+	* SIMD find as `gk::ArrayList`. See `findInColumn()`.
+	*
+	* Unlike `gk::ArrayList`, it's not usable in constexpr contexts.
+	*
+	* @param T: Aggregate with public fields, and at most 9 fields. See `gk::internal::tieFields()`.
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	*/
+	template<typename T, typename Allocator = GlobalHeapStaticAllocator>
+	struct SoaArrayList
+	{
+		static_assert(std::is_aggregate_v<T>, "SoaArrayList element type must be an aggregate, so its fields can be reflected");
+		static_assert(AllocatorPolicy<Allocator>, "SoaArrayList Allocator must be either AllocatorRef, or satisfy gk::StaticAllocator");
+
+	public:
+
+		using ValueType = T;
+
+		/**
+		* Tuple of the types of each field of `T`, in declaration order.
+		*/
+		using FieldTypes = internal::FieldTypes<T>;
+
+		/**
+		* The type of the field of `T` at index `N`, which is the element type of column `N`.
+		*/
+		template<usize N>
+		using FieldType = std::tuple_element_t<N, FieldTypes>;
+
+		/**
+		* The number of fields in `T`, and therefore the number of columns.
+		*/
+		constexpr static usize FIELD_COUNT = std::tuple_size_v<FieldTypes>;
+
+	private:
+
+		template<usize N>
+		constexpr static bool IS_FIELD_SIMD = (std::is_arithmetic_v<FieldType<N>> || std::is_pointer_v<FieldType<N>> || std::is_enum_v<FieldType<N>>);
+
+		template<typename IndexSequence>
+		struct ColumnPointersImpl;
+
+		template<usize... Is>
+		struct ColumnPointersImpl<std::index_sequence<Is...>> {
+			using Type = std::tuple<FieldType<Is>*...>;
+		};
+
+		using ColumnPointers = typename ColumnPointersImpl<std::make_index_sequence<FIELD_COUNT>>::Type;
+
+		/**
+		* Simple constructor to initialize the SoaArrayList with a specified allocator.
+		* For actual use, call SoaArrayList::init().
+		*/
+		SoaArrayList(Allocator&& inAllocator);
+
+	public:
+
+		/**
+		* Default constructor uses gk::globalHeapAllocator().
+		*/
+		SoaArrayList();
+
+		/**
+		* The copy constructor of SoaArrayList will make a clone of the other's allocator.
+		* Requires that every field of T is copyable.
+		*
+		* @param other: Other SoaArrayList to copy rows and allocator from.
+		*/
+		SoaArrayList(const SoaArrayList& other);
+
+		/**
+		* During move construction, the other SoaArrayList will be left empty.
+		*
+		* @param other: Other SoaArrayList to take ownership of it's held columns.
+		*/
+		SoaArrayList(SoaArrayList&& other) noexcept;
+
+		/**
+		* Destructs all held fields, freeing every column.
+		*/
+		~SoaArrayList();
+
+		/**
+		* The copy assignment operator of SoaArrayList will make a clone of the other's allocator.
+		* Requires that every field of T is copyable.
+		*
+		* @param other: Other SoaArrayList to copy rows and allocator from.
+		*/
+		SoaArrayList& operator = (const SoaArrayList& other);
+
+		/**
+		* During move assignment, the other SoaArrayList will be left empty.
+		*
+		* @param other: Other SoaArrayList to take ownership of it's held columns.
+		*/
+		SoaArrayList& operator = (SoaArrayList&& other) noexcept;
+
+		/**
+		* Create a new SoaArrayList given an allocator to take ownership of.
+		*
+		* @param inAllocator: Allocator to own
+		*/
+		[[nodiscard]] static SoaArrayList init(Allocator&& inAllocator) { return SoaArrayList(std::move(inAllocator)); }
+
+		/**
+		* The number of rows contained in the SoaArrayList.
+		*/
+		[[nodiscard]] usize len() const { return _length; }
+
+		/**
+		* The number of rows every column can store without reallocation.
+		*/
+		[[nodiscard]] usize capacity() const { return _capacity; }
+
+		/**
+		* @return The allocator used by the SoaArrayList. Can be copied.
+		*/
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
+
+		/**
+		* A mutable pointer to the column holding field `N` of every row. Accessing beyond `len()` is undefined behaviour.
+		* Invalidated by anything that reallocates.
+		*/
+		template<usize N>
+		[[nodiscard]] FieldType<N>* columnData() { return std::get<N>(_columns); }
+
+		/**
+		* An immutable pointer to the column holding field `N` of every row. Accessing beyond `len()` is undefined behaviour.
+		* Invalidated by anything that reallocates.
+		*/
+		template<usize N>
+		[[nodiscard]] const FieldType<N>* columnData() const { return std::get<N>(_columns); }
+
+		/**
+		* A mutable span over field `N` of every row, of length `len()`.
+		* Invalidated by anything that reallocates.
+		*/
+		template<usize N>
+		[[nodiscard]] std::span<FieldType<N>> column() { return std::span<FieldType<N>>(std::get<N>(_columns), _length); }
+
+		/**
+		* An immutable span over field `N` of every row, of length `len()`.
+		* Invalidated by anything that reallocates.
+		*/
+		template<usize N>
+		[[nodiscard]] std::span<const FieldType<N>> column() const { return std::span<const FieldType<N>>(std::get<N>(_columns), _length); }
+
+		/**
+		* Get a mutable reference to field `N` of a row.
+		*
+		* @param row: The row to get the field of. Asserts that is less than `len()`.
+		*/
+		template<usize N>
+		[[nodiscard]] FieldType<N>& field(usize row);
+
+		/**
+		* Get an immutable reference to field `N` of a row.
+		*
+		* @param row: The row to get the field of. Asserts that is less than `len()`.
+		*/
+		template<usize N>
+		[[nodiscard]] const FieldType<N>& field(usize row) const;
+
+		/**
+		* Gathers a copy of every field of a row into a T.
+		*
+		* @param row: The row to copy. Asserts that is less than `len()`.
+		*/
+		[[nodiscard]] T operator [] (usize row) const;
+
+		/**
+		* Overwrites every field of a row with a copy of the fields of `element`.
+		*
+		* @param row: The row to overwrite. Asserts that is less than `len()`.
+		* @param element: Element to copy the fields from.
+		*/
+		void set(usize row, const T& element);
+
+		/**
+		* Overwrites every field of a row by moving the fields of `element`.
+		*
+		* @param row: The row to overwrite. Asserts that is less than `len()`.
+		* @param element: Element to move the fields from.
+		*/
+		void set(usize row, T&& element);
+
+		/**
+		* Scatters a copy of every field of `element` onto the end of each column, increasing the length by 1.
+		* May reallocate every column if there isn't enough capacity already.
+		*
+		* @param element: Element to copy the fields of.
+		*/
+		void push(const T& element);
+
+		/**
+		* Scatters every field of `element` onto the end of each column by moving, increasing the length by 1.
+		* May reallocate every column if there isn't enough capacity already.
+		*
+		* @param element: Element to move the fields of.
+		*/
+		void push(T&& element);
+
+		/**
+		* Removes the last row, gathering it's fields into a T. Asserts that `len()` is greater than 0.
+		*
+		* @return The removed row.
+		*/
+		T pop();
+
+		/**
+		* Removes a row, moving the last row in place. Does not maintain order.
+		*
+		* @param row: The row to remove. Asserts that is less than `len()`.
+		* @return The removed row. Can be ignored.
+		*/
+		T removeSwap(usize row);
+
+		/**
+		* Reserves additional capacity in every column. The new capacity will be greater than or equal to `len()` + `additional`.
+		*
+		* @param additional: Minimum amount to increase the capacity by
+		*/
+		void reserve(usize additional);
+
+		/**
+		* Shortens the length of the SoaArrayList, keeping the first `newLength` rows,
+		* and destructing the rest. If `newLength` is greater than or equal to the current
+		* `len()`, this function does nothing.
+		* This function has no effect on the allocated capacity.
+		*
+		* @param newLength: Number of rows to keep.
+		*/
+		void truncate(usize newLength);
+
+		/**
+		* Finds the first row where field `N` equals `value`. For field types that support it,
+		* uses the same runtime dispatched SIMD find as `gk::ArrayList::find()` over just that column.
+		*
+		* @param value: Value to compare field `N` of every row against.
+		* @return The found row, or None
+		*/
+		template<usize N>
+		[[nodiscard]] gk::Option<usize> findInColumn(const FieldType<N>& value) const;
+
+	private:
+
+		template<usize... Is>
+		T gatherRow(usize row, std::index_sequence<Is...>) const;
+
+		template<usize... Is>
+		T takeRow(usize row, std::index_sequence<Is...>);
+
+		/**
+		* Moves the fields of `src` into the uninitialized `dst` of a column, leaving `src` without live fields.
+		*/
+		template<typename FieldT>
+		static void moveFields(FieldT* dst, FieldT* src, usize count);
+
+		/**
+		* Moves every column into new buffers holding at least `capacity` rows.
+		*/
+		void reallocate(usize capacity);
+
+		/**
+		* Destructs all fields, and frees every column.
+		*/
+		void deleteExistingBuffer();
+
+	private:
+
+		ColumnPointers _columns;
+		usize _length;
+		usize _capacity;
+		no_unique_address_member Allocator _allocator;
+
+	}; // struct SoaArrayList
+
+	template<typename T, typename Allocator>
+	struct is_trivially_relocatable<SoaArrayList<T, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace gk
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>::SoaArrayList(Allocator&& inAllocator)
+	: _columns(), _length(0), _capacity(0), _allocator(std::move(inAllocator))
+{}
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>::SoaArrayList()
+	: _columns(), _length(0), _capacity(0), _allocator(internal::arrayListDefaultAllocator<Allocator>())
+{}
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>::SoaArrayList(const SoaArrayList& other)
+	: _columns(), _length(0), _capacity(0), _allocator(other._allocator)
+{
+	if (other._length == 0) {
+		return;
+	}
+
+	reallocate(other._length);
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		(std::uninitialized_copy_n(std::get<Is>(other._columns), other._length, std::get<Is>(_columns)), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+	_length = other._length;
+}
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>::SoaArrayList(SoaArrayList&& other) noexcept
+	: _columns(other._columns), _length(other._length), _capacity(other._capacity), _allocator(std::move(other._allocator))
+{
+	other._columns = ColumnPointers();
+	other._length = 0;
+	other._capacity = 0;
+}
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>::~SoaArrayList()
+{
+	deleteExistingBuffer();
+}
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>& gk::SoaArrayList<T, Allocator>::operator=(const SoaArrayList& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = other._allocator;
+	if (other._length == 0) {
+		return *this;
+	}
+
+	reallocate(other._length);
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		(std::uninitialized_copy_n(std::get<Is>(other._columns), other._length, std::get<Is>(_columns)), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+	_length = other._length;
+	return *this;
+}
+
+template<typename T, typename Allocator>
+inline gk::SoaArrayList<T, Allocator>& gk::SoaArrayList<T, Allocator>::operator=(SoaArrayList&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_columns = other._columns;
+	_length = other._length;
+	_capacity = other._capacity;
+	_allocator = std::move(other._allocator);
+	other._columns = ColumnPointers();
+	other._length = 0;
+	other._capacity = 0;
+	return *this;
+}
+
+template<typename T, typename Allocator>
+template<gk::usize N>
+inline typename gk::SoaArrayList<T, Allocator>::template FieldType<N>& gk::SoaArrayList<T, Allocator>::field(usize row)
+{
+	check_message(row < _length, "Index out of bounds! Attempted to access row ", row, " from SoaArrayList of length ", _length);
+	return std::get<N>(_columns)[row];
+}
+
+template<typename T, typename Allocator>
+template<gk::usize N>
+inline const typename gk::SoaArrayList<T, Allocator>::template FieldType<N>& gk::SoaArrayList<T, Allocator>::field(usize row) const
+{
+	check_message(row < _length, "Index out of bounds! Attempted to access row ", row, " from SoaArrayList of length ", _length);
+	return std::get<N>(_columns)[row];
+}
+
+template<typename T, typename Allocator>
+inline T gk::SoaArrayList<T, Allocator>::operator[](usize row) const
+{
+	check_message(row < _length, "Index out of bounds! Attempted to access row ", row, " from SoaArrayList of length ", _length);
+	return gatherRow(row, std::make_index_sequence<FIELD_COUNT>());
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::set(usize row, const T& element)
+{
+	check_message(row < _length, "Index out of bounds! Attempted to set row ", row, " from SoaArrayList of length ", _length);
+	auto fields = internal::tieFields(element);
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		((std::get<Is>(_columns)[row] = std::get<Is>(fields)), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::set(usize row, T&& element)
+{
+	check_message(row < _length, "Index out of bounds! Attempted to set row ", row, " from SoaArrayList of length ", _length);
+	auto fields = internal::tieFields(element);
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		((std::get<Is>(_columns)[row] = std::move(std::get<Is>(fields))), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::push(const T& element)
+{
+	if (_length == _capacity) {
+		reallocate(internal::arrayGrowCapacity(_capacity, _length + 1));
+	}
+
+	auto fields = internal::tieFields(element);
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		(std::construct_at(std::get<Is>(_columns) + _length, std::get<Is>(fields)), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+	_length++;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::push(T&& element)
+{
+	if (_length == _capacity) {
+		reallocate(internal::arrayGrowCapacity(_capacity, _length + 1));
+	}
+
+	auto fields = internal::tieFields(element);
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		(std::construct_at(std::get<Is>(_columns) + _length, std::move(std::get<Is>(fields))), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+	_length++;
+}
+
+template<typename T, typename Allocator>
+inline T gk::SoaArrayList<T, Allocator>::pop()
+{
+	check_message(_length > 0, "Cannot pop from an empty SoaArrayList");
+	_length--;
+	return takeRow(_length, std::make_index_sequence<FIELD_COUNT>());
+}
+
+template<typename T, typename Allocator>
+inline T gk::SoaArrayList<T, Allocator>::removeSwap(usize row)
+{
+	check_message(row < _length, "Index out of bounds! Attempted to removed row ", row, " from SoaArrayList of length ", _length);
+
+	T temp = takeRow(row, std::make_index_sequence<FIELD_COUNT>());
+	const usize last = _length - 1;
+	if (row != last) { // swap the last row in place if it's not the one being removed
+		[&]<usize... Is>(std::index_sequence<Is...>) {
+			((std::construct_at(std::get<Is>(_columns) + row, std::move(std::get<Is>(_columns)[last])),
+				std::destroy_at(std::get<Is>(_columns) + last)), ...);
+		}(std::make_index_sequence<FIELD_COUNT>());
+	}
+
+	_length--;
+	return temp;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::reserve(usize additional)
+{
+	const usize addedLength = _length + additional;
+	if (addedLength <= _capacity) return;
+
+	reallocate(internal::arrayGrowCapacity(_capacity, addedLength));
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::truncate(usize newLength)
+{
+	if (newLength >= _length) return;
+
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		(std::destroy(std::get<Is>(_columns) + newLength, std::get<Is>(_columns) + _length), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+	_length = newLength;
+}
+
+template<typename T, typename Allocator>
+template<gk::usize N>
+inline gk::Option<gk::usize> gk::SoaArrayList<T, Allocator>::findInColumn(const FieldType<N>& value) const
+{
+	const FieldType<N>* columnStart = std::get<N>(_columns);
+	if constexpr (IS_FIELD_SIMD<N>) {
+		// The SIMD find uses unaligned loads and handles the tail itself, so the column needs no padding.
+		return internal::doSimdArrayElementFind(columnStart, _length, value);
+	}
+	else {
+		for (usize i = 0; i < _length; i++) {
+			if (columnStart[i] == value) {
+				return gk::Option<usize>(i);
+			}
+		}
+		return gk::Option<usize>();
+	}
+}
+
+template<typename T, typename Allocator>
+template<gk::usize... Is>
+inline T gk::SoaArrayList<T, Allocator>::gatherRow(usize row, std::index_sequence<Is...>) const
+{
+	return T{ std::get<Is>(_columns)[row]... };
+}
+
+template<typename T, typename Allocator>
+template<gk::usize... Is>
+inline T gk::SoaArrayList<T, Allocator>::takeRow(usize row, std::index_sequence<Is...>)
+{
+	T out{ std::move(std::get<Is>(_columns)[row])... };
+	(std::destroy_at(std::get<Is>(_columns) + row), ...);
+	return out;
+}
+
+template<typename T, typename Allocator>
+template<typename FieldT>
+inline void gk::SoaArrayList<T, Allocator>::moveFields(FieldT* dst, FieldT* src, usize count)
+{
+	if constexpr (gk::is_trivially_relocatable_v<FieldT>) {
+		if (count > 0) {
+			memcpy((void*)dst, (const void*)src, count * sizeof(FieldT));
+		}
+	}
+	else {
+		for (usize i = 0; i < count; i++) {
+			new (dst + i) FieldT(std::move(src[i]));
+			src[i].~FieldT();
+		}
+	}
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::reallocate(usize capacity)
+{
+	check_ge(capacity, _length);
+
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		([&] {
+			using FieldT = FieldType<Is>;
+			FieldT*& columnStart = std::get<Is>(_columns);
+			FieldT* newColumn = _allocator.template mallocAlignedBuffer<FieldT>(capacity, alignof(FieldT)).ok();
+			if (columnStart != nullptr) {
+				moveFields(newColumn, columnStart, _length);
+				_allocator.freeAlignedBuffer(columnStart, _capacity, alignof(FieldT));
+			}
+			columnStart = newColumn;
+		}(), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+
+	_capacity = capacity;
+}
+
+template<typename T, typename Allocator>
+inline void gk::SoaArrayList<T, Allocator>::deleteExistingBuffer()
+{
+	if (_capacity == 0) {
+		return;
+	}
+
+	[&]<usize... Is>(std::index_sequence<Is...>) {
+		([&] {
+			using FieldT = FieldType<Is>;
+			FieldT*& columnStart = std::get<Is>(_columns);
+			std::destroy(columnStart, columnStart + _length);
+			_allocator.freeAlignedBuffer(columnStart, _capacity, alignof(FieldT));
+			columnStart = nullptr;
+		}(), ...);
+	}(std::make_index_sequence<FIELD_COUNT>());
+
+	_length = 0;
+	_capacity = 0;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 namespace gk
 {
 	// Signed 8 bit integer
@@ -21,6 +23,17 @@ namespace gk
 	using u64 = unsigned long long;
 
 	using usize = size_t;
+
+	/**
+	* Whether a T can be moved to a new address with memcpy, leaving the old bytes dead without calling a destructor.
+	* Defaults to trivially copyable types. Types that own heap memory, but hold no pointers into themselves
+	* (such as gk::String or gk::ArrayList) specialize this to true, letting containers relocate them in bulk.
+	*/
+	template<typename T>
+	struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+	template<typename T>
+	constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
 }
 
 static_assert(sizeof(gk::i8) == 1);
@@ -37,8 +50,13 @@ static_assert(sizeof(gk::u64) == 8);
 
 #define forceinline __forceinline
 
+// MSVC ignores the standard attribute, but respects its own.
+#define no_unique_address_member [[msvc::no_unique_address]]
+
 #else
 
 #define forceinline __attribute__((always_inline))
 
+#define no_unique_address_member [[no_unique_address]]
+
 #endif
\ No newline at end of file
@@ -2,11 +2,22 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <processthreadsapi.h>
+#include <intrin.h>
 #include <thread>
 
 bool gk::x86::isAvx512Supported()
 {
-	return IsProcessorFeaturePresent(PF_AVX512F_INSTRUCTIONS_AVAILABLE);
+	if (!IsProcessorFeaturePresent(PF_AVX512F_INSTRUCTIONS_AVAILABLE)) {
+		return false;
+	}
+
+	// Extended features leaf. The BW and VL flags are in EBX.
+	constexpr u32 AVX512BW_BIT = 1u << 30;
+	constexpr u32 AVX512VL_BIT = 1u << 31;
+	int cpuInfo[4];
+	__cpuidex(cpuInfo, 7, 0);
+	const u32 ebx = static_cast<u32>(cpuInfo[1]);
+	return (ebx & AVX512BW_BIT) && (ebx & AVX512VL_BIT);
 }
 
 bool gk::x86::isAvx2Supported()
@@ -14,6 +25,11 @@ bool gk::x86::isAvx2Supported()
 	return IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE);
 }
 
+bool gk::x86::isSse42Supported()
+{
+	return IsProcessorFeaturePresent(PF_SSE4_2_INSTRUCTIONS_AVAILABLE);
+}
+
 gk::u32 gk::systemThreadCount()
 {
 	u32 threadCount = std::thread::hardware_concurrency();
@@ -8,6 +8,8 @@ namespace gk
 	{
 		/**
 		* Check at runtime if AVX-512 is supported by this x86 processor.
+		* Requires the foundation, byte and word (BW), and vector length (VL) extensions,
+		* as the SIMD code throughout this library uses all three.
 		* 
 		* @return If AVX-512 is supported
 		*/
@@ -19,6 +21,13 @@ namespace gk
 		* @return If AVX-2 is supported
 		*/
 		[[nodiscard]] bool isAvx2Supported();
+
+		/**
+		* Check at runtime if SSE4.2 is supported by this x86 processor.
+		*
+		* @return If SSE4.2 is supported
+		*/
+		[[nodiscard]] bool isSse42Supported();
 	}
 
 	/**
@@ -0,0 +1,235 @@
+#include "concurrent_hashmap.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../string/string.h"
+
+using gk::ConcurrentHashMap;
+using gk::usize;
+using gk::i32;
+using gk::u64;
+
+namespace gk
+{
+	namespace unitTests
+	{
+		constexpr usize CONCURRENT_MAP_JOB_COUNT = 8;
+		constexpr u64 CONCURRENT_MAP_KEYS_PER_JOB = 5000;
+		constexpr u64 CONCURRENT_MAP_SHARED_KEYS = 100;
+
+		struct ConcurrentMapJob {
+			ConcurrentHashMap<u64, u64>* map;
+			u64 firstKey;
+			std::atomic<usize>* remainingJobs;
+		};
+
+		static void runConcurrentMapInsertJob(ConcurrentMapJob* job) {
+			for (u64 i = 0; i < CONCURRENT_MAP_KEYS_PER_JOB; i++) {
+				const u64 key = job->firstKey + i;
+				check(job->map->insert(key, key * 2));
+				// Another job may be writing to the same shard.
+				check_eq(job->map->find(key).someCopy(), key * 2);
+			}
+			job->remainingJobs->fetch_sub(1, std::memory_order::release);
+		}
+
+		static void runConcurrentMapUpsertJob(ConcurrentMapJob* job) {
+			for (u64 i = 0; i < CONCURRENT_MAP_SHARED_KEYS; i++) {
+				job->map->upsert(i, 1, [](u64& count) { count++; });
+			}
+			job->remainingJobs->fetch_sub(1, std::memory_order::release);
+		}
+
+		static void waitForConcurrentMapJobs(std::atomic<usize>& remainingJobs) {
+			while (remainingJobs.load(std::memory_order::acquire) != 0) {
+				std::this_thread::yield();
+			}
+		}
+
+		struct NestedParallelForEachJob {
+			JobSystem* jobSystem;
+			const ConcurrentHashMap<u64, u64>* map;
+			std::atomic<usize>* count;
+		};
+
+		static void runNestedParallelForEach(NestedParallelForEachJob* job) {
+			job->map->parallelForEach(*job->jobSystem, [job](const u64& key, const u64& value) {
+				job->count->fetch_add(1, std::memory_order::relaxed);
+			});
+		}
+	}
+}
+
+using gk::unitTests::ConcurrentMapJob;
+
+test_case("ConcurrentHashMap default construct") {
+	ConcurrentHashMap<i32, i32> map;
+	check_eq(map.size(), 0);
+	check(map.find(0).none());
+	check(!map.contains(0));
+	check(!map.erase(0));
+}
+
+test_case("ConcurrentHashMap insert, find, and erase ints") {
+	ConcurrentHashMap<i32, i32> map;
+	for (i32 i = 0; i < 1000; i++) {
+		check(map.insert(i, i * 2));
+	}
+	check_eq(map.size(), 1000);
+	for (i32 i = 0; i < 1000; i++) {
+		check_eq(map.find(i).someCopy(), i * 2);
+	}
+	check(map.find(1000).none());
+
+	for (i32 i = 0; i < 1000; i += 2) {
+		check(map.erase(i));
+	}
+	check(!map.erase(0));
+	check_eq(map.size(), 500);
+	check(!map.contains(0));
+	check(map.contains(1));
+}
+
+test_case("ConcurrentHashMap insert existing leaves value") {
+	ConcurrentHashMap<i32, i32> map;
+	check(map.insert(5, 10));
+	check(!map.insert(5, 20));
+	check_eq(map.size(), 1);
+	check_eq(map.find(5).someCopy(), 10);
+}
+
+test_case("ConcurrentHashMap single shard") {
+	ConcurrentHashMap<i32, i32, 1> map;
+	for (i32 i = 0; i < 100; i++) {
+		map.insert(i, i);
+	}
+	check_eq(map.size(), 100);
+	check_eq(map.find(99).someCopy(), 99);
+}
+
+test_case("ConcurrentHashMap strings with Str lookup") {
+	ConcurrentHashMap<gk::String, gk::String> map;
+	for (u64 i = 0; i < 500; i++) {
+		map.insert(gk::String::fromUint(i), gk::String::fromUint(i * 3));
+	}
+	check_eq(map.size(), 500);
+	check_eq(map.find(gk::String::fromUint(7)).someCopy(), gk::String::fromUint(21));
+
+	const char* buffer = "12345";
+	check_eq(map.find(gk::Str::fromSlice(buffer + 1, 2)).someCopy(), gk::String::fromUint(69));
+	check(map.contains(gk::Str::fromSlice(buffer, 3)));
+	check(!map.contains(gk::Str::fromSlice(buffer, 4)));
+	check(map.erase(gk::Str::fromSlice(buffer, 3)));
+	check(!map.contains(gk::String::fromUint(123)));
+}
+
+test_case("ConcurrentHashMap upsert") {
+	ConcurrentHashMap<gk::String, i32> map;
+	const gk::String key = gk::String::fromInt(1);
+	for (i32 i = 0; i < 10; i++) {
+		map.upsert(key, 1, [](i32& count) { count++; });
+	}
+	check(map.upsert(gk::String::fromInt(2), 1, [](i32& count) { count++; }));
+	check(!map.upsert(gk::String::fromInt(2), 1, [](i32& count) { count++; }));
+	check_eq(map.size(), 2);
+	check_eq(map.find(key).someCopy(), 10);
+	check_eq(map.find(gk::String::fromInt(2)).someCopy(), 2);
+}
+
+test_case("ConcurrentHashMap reserve") {
+	ConcurrentHashMap<i32, i32> map;
+	map.reserve(10000);
+	for (i32 i = 0; i < 10000; i++) {
+		map.insert(i, i);
+	}
+	check_eq(map.size(), 10000);
+	check_eq(map.find(9999).someCopy(), 9999);
+}
+
+test_case("ConcurrentHashMap forEach and snapshot") {
+	ConcurrentHashMap<i32, i32> map;
+	for (i32 i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	i32 keySum = 0;
+	usize count = 0;
+	map.forEach([&](const i32& key, const i32& value) {
+		check_eq(value, key * 2);
+		keySum += key;
+		count++;
+	});
+	check_eq(count, 1000);
+	check_eq(keySum, 999 * 500);
+
+	gk::HashMap<i32, i32> copy = map.snapshot();
+	check_eq(copy.size(), 1000);
+	for (i32 i = 0; i < 1000; i++) {
+		check_eq(*copy.find(i).some(), i * 2);
+	}
+}
+
+test_case("ConcurrentHashMap insert and find from many jobs") {
+	gk::JobSystem jobSystem(4);
+	ConcurrentHashMap<u64, u64> map;
+	std::atomic<usize> remainingJobs = gk::unitTests::CONCURRENT_MAP_JOB_COUNT;
+	ConcurrentMapJob jobs[gk::unitTests::CONCURRENT_MAP_JOB_COUNT];
+	for (usize i = 0; i < gk::unitTests::CONCURRENT_MAP_JOB_COUNT; i++) {
+		jobs[i] = ConcurrentMapJob{ &map, i * gk::unitTests::CONCURRENT_MAP_KEYS_PER_JOB, &remainingJobs };
+		(void)jobSystem.runJob(gk::unitTests::runConcurrentMapInsertJob, &jobs[i]);
+	}
+	gk::unitTests::waitForConcurrentMapJobs(remainingJobs);
+
+	const u64 keyCount = gk::unitTests::CONCURRENT_MAP_JOB_COUNT * gk::unitTests::CONCURRENT_MAP_KEYS_PER_JOB;
+	check_eq(map.size(), keyCount);
+	for (u64 i = 0; i < keyCount; i++) {
+		check_eq(map.find(i).someCopy(), i * 2);
+	}
+}
+
+test_case("ConcurrentHashMap upsert from many jobs") {
+	gk::JobSystem jobSystem(4);
+	ConcurrentHashMap<u64, u64> map;
+	std::atomic<usize> remainingJobs = gk::unitTests::CONCURRENT_MAP_JOB_COUNT;
+	ConcurrentMapJob jobs[gk::unitTests::CONCURRENT_MAP_JOB_COUNT];
+	for (usize i = 0; i < gk::unitTests::CONCURRENT_MAP_JOB_COUNT; i++) {
+		jobs[i] = ConcurrentMapJob{ &map, 0, &remainingJobs };
+		(void)jobSystem.runJob(gk::unitTests::runConcurrentMapUpsertJob, &jobs[i]);
+	}
+	gk::unitTests::waitForConcurrentMapJobs(remainingJobs);
+
+	check_eq(map.size(), gk::unitTests::CONCURRENT_MAP_SHARED_KEYS);
+	for (u64 i = 0; i < gk::unitTests::CONCURRENT_MAP_SHARED_KEYS; i++) {
+		check_eq(map.find(i).someCopy(), gk::unitTests::CONCURRENT_MAP_JOB_COUNT);
+	}
+}
+
+test_case("ConcurrentHashMap parallelForEach") {
+	gk::JobSystem jobSystem(4);
+	ConcurrentHashMap<u64, u64> map;
+	for (u64 i = 0; i < 10000; i++) {
+		map.insert(i, i);
+	}
+	std::atomic<u64> sum = 0;
+	std::atomic<usize> count = 0;
+	map.parallelForEach(jobSystem, [&](const u64& key, const u64& value) {
+		sum.fetch_add(value, std::memory_order::relaxed);
+		count.fetch_add(1, std::memory_order::relaxed);
+	});
+	check_eq(count.load(), 10000);
+	check_eq(sum.load(), 9999ULL * 5000ULL);
+}
+
+test_case("ConcurrentHashMap parallelForEach from inside a job") {
+	// One worker, so waiting on the shard jobs from inside a job would never finish.
+	gk::JobSystem jobSystem(1);
+	ConcurrentHashMap<u64, u64> map;
+	for (u64 i = 0; i < 10000; i++) {
+		map.insert(i, i);
+	}
+	std::atomic<usize> count = 0;
+	gk::unitTests::NestedParallelForEachJob job{ &jobSystem, &map, &count };
+	jobSystem.runJob(gk::unitTests::runNestedParallelForEach, &job).wait();
+	check_eq(count.load(), 10000);
+}
+
+#endif
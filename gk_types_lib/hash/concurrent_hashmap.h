@@ -0,0 +1,453 @@
+#pragma once
+
+#include "hashmap.h"
+#include "../sync/rw_lock.h"
+#include "../job/job_system.h"
+#include <atomic>
+#include <bit>
+#include <thread>
+
+namespace gk
+{
+	/**
+	* HashMap that many threads can read and write at once. The entries are split between `SHARD_COUNT`
+	* independent `gk::HashMap` shards, each guarded by it's own `gk::RawRwLock`, and placed on it's own cache line.
+	* The shard of a key is chosen from the high bits of it's scrambled hash code, while the shard's HashMap uses
+	* the low bits, so the two never correlate. Lookups only take a shared lock on a single shard, so
+	* read heavy workloads scale with the thread count, and writers only block the threads using the same shard.
+	*
+	* Values are returned as copies, as another thread may erase or move an entry as soon as it's shard is unlocked.
+	* To modify an entry in place, use `upsert()`.
+	*
+	* Cannot be copied or moved, as other threads may be using it. See `snapshot()`.
+	*
+	* @param Key: Must satisy the `Hashable` concept.
+	* @param Value: Must be copy constructible, and default constructible.
+	* @param SHARD_COUNT: Number of independently locked shards. Must be a power of 2.
+	* Should be comfortably larger than the number of threads accessing the map.
+	*/
+	template<typename Key, typename Value, usize SHARD_COUNT = 64>
+	struct ConcurrentHashMap
+	{
+		static_assert(Hashable<Key>, "ConcurrentHashMap Key must satisfy gk::Hashable");
+		static_assert(SHARD_COUNT > 0 && (SHARD_COUNT & (SHARD_COUNT - 1)) == 0, "ConcurrentHashMap SHARD_COUNT must be a power of 2");
+
+	private:
+
+		using MapT = HashMap<Key, Value>;
+
+		struct alignas(64) Shard {
+			mutable RawRwLock lock;
+			MapT map;
+		};
+
+		template<typename F>
+		struct ShardJob {
+			const Shard* shard;
+			const F* func;
+			std::atomic<usize>* remainingJobs;
+		};
+
+		static constexpr usize SHARD_BITS = static_cast<usize>(std::countr_zero(SHARD_COUNT));
+
+		/**
+		* Fibonacci hashing. Multiplying spreads every bit of the hash code into the high bits, which matters
+		* for hash codes that only use their low bits, such as integers.
+		*/
+		static constexpr usize shardIndexOf(usize hashCode);
+
+		template<typename F>
+		static void runShardJob(ShardJob<F>* job);
+
+	public:
+
+		ConcurrentHashMap() = default;
+
+		ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+		ConcurrentHashMap(ConcurrentHashMap&&) = delete;
+		ConcurrentHashMap& operator = (const ConcurrentHashMap&) = delete;
+		ConcurrentHashMap& operator = (ConcurrentHashMap&&) = delete;
+
+		/**
+		* No other threads may be using the map.
+		*/
+		~ConcurrentHashMap() = default;
+
+		/**
+		* Locks each shard in turn, so if other threads are writing, the result may already be out of date.
+		*
+		* @return Number of elements stored in the ConcurrentHashMap.
+		*/
+		[[nodiscard]] usize size() const;
+
+		/**
+		* Finds an entry, returning a copy of it's value.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't.
+		*/
+		[[nodiscard]] Option<Value> find(const Key& key) const;
+
+		/**
+		* Finds an entry using a different type than `Key`, returning a copy of it's value.
+		* Avoids constructing a `Key`, such as searching `gk::String` keys with a `gk::Str`. See `gk::HashLookup`.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] Option<Value> find(const Lookup& key) const;
+
+		/**
+		* @return `true` if the key exists in the map, or `false` if it doesn't.
+		*/
+		[[nodiscard]] bool contains(const Key& key) const;
+
+		/**
+		* Checks for a key using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists in the map, or `false` if it doesn't.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] bool contains(const Lookup& key) const;
+
+		/**
+		* Inserts an entry if it DOES NOT exist. If it does, the existing value is left unchanged.
+		*
+		* @return `true` if the entry was added, or `false` if the key already existed. Can be ignored.
+		*/
+		bool insert(Key&& key, Value&& value);
+
+		/**
+		* Inserts a copy of an entry if it DOES NOT exist. If it does, the existing value is left unchanged.
+		*
+		* @return `true` if the entry was added, or `false` if the key already existed. Can be ignored.
+		*/
+		bool insert(const Key& key, const Value& value);
+
+		/**
+		* Inserts an entry if it DOES NOT exist. If it does, calls `onExisting` with a mutable reference
+		* to the existing value instead, while the shard is exclusively locked.
+		* `onExisting` must not use this map.
+		*
+		* @param onExisting: Callable as `void(Value&)`.
+		* @return `true` if the entry was added, or `false` if `onExisting` was called. Can be ignored.
+		*/
+		template<typename F>
+		bool upsert(Key&& key, Value&& value, F&& onExisting);
+
+		/**
+		* Inserts a copy of the key if it DOES NOT exist. If it does, calls `onExisting` with a mutable reference
+		* to the existing value instead, while the shard is exclusively locked.
+		* `onExisting` must not use this map.
+		*
+		* @param onExisting: Callable as `void(Value&)`.
+		* @return `true` if the entry was added, or `false` if `onExisting` was called. Can be ignored.
+		*/
+		template<typename F>
+		bool upsert(const Key& key, Value&& value, F&& onExisting);
+
+		/**
+		* Erases an entry.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the map. Can be ignored.
+		*/
+		bool erase(const Key& key);
+
+		/**
+		* Erases an entry using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the map. Can be ignored.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		bool erase(const Lookup& key);
+
+		/**
+		* Reserves additional capacity, spread evenly between the shards.
+		*
+		* @param additional: Minimum amount of elements to reserve extra capacity for.
+		*/
+		void reserve(usize additional);
+
+		/**
+		* Calls `func` on every entry. Each shard is shared locked while it's entries are visited,
+		* so entries may be inserted or erased in other shards during iteration.
+		* `func` must not write to this map.
+		*
+		* @param func: Callable as `void(const Key&, const Value&)`.
+		*/
+		template<typename F>
+		void forEach(const F& func) const;
+
+		/**
+		* Calls `func` on every entry, visiting each shard as a separate job on `jobSystem`.
+		* Returns once every shard has been visited. Each shard is shared locked while it's entries are visited.
+		* `func` will be called from many threads at once, and must not write to this map.
+		* When called from one of `jobSystem`'s worker threads, the shards are visited on the calling thread with `forEach()`.
+		*
+		* @param jobSystem: Job system to run the shards on.
+		* @param func: Callable as `void(const Key&, const Value&)`.
+		*/
+		template<typename F>
+		void parallelForEach(JobSystem& jobSystem, const F& func) const;
+
+		/**
+		* Copies every entry into a single threaded `gk::HashMap`. Every shard is shared locked at once
+		* while copying, so the result is a consistent point in time view of the map.
+		*
+		* @return Copy of all entries.
+		*/
+		[[nodiscard]] MapT snapshot() const;
+
+	private:
+
+		Shard _shards[SHARD_COUNT];
+	};
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline constexpr gk::usize gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::shardIndexOf(usize hashCode)
+{
+	if constexpr (SHARD_COUNT == 1) {
+		return 0;
+	}
+	else {
+		return (hashCode * 0x9E3779B97F4A7C15ULL) >> (64 - SHARD_BITS);
+	}
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename F>
+inline void gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::runShardJob(ShardJob<F>* job)
+{
+	job->shard->lock.lockShared();
+	for (auto pair : job->shard->map) {
+		(*job->func)(pair.key, pair.value);
+	}
+	job->shard->lock.unlockShared();
+	job->remainingJobs->fetch_sub(1, std::memory_order::release);
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline gk::usize gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::size() const
+{
+	usize total = 0;
+	for (const Shard& shard : _shards) {
+		shard.lock.lockShared();
+		total += shard.map.size();
+		shard.lock.unlockShared();
+	}
+	return total;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline gk::Option<Value> gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::find(const Key& key) const
+{
+	const usize hashCode = MapT::hashKey(key);
+	const Shard& shard = _shards[shardIndexOf(hashCode)];
+	Option<Value> out;
+	shard.lock.lockShared();
+	if (shard.map._groupCount != 0) {
+		Option<const Value*> found = shard.map.findImpl(key, hashCode);
+		if (found.isSome()) {
+			out = *found.some();
+		}
+	}
+	shard.lock.unlockShared();
+	return out;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline gk::Option<Value> gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::find(const Lookup& key) const
+{
+	const usize hashCode = MapT::hashLookup(key);
+	const Shard& shard = _shards[shardIndexOf(hashCode)];
+	Option<Value> out;
+	shard.lock.lockShared();
+	if (shard.map._groupCount != 0) {
+		Option<const Value*> found = shard.map.findImpl(key, hashCode);
+		if (found.isSome()) {
+			out = *found.some();
+		}
+	}
+	shard.lock.unlockShared();
+	return out;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::contains(const Key& key) const
+{
+	const usize hashCode = MapT::hashKey(key);
+	const Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockShared();
+	const bool found = shard.map._groupCount != 0 && shard.map.findImpl(key, hashCode).isSome();
+	shard.lock.unlockShared();
+	return found;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::contains(const Lookup& key) const
+{
+	const usize hashCode = MapT::hashLookup(key);
+	const Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockShared();
+	const bool found = shard.map._groupCount != 0 && shard.map.findImpl(key, hashCode).isSome();
+	shard.lock.unlockShared();
+	return found;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::insert(Key&& key, Value&& value)
+{
+	const usize hashCode = MapT::hashKey(key);
+	Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockExclusive();
+	shard.map.reserve(1); // Grows the group count along with the element count.
+	const bool added = shard.map.insertWithHashCode(std::move(key), std::move(value), hashCode).none();
+	shard.lock.unlockExclusive();
+	return added;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::insert(const Key& key, const Value& value)
+{
+	Key keyCopy = key;
+	Value valueCopy = value;
+	return insert(std::move(keyCopy), std::move(valueCopy));
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename F>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::upsert(Key&& key, Value&& value, F&& onExisting)
+{
+	const usize hashCode = MapT::hashKey(key);
+	Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockExclusive();
+	shard.map.reserve(1);
+	Option<Value*> existing = shard.map.insertWithHashCode(std::move(key), std::move(value), hashCode);
+	const bool added = existing.none();
+	if (!added) {
+		onExisting(*existing.some());
+	}
+	shard.lock.unlockExclusive();
+	return added;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename F>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::upsert(const Key& key, Value&& value, F&& onExisting)
+{
+	const usize hashCode = MapT::hashKey(key);
+	Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockExclusive();
+	if (shard.map._groupCount != 0) {
+		Option<Value*> existing = shard.map.findImpl(key, hashCode);
+		if (existing.isSome()) {
+			onExisting(*existing.some());
+			shard.lock.unlockExclusive();
+			return false;
+		}
+	}
+	shard.map.reserve(1);
+	(void)shard.map.insertWithHashCode(Key(key), std::move(value), hashCode);
+	shard.lock.unlockExclusive();
+	return true;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::erase(const Key& key)
+{
+	const usize hashCode = MapT::hashKey(key);
+	Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockExclusive();
+	const bool erased = shard.map._groupCount != 0 && shard.map.eraseImpl(key, hashCode);
+	shard.lock.unlockExclusive();
+	return erased;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline bool gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::erase(const Lookup& key)
+{
+	const usize hashCode = MapT::hashLookup(key);
+	Shard& shard = _shards[shardIndexOf(hashCode)];
+	shard.lock.lockExclusive();
+	const bool erased = shard.map._groupCount != 0 && shard.map.eraseImpl(key, hashCode);
+	shard.lock.unlockExclusive();
+	return erased;
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline void gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::reserve(usize additional)
+{
+	const usize perShard = (additional + SHARD_COUNT - 1) / SHARD_COUNT;
+	for (Shard& shard : _shards) {
+		shard.lock.lockExclusive();
+		shard.map.reserve(perShard);
+		shard.lock.unlockExclusive();
+	}
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename F>
+inline void gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::forEach(const F& func) const
+{
+	for (const Shard& shard : _shards) {
+		shard.lock.lockShared();
+		for (auto pair : shard.map) {
+			func(pair.key, pair.value);
+		}
+		shard.lock.unlockShared();
+	}
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+template<typename F>
+inline void gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::parallelForEach(JobSystem& jobSystem, const F& func) const
+{
+	// Waiting on the shard jobs from a worker would deadlock once every worker is waiting.
+	if (jobSystem.isWorkerThread()) {
+		forEach(func);
+		return;
+	}
+
+	std::atomic<usize> remainingJobs = SHARD_COUNT;
+	ShardJob<F> jobs[SHARD_COUNT];
+	for (usize i = 0; i < SHARD_COUNT; i++) {
+		jobs[i] = ShardJob<F>{ &_shards[i], &func, &remainingJobs };
+		(void)jobSystem.runJob(runShardJob<F>, &jobs[i]);
+	}
+	while (remainingJobs.load(std::memory_order::acquire) != 0) {
+		std::this_thread::yield();
+	}
+}
+
+template<typename Key, typename Value, gk::usize SHARD_COUNT>
+inline gk::HashMap<Key, Value> gk::ConcurrentHashMap<Key, Value, SHARD_COUNT>::snapshot() const
+{
+	// Shards are always locked in index order, and writers only ever hold one, so this can't deadlock.
+	usize total = 0;
+	for (const Shard& shard : _shards) {
+		shard.lock.lockShared();
+		total += shard.map.size();
+	}
+
+	MapT out;
+	out.reserve(total);
+	for (const Shard& shard : _shards) {
+		for (auto pair : shard.map) {
+			(void)out.insert(pair.key, pair.value);
+		}
+	}
+
+	for (const Shard& shard : _shards) {
+		shard.lock.unlockShared();
+	}
+	return out;
+}
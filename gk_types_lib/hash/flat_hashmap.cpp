@@ -0,0 +1,203 @@
+#include "flat_hashmap.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../allocator/stats_allocator.h"
+#include "../string/string.h"
+
+using gk::FlatHashMap;
+using gk::usize;
+using gk::i32;
+using gk::u64;
+
+test_case("FlatHashMap default construct") {
+	FlatHashMap<i32, i32> map;
+	check_eq(map.size(), 0);
+	check_eq(map.capacity(), 0);
+	check(map.find(0).none());
+	check(!map.erase(0));
+}
+
+test_case("FlatHashMap insert and find ints") {
+	FlatHashMap<i32, i32> map;
+	for (i32 i = 0; i < 1000; i++) {
+		check(map.insert(i, i * 2).none());
+	}
+	check_eq(map.size(), 1000);
+	for (i32 i = 0; i < 1000; i++) {
+		check_eq(*map.find(i).some(), i * 2);
+	}
+	check(map.find(1000).none());
+	check(map.find(-1).none());
+}
+
+test_case("FlatHashMap insert existing returns value") {
+	FlatHashMap<i32, i32> map;
+	map.insert(5, 10);
+	gk::Option<i32*> existing = map.insert(5, 20);
+	check(existing.isSome());
+	i32* existingValue = existing.some();
+	check_eq(*existingValue, 10);
+	*existingValue = 30;
+	check_eq(map.size(), 1);
+	check_eq(*map.find(5).some(), 30);
+}
+
+test_case("FlatHashMap strings") {
+	FlatHashMap<gk::String, gk::String> map;
+	for (u64 i = 0; i < 500; i++) {
+		map.insert(gk::String::fromUint(i), gk::String::fromUint(i * 3));
+	}
+	check_eq(map.size(), 500);
+	const FlatHashMap<gk::String, gk::String>& constMap = map;
+	for (u64 i = 0; i < 500; i++) {
+		check_eq(*constMap.find(gk::String::fromUint(i)).some(), gk::String::fromUint(i * 3));
+	}
+	check(constMap.find(gk::String::fromUint(500)).none());
+}
+
+test_case("FlatHashMap find, contains, and erase with Str") {
+	FlatHashMap<gk::String, i32> map;
+	for (i32 i = 0; i < 100; i++) {
+		map.insert(gk::String::fromInt(i), i);
+	}
+	const char* buffer = "12345";
+	check_eq(*map.find(gk::Str::fromSlice(buffer + 1, 2)).some(), 23);
+	check(map.contains(gk::Str::fromSlice(buffer, 1)));
+	check(!map.contains(gk::Str::fromSlice(buffer, 3)));
+	check(map.erase(gk::Str::fromSlice(buffer + 3, 2)));
+	check(!map.erase(gk::Str::fromSlice(buffer + 3, 2)));
+	check_eq(map.size(), 99);
+}
+
+test_case("FlatHashMap erase leaves no tombstones") {
+	FlatHashMap<i32, i32> map;
+	for (i32 i = 0; i < 2000; i++) {
+		map.insert(i, i);
+	}
+	const usize capacity = map.capacity();
+	for (i32 i = 0; i < 2000; i += 2) {
+		check(map.erase(i));
+	}
+	check(!map.erase(0));
+	check_eq(map.size(), 1000);
+	for (i32 i = 0; i < 2000; i++) {
+		if (i % 2 == 0) {
+			check(map.find(i).none());
+		}
+		else {
+			check_eq(*map.find(i).some(), i);
+		}
+	}
+
+	// Repeatedly erasing and inserting must not grow the map, or fill it with deleted slots.
+	for (i32 round = 0; round < 20; round++) {
+		for (i32 i = 0; i < 1000; i++) {
+			map.insert(10000 + i, i);
+		}
+		for (i32 i = 0; i < 1000; i++) {
+			check(map.erase(10000 + i));
+		}
+	}
+	check_eq(map.size(), 1000);
+	check_eq(map.capacity(), capacity);
+	for (i32 i = 1; i < 2000; i += 2) {
+		check_eq(*map.find(i).some(), i);
+	}
+}
+
+test_case("FlatHashMap erase everything") {
+	FlatHashMap<gk::String, i32> map;
+	for (i32 i = 0; i < 300; i++) {
+		map.insert(gk::String::fromInt(i), i);
+	}
+	for (i32 i = 0; i < 300; i++) {
+		check(map.erase(gk::String::fromInt(i)));
+	}
+	check_eq(map.size(), 0);
+	check(map.begin() == map.end());
+}
+
+test_case("FlatHashMap reserve") {
+	FlatHashMap<i32, i32> map;
+	map.reserve(1000);
+	const usize capacity = map.capacity();
+	check(capacity >= 1000);
+	for (i32 i = 0; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	check_eq(map.capacity(), capacity);
+}
+
+test_case("FlatHashMap iterate") {
+	FlatHashMap<i32, i32> map;
+	for (i32 i = 0; i < 100; i++) {
+		map.insert(i, i);
+	}
+	i32 keySum = 0;
+	usize count = 0;
+	for (auto pair : map) {
+		keySum += pair.key;
+		pair.value *= 2;
+		count++;
+	}
+	check_eq(count, 100);
+	check_eq(keySum, 99 * 50);
+
+	const FlatHashMap<i32, i32>& constMap = map;
+	i32 valueSum = 0;
+	for (auto pair : constMap) {
+		valueSum += pair.value;
+	}
+	check_eq(valueSum, 99 * 100);
+}
+
+test_case("FlatHashMap copy and move") {
+	FlatHashMap<gk::String, i32> map;
+	for (i32 i = 0; i < 100; i++) {
+		map.insert(gk::String::fromInt(i), i);
+	}
+	FlatHashMap<gk::String, i32> copy = map;
+	check_eq(copy.size(), 100);
+	check_eq(*copy.find(gk::String::fromInt(42)).some(), 42);
+	check_ne(copy.find(gk::String::fromInt(42)).some(), map.find(gk::String::fromInt(42)).some());
+
+	FlatHashMap<gk::String, i32> moved = std::move(map);
+	check_eq(map.size(), 0);
+	check_eq(moved.size(), 100);
+
+	map = copy;
+	check_eq(*map.find(gk::String::fromInt(99)).some(), 99);
+	copy = std::move(moved);
+	check_eq(moved.size(), 0);
+	check_eq(*copy.find(gk::String::fromInt(7)).some(), 7);
+}
+
+test_case("FlatHashMap uses a single allocation") {
+	gk::StatsAllocator allocator(gk::globalHeapAllocatorRef());
+	{
+		auto map = FlatHashMap<i32, i32, gk::AllocatorRef>::withCapacity(allocator.toRef(), 100);
+		check_eq(allocator.stats().totalAllocations, 1);
+		for (i32 i = 0; i < 100; i++) {
+			map.insert(i, i);
+		}
+		check_eq(allocator.stats().totalAllocations, 1);
+		map.erase(50);
+		map.insert(1000, 1000);
+		check_eq(allocator.stats().totalAllocations, 1);
+	}
+	check_eq(allocator.stats().liveBytes, 0);
+}
+
+test_case("FlatHashMap pointer keys") {
+	i32 values[64];
+	FlatHashMap<i32*, usize> map;
+	for (usize i = 0; i < 64; i++) {
+		map.insert(&values[i], i);
+	}
+	for (usize i = 0; i < 64; i++) {
+		check_eq(*map.find(&values[i]).some(), i);
+	}
+}
+
+#endif
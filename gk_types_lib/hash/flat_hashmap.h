@@ -0,0 +1,847 @@
+#pragma once
+
+#include "hashmap.h"
+#include "../array/array_list.h"
+#include <intrin.h>
+#include <bit>
+
+namespace gk
+{
+	namespace internal
+	{
+		/// Number of control bytes compared at once when probing a FlatHashMap.
+		constexpr usize FLAT_HASH_MAP_GROUP_WIDTH = 16;
+
+		/// Smallest capacity of a FlatHashMap that has allocated. Must be at least `FLAT_HASH_MAP_GROUP_WIDTH`.
+		constexpr usize FLAT_HASH_MAP_MIN_CAPACITY = 16;
+
+		/**
+		* Spreads the entropy of every bit of a hash code into every other bit, so that keys whose
+		* `gk::hash<>` only differs in a few bits, such as sequential integers, don't form long probe sequences.
+		*/
+		constexpr usize flatHashMapMix(usize hashCode) {
+			hashCode ^= hashCode >> 30;
+			hashCode *= 0xbf58476d1ce4e5b9ULL;
+			hashCode ^= hashCode >> 27;
+			hashCode *= 0x94d049bb133111ebULL;
+			hashCode ^= hashCode >> 31;
+			return hashCode;
+		}
+
+		/**
+		* Compares 16 control bytes against `value` using SSE2.
+		* Inlined rather than runtime dispatched, since SSE2 is always available on x86-64, and it's done on every probe.
+		*
+		* @param controls: Does not need to be aligned.
+		* @return Bitmask where bit `n` is set if `controls[n] == value`.
+		*/
+		inline u32 flatHashMapMatchControls(const i8* controls, i8 value) {
+			const __m128i controlVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(controls));
+			return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(controlVec, _mm_set1_epi8(value))));
+		}
+	}
+
+	/**
+	* Open addressing HashMap storing every key value pair in a single flat array of slots,
+	* with one control byte per slot in a separate array, in the same allocation.
+	* A control byte is 0 for an empty slot, or the 7 bit tag from `HashMapPairBitmask` for a full one.
+	*
+	* Lookups start at the slot chosen by the hash code, comparing 16 control bytes at a time against the tag with SSE2,
+	* only comparing keys whose tag matches, and stopping at the first empty slot. Unlike `gk::HashMap`,
+	* a lookup never follows a pointer to a group before reaching the control bytes and slots.
+	*
+	* Erasing shifts later entries of the same probe sequence backwards, so no tombstones are left behind,
+	* and lookups don't get slower after many erases.
+	*
+	* Requires that template type `Key` satisfies the concept `Hashable`.
+	* Unlike `gk::HashMap`, it's not usable in constexpr contexts.
+	*
+	* NOTE: The key value pairs do not have pointer stability. Any mutation to the hashmap
+	* may modify the location where the values are stored, so they should not be directly stored
+	* as references.
+	*
+	* @param Key: Must satisy the `Hashable` concept.
+	* @param Value: Has no restrictions.
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	*/
+	template<typename Key, typename Value, typename Allocator = GlobalHeapStaticAllocator>
+		requires (Hashable<Key> && AllocatorPolicy<Allocator>)
+	struct FlatHashMap
+	{
+	private:
+
+		struct Slot {
+			Key key;
+			Value value;
+		};
+
+		constexpr static usize ALLOC_ALIGNMENT = alignof(Slot) > 16 ? alignof(Slot) : 16;
+
+		/**
+		* Simple constructor to initialize the FlatHashMap with a specified allocator.
+		* For actual use, call FlatHashMap::init() for whichever overload necessary.
+		*/
+		FlatHashMap(Allocator&& inAllocator);
+
+		static usize hashKey(const Key& key);
+
+	public:
+
+		/**
+		* Default constructor uses gk::globalHeapAllocator().
+		*/
+		FlatHashMap();
+
+		/**
+		* The copy constructor of FlatHashMap will make a clone of the other's allocator.
+		* Requires that Key and Value are copyable.
+		*
+		* @param other: Other FlatHashMap to copy entries and allocator from.
+		*/
+		FlatHashMap(const FlatHashMap& other);
+
+		/**
+		* During move construction, the other FlatHashMap will be left empty.
+		*
+		* @param other: Other FlatHashMap to take ownership of it's entries.
+		*/
+		FlatHashMap(FlatHashMap&& other) noexcept;
+
+		/**
+		* Destructs all entries, freeing the slots.
+		*/
+		~FlatHashMap();
+
+		/**
+		* The copy assignment operator of FlatHashMap will make a clone of the other's allocator.
+		* Requires that Key and Value are copyable.
+		*
+		* @param other: Other FlatHashMap to copy entries and allocator from.
+		*/
+		FlatHashMap& operator = (const FlatHashMap& other);
+
+		/**
+		* During move assignment, the other FlatHashMap will be left empty.
+		*
+		* @param other: Other FlatHashMap to take ownership of it's entries.
+		*/
+		FlatHashMap& operator = (FlatHashMap&& other) noexcept;
+
+		/**
+		* Create a new FlatHashMap given an allocator to take ownership of.
+		*
+		* @param inAllocator: Allocator to own
+		*/
+		[[nodiscard]] static FlatHashMap init(Allocator&& inAllocator) { return FlatHashMap(std::move(inAllocator)); }
+
+		/**
+		* Create a new FlatHashMap given an allocator to take ownership of, able to hold at least
+		* `minCapacity` entries without reallocating.
+		*
+		* @param inAllocator: Allocator to own
+		* @param minCapacity: Minimum number of entries to hold.
+		*/
+		[[nodiscard]] static FlatHashMap withCapacity(Allocator&& inAllocator, usize minCapacity);
+
+		/**
+		* @return Number of elements stored in the FlatHashMap
+		*/
+		[[nodiscard]] usize size() const { return _elementCount; }
+
+		/**
+		* @return Number of slots. The FlatHashMap reallocates once more than 3/4 of them would be full.
+		*/
+		[[nodiscard]] usize capacity() const { return _capacity; }
+
+		/**
+		* @return Immutable reference to the allocator used by this FlatHashMap.
+		*/
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
+
+		/**
+		* Finds an entry within the FlatHashMap, returning an optional mutable value.
+		*
+		* NOTE: The FlatHashMap does not have pointer stability. Subsequent mutation operations on the FlatHashMap may
+		* invalidate the returned Some pointer due to the underlying data being moved to a new location.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		[[nodiscard]] Option<Value*> find(const Key& key);
+
+		/**
+		* Finds an entry within the FlatHashMap, returning an optional immutable value.
+		*
+		* NOTE: The FlatHashMap does not have pointer stability. Subsequent mutation operations on the FlatHashMap may
+		* invalidate the returned Some pointer due to the underlying data being moved to a new location.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		[[nodiscard]] Option<const Value*> find(const Key& key) const;
+
+		/**
+		* Finds an entry within the FlatHashMap using a different type than `Key`, returning an optional mutable value.
+		* Avoids constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] Option<Value*> find(const Lookup& key);
+
+		/**
+		* Finds an entry within the FlatHashMap using a different type than `Key`, returning an optional immutable value.
+		* Avoids constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] Option<const Value*> find(const Lookup& key) const;
+
+		/**
+		* @return `true` if the key exists in the FlatHashMap, or `false` if it doesn't.
+		*/
+		[[nodiscard]] bool contains(const Key& key) const { return find(key).isSome(); }
+
+		/**
+		* Checks for a key using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists in the FlatHashMap, or `false` if it doesn't.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] bool contains(const Lookup& key) const { return find(key).isSome(); }
+
+		/**
+		* Invalidates any iterators.
+		* Inserts an entry into the FlatHashMap if it DOES NOT exist.
+		* If it does exist, an option containing the existing value will be returned, which can be modified.
+		*
+		* @return The entry if it already exists in the FlatHashMap, or a None option if it didn't exist and thus was added.
+		* Can be ignored.
+		*/
+		Option<Value*> insert(Key&& key, Value&& value);
+
+		/**
+		* See `insert(Key&&, Value&&)`.
+		*/
+		Option<Value*> insert(const Key& key, Value&& value);
+
+		/**
+		* See `insert(Key&&, Value&&)`.
+		*/
+		Option<Value*> insert(Key&& key, const Value& value);
+
+		/**
+		* See `insert(Key&&, Value&&)`.
+		*/
+		Option<Value*> insert(const Key& key, const Value& value);
+
+		/**
+		* Invalidates any iterators.
+		* Erases an entry from the FlatHashMap, shifting back any entries that probed past it.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the FlatHashMap.
+		* Can be ignored.
+		*/
+		bool erase(const Key& key);
+
+		/**
+		* Invalidates any iterators.
+		* Erases an entry from the FlatHashMap using a different type than `Key`,
+		* without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the FlatHashMap.
+		* Can be ignored.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		bool erase(const Lookup& key);
+
+		/**
+		* Reserves additional capacity in the FlatHashMap. If it decides to reallocate,
+		* all keys will be rehashed. The FlatHashMap will be able to store at LEAST
+		* `size()` + additional entries.
+		*
+		* @param additional: Minimum amount of elements to reserve extra capacity for
+		*/
+		void reserve(usize additional);
+
+		template<bool IS_CONST>
+		struct SlotIterator;
+
+		using Iterator = SlotIterator<false>;
+		using ConstIterator = SlotIterator<true>;
+
+		/**
+		* `insert()`, `erase()`, `reserve()`, `std::move()` and other mutation operations
+		* can be assumed to invalidate the iterator.
+		*
+		* @return Begin of an Iterator with immutable keys, and mutable values.
+		*/
+		Iterator begin() { return Iterator(this, 0); }
+
+		/**
+		* @return End of an Iterator with immutable keys, and mutable values.
+		*/
+		Iterator end() { return Iterator(this, _capacity); }
+
+		/**
+		* `insert()`, `erase()`, `reserve()`, `std::move()` and other mutation operations
+		* can be assumed to invalidate the iterator.
+		*
+		* @return Begin of an Iterator with immutable keys, and immutable values.
+		*/
+		ConstIterator begin() const { return ConstIterator(this, 0); }
+
+		/**
+		* @return End of an Iterator with immutable keys, and immutable values.
+		*/
+		ConstIterator end() const { return ConstIterator(this, _capacity); }
+
+		template<bool IS_CONST>
+		struct SlotIterator {
+			using MapT = std::conditional_t<IS_CONST, const FlatHashMap, FlatHashMap>;
+
+			struct Pair {
+				const Key& key;
+				std::conditional_t<IS_CONST, const Value&, Value&> value;
+			};
+
+			SlotIterator(MapT* map, usize slotIndex) : _map(map), _slotIndex(slotIndex) { skipEmpty(); }
+
+			bool operator ==(const SlotIterator& other) const { return _slotIndex == other._slotIndex; }
+
+			Pair operator*() const { return Pair{ _map->_slots[_slotIndex].key, _map->_slots[_slotIndex].value }; }
+
+			SlotIterator& operator++() {
+				_slotIndex++;
+				skipEmpty();
+				return *this;
+			}
+
+		private:
+
+			void skipEmpty() {
+				while (_slotIndex < _map->_capacity && _map->_controls[_slotIndex] == 0) {
+					_slotIndex++;
+				}
+			}
+
+			MapT* _map;
+			usize _slotIndex;
+		}; // struct SlotIterator
+
+	private:
+
+		/**
+		* Index of the slot holding `key`, if it exists.
+		*/
+		template<typename LookupKey>
+		Option<usize> findSlot(const LookupKey& key, usize mixedHash) const;
+
+		/**
+		* Destroys the entry at `slotIndex`, shifting back any entries that probed past it.
+		*/
+		void eraseSlot(usize slotIndex);
+
+		/**
+		* Index of the first empty slot in the probe sequence of `mixedHash`. Requires there is at least one empty slot.
+		*/
+		usize findEmptySlot(usize mixedHash) const;
+
+		/**
+		* Sets a control byte, and it's mirror past the end of the control bytes, if it has one.
+		*/
+		void setControl(usize slotIndex, i8 control);
+
+		/**
+		* Inserts the key value pair if the key doesn't already exist, constructing them from `keyArg` and `valueArg`.
+		*/
+		template<typename KeyArg, typename ValueArg>
+		Option<Value*> insertImpl(KeyArg&& keyArg, ValueArg&& valueArg);
+
+		/**
+		* Smallest power of two capacity, that is at least `FLAT_HASH_MAP_MIN_CAPACITY`, that can hold `requiredCapacity` entries
+		* without exceeding the max load factor.
+		*/
+		static usize calculateNewCapacity(usize requiredCapacity);
+
+		/**
+		* Allocates the control bytes and slots for `newCapacity` slots, all empty. Does not free the existing allocation.
+		*/
+		void allocate(usize newCapacity);
+
+		/**
+		* Moves every entry into a new allocation of `newCapacity` slots.
+		*/
+		void rehash(usize newCapacity);
+
+		/**
+		* Destructs all entries, and frees the allocation, leaving this empty with no capacity.
+		*/
+		void deleteExistingBuffer();
+
+		/**
+		* Copies the entries of `other`, which has the same slot layout since the capacity is the same.
+		*/
+		void copyFrom(const FlatHashMap& other);
+
+		static usize allocationSize(usize capacity);
+
+		/**
+		* The control bytes are followed by a mirror of the first `FLAT_HASH_MAP_GROUP_WIDTH` - 1 bytes,
+		* so a group starting near the end wraps around. Rounded up so the slots are aligned.
+		*/
+		static usize controlBytesSize(usize capacity);
+
+	private:
+
+		i8* _controls;
+		Slot* _slots;
+		usize _capacity;
+		usize _elementCount;
+		no_unique_address_member Allocator _allocator;
+
+	}; // struct FlatHashMap
+
+	template<typename Key, typename Value, typename Allocator>
+	struct is_trivially_relocatable<FlatHashMap<Key, Value, Allocator>> : is_trivially_relocatable<Allocator> {};
+
+} // namespace gk
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>::FlatHashMap(Allocator&& inAllocator)
+	: _controls(nullptr), _slots(nullptr), _capacity(0), _elementCount(0), _allocator(std::move(inAllocator))
+{}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::usize gk::FlatHashMap<Key, Value, Allocator>::hashKey(const Key& key)
+{
+	if constexpr (!std::is_pointer<Key>::value) {
+		return internal::flatHashMapMix(gk::hash<Key>(key));
+	}
+	else {
+		return internal::flatHashMapMix(reinterpret_cast<usize>(key));
+	}
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>::FlatHashMap()
+	: _controls(nullptr), _slots(nullptr), _capacity(0), _elementCount(0), _allocator(internal::arrayListDefaultAllocator<Allocator>())
+{}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>::FlatHashMap(const FlatHashMap& other)
+	: _controls(nullptr), _slots(nullptr), _capacity(0), _elementCount(0), _allocator(other._allocator)
+{
+	copyFrom(other);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>::FlatHashMap(FlatHashMap&& other) noexcept
+	: _controls(other._controls), _slots(other._slots), _capacity(other._capacity), _elementCount(other._elementCount), _allocator(std::move(other._allocator))
+{
+	other._controls = nullptr;
+	other._slots = nullptr;
+	other._capacity = 0;
+	other._elementCount = 0;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>::~FlatHashMap()
+{
+	deleteExistingBuffer();
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>& gk::FlatHashMap<Key, Value, Allocator>::operator=(const FlatHashMap& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = other._allocator;
+	copyFrom(other);
+	return *this;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator>& gk::FlatHashMap<Key, Value, Allocator>::operator=(FlatHashMap&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	deleteExistingBuffer();
+	_allocator = std::move(other._allocator);
+	_controls = other._controls;
+	_slots = other._slots;
+	_capacity = other._capacity;
+	_elementCount = other._elementCount;
+	other._controls = nullptr;
+	other._slots = nullptr;
+	other._capacity = 0;
+	other._elementCount = 0;
+	return *this;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::FlatHashMap<Key, Value, Allocator> gk::FlatHashMap<Key, Value, Allocator>::withCapacity(Allocator&& inAllocator, usize minCapacity)
+{
+	FlatHashMap newMap = FlatHashMap(std::move(inAllocator));
+	newMap.reserve(minCapacity);
+	return newMap;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::find(const Key& key)
+{
+	if (_elementCount == 0) {
+		return Option<Value*>();
+	}
+
+	Option<usize> slotIndex = findSlot(key, hashKey(key));
+	if (slotIndex.none()) {
+		return Option<Value*>();
+	}
+	return Option<Value*>(&_slots[slotIndex.someCopy()].value);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::Option<const Value*> gk::FlatHashMap<Key, Value, Allocator>::find(const Key& key) const
+{
+	if (_elementCount == 0) {
+		return Option<const Value*>();
+	}
+
+	Option<usize> slotIndex = findSlot(key, hashKey(key));
+	if (slotIndex.none()) {
+		return Option<const Value*>();
+	}
+	return Option<const Value*>(&_slots[slotIndex.someCopy()].value);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::find(const Lookup& key)
+{
+	if (_elementCount == 0) {
+		return Option<Value*>();
+	}
+
+	Option<usize> slotIndex = findSlot(key, internal::flatHashMapMix(HashLookup<Key, Lookup>::hash(key)));
+	if (slotIndex.none()) {
+		return Option<Value*>();
+	}
+	return Option<Value*>(&_slots[slotIndex.someCopy()].value);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline gk::Option<const Value*> gk::FlatHashMap<Key, Value, Allocator>::find(const Lookup& key) const
+{
+	if (_elementCount == 0) {
+		return Option<const Value*>();
+	}
+
+	Option<usize> slotIndex = findSlot(key, internal::flatHashMapMix(HashLookup<Key, Lookup>::hash(key)));
+	if (slotIndex.none()) {
+		return Option<const Value*>();
+	}
+	return Option<const Value*>(&_slots[slotIndex.someCopy()].value);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::insert(Key&& key, Value&& value)
+{
+	return insertImpl(std::move(key), std::move(value));
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::insert(const Key& key, Value&& value)
+{
+	return insertImpl(key, std::move(value));
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::insert(Key&& key, const Value& value)
+{
+	return insertImpl(std::move(key), value);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::insert(const Key& key, const Value& value)
+{
+	return insertImpl(key, value);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline bool gk::FlatHashMap<Key, Value, Allocator>::erase(const Key& key)
+{
+	if (_elementCount == 0) {
+		return false;
+	}
+
+	Option<usize> foundSlot = findSlot(key, hashKey(key));
+	if (foundSlot.none()) {
+		return false;
+	}
+	eraseSlot(foundSlot.someCopy());
+	return true;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline bool gk::FlatHashMap<Key, Value, Allocator>::erase(const Lookup& key)
+{
+	if (_elementCount == 0) {
+		return false;
+	}
+
+	Option<usize> foundSlot = findSlot(key, internal::flatHashMapMix(HashLookup<Key, Lookup>::hash(key)));
+	if (foundSlot.none()) {
+		return false;
+	}
+	eraseSlot(foundSlot.someCopy());
+	return true;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::eraseSlot(usize slotIndex)
+{
+	const usize mask = _capacity - 1;
+	usize hole = slotIndex;
+	_slots[hole].~Slot();
+
+	// Backward shift deletion. Any entry after the hole in the same run of full slots that could have
+	// been placed at the hole is moved into it, which leaves a new hole, until reaching an empty slot.
+	usize next = (hole + 1) & mask;
+	while (_controls[next] != 0) {
+		const usize home = internal::HashMapGroupBitmask(hashKey(_slots[next].key)).value & mask;
+		const usize distanceFromHome = (next - home) & mask;
+		const usize distanceFromHole = (next - hole) & mask;
+		if (distanceFromHome >= distanceFromHole) {
+			new (&_slots[hole]) Slot(std::move(_slots[next]));
+			_slots[next].~Slot();
+			setControl(hole, _controls[next]);
+			hole = next;
+		}
+		next = (next + 1) & mask;
+	}
+	setControl(hole, 0);
+	_elementCount--;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::reserve(usize additional)
+{
+	const usize newCapacity = calculateNewCapacity(_elementCount + additional);
+	if (newCapacity > _capacity) {
+		rehash(newCapacity);
+	}
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+template<typename LookupKey>
+inline gk::Option<gk::usize> gk::FlatHashMap<Key, Value, Allocator>::findSlot(const LookupKey& key, usize mixedHash) const
+{
+	const i8 tag = internal::HashMapPairBitmask(mixedHash).value;
+	const usize mask = _capacity - 1;
+	usize groupStart = internal::HashMapGroupBitmask(mixedHash).value & mask;
+	while (true) {
+		u32 matches = internal::flatHashMapMatchControls(_controls + groupStart, tag);
+		const u32 empties = internal::flatHashMapMatchControls(_controls + groupStart, 0);
+		if (empties != 0) {
+			// Entries are never placed past an empty slot in their probe sequence.
+			matches &= (empties & (0U - empties)) - 1;
+		}
+		while (matches != 0) {
+			const usize slotIndex = (groupStart + static_cast<usize>(std::countr_zero(matches))) & mask;
+			if (internal::hashKeysEqual(_slots[slotIndex].key, key)) {
+				return Option<usize>(slotIndex);
+			}
+			matches &= matches - 1;
+		}
+		if (empties != 0) {
+			return Option<usize>();
+		}
+		groupStart = (groupStart + internal::FLAT_HASH_MAP_GROUP_WIDTH) & mask;
+	}
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::usize gk::FlatHashMap<Key, Value, Allocator>::findEmptySlot(usize mixedHash) const
+{
+	const usize mask = _capacity - 1;
+	usize groupStart = internal::HashMapGroupBitmask(mixedHash).value & mask;
+	while (true) {
+		const u32 empties = internal::flatHashMapMatchControls(_controls + groupStart, 0);
+		if (empties != 0) {
+			return (groupStart + static_cast<usize>(std::countr_zero(empties))) & mask;
+		}
+		groupStart = (groupStart + internal::FLAT_HASH_MAP_GROUP_WIDTH) & mask;
+	}
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::setControl(usize slotIndex, i8 control)
+{
+	_controls[slotIndex] = control;
+	if (slotIndex < internal::FLAT_HASH_MAP_GROUP_WIDTH - 1) {
+		_controls[_capacity + slotIndex] = control;
+	}
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+template<typename KeyArg, typename ValueArg>
+inline gk::Option<Value*> gk::FlatHashMap<Key, Value, Allocator>::insertImpl(KeyArg&& keyArg, ValueArg&& valueArg)
+{
+	const usize mixedHash = hashKey(keyArg);
+	if (_elementCount != 0) {
+		Option<usize> existing = findSlot(keyArg, mixedHash);
+		if (existing.isSome()) {
+			return Option<Value*>(&_slots[existing.someCopy()].value);
+		}
+	}
+
+	const usize requiredCapacity = calculateNewCapacity(_elementCount + 1);
+	if (requiredCapacity > _capacity) {
+		rehash(requiredCapacity);
+	}
+
+	const usize slotIndex = findEmptySlot(mixedHash);
+	new (&_slots[slotIndex]) Slot{ Key(std::forward<KeyArg>(keyArg)), Value(std::forward<ValueArg>(valueArg)) };
+	setControl(slotIndex, internal::HashMapPairBitmask(mixedHash).value);
+	_elementCount++;
+	return Option<Value*>();
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::usize gk::FlatHashMap<Key, Value, Allocator>::calculateNewCapacity(usize requiredCapacity)
+{
+	// Max load factor of 3/4.
+	const usize minSlots = requiredCapacity + (requiredCapacity / 3) + 1;
+	const usize capacity = static_cast<usize>(upperPowerOfTwo(minSlots));
+	return capacity < internal::FLAT_HASH_MAP_MIN_CAPACITY ? internal::FLAT_HASH_MAP_MIN_CAPACITY : capacity;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::allocate(usize newCapacity)
+{
+	i8* memory = _allocator.template mallocAlignedBuffer<i8>(allocationSize(newCapacity), ALLOC_ALIGNMENT).ok();
+	std::memset(memory, 0, controlBytesSize(newCapacity));
+	_controls = memory;
+	_slots = reinterpret_cast<Slot*>(memory + controlBytesSize(newCapacity));
+	_capacity = newCapacity;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::rehash(usize newCapacity)
+{
+	i8* oldControls = _controls;
+	Slot* oldSlots = _slots;
+	const usize oldCapacity = _capacity;
+
+	allocate(newCapacity);
+
+	for (usize i = 0; i < oldCapacity; i++) {
+		if (oldControls[i] == 0) {
+			continue;
+		}
+		const usize slotIndex = findEmptySlot(hashKey(oldSlots[i].key));
+		new (&_slots[slotIndex]) Slot(std::move(oldSlots[i]));
+		oldSlots[i].~Slot();
+		setControl(slotIndex, oldControls[i]);
+	}
+
+	if (oldControls != nullptr) {
+		_allocator.freeAlignedBuffer(oldControls, allocationSize(oldCapacity), ALLOC_ALIGNMENT);
+	}
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::deleteExistingBuffer()
+{
+	if (_controls == nullptr) {
+		return;
+	}
+
+	for (usize i = 0; i < _capacity; i++) {
+		if (_controls[i] != 0) {
+			_slots[i].~Slot();
+		}
+	}
+	_allocator.freeAlignedBuffer(_controls, allocationSize(_capacity), ALLOC_ALIGNMENT);
+	_controls = nullptr;
+	_slots = nullptr;
+	_capacity = 0;
+	_elementCount = 0;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline void gk::FlatHashMap<Key, Value, Allocator>::copyFrom(const FlatHashMap& other)
+{
+	if (other._elementCount == 0) {
+		return;
+	}
+
+	allocate(other._capacity);
+	std::memcpy(_controls, other._controls, controlBytesSize(_capacity));
+	for (usize i = 0; i < _capacity; i++) {
+		if (_controls[i] != 0) {
+			new (&_slots[i]) Slot(other._slots[i]);
+		}
+	}
+	_elementCount = other._elementCount;
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::usize gk::FlatHashMap<Key, Value, Allocator>::allocationSize(usize capacity)
+{
+	return controlBytesSize(capacity) + (sizeof(Slot) * capacity);
+}
+
+template<typename Key, typename Value, typename Allocator>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator>)
+inline gk::usize gk::FlatHashMap<Key, Value, Allocator>::controlBytesSize(usize capacity)
+{
+	const usize unaligned = capacity + internal::FLAT_HASH_MAP_GROUP_WIDTH;
+	return ((unaligned + ALLOC_ALIGNMENT - 1) / ALLOC_ALIGNMENT) * ALLOC_ALIGNMENT;
+}
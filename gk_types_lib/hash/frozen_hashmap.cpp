@@ -0,0 +1,198 @@
+#include "frozen_hashmap.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../string/string.h"
+
+using gk::FrozenHashMap;
+using gk::FrozenHashMapError;
+using gk::ArrayList;
+using gk::usize;
+using gk::i32;
+using gk::u64;
+
+test_case("FrozenHashMap default construct") {
+	FrozenHashMap<i32, i32> map;
+	check_eq(map.size(), 0);
+	check(map.find(0).none());
+	check(!map.contains(0));
+	check(map.begin() == map.end());
+}
+
+static constexpr void frozenHashMapFromPairsInts() {
+	using MapT = FrozenHashMap<i32, i32>;
+	ArrayList<MapT::Pair> pairs;
+	for (i32 i = 0; i < 100; i++) {
+		pairs.push(MapT::Pair{ i, i * 2 });
+	}
+	MapT map = MapT::fromPairs(std::move(pairs)).ok();
+	check_eq(map.size(), 100);
+	for (i32 i = 0; i < 100; i++) {
+		check_eq(*map.find(i).some(), i * 2);
+	}
+	check(map.find(100).none());
+	check(map.find(-1).none());
+}
+
+test_case("FrozenHashMap from pairs ints") {
+	frozenHashMapFromPairsInts();
+}
+
+comptime_test_case(FrozenHashMapFromPairsInts, {
+	frozenHashMapFromPairsInts();
+});
+
+test_case("FrozenHashMap many keys") {
+	using MapT = FrozenHashMap<u64, u64>;
+	ArrayList<MapT::Pair> pairs;
+	for (u64 i = 0; i < 20000; i++) {
+		pairs.push(MapT::Pair{ i * 7, i });
+	}
+	MapT map = MapT::fromPairs(std::move(pairs)).ok();
+	check_eq(map.size(), 20000);
+	for (u64 i = 0; i < 140000; i++) {
+		if (i % 7 == 0) {
+			check_eq(*map.find(i).some(), i / 7);
+		}
+		else {
+			check(!map.contains(i));
+		}
+	}
+}
+
+test_case("FrozenHashMap single pair") {
+	using MapT = FrozenHashMap<i32, i32>;
+	ArrayList<MapT::Pair> pairs;
+	pairs.push(MapT::Pair{ 5, 10 });
+	MapT map = MapT::fromPairs(std::move(pairs)).ok();
+	check_eq(map.size(), 1);
+	check_eq(*map.find(5).some(), 10);
+	check(map.find(6).none());
+}
+
+test_case("FrozenHashMap empty pairs") {
+	using MapT = FrozenHashMap<i32, i32>;
+	MapT map = MapT::fromPairs(ArrayList<MapT::Pair>()).ok();
+	check_eq(map.size(), 0);
+	check(map.find(0).none());
+}
+
+test_case("FrozenHashMap duplicate key") {
+	using MapT = FrozenHashMap<i32, i32>;
+	ArrayList<MapT::Pair> pairs;
+	for (i32 i = 0; i < 100; i++) {
+		pairs.push(MapT::Pair{ i, i });
+	}
+	pairs.push(MapT::Pair{ 50, 0 });
+	gk::Result<MapT, FrozenHashMapError> result = MapT::fromPairs(std::move(pairs));
+	check(result.isError());
+	check_eq(result.error(), FrozenHashMapError::DuplicateKey);
+}
+
+test_case("FrozenHashMap hash collision") {
+	struct ConstantHashMixer {
+		static constexpr usize mix(usize) { return 0; }
+	};
+	using MapT = FrozenHashMap<i32, i32, gk::AllocatorRef, ConstantHashMixer>;
+	ArrayList<MapT::Pair> pairs;
+	pairs.push(MapT::Pair{ 1, 1 });
+	pairs.push(MapT::Pair{ 2, 2 });
+	gk::Result<MapT, FrozenHashMapError> result = MapT::fromPairs(std::move(pairs));
+	check(result.isError());
+	check_eq(result.error(), FrozenHashMapError::HashCollision);
+}
+
+test_case("FrozenHashMap strings with Str lookup") {
+	using MapT = FrozenHashMap<gk::String, gk::String>;
+	ArrayList<MapT::Pair> pairs;
+	for (u64 i = 0; i < 500; i++) {
+		pairs.push(MapT::Pair{ gk::String::fromUint(i), gk::String::fromUint(i * 3) });
+	}
+	MapT map = MapT::fromPairs(std::move(pairs)).ok();
+	check_eq(*map.find(gk::String::fromUint(7)).some(), gk::String::fromUint(21));
+
+	const char* buffer = "12345";
+	check_eq(*map.find(gk::Str::fromSlice(buffer + 1, 2)).some(), gk::String::fromUint(69));
+	check(map.contains(gk::Str::fromSlice(buffer, 3)));
+	check(!map.contains(gk::Str::fromSlice(buffer, 4)));
+}
+
+test_case("FrozenHashMap from HashMap") {
+	gk::HashMap<gk::String, i32> hashMap;
+	for (i32 i = 0; i < 1000; i++) {
+		hashMap.insert(gk::String::fromInt(i), i);
+	}
+	FrozenHashMap<gk::String, i32> map = FrozenHashMap<gk::String, i32>::fromHashMap(hashMap).ok();
+	check_eq(map.size(), 1000);
+	for (i32 i = 0; i < 1000; i++) {
+		check_eq(*map.find(gk::String::fromInt(i)).some(), i);
+	}
+	check(map.find(gk::String::fromInt(1000)).none());
+	check_eq(hashMap.size(), 1000);
+}
+
+test_case("FrozenHashMap iterate") {
+	using MapT = FrozenHashMap<i32, i32>;
+	ArrayList<MapT::Pair> pairs;
+	for (i32 i = 0; i < 100; i++) {
+		pairs.push(MapT::Pair{ i, i * 2 });
+	}
+	MapT map = MapT::fromPairs(std::move(pairs)).ok();
+	i32 keySum = 0;
+	usize count = 0;
+	for (const MapT::Pair& pair : map) {
+		check_eq(pair.value, pair.key * 2);
+		keySum += pair.key;
+		count++;
+	}
+	check_eq(count, 100);
+	check_eq(keySum, 99 * 50);
+}
+
+test_case("FrozenHashMap copy and move") {
+	using MapT = FrozenHashMap<gk::String, i32>;
+	ArrayList<MapT::Pair> pairs;
+	for (i32 i = 0; i < 100; i++) {
+		pairs.push(MapT::Pair{ gk::String::fromInt(i), i });
+	}
+	MapT map = MapT::fromPairs(std::move(pairs)).ok();
+	MapT copy = map;
+	check_eq(copy.size(), 100);
+	check_eq(*copy.find(gk::String::fromInt(42)).some(), 42);
+
+	MapT moved = std::move(map);
+	check_eq(map.size(), 0);
+	check(map.find(gk::String::fromInt(42)).none());
+	check_eq(moved.size(), 100);
+	check_eq(*moved.find(gk::String::fromInt(42)).some(), 42);
+
+	copy = moved;
+	check_eq(*copy.find(gk::String::fromInt(99)).some(), 99);
+}
+
+namespace gk
+{
+	namespace unitTests
+	{
+		/**
+		* A table computed entirely at compile time.
+		*/
+		static constexpr i32 frozenHashMapSquareOf(i32 key) {
+			using MapT = FrozenHashMap<i32, i32>;
+			ArrayList<MapT::Pair> pairs;
+			for (i32 i = 0; i < 64; i++) {
+				pairs.push(MapT::Pair{ i, i * i });
+			}
+			const MapT map = MapT::fromPairs(std::move(pairs)).ok();
+			return *map.find(key).some();
+		}
+	}
+}
+
+test_case("FrozenHashMap compile time table") {
+	constexpr i32 square = gk::unitTests::frozenHashMapSquareOf(12);
+	static_assert(square == 144);
+	check_eq(square, 144);
+}
+
+#endif
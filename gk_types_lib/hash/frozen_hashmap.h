@@ -0,0 +1,528 @@
+#pragma once
+
+#include "hashmap.h"
+
+namespace gk
+{
+	enum class FrozenHashMapError {
+		/**
+		* Two of the pairs have equal keys.
+		*/
+		DuplicateKey,
+		/**
+		* Two different keys have the same mixed hash code, so no pilot can give them separate slots.
+		* Try a different `gk::HashMixer`.
+		*/
+		HashCollision
+	};
+
+	namespace internal
+	{
+		/**
+		* Average amount of keys per bucket of a `gk::FrozenHashMap`. More keys per bucket uses less memory for pilots,
+		* but takes longer to build.
+		*/
+		constexpr usize FROZEN_HASH_MAP_KEYS_PER_BUCKET = 4;
+
+		/**
+		* Maps the high 32 bits of a mixed hash code onto `[0, bucketCount)` with a multiply and shift, rather than a modulo.
+		*/
+		constexpr usize frozenHashMapBucket(u64 hashCode, usize bucketCount) {
+			return static_cast<usize>(((hashCode >> 32) * static_cast<u64>(bucketCount)) >> 32);
+		}
+
+		/**
+		* The slot of a key within a `gk::FrozenHashMap`. The pilot is folded into the hash code,
+		* so that each pilot moves the keys of a bucket to unrelated slots.
+		*/
+		constexpr usize frozenHashMapSlot(u64 hashCode, u32 pilot, usize entryCount) {
+			return static_cast<usize>(hashMultiplyFold(hashCode ^ HASH_SECRET[2], static_cast<u64>(pilot) ^ HASH_SECRET[3]) % entryCount);
+		}
+
+		constexpr usize frozenHashMapBucketCount(usize entryCount) {
+			return entryCount / FROZEN_HASH_MAP_KEYS_PER_BUCKET + 1;
+		}
+
+		/**
+		* Searches for the pilot of every bucket of a minimal perfect hash, as used by `gk::FrozenHashMap`.
+		* Buckets with the most keys are placed first, while most of the slots are still free.
+		*
+		* @param hashCodes: Mixed hash code of each entry.
+		* @param bucketCount: See `frozenHashMapBucketCount()`.
+		* @param keysEqual: Called with the indices of two entries that have the same hash code.
+		* @param pilots: Receives the pilot of each bucket.
+		* @param entrySlots: Receives the slot of each entry.
+		* @return None on success, or Some error if two entries can't be given separate slots.
+		*/
+		template<typename KeysEqual>
+		constexpr Option<FrozenHashMapError> buildFrozenHashMapPilots(const ArrayList<u64>& hashCodes, usize bucketCount,
+			const KeysEqual& keysEqual, ArrayList<u32>& pilots, ArrayList<usize>& entrySlots)
+		{
+			const usize entryCount = hashCodes.len();
+
+			// Counting sort of the entries by bucket. The entries of bucket `b` are
+			// `bucketEntries[bucketStarts[b]]` up to `bucketEntries[bucketStarts[b + 1]]`.
+			ArrayList<usize> bucketStarts;
+			bucketStarts.resize(bucketCount + 1, 0);
+			for (usize i = 0; i < entryCount; i++) {
+				bucketStarts[frozenHashMapBucket(hashCodes[i], bucketCount) + 1]++;
+			}
+			usize largestBucket = 0;
+			for (usize bucket = 0; bucket < bucketCount; bucket++) {
+				if (bucketStarts[bucket + 1] > largestBucket) {
+					largestBucket = bucketStarts[bucket + 1];
+				}
+				bucketStarts[bucket + 1] += bucketStarts[bucket];
+			}
+			ArrayList<usize> bucketEntries;
+			bucketEntries.resize(entryCount, 0);
+			{
+				ArrayList<usize> bucketFill = bucketStarts;
+				for (usize i = 0; i < entryCount; i++) {
+					const usize bucket = frozenHashMapBucket(hashCodes[i], bucketCount);
+					bucketEntries[bucketFill[bucket]] = i;
+					bucketFill[bucket]++;
+				}
+			}
+
+			pilots.resize(bucketCount, 0);
+			entrySlots.resize(entryCount, 0);
+			ArrayList<bool> slotTaken;
+			slotTaken.resize(entryCount, false);
+			ArrayList<usize> candidateSlots;
+			candidateSlots.resize(largestBucket, 0);
+
+			for (usize bucketSize = largestBucket; bucketSize > 0; bucketSize--) {
+				for (usize bucket = 0; bucket < bucketCount; bucket++) {
+					const usize start = bucketStarts[bucket];
+					if (bucketStarts[bucket + 1] - start != bucketSize) {
+						continue;
+					}
+
+					// Keys with the same hash code land in the same slot no matter the pilot.
+					for (usize i = 0; i < bucketSize; i++) {
+						for (usize j = i + 1; j < bucketSize; j++) {
+							const usize first = bucketEntries[start + i];
+							const usize second = bucketEntries[start + j];
+							if (hashCodes[first] != hashCodes[second]) {
+								continue;
+							}
+							if (keysEqual(first, second)) {
+								return Option<FrozenHashMapError>(FrozenHashMapError::DuplicateKey);
+							}
+							return Option<FrozenHashMapError>(FrozenHashMapError::HashCollision);
+						}
+					}
+
+					u64 pilot = 0;
+					while (true) {
+						if (pilot > static_cast<u64>(UINT32_MAX)) {
+							return Option<FrozenHashMapError>(FrozenHashMapError::HashCollision);
+						}
+
+						bool fits = true;
+						for (usize i = 0; i < bucketSize && fits; i++) {
+							const usize slot = frozenHashMapSlot(hashCodes[bucketEntries[start + i]], static_cast<u32>(pilot), entryCount);
+							if (slotTaken[slot]) {
+								fits = false;
+							}
+							for (usize j = 0; j < i && fits; j++) {
+								if (candidateSlots[j] == slot) {
+									fits = false;
+								}
+							}
+							candidateSlots[i] = slot;
+						}
+						if (fits) {
+							break;
+						}
+						pilot++;
+					}
+
+					pilots[bucket] = static_cast<u32>(pilot);
+					for (usize i = 0; i < bucketSize; i++) {
+						slotTaken[candidateSlots[i]] = true;
+						entrySlots[bucketEntries[start + i]] = candidateSlots[i];
+					}
+				}
+			}
+			return Option<FrozenHashMapError>();
+		}
+	}
+
+	/**
+	* An immutable hash map, built once from a `gk::HashMap` or an `gk::ArrayList` of pairs, using a minimal perfect hash
+	* in the style of PTHash. Every key is hashed into a bucket, and each bucket stores a pilot that was searched
+	* for at build time, so that the keys of every bucket land in separate slots.
+	* The pairs are stored contiguously, with exactly one slot per pair, so a lookup is one hash,
+	* one pilot read, one slot read, and one key compare.
+	*
+	* Can be built and queried in constexpr, for tables computed at compile time.
+	* In constexpr, `Key` and `Value` must be default constructible.
+	*
+	* Unlike `gk::HashMap`, the pairs do have pointer stability, as they are never moved after building.
+	*
+	* @param Key: Must satisy the `Hashable` concept.
+	* @param Value: Has no restrictions.
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	* @param Mixer: Scrambles gk::hash<>() before choosing a bucket and slot. See `gk::HashMixer`.
+	* Defaults to `StrongHashMixer` for every key, as buckets are chosen from the high bits, which the integer hashes leave empty.
+	*/
+	template<typename Key, typename Value, typename Allocator = GlobalHeapStaticAllocator, typename Mixer = StrongHashMixer>
+		requires (Hashable<Key> && AllocatorPolicy<Allocator> && HashMixer<Mixer>)
+	struct FrozenHashMap
+	{
+	public:
+
+		struct Pair {
+			Key key;
+			Value value;
+		};
+
+		/**
+		* Create a new empty instance of `FrozenHashMap`.
+		* At runtime, uses the `gk::globalHeapAllocator()`.
+		*/
+		constexpr FrozenHashMap();
+
+		constexpr FrozenHashMap(const FrozenHashMap& other);
+
+		constexpr FrozenHashMap(FrozenHashMap&& other) noexcept;
+
+		constexpr ~FrozenHashMap();
+
+		constexpr FrozenHashMap& operator = (const FrozenHashMap& other);
+
+		constexpr FrozenHashMap& operator = (FrozenHashMap&& other) noexcept;
+
+		/**
+		* Builds the minimal perfect hash of `pairs`, moving each pair into it's slot.
+		* Tries pilots for the buckets with the most keys first, while most slots are still free.
+		*
+		* @return The FrozenHashMap, or an error if two keys are equal, or hash to the same value.
+		*/
+		template<typename ListAllocator>
+		[[nodiscard]] static constexpr Result<FrozenHashMap, FrozenHashMapError> fromPairs(ArrayList<Pair, ListAllocator>&& pairs);
+
+		/**
+		* Builds the minimal perfect hash of a copy of every entry in `map`.
+		*
+		* @return The FrozenHashMap, or an error if two keys hash to the same value.
+		*/
+		template<usize GROUP_ALLOC_SIZE, typename MapAllocator, typename MapMixer>
+		[[nodiscard]] static constexpr Result<FrozenHashMap, FrozenHashMapError> fromHashMap(const HashMap<Key, Value, GROUP_ALLOC_SIZE, MapAllocator, MapMixer>& map);
+
+		/**
+		* @return Number of pairs stored in the FrozenHashMap
+		*/
+		[[nodiscard]] constexpr usize size() const { return _pairCount; }
+
+		/**
+		* Finds an entry within the FrozenHashMap, returning an optional immutable value.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		[[nodiscard]] constexpr Option<const Value*> find(const Key& key) const { return findImpl(key, hashKey(key)); }
+
+		/**
+		* Finds an entry using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] constexpr Option<const Value*> find(const Lookup& key) const { return findImpl(key, hashLookup(key)); }
+
+		/**
+		* @return `true` if the key exists in the FrozenHashMap, or `false` if it doesn't.
+		*/
+		[[nodiscard]] constexpr bool contains(const Key& key) const { return find(key).isSome(); }
+
+		/**
+		* Checks for a key using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists in the FrozenHashMap, or `false` if it doesn't.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] constexpr bool contains(const Lookup& key) const { return find(key).isSome(); }
+
+		/**
+		* The pairs are in slot order, which is effectively random.
+		*
+		* @return Begin of the contiguous pairs.
+		*/
+		constexpr const Pair* begin() const { return _pairs; }
+
+		/**
+		* @return End of the contiguous pairs.
+		*/
+		constexpr const Pair* end() const { return _pairs + _pairCount; }
+
+	private:
+
+		static constexpr usize hashKey(const Key& key);
+
+		template<typename Lookup>
+		static constexpr usize hashLookup(const Lookup& key) { return Mixer::mix(static_cast<usize>(HashLookup<Key, Lookup>::hash(key))); }
+
+		template<typename LookupKey>
+		constexpr Option<const Value*> findImpl(const LookupKey& key, usize hashCode) const;
+
+		/**
+		* Allocates space for `_pairCount` pairs and `_bucketCount` pilots.
+		* In constexpr, the pairs are default constructed, otherwise they are left uninitialized.
+		*/
+		constexpr void allocate();
+
+		constexpr void free();
+
+	private:
+
+		Pair* _pairs;
+		u32* _pilots;
+		usize _pairCount;
+		usize _bucketCount;
+		no_unique_address_member Allocator _allocator;
+	};
+
+	template<typename Key, typename Value, typename Allocator, typename Mixer>
+	struct is_trivially_relocatable<FrozenHashMap<Key, Value, Allocator, Mixer>> : is_trivially_relocatable<Allocator> {};
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::FrozenHashMap<Key, Value, Allocator, Mixer>::FrozenHashMap()
+	: _pairs(nullptr), _pilots(nullptr), _pairCount(0), _bucketCount(0)
+{
+	if constexpr (!StaticAllocator<Allocator>) {
+		if (!std::is_constant_evaluated()) {
+			new (&_allocator) AllocatorRef(globalHeapAllocatorRef());
+		}
+	}
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::FrozenHashMap<Key, Value, Allocator, Mixer>::FrozenHashMap(const FrozenHashMap& other)
+	: _pairs(nullptr), _pilots(nullptr), _pairCount(other._pairCount), _bucketCount(other._bucketCount)
+{
+	if constexpr (!StaticAllocator<Allocator>) {
+		if (!std::is_constant_evaluated()) {
+			new (&_allocator) AllocatorRef(globalHeapAllocatorRef());
+		}
+	}
+	if (_pairCount == 0) {
+		return;
+	}
+
+	allocate();
+	for (usize i = 0; i < _pairCount; i++) {
+		if (std::is_constant_evaluated()) {
+			_pairs[i] = other._pairs[i];
+		}
+		else {
+			new (_pairs + i) Pair(other._pairs[i]);
+		}
+	}
+	for (usize i = 0; i < _bucketCount; i++) {
+		_pilots[i] = other._pilots[i];
+	}
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::FrozenHashMap<Key, Value, Allocator, Mixer>::FrozenHashMap(FrozenHashMap&& other) noexcept
+	: _pairs(other._pairs), _pilots(other._pilots), _pairCount(other._pairCount), _bucketCount(other._bucketCount), _allocator(std::move(other._allocator))
+{
+	other._pairs = nullptr;
+	other._pilots = nullptr;
+	other._pairCount = 0;
+	other._bucketCount = 0;
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::FrozenHashMap<Key, Value, Allocator, Mixer>::~FrozenHashMap()
+{
+	free();
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::FrozenHashMap<Key, Value, Allocator, Mixer>& gk::FrozenHashMap<Key, Value, Allocator, Mixer>::operator=(const FrozenHashMap& other)
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	free();
+	_pairCount = other._pairCount;
+	_bucketCount = other._bucketCount;
+	if (_pairCount == 0) {
+		return *this;
+	}
+
+	allocate();
+	for (usize i = 0; i < _pairCount; i++) {
+		if (std::is_constant_evaluated()) {
+			_pairs[i] = other._pairs[i];
+		}
+		else {
+			new (_pairs + i) Pair(other._pairs[i]);
+		}
+	}
+	for (usize i = 0; i < _bucketCount; i++) {
+		_pilots[i] = other._pilots[i];
+	}
+	return *this;
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::FrozenHashMap<Key, Value, Allocator, Mixer>& gk::FrozenHashMap<Key, Value, Allocator, Mixer>::operator=(FrozenHashMap&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	free();
+	_pairs = other._pairs;
+	_pilots = other._pilots;
+	_pairCount = other._pairCount;
+	_bucketCount = other._bucketCount;
+	_allocator = std::move(other._allocator);
+	other._pairs = nullptr;
+	other._pilots = nullptr;
+	other._pairCount = 0;
+	other._bucketCount = 0;
+	return *this;
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename ListAllocator>
+inline constexpr gk::Result<gk::FrozenHashMap<Key, Value, Allocator, Mixer>, gk::FrozenHashMapError> gk::FrozenHashMap<Key, Value, Allocator, Mixer>::fromPairs(ArrayList<Pair, ListAllocator>&& pairs)
+{
+	FrozenHashMap map;
+	const usize pairCount = pairs.len();
+	if (pairCount == 0) {
+		return ResultOk<FrozenHashMap>(std::move(map));
+	}
+
+	const usize bucketCount = internal::frozenHashMapBucketCount(pairCount);
+
+	ArrayList<u64> hashCodes;
+	hashCodes.reserve(pairCount);
+	for (usize i = 0; i < pairCount; i++) {
+		hashCodes.push(hashKey(pairs[i].key));
+	}
+
+	ArrayList<u32> pilots;
+	ArrayList<usize> pairSlots;
+	Option<FrozenHashMapError> buildError = internal::buildFrozenHashMapPilots(hashCodes, bucketCount,
+		[&pairs](usize first, usize second) { return pairs[first].key == pairs[second].key; }, pilots, pairSlots);
+	if (buildError.isSome()) {
+		return ResultErr<FrozenHashMapError>(buildError.someCopy());
+	}
+
+	map._pairCount = pairCount;
+	map._bucketCount = bucketCount;
+	map.allocate();
+	for (usize bucket = 0; bucket < bucketCount; bucket++) {
+		map._pilots[bucket] = pilots[bucket];
+	}
+	for (usize i = 0; i < pairCount; i++) {
+		if (std::is_constant_evaluated()) {
+			map._pairs[pairSlots[i]] = std::move(pairs[i]);
+		}
+		else {
+			new (map._pairs + pairSlots[i]) Pair(std::move(pairs[i]));
+		}
+	}
+	return ResultOk<FrozenHashMap>(std::move(map));
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<gk::usize GROUP_ALLOC_SIZE, typename MapAllocator, typename MapMixer>
+inline constexpr gk::Result<gk::FrozenHashMap<Key, Value, Allocator, Mixer>, gk::FrozenHashMapError> gk::FrozenHashMap<Key, Value, Allocator, Mixer>::fromHashMap(const HashMap<Key, Value, GROUP_ALLOC_SIZE, MapAllocator, MapMixer>& map)
+{
+	ArrayList<Pair> pairs;
+	pairs.reserve(map.size());
+	for (auto pair : map) {
+		pairs.push(Pair{ pair.key, pair.value });
+	}
+	return fromPairs(std::move(pairs));
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::usize gk::FrozenHashMap<Key, Value, Allocator, Mixer>::hashKey(const Key& key)
+{
+	if constexpr (!std::is_pointer<Key>::value) {
+		return Mixer::mix(gk::hash<Key>(key));
+	}
+	else {
+		if (std::is_constant_evaluated()) {
+			throw std::invalid_argument("Cannot use pointer type for FrozenHashMap Key in constexpr contexts");
+		}
+		const usize ptrAsNum = reinterpret_cast<usize>(key);
+		return Mixer::mix(ptrAsNum);
+	}
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename LookupKey>
+inline constexpr gk::Option<const Value*> gk::FrozenHashMap<Key, Value, Allocator, Mixer>::findImpl(const LookupKey& key, usize hashCode) const
+{
+	if (_pairCount == 0) {
+		return Option<const Value*>();
+	}
+
+	const u32 pilot = _pilots[internal::frozenHashMapBucket(hashCode, _bucketCount)];
+	const Pair& pair = _pairs[internal::frozenHashMapSlot(hashCode, pilot, _pairCount)];
+	if (!internal::hashKeysEqual(pair.key, key)) {
+		return Option<const Value*>();
+	}
+	return Option<const Value*>(&pair.value);
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::FrozenHashMap<Key, Value, Allocator, Mixer>::allocate()
+{
+	if (std::is_constant_evaluated()) {
+		_pairs = new Pair[_pairCount];
+		_pilots = new u32[_bucketCount];
+	}
+	else {
+		_pairs = _allocator.template mallocBuffer<Pair>(_pairCount).ok();
+		_pilots = _allocator.template mallocBuffer<u32>(_bucketCount).ok();
+	}
+}
+
+template<typename Key, typename Value, typename Allocator, typename Mixer>
+	requires (gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::FrozenHashMap<Key, Value, Allocator, Mixer>::free()
+{
+	if (_pairs == nullptr) return;
+
+	if (std::is_constant_evaluated()) {
+		delete[] _pairs;
+		delete[] _pilots;
+	}
+	else {
+		for (usize i = 0; i < _pairCount; i++) {
+			_pairs[i].~Pair();
+		}
+		_allocator.template freeBuffer<Pair>(_pairs, _pairCount);
+		_allocator.template freeBuffer<u32>(_pilots, _bucketCount);
+	}
+	_pairs = nullptr;
+	_pilots = nullptr;
+	_pairCount = 0;
+	_bucketCount = 0;
+}
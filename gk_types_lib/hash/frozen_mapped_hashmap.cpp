@@ -0,0 +1,319 @@
+#include "frozen_mapped_hashmap.h"
+
+#if defined(_WIN32) || defined(WIN32)
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using gk::Result;
+using gk::usize;
+using gk::u8;
+using gk::FrozenMappedHashMapError;
+using gk::internal::MappedFile;
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: data(other.data), byteCount(other.byteCount)
+{
+	other.data = nullptr;
+	other.byteCount = 0;
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	unmap();
+	data = other.data;
+	byteCount = other.byteCount;
+	other.data = nullptr;
+	other.byteCount = 0;
+	return *this;
+}
+
+MappedFile::~MappedFile()
+{
+	unmap();
+}
+
+#if defined(_WIN32) || defined(WIN32)
+
+Result<MappedFile, FrozenMappedHashMapError> MappedFile::open(const String& path)
+{
+	HANDLE file = CreateFileA(path.cstr(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+	// Empty files can't be mapped.
+	if (fileSize.QuadPart == 0) {
+		CloseHandle(file);
+		return ResultOk<MappedFile>(MappedFile());
+	}
+
+	// The view keeps the file and mapping alive, so both handles can be closed straight away.
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (mapping == nullptr) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (view == nullptr) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+
+	MappedFile mapped;
+	mapped.data = reinterpret_cast<const u8*>(view);
+	mapped.byteCount = static_cast<usize>(fileSize.QuadPart);
+	return ResultOk<MappedFile>(std::move(mapped));
+}
+
+void MappedFile::unmap()
+{
+	if (data == nullptr) return;
+
+	UnmapViewOfFile(data);
+	data = nullptr;
+	byteCount = 0;
+}
+
+bool gk::internal::writeWholeFile(const String& path, const u8* data, usize byteCount)
+{
+	HANDLE file = CreateFileA(path.cstr(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	// WriteFile takes a 32 bit length.
+	constexpr usize MAX_WRITE_BYTES = 1ULL << 30;
+	usize written = 0;
+	while (written < byteCount) {
+		const usize remaining = byteCount - written;
+		const DWORD toWrite = static_cast<DWORD>(remaining < MAX_WRITE_BYTES ? remaining : MAX_WRITE_BYTES);
+		DWORD writtenNow = 0;
+		if (!WriteFile(file, data + written, toWrite, &writtenNow, nullptr) || writtenNow == 0) {
+			CloseHandle(file);
+			return false;
+		}
+		written += writtenNow;
+	}
+	return CloseHandle(file) != 0;
+}
+
+#else
+
+Result<MappedFile, FrozenMappedHashMapError> MappedFile::open(const String& path)
+{
+	const int file = ::open(path.cstr(), O_RDONLY);
+	if (file < 0) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+
+	struct stat fileStat;
+	if (fstat(file, &fileStat) != 0) {
+		::close(file);
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+	// Empty files can't be mapped.
+	if (fileStat.st_size == 0) {
+		::close(file);
+		return ResultOk<MappedFile>(MappedFile());
+	}
+
+	// The mapping keeps the file alive, so it can be closed straight away.
+	void* mem = mmap(nullptr, static_cast<usize>(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+	::close(file);
+	if (mem == MAP_FAILED) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+
+	MappedFile mapped;
+	mapped.data = reinterpret_cast<const u8*>(mem);
+	mapped.byteCount = static_cast<usize>(fileStat.st_size);
+	return ResultOk<MappedFile>(std::move(mapped));
+}
+
+void MappedFile::unmap()
+{
+	if (data == nullptr) return;
+
+	munmap(const_cast<u8*>(data), byteCount);
+	data = nullptr;
+	byteCount = 0;
+}
+
+bool gk::internal::writeWholeFile(const String& path, const u8* data, usize byteCount)
+{
+	const int file = ::open(path.cstr(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file < 0) {
+		return false;
+	}
+
+	usize written = 0;
+	while (written < byteCount) {
+		const ssize_t writtenNow = ::write(file, data + written, byteCount - written);
+		if (writtenNow < 0 && errno == EINTR) {
+			continue;
+		}
+		if (writtenNow <= 0) {
+			::close(file);
+			return false;
+		}
+		written += static_cast<usize>(writtenNow);
+	}
+	return ::close(file) == 0;
+}
+
+#endif
+
+#if GK_TYPES_LIB_TEST
+
+#include <cstdio>
+
+using gk::FrozenMappedHashMap;
+using gk::HashMap;
+using gk::ArrayList;
+using gk::i32;
+using gk::u64;
+
+namespace gk
+{
+	namespace unitTests
+	{
+		struct MappedTestValue {
+			u64 count;
+			double weight;
+		};
+	}
+}
+
+test_case("FrozenMappedHashMap default construct") {
+	FrozenMappedHashMap<u64, u64> map;
+	check_eq(map.size(), 0);
+	check(map.find(0).none());
+	check(!map.contains(0));
+}
+
+test_case("FrozenMappedHashMap serialize ints") {
+	HashMap<u64, u64> map;
+	for (u64 i = 0; i < 10000; i++) {
+		map.insert(i * 3, i);
+	}
+	ArrayList<u8> bytes = FrozenMappedHashMap<u64, u64>::serialize(map).ok();
+	FrozenMappedHashMap<u64, u64> view = FrozenMappedHashMap<u64, u64>::fromBytes(bytes.data(), bytes.len()).ok();
+	check_eq(view.size(), 10000);
+	for (u64 i = 0; i < 30000; i++) {
+		if (i % 3 == 0) {
+			check_eq(*view.find(i).some(), i / 3);
+		}
+		else {
+			check(!view.contains(i));
+		}
+	}
+}
+
+test_case("FrozenMappedHashMap serialize struct values") {
+	using gk::unitTests::MappedTestValue;
+	HashMap<i32, MappedTestValue> map;
+	for (i32 i = 0; i < 100; i++) {
+		map.insert(i, MappedTestValue{ static_cast<u64>(i) * 2, i * 0.5 });
+	}
+	ArrayList<u8> bytes = FrozenMappedHashMap<i32, MappedTestValue>::serialize(map).ok();
+	FrozenMappedHashMap<i32, MappedTestValue> view = FrozenMappedHashMap<i32, MappedTestValue>::fromBytes(bytes.data(), bytes.len()).ok();
+	const MappedTestValue* value = view.find(40).some();
+	check_eq(value->count, 80);
+	check_eq(value->weight, 20.0);
+	check(view.find(100).none());
+}
+
+test_case("FrozenMappedHashMap serialize empty") {
+	HashMap<u64, u64> map;
+	ArrayList<u8> bytes = FrozenMappedHashMap<u64, u64>::serialize(map).ok();
+	FrozenMappedHashMap<u64, u64> view = FrozenMappedHashMap<u64, u64>::fromBytes(bytes.data(), bytes.len()).ok();
+	check_eq(view.size(), 0);
+	check(view.find(0).none());
+}
+
+test_case("FrozenMappedHashMap strings with Str lookup") {
+	HashMap<gk::String, u64> map;
+	for (u64 i = 0; i < 500; i++) {
+		map.insert(gk::String::fromUint(i), i * 3);
+	}
+	ArrayList<u8> bytes = FrozenMappedHashMap<gk::String, u64>::serialize(map).ok();
+	FrozenMappedHashMap<gk::String, u64> view = FrozenMappedHashMap<gk::String, u64>::fromBytes(bytes.data(), bytes.len()).ok();
+	check_eq(view.size(), 500);
+	check_eq(*view.find(gk::String::fromUint(7)).some(), 21);
+
+	const char* buffer = "12345";
+	check_eq(*view.find(gk::Str::fromSlice(buffer + 1, 2)).some(), 69);
+	check(view.contains(gk::Str::fromSlice(buffer, 3)));
+	check(!view.contains(gk::Str::fromSlice(buffer, 4)));
+	check(!view.contains(gk::String::fromUint(500)));
+}
+
+test_case("FrozenMappedHashMap rejects other formats") {
+	HashMap<u64, u64> map;
+	for (u64 i = 0; i < 100; i++) {
+		map.insert(i, i);
+	}
+	ArrayList<u8> bytes = FrozenMappedHashMap<u64, u64>::serialize(map).ok();
+
+	Result<FrozenMappedHashMap<i32, u64>, FrozenMappedHashMapError> wrongKey = FrozenMappedHashMap<i32, u64>::fromBytes(bytes.data(), bytes.len());
+	check_eq(wrongKey.error(), FrozenMappedHashMapError::InvalidFormat);
+
+	Result<FrozenMappedHashMap<u64, u64, gk::IdentityHashMixer>, FrozenMappedHashMapError> wrongMixer =
+		FrozenMappedHashMap<u64, u64, gk::IdentityHashMixer>::fromBytes(bytes.data(), bytes.len());
+	check_eq(wrongMixer.error(), FrozenMappedHashMapError::InvalidFormat);
+
+	Result<FrozenMappedHashMap<u64, u64>, FrozenMappedHashMapError> truncated = FrozenMappedHashMap<u64, u64>::fromBytes(bytes.data(), bytes.len() - 8);
+	check_eq(truncated.error(), FrozenMappedHashMapError::InvalidFormat);
+
+	bytes[0] = 0;
+	Result<FrozenMappedHashMap<u64, u64>, FrozenMappedHashMapError> badMagic = FrozenMappedHashMap<u64, u64>::fromBytes(bytes.data(), bytes.len());
+	check_eq(badMagic.error(), FrozenMappedHashMapError::InvalidFormat);
+}
+
+test_case("FrozenMappedHashMap write and open file") {
+	const gk::String path = "gk_frozen_mapped_hashmap_test.bin"_str;
+	{
+		HashMap<gk::String, u64> map;
+		for (u64 i = 0; i < 1000; i++) {
+			map.insert(gk::String::fromUint(i), i);
+		}
+		Result<void, FrozenMappedHashMapError> written = FrozenMappedHashMap<gk::String, u64>::writeFile(map, path);
+		check(written.isOk());
+	}
+	{
+		FrozenMappedHashMap<gk::String, u64> view = FrozenMappedHashMap<gk::String, u64>::open(path).ok();
+		check_eq(view.size(), 1000);
+		for (u64 i = 0; i < 1000; i++) {
+			check_eq(*view.find(gk::String::fromUint(i)).some(), i);
+		}
+
+		FrozenMappedHashMap<gk::String, u64> moved = std::move(view);
+		check_eq(view.size(), 0);
+		check_eq(*moved.find(gk::String::fromUint(999)).some(), 999);
+	}
+	check_eq(std::remove(path.cstr()), 0);
+}
+
+test_case("FrozenMappedHashMap open missing file") {
+	Result<FrozenMappedHashMap<u64, u64>, FrozenMappedHashMapError> result = FrozenMappedHashMap<u64, u64>::open("gk_frozen_mapped_hashmap_missing.bin"_str);
+	check_eq(result.error(), FrozenMappedHashMapError::FileAccess);
+}
+
+#endif
@@ -0,0 +1,474 @@
+#pragma once
+
+#include "frozen_hashmap.h"
+#include "../string/string.h"
+#include <cstring>
+
+namespace gk
+{
+	enum class FrozenMappedHashMapError {
+		/**
+		* The file couldn't be opened, created, mapped, or written.
+		*/
+		FileAccess,
+		/**
+		* The bytes aren't a snapshot, are a snapshot of different key or value types,
+		* were built with a different `gk::HashMixer`, or are truncated.
+		*/
+		InvalidFormat,
+		/**
+		* Two different keys have the same mixed hash code. Try a different `gk::HashMixer`.
+		*/
+		HashCollision
+	};
+
+	namespace internal
+	{
+		/**
+		* "GKFROZEN" in little endian.
+		*/
+		constexpr u64 FROZEN_MAPPED_HASH_MAP_MAGIC = 0x4E455A4F52464B47ULL;
+		constexpr u64 FROZEN_MAPPED_HASH_MAP_VERSION = 1;
+
+		/**
+		* Start of a `gk::FrozenMappedHashMap` snapshot. Every offset is in bytes from the start of the snapshot,
+		* so the snapshot can be mapped at any address.
+		*/
+		struct FrozenMappedHashMapHeader {
+			u64 magic;
+			u64 version;
+			u64 slotSize;
+			/**
+			* `sizeof(Key)`, or 0 for `gk::String` keys.
+			*/
+			u64 keySize;
+			u64 valueSize;
+			/**
+			* The mixer's result for the magic number, so snapshots of a different `gk::HashMixer` are rejected.
+			*/
+			u64 mixerCheck;
+			u64 pairCount;
+			u64 bucketCount;
+			u64 pilotsOffset;
+			u64 slotsOffset;
+			u64 byteCount;
+		};
+
+		template<typename Key, typename Value>
+		struct FrozenMappedHashMapSlot {
+			Key key;
+			Value value;
+		};
+
+		/**
+		* The chars of `gk::String` keys are stored after the slots, with no null terminator.
+		*/
+		template<typename Value>
+		struct FrozenMappedHashMapSlot<String, Value> {
+			u64 keyOffset;
+			u64 keyLength;
+			Value value;
+		};
+
+		/**
+		* Read only mapping of an entire file. The pages are shared with every other process mapping the same file.
+		*/
+		struct MappedFile {
+			/**
+			* Maps no file.
+			*/
+			MappedFile() : data(nullptr), byteCount(0) {}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile(MappedFile&& other) noexcept;
+			MappedFile& operator = (const MappedFile&) = delete;
+			MappedFile& operator = (MappedFile&& other) noexcept;
+			~MappedFile();
+
+			/**
+			* An empty file is opened successfully, without mapping anything.
+			*/
+			[[nodiscard]] static Result<MappedFile, FrozenMappedHashMapError> open(const String& path);
+
+			const u8* data;
+			usize byteCount;
+
+		private:
+
+			void unmap();
+		};
+
+		/**
+		* Creates or replaces the file at `path` with `byteCount` bytes of `data`.
+		*
+		* @return If the whole file was written.
+		*/
+		bool writeWholeFile(const String& path, const u8* data, usize byteCount);
+	}
+
+	/**
+	* Read only view of a `gk::HashMap` snapshot, serving `find()` directly from a memory mapped file
+	* without deserializing, so opening a multi-gigabyte snapshot takes constant time, and every process
+	* mapping the same file shares it's pages.
+	*
+	* The snapshot uses the same minimal perfect hash as `gk::FrozenHashMap`, and stores offsets rather than
+	* pointers, so it can be mapped at any address. It uses the byte order of the machine that wrote it.
+	*
+	* @param Key: Either trivially copyable and not a pointer, or `gk::String`.
+	* For `gk::String` keys, the lookups use `gk::Str`.
+	* @param Value: Must be trivially copyable.
+	* @param Mixer: Must be the same as the mixer the snapshot was written with. See `gk::HashMixer`.
+	*/
+	template<typename Key, typename Value, typename Mixer = StrongHashMixer>
+		requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, String>)
+			&& std::is_trivially_copyable_v<Value> && Hashable<Key> && HashMixer<Mixer>)
+	struct FrozenMappedHashMap
+	{
+	private:
+
+		using SlotT = internal::FrozenMappedHashMapSlot<Key, Value>;
+
+		static constexpr bool STRING_KEYS = std::is_same_v<Key, String>;
+
+		using LookupT = std::conditional_t<STRING_KEYS, Str, Key>;
+
+		/**
+		* Slots are aligned to at least a u64, as the string key slots hold offsets.
+		*/
+		static constexpr usize SLOT_ALIGNMENT = alignof(SlotT) > alignof(u64) ? alignof(SlotT) : alignof(u64);
+
+	public:
+
+		/**
+		* An empty view, that maps nothing.
+		*/
+		FrozenMappedHashMap();
+
+		FrozenMappedHashMap(const FrozenMappedHashMap&) = delete;
+		FrozenMappedHashMap(FrozenMappedHashMap&& other) noexcept;
+		FrozenMappedHashMap& operator = (const FrozenMappedHashMap&) = delete;
+		FrozenMappedHashMap& operator = (FrozenMappedHashMap&& other) noexcept;
+		~FrozenMappedHashMap() = default;
+
+		/**
+		* Builds a snapshot of every entry in `map`.
+		*
+		* @return The bytes of the snapshot, or an error if two keys hash to the same value.
+		*/
+		template<usize GROUP_ALLOC_SIZE, typename MapAllocator, typename MapMixer>
+		[[nodiscard]] static Result<ArrayList<u8>, FrozenMappedHashMapError> serialize(const HashMap<Key, Value, GROUP_ALLOC_SIZE, MapAllocator, MapMixer>& map);
+
+		/**
+		* Builds a snapshot of every entry in `map`, and writes it to the file at `path`.
+		*
+		* NOTE: Replacing a file while other processes have it mapped is undefined behaviour on some platforms.
+		* Write to a new path, and move it over the old one instead.
+		*/
+		template<usize GROUP_ALLOC_SIZE, typename MapAllocator, typename MapMixer>
+		[[nodiscard]] static Result<void, FrozenMappedHashMapError> writeFile(const HashMap<Key, Value, GROUP_ALLOC_SIZE, MapAllocator, MapMixer>& map, const String& path);
+
+		/**
+		* Maps the snapshot file at `path`. Only the header is read, so this takes constant time.
+		* The file is unmapped when the FrozenMappedHashMap is destroyed.
+		*/
+		[[nodiscard]] static Result<FrozenMappedHashMap, FrozenMappedHashMapError> open(const String& path);
+
+		/**
+		* Views a snapshot already in memory, such as from `serialize()`. Only the header is read.
+		*
+		* @param bytes: Must be aligned to at least 8 bytes, and outlive the FrozenMappedHashMap.
+		*/
+		[[nodiscard]] static Result<FrozenMappedHashMap, FrozenMappedHashMapError> fromBytes(const u8* bytes, usize byteCount);
+
+		/**
+		* @return Number of pairs stored in the snapshot
+		*/
+		[[nodiscard]] usize size() const { return _pairCount; }
+
+		/**
+		* Finds an entry within the snapshot. The value is read directly from the mapped memory.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		[[nodiscard]] Option<const Value*> find(const LookupT& key) const;
+
+		[[nodiscard]] Option<const Value*> find(const String& key) const requires STRING_KEYS { return find(key.asStr()); }
+
+		/**
+		* @return `true` if the key exists in the snapshot, or `false` if it doesn't.
+		*/
+		[[nodiscard]] bool contains(const LookupT& key) const { return find(key).isSome(); }
+
+		[[nodiscard]] bool contains(const String& key) const requires STRING_KEYS { return find(key.asStr()).isSome(); }
+
+	private:
+
+		static usize hashKey(const LookupT& key);
+
+		static usize alignOffset(usize offset, usize alignment) { return (offset + (alignment - 1)) & ~(alignment - 1); }
+
+	private:
+
+		internal::MappedFile _file;
+		const u8* _bytes;
+		usize _byteCount;
+		const u32* _pilots;
+		const SlotT* _slots;
+		usize _pairCount;
+		usize _bucketCount;
+	};
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::FrozenMappedHashMap<Key, Value, Mixer>::FrozenMappedHashMap()
+	: _bytes(nullptr), _byteCount(0), _pilots(nullptr), _slots(nullptr), _pairCount(0), _bucketCount(0)
+{}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::FrozenMappedHashMap<Key, Value, Mixer>::FrozenMappedHashMap(FrozenMappedHashMap&& other) noexcept
+	: _file(std::move(other._file)), _bytes(other._bytes), _byteCount(other._byteCount), _pilots(other._pilots),
+	_slots(other._slots), _pairCount(other._pairCount), _bucketCount(other._bucketCount)
+{
+	other._bytes = nullptr;
+	other._byteCount = 0;
+	other._pilots = nullptr;
+	other._slots = nullptr;
+	other._pairCount = 0;
+	other._bucketCount = 0;
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::FrozenMappedHashMap<Key, Value, Mixer>& gk::FrozenMappedHashMap<Key, Value, Mixer>::operator=(FrozenMappedHashMap&& other) noexcept
+{
+	if (this == &other) {
+		return *this;
+	}
+
+	_file = std::move(other._file);
+	_bytes = other._bytes;
+	_byteCount = other._byteCount;
+	_pilots = other._pilots;
+	_slots = other._slots;
+	_pairCount = other._pairCount;
+	_bucketCount = other._bucketCount;
+	other._bytes = nullptr;
+	other._byteCount = 0;
+	other._pilots = nullptr;
+	other._slots = nullptr;
+	other._pairCount = 0;
+	other._bucketCount = 0;
+	return *this;
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+template<gk::usize GROUP_ALLOC_SIZE, typename MapAllocator, typename MapMixer>
+inline gk::Result<gk::ArrayList<gk::u8>, gk::FrozenMappedHashMapError> gk::FrozenMappedHashMap<Key, Value, Mixer>::serialize(const HashMap<Key, Value, GROUP_ALLOC_SIZE, MapAllocator, MapMixer>& map)
+{
+	const usize pairCount = map.size();
+	const usize bucketCount = pairCount == 0 ? 0 : internal::frozenHashMapBucketCount(pairCount);
+
+	// The map isn't mutated, so it's pairs stay in place.
+	ArrayList<const Key*> keys;
+	ArrayList<const Value*> values;
+	ArrayList<u64> hashCodes;
+	keys.reserve(pairCount);
+	values.reserve(pairCount);
+	hashCodes.reserve(pairCount);
+	usize stringBytes = 0;
+	for (auto pair : map) {
+		keys.push(&pair.key);
+		values.push(&pair.value);
+		if constexpr (STRING_KEYS) {
+			hashCodes.push(hashKey(pair.key.asStr()));
+			stringBytes += pair.key.len();
+		}
+		else {
+			hashCodes.push(hashKey(pair.key));
+		}
+	}
+
+	ArrayList<u32> pilots;
+	ArrayList<usize> pairSlots;
+	if (pairCount != 0) {
+		// The keys of a HashMap are unique.
+		Option<FrozenHashMapError> buildError = internal::buildFrozenHashMapPilots(hashCodes, bucketCount,
+			[](usize, usize) { return false; }, pilots, pairSlots);
+		if (buildError.isSome()) {
+			return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::HashCollision);
+		}
+	}
+
+	internal::FrozenMappedHashMapHeader header;
+	header.magic = internal::FROZEN_MAPPED_HASH_MAP_MAGIC;
+	header.version = internal::FROZEN_MAPPED_HASH_MAP_VERSION;
+	header.slotSize = sizeof(SlotT);
+	header.keySize = STRING_KEYS ? 0 : sizeof(Key);
+	header.valueSize = sizeof(Value);
+	header.mixerCheck = Mixer::mix(internal::FROZEN_MAPPED_HASH_MAP_MAGIC);
+	header.pairCount = pairCount;
+	header.bucketCount = bucketCount;
+	header.pilotsOffset = sizeof(internal::FrozenMappedHashMapHeader);
+	header.slotsOffset = alignOffset(header.pilotsOffset + bucketCount * sizeof(u32), SLOT_ALIGNMENT);
+	const usize stringsOffset = header.slotsOffset + pairCount * sizeof(SlotT);
+	header.byteCount = stringsOffset + stringBytes;
+
+	ArrayList<u8> bytes;
+	bytes.resize(header.byteCount, 0);
+	std::memcpy(bytes.data(), &header, sizeof(header));
+	if (bucketCount != 0) {
+		std::memcpy(bytes.data() + header.pilotsOffset, pilots.data(), bucketCount * sizeof(u32));
+	}
+
+	usize nextStringOffset = stringsOffset;
+	for (usize i = 0; i < pairCount; i++) {
+		u8* slotBytes = bytes.data() + header.slotsOffset + pairSlots[i] * sizeof(SlotT);
+		if constexpr (STRING_KEYS) {
+			const usize keyLength = keys[i]->len();
+			const SlotT slot{ nextStringOffset, keyLength, *values[i] };
+			std::memcpy(slotBytes, &slot, sizeof(SlotT));
+			std::memcpy(bytes.data() + nextStringOffset, keys[i]->cstr(), keyLength);
+			nextStringOffset += keyLength;
+		}
+		else {
+			const SlotT slot{ *keys[i], *values[i] };
+			std::memcpy(slotBytes, &slot, sizeof(SlotT));
+		}
+	}
+	return ResultOk<ArrayList<u8>>(std::move(bytes));
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+template<gk::usize GROUP_ALLOC_SIZE, typename MapAllocator, typename MapMixer>
+inline gk::Result<void, gk::FrozenMappedHashMapError> gk::FrozenMappedHashMap<Key, Value, Mixer>::writeFile(const HashMap<Key, Value, GROUP_ALLOC_SIZE, MapAllocator, MapMixer>& map, const String& path)
+{
+	Result<ArrayList<u8>, FrozenMappedHashMapError> serialized = serialize(map);
+	if (serialized.isError()) {
+		return ResultErr<FrozenMappedHashMapError>(serialized.error());
+	}
+	const ArrayList<u8> bytes = serialized.ok();
+	if (!internal::writeWholeFile(path, bytes.data(), bytes.len())) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::FileAccess);
+	}
+	return ResultOk<void>();
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::Result<gk::FrozenMappedHashMap<Key, Value, Mixer>, gk::FrozenMappedHashMapError> gk::FrozenMappedHashMap<Key, Value, Mixer>::open(const String& path)
+{
+	Result<internal::MappedFile, FrozenMappedHashMapError> mapped = internal::MappedFile::open(path);
+	if (mapped.isError()) {
+		return ResultErr<FrozenMappedHashMapError>(mapped.error());
+	}
+	internal::MappedFile file = mapped.ok();
+
+	Result<FrozenMappedHashMap, FrozenMappedHashMapError> viewed = fromBytes(file.data, file.byteCount);
+	if (viewed.isError()) {
+		return ResultErr<FrozenMappedHashMapError>(viewed.error());
+	}
+	FrozenMappedHashMap view = viewed.ok();
+	// Moving the mapping doesn't move the mapped memory the view points into.
+	view._file = std::move(file);
+	return ResultOk<FrozenMappedHashMap>(std::move(view));
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::Result<gk::FrozenMappedHashMap<Key, Value, Mixer>, gk::FrozenMappedHashMapError> gk::FrozenMappedHashMap<Key, Value, Mixer>::fromBytes(const u8* bytes, usize byteCount)
+{
+	if (byteCount < sizeof(internal::FrozenMappedHashMapHeader) || (reinterpret_cast<usize>(bytes) % SLOT_ALIGNMENT) != 0) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::InvalidFormat);
+	}
+
+	internal::FrozenMappedHashMapHeader header;
+	std::memcpy(&header, bytes, sizeof(header));
+
+	const bool validHeader = header.magic == internal::FROZEN_MAPPED_HASH_MAP_MAGIC
+		&& header.version == internal::FROZEN_MAPPED_HASH_MAP_VERSION
+		&& header.slotSize == sizeof(SlotT)
+		&& header.keySize == (STRING_KEYS ? 0 : sizeof(Key))
+		&& header.valueSize == sizeof(Value)
+		&& header.mixerCheck == Mixer::mix(internal::FROZEN_MAPPED_HASH_MAP_MAGIC)
+		&& header.byteCount == byteCount;
+	if (!validHeader) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::InvalidFormat);
+	}
+
+	// The divisions keep a corrupt count from overflowing the bounds checks.
+	const bool validLayout = header.bucketCount == (header.pairCount == 0 ? 0 : internal::frozenHashMapBucketCount(header.pairCount))
+		&& header.pilotsOffset % alignof(u32) == 0
+		&& header.pilotsOffset <= byteCount
+		&& header.bucketCount <= (byteCount - header.pilotsOffset) / sizeof(u32)
+		&& header.slotsOffset % SLOT_ALIGNMENT == 0
+		&& header.slotsOffset <= byteCount
+		&& header.pairCount <= (byteCount - header.slotsOffset) / sizeof(SlotT);
+	if (!validLayout) {
+		return ResultErr<FrozenMappedHashMapError>(FrozenMappedHashMapError::InvalidFormat);
+	}
+
+	FrozenMappedHashMap view;
+	view._bytes = bytes;
+	view._byteCount = byteCount;
+	view._pilots = reinterpret_cast<const u32*>(bytes + header.pilotsOffset);
+	view._slots = reinterpret_cast<const SlotT*>(bytes + header.slotsOffset);
+	view._pairCount = header.pairCount;
+	view._bucketCount = header.bucketCount;
+	return ResultOk<FrozenMappedHashMap>(std::move(view));
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::Option<const Value*> gk::FrozenMappedHashMap<Key, Value, Mixer>::find(const LookupT& key) const
+{
+	if (_pairCount == 0) {
+		return Option<const Value*>();
+	}
+
+	const usize hashCode = hashKey(key);
+	const u32 pilot = _pilots[internal::frozenHashMapBucket(hashCode, _bucketCount)];
+	const SlotT& slot = _slots[internal::frozenHashMapSlot(hashCode, pilot, _pairCount)];
+	if constexpr (STRING_KEYS) {
+		if (slot.keyLength != key.len) {
+			return Option<const Value*>();
+		}
+		// Only the header is validated when opening, so a corrupt slot mustn't read outside of the snapshot.
+		if (slot.keyOffset > _byteCount || slot.keyLength > _byteCount - slot.keyOffset) {
+			return Option<const Value*>();
+		}
+		if (std::memcmp(_bytes + slot.keyOffset, key.buffer, key.len) != 0) {
+			return Option<const Value*>();
+		}
+	}
+	else {
+		if (!(slot.key == key)) {
+			return Option<const Value*>();
+		}
+	}
+	return Option<const Value*>(&slot.value);
+}
+
+template<typename Key, typename Value, typename Mixer>
+	requires (((std::is_trivially_copyable_v<Key> && !std::is_pointer_v<Key>) || std::is_same_v<Key, gk::String>)
+		&& std::is_trivially_copyable_v<Value> && gk::Hashable<Key> && gk::HashMixer<Mixer>)
+inline gk::usize gk::FrozenMappedHashMap<Key, Value, Mixer>::hashKey(const LookupT& key)
+{
+	if constexpr (STRING_KEYS) {
+		return Mixer::mix(static_cast<usize>(HashLookup<String, Str>::hash(key)));
+	}
+	else {
+		return Mixer::mix(gk::hash<Key>(key));
+	}
+}
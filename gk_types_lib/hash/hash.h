@@ -5,9 +5,14 @@
 #include <concepts>
 #include <utility>
 #include <string>
+#include <intrin.h>
 
 namespace gk 
 {
+	/**
+	* Hashes a key. The integer specializations are cheap and reversible, but keep sequential and strided keys
+	* close together, so hash maps spread them out with `gk::StrongHashMixer` by default. See `gk::DefaultHashMixer`.
+	*/
 	template<typename KeyType>
 	constexpr size_t hash(const KeyType& key) = delete;
 
@@ -49,12 +54,18 @@ namespace gk
 
 	template<>
 	constexpr size_t hash<float>(const float& key) {
+		if (key == 0.f) {
+			return 0; // -0 == 0, so they must hash the same
+		}
 		const double asDouble = static_cast<double>(key);
 		return std::bit_cast<size_t, double>(asDouble);
 	}
 
 	template<>
 	constexpr size_t hash<double>(const double& key) {
+		if (key == 0.0) {
+			return 0; // -0 == 0, so they must hash the same
+		}
 		return std::bit_cast<size_t, double>(key);
 	}
 
@@ -76,6 +87,37 @@ namespace gk
 
 	namespace internal
 	{
+		/**
+		* Default secret of wyhash, by Wang Yi. Odd, with an equal number of set and unset bits in every byte.
+		*/
+		constexpr u64 HASH_SECRET[4] = { 0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL, 0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL };
+
+		/**
+		* Full 64 bit by 64 bit multiply, folding the high and low halves of the 128 bit product together.
+		* Every bit of the result depends on every bit of both inputs. The core of wyhash.
+		*/
+		constexpr u64 hashMultiplyFold(u64 a, u64 b) {
+			if (std::is_constant_evaluated()) {
+				const u64 aLow = a & 0xFFFFFFFFULL;
+				const u64 aHigh = a >> 32;
+				const u64 bLow = b & 0xFFFFFFFFULL;
+				const u64 bHigh = b >> 32;
+				const u64 lowLow = aLow * bLow;
+				const u64 lowHigh = aLow * bHigh;
+				const u64 highLow = aHigh * bLow;
+				const u64 highHigh = aHigh * bHigh;
+				const u64 middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFULL) + (highLow & 0xFFFFFFFFULL);
+				const u64 low = (lowLow & 0xFFFFFFFFULL) | (middle << 32);
+				const u64 high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+				return low ^ high;
+			}
+			else {
+				u64 high;
+				const u64 low = _umul128(a, b, &high);
+				return low ^ high;
+			}
+		}
+
 		template<typename T>
 		concept CanBeHashed = requires(T a)
 		{
@@ -90,4 +132,96 @@ namespace gk
 	*/
 	template<typename T>
 	concept Hashable = (internal::CanBeHashed<T> || std::is_pointer<T>::value) && std::equality_comparable<T>;
+
+	/**
+	* Policy used by `gk::HashMap` to scramble the result of gk::hash<>() before choosing a group and tag from it.
+	* Must provide `static size_t mix(size_t hashCode)`, and be deterministic.
+	*/
+	template<typename T>
+	concept HashMixer = requires(size_t hashCode)
+	{
+		{ T::mix(hashCode) } -> std::convertible_to<std::size_t>;
+	};
+
+	/**
+	* Uses the result of gk::hash<>() as is. Free, and keeps sequential integer keys in neighbouring groups,
+	* but strided keys crowd into a few groups. Tags are always taken from every bit of the hash, so they stay spread out.
+	* Ideal for keys whose hash already spreads over every bit, such as `gk::String`.
+	*/
+	struct IdentityHashMixer {
+		static constexpr size_t mix(size_t hashCode) { return hashCode; }
+	};
+
+	/**
+	* Two rounds of wyhash's multiply fold, so that sequential, strided, and aligned pointer keys
+	* spread over every group and tag. Costs two multiplies.
+	*/
+	struct StrongHashMixer {
+		static constexpr size_t mix(size_t hashCode) {
+			const u64 folded = internal::hashMultiplyFold(hashCode ^ internal::HASH_SECRET[0], internal::HASH_SECRET[1]);
+			return internal::hashMultiplyFold(folded ^ internal::HASH_SECRET[0], internal::HASH_SECRET[1]);
+		}
+	};
+
+	/**
+	* The `gk::HashMixer` that `gk::HashMap` and `gk::HashSet` use for keys of type `Key` when none is given.
+	* Integer, float, and pointer keys use `StrongHashMixer`, as their gk::hash<>() only shifts the bits,
+	* so strided keys, or keys differing only in their high bits, would otherwise crowd into a few groups.
+	* Other keys use `IdentityHashMixer`, as `gk::String`, `gk::Str` and `gk::GlobalString` are already wyhash,
+	* so mixing them again is wasted. Specialize this to change the default for a key type, or pass
+	* `IdentityHashMixer` to keep dense sequential integer ids in neighbouring groups.
+	*/
+	template<typename Key>
+	struct DefaultHashMixer {
+		using Type = IdentityHashMixer;
+	};
+
+	template<typename Key>
+		requires std::is_arithmetic_v<Key>
+	struct DefaultHashMixer<Key> {
+		using Type = StrongHashMixer;
+	};
+
+	template<typename T>
+	struct DefaultHashMixer<T*> {
+		using Type = StrongHashMixer;
+	};
+
+	template<typename Key>
+	using DefaultHashMixerFor = typename DefaultHashMixer<Key>::Type;
+
+	/**
+	* Opt-in heterogeneous lookup, allowing hash maps with keys of type `Key` to be searched
+	* using a `Lookup` without constructing a `Key`. Specializations must provide:
+	* 1. `static size_t hash(const Lookup&)`, equal to gk::hash<Key>() of the equivalent key.
+	* 2. `static bool equal(const Key&, const Lookup&)`.
+	*/
+	template<typename Key, typename Lookup>
+	struct HashLookup;
+
+	/**
+	* A `Lookup` can search a hash map with keys of type `Key` if `HashLookup<Key, Lookup>` is specialized.
+	*/
+	template<typename Lookup, typename Key>
+	concept HashLookupFor = !std::is_same_v<Lookup, Key> && requires(const Key& key, const Lookup& lookup)
+	{
+		{ HashLookup<Key, Lookup>::hash(lookup) } -> std::convertible_to<std::size_t>;
+		{ HashLookup<Key, Lookup>::equal(key, lookup) } -> std::convertible_to<bool>;
+	};
+
+	namespace internal
+	{
+		/**
+		* Compares a stored key against a key of the same type, or a heterogeneous lookup.
+		*/
+		template<typename Key, typename Lookup>
+		constexpr bool hashKeysEqual(const Key& key, const Lookup& lookup) {
+			if constexpr (std::is_same_v<Key, Lookup>) {
+				return key == lookup;
+			}
+			else {
+				return HashLookup<Key, Lookup>::equal(key, lookup);
+			}
+		}
+	}
 }
\ No newline at end of file
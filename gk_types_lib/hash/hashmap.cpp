@@ -165,7 +165,12 @@ u64 gk::internal::simdFindEqualHashCodeBitmaskIteration64(const i8* bufferOffset
 }
 
 #if GK_TYPES_LIB_TEST
+#include "../string/string.h"
 #include <string>
+#include <string_view>
+#include <vector>
+#include <iostream>
+#include <chrono>
 
 template<typename Key, typename Value>
 using HashMap = gk::HashMap<Key, Value, 32>;
@@ -177,6 +182,16 @@ static size_t gk::hash<std::string>(const std::string& key) {
 	return hasher(key);
 }
 
+// Example of allowing lookups without constructing the key type
+template<>
+struct gk::HashLookup<std::string, std::string_view> {
+	static size_t hash(const std::string_view& lookup) {
+		std::hash<std::string_view> hasher;
+		return hasher(lookup);
+	}
+	static bool equal(const std::string& key, const std::string_view& lookup) { return key == lookup; }
+};
+
 static constexpr void hashMapDefaultConstruct() {
 	HashMap<int, int> map;
 	check_eq(map.size(), 0);
@@ -454,6 +469,117 @@ test_case("EraseAllElements") {
 	check_eq(map.size(), 0);
 }
 
+test_case("EraseMissingKeyKeepsSize") {
+	HashMap<std::string, int> map;
+	for (int i = 0; i < 20; i++) {
+		map.insert(std::to_string(i), 100);
+	}
+	check(!map.erase(std::to_string(20)));
+	check_eq(map.size(), 20);
+}
+
+test_case("Contains") {
+	HashMap<std::string, int> map;
+	map.insert(std::to_string(5), 100);
+	check(map.contains(std::to_string(5)));
+	check(!map.contains(std::to_string(6)));
+}
+
+test_case("FindHeterogeneous") {
+	HashMap<std::string, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	const std::string buffer = "12345";
+	check_eq(*map.find(std::string_view(buffer).substr(1, 2)).some(), 23);
+	check(map.find(std::string_view(buffer)).none());
+
+	const HashMap<std::string, int>& constMap = map;
+	check_eq(*constMap.find(std::string_view(buffer).substr(0, 1)).some(), 1);
+	check(constMap.contains(std::string_view(buffer).substr(3, 2)));
+	check(!constMap.contains(std::string_view(buffer).substr(0, 3)));
+}
+
+test_case("EraseHeterogeneous") {
+	HashMap<std::string, int> map;
+	for (int i = 0; i < 20; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	check(map.erase(std::string_view("7")));
+	check(!map.erase(std::string_view("7")));
+	check(map.find("7").none());
+	check_eq(map.size(), 19);
+}
+
+test_case("FindManyInts") {
+	HashMap<int, int> map;
+	for (int i = 0; i < 1000; i += 2) {
+		map.insert(i, i * 3);
+	}
+	int keys[1000];
+	for (int i = 0; i < 1000; i++) {
+		keys[i] = 999 - i;
+	}
+	gk::Option<int*> results[1000];
+	map.findMany(keys, 1000, results);
+	for (int i = 0; i < 1000; i++) {
+		if (keys[i] % 2 == 0) {
+			check_eq(*results[i].some(), keys[i] * 3);
+		}
+		else {
+			check(results[i].none());
+		}
+	}
+}
+
+test_case("FindManyStringsConst") {
+	HashMap<std::string, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	const HashMap<std::string, int>& constMap = map;
+	std::string keys[37];
+	for (int i = 0; i < 37; i++) {
+		keys[i] = std::to_string(i * 3);
+	}
+	gk::Option<const int*> results[37];
+	constMap.findMany(keys, 37, results);
+	for (int i = 0; i < 37; i++) {
+		if (i * 3 < 100) {
+			check_eq(*results[i].some(), i * 3);
+		}
+		else {
+			check(results[i].none());
+		}
+	}
+}
+
+test_case("FindManyEmptyMap") {
+	HashMap<int, int> map;
+	int keys[3] = { 1, 2, 3 };
+	gk::Option<int*> results[3];
+	map.findMany(keys, 3, results);
+	check(results[0].none());
+	check(results[1].none());
+	check(results[2].none());
+}
+
+test_case("InsertMany") {
+	HashMap<std::string, int> map;
+	map.insert(std::to_string(5), -1);
+	std::string keys[100];
+	int values[100];
+	for (int i = 0; i < 100; i++) {
+		keys[i] = std::to_string(i % 50);
+		values[i] = i;
+	}
+	check_eq(map.insertMany(keys, values, 100), 49);
+	check_eq(map.size(), 50);
+	check_eq(*map.find(std::to_string(5)).some(), -1);
+	check_eq(*map.find(std::to_string(49)).some(), 49);
+	check_eq(map.insertMany(keys, values, 0), 0);
+}
+
 test_case("Reserve") {
 	HashMap<std::string, int> map;
 	map.reserve(100);
@@ -557,4 +683,371 @@ test_case("MoveAssign") {
 	check_eq(iterCount, 100);
 }
 
-#endif
\ No newline at end of file
+test_case("IncrementalRehashInsertAndFind") {
+	HashMap<int, int> map;
+	map.setIncrementalRehash(true);
+	check(map.incrementalRehash());
+	bool sawRehash = false;
+	for (int i = 0; i < 10000; i++) {
+		map.insert(i, i * 2);
+		sawRehash |= map.isRehashing();
+		if (i % 97 == 0) {
+			for (int j = 0; j <= i; j += 13) {
+				check_eq(*map.find(j).some(), j * 2);
+			}
+		}
+	}
+	check(sawRehash);
+	check_eq(map.size(), 10000);
+	for (int i = 0; i < 10000; i++) {
+		check_eq(*map.find(i).some(), i * 2);
+	}
+	check(map.find(10000).none());
+}
+
+test_case("IncrementalRehashEraseAndReinsert") {
+	HashMap<std::string, int> map;
+	map.setIncrementalRehash(true);
+	for (int i = 0; i < 500; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	map.reserve(5000);
+	check(map.isRehashing());
+	check_eq(map.size(), 500);
+
+	for (int i = 0; i < 500; i += 2) {
+		check(map.erase(std::to_string(i)));
+	}
+	check(!map.erase(std::to_string(0)));
+	check_eq(map.size(), 250);
+	for (int i = 0; i < 500; i++) {
+		if (i % 2 == 0) {
+			check(map.find(std::to_string(i)).none());
+			check(map.insert(std::to_string(i), -i).none());
+		}
+		else {
+			check_eq(*map.find(std::to_string(i)).some(), i);
+			check(map.insert(std::to_string(i), -i).isSome());
+		}
+	}
+	check_eq(map.size(), 500);
+	check(!map.isRehashing());
+	for (int i = 0; i < 500; i++) {
+		check_eq(*map.find(std::to_string(i)).some(), i % 2 == 0 ? -i : i);
+	}
+}
+
+test_case("IncrementalRehashIterateCopyAndDisable") {
+	HashMap<std::string, int> map;
+	map.setIncrementalRehash(true);
+	for (int i = 0; i < 1000; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	map.reserve(10000);
+	map.insert(std::to_string(1000), 1000);
+	check(map.isRehashing());
+
+	int iterCount = 0;
+	int valueSum = 0;
+	for (auto pair : map) {
+		iterCount++;
+		valueSum += pair.value;
+	}
+	check_eq(iterCount, 1001);
+	check_eq(valueSum, 1000 * 1001 / 2);
+
+	HashMap<std::string, int> copy = map;
+	check_eq(copy.size(), 1001);
+	check_eq(*copy.find(std::to_string(7)).some(), 7);
+
+	HashMap<std::string, int> moved = std::move(map);
+	check(moved.isRehashing());
+	moved.setIncrementalRehash(false);
+	check(!moved.isRehashing());
+	check_eq(moved.size(), 1001);
+	for (int i = 0; i <= 1000; i++) {
+		check_eq(*moved.find(std::to_string(i)).some(), i);
+	}
+}
+
+namespace gk
+{
+	namespace unitTests
+	{
+		/**
+		* Distributes `count` keys, `stride` apart, over 256 groups using `Mixer`, the same way `gk::HashMap` does.
+		* Checks that no group is more than twice as full as the average, and that most of the 128 tags are used.
+		*/
+		template<typename Mixer>
+		static void checkHashMixerDistribution(u64 firstKey, u64 stride, usize count) {
+			constexpr usize GROUP_COUNT = 256;
+			usize groupOccupancy[GROUP_COUNT] = {};
+			bool tagsUsed[128] = {};
+			for (usize i = 0; i < count; i++) {
+				const usize hashCode = Mixer::mix(gk::hash<u64>(firstKey + (i * stride)));
+				groupOccupancy[gk::internal::HashMapGroupBitmask(hashCode).value % GROUP_COUNT]++;
+				tagsUsed[gk::internal::HashMapPairBitmask(hashCode).value & 0b01111111] = true;
+			}
+
+			usize mostOccupied = 0;
+			for (usize occupancy : groupOccupancy) {
+				mostOccupied = occupancy > mostOccupied ? occupancy : mostOccupied;
+			}
+			usize tagCount = 0;
+			for (bool used : tagsUsed) {
+				tagCount += used ? 1 : 0;
+			}
+			check(mostOccupied <= (count / GROUP_COUNT) * 2);
+			check(tagCount >= 120);
+		}
+	}
+}
+
+test_case("StrongHashMixerSequentialKeys") {
+	gk::unitTests::checkHashMixerDistribution<gk::StrongHashMixer>(0, 1, 8192);
+}
+
+test_case("StrongHashMixerStridedKeys") {
+	gk::unitTests::checkHashMixerDistribution<gk::StrongHashMixer>(0, 64, 8192);
+	gk::unitTests::checkHashMixerDistribution<gk::StrongHashMixer>(0, 4096, 8192);
+	gk::unitTests::checkHashMixerDistribution<gk::StrongHashMixer>(1ULL << 32, 1ULL << 32, 8192);
+}
+
+test_case("IdentityHashMixerStridedKeyTags") {
+	// Stride 64 keys hash to multiples of 128, which leave the low 7 bits 0. The tag must still use every hash bit.
+	gk::unitTests::checkHashMixerDistribution<gk::IdentityHashMixer>(0, 64, 8192);
+}
+
+test_case("StrongHashMixerAlignedPointerKeys") {
+	// Typical 16 byte aligned heap addresses.
+	gk::unitTests::checkHashMixerDistribution<gk::StrongHashMixer>(0x000001F2A4C30000ULL, 16, 8192);
+}
+
+test_case("IdentityHashMixer") {
+	gk::HashMap<int, int, 32, gk::AllocatorRef, gk::IdentityHashMixer> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	check_eq(map.size(), 1000);
+	for (int i = 0; i < 1000; i++) {
+		check_eq(*map.find(i).some(), i * 2);
+	}
+	check(map.find(1000).none());
+}
+
+test_case("DefaultHashMixer") {
+	static_assert(std::is_same_v<HashMap<u64, int>, gk::HashMap<u64, int, 32, gk::GlobalHeapStaticAllocator, gk::StrongHashMixer>>);
+	static_assert(std::is_same_v<gk::DefaultHashMixerFor<gk::i32>, gk::StrongHashMixer>);
+	static_assert(std::is_same_v<gk::DefaultHashMixerFor<double>, gk::StrongHashMixer>);
+	static_assert(std::is_same_v<gk::DefaultHashMixerFor<std::string>, gk::IdentityHashMixer>);
+	static_assert(std::is_same_v<HashMap<int*, int>, gk::HashMap<int*, int, 32, gk::GlobalHeapStaticAllocator, gk::StrongHashMixer>>);
+	static_assert(std::is_same_v<gk::DefaultHashMixerFor<const char*>, gk::StrongHashMixer>);
+}
+
+test_case("NegativeZeroFloatKey") {
+	HashMap<double, int> map;
+	map.insert(0.0, 1);
+	check_eq(*map.find(-0.0).some(), 1);
+	check_eq(gk::hash<float>(-0.f), gk::hash<float>(0.f));
+}
+
+test_case("StatsEmpty") {
+	HashMap<int, int> map;
+	const gk::HashMapStats stats = map.stats();
+	check_eq(stats.groupCount, 0);
+	check_eq(stats.elementCount, 0);
+	check_eq(stats.totalBytes, 0);
+	check_eq(stats.averageScanLength, 0.0);
+	check_eq(stats.pairCountHistogram.len(), 33);
+}
+
+test_case("StatsCountsEveryEntry") {
+	HashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	const gk::HashMapStats stats = map.stats();
+	check_eq(stats.elementCount, 1000);
+	check(stats.slotCount >= 1000);
+	usize groupCount = 0;
+	usize pairCount = 0;
+	for (usize i = 0; i < stats.pairCountHistogram.len(); i++) {
+		groupCount += stats.pairCountHistogram[i];
+		pairCount += stats.pairCountHistogram[i] * i;
+	}
+	check_eq(groupCount, stats.groupCount);
+	check_eq(pairCount, 1000);
+	check(stats.averageScanLength >= 1.0);
+	check(stats.maxScanLength >= 1);
+	check(stats.tagFalsePositiveRate < 0.5);
+	check(stats.totalBytes > stats.slotCount);
+}
+
+test_case("StatsDuringIncrementalRehash") {
+	HashMap<std::string, int> map;
+	map.setIncrementalRehash(true);
+	for (int i = 0; i < 1000; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	map.reserve(10000);
+	map.insert(std::to_string(1000), 1000);
+	check(map.isRehashing());
+	const gk::HashMapStats stats = map.stats();
+	usize pairCount = 0;
+	for (usize i = 0; i < stats.pairCountHistogram.len(); i++) {
+		pairCount += stats.pairCountHistogram[i] * i;
+	}
+	check_eq(pairCount, 1001);
+	// Keys and values too big to store in place are separately allocated.
+	check(stats.totalBytes > 1001 * (sizeof(std::string) + sizeof(int)));
+}
+
+namespace gk
+{
+	namespace unitTests
+	{
+		/**
+		* Puts every key in the same group with the same tag.
+		*/
+		struct CollidingHashMixer {
+			static constexpr usize mix(usize) { return 0; }
+		};
+	}
+}
+
+test_case("StatsTagCollisions") {
+	gk::HashMap<u64, u64, 32, gk::AllocatorRef, gk::unitTests::CollidingHashMixer> collidingMap;
+	gk::HashMap<u64, u64, 32, gk::AllocatorRef, gk::StrongHashMixer> mixedMap;
+	for (u64 i = 0; i < 1000; i++) {
+		collidingMap.insert(i * 64, i);
+		mixedMap.insert(i * 64, i);
+	}
+	const gk::HashMapStats colliding = collidingMap.stats();
+	const gk::HashMapStats mixed = mixedMap.stats();
+	check(colliding.maxScanLength > 1);
+	check(colliding.tagFalsePositiveRate > 0.0);
+	check(colliding.averageScanLength > mixed.averageScanLength);
+	check(mixed.tagFalsePositiveRate < colliding.tagFalsePositiveRate);
+}
+
+test_case("StaticAllocator") {
+	HashMap<std::string, int, 32, gk::GlobalHeapStaticAllocator> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(std::to_string(i), i);
+	}
+	HashMap<std::string, int, 32, gk::GlobalHeapStaticAllocator> otherMap = map;
+	check_eq(otherMap.size(), 100);
+	check_eq(*otherMap.find("50").some(), 50);
+	check(otherMap.erase("50"));
+	check(otherMap.find("50").none());
+	check_eq(*map.find("50").some(), 50);
+}
+
+namespace gk
+{
+	namespace unitTests
+	{
+		/**
+		* Distributes `hashCodes` over as many groups as a `gk::HashMap` holding them would have, printing
+		* the group occupancy, and how many entries share their group and tag with an earlier entry,
+		* which each cost a full key comparison when searching.
+		*/
+		template<typename Mixer>
+		static void printHashDistribution(const char* mixerName, const std::vector<usize>& hashCodes) {
+			const usize groupCount = gk::upperPowerOfTwo(hashCodes.size() / 4);
+			std::vector<usize> groupOccupancy(groupCount, 0);
+			std::vector<u64> groupTags(groupCount * 2, 0);
+			usize tagCollisions = 0;
+			for (usize hashCode : hashCodes) {
+				const usize mixed = Mixer::mix(hashCode);
+				const usize group = gk::internal::HashMapGroupBitmask(mixed).value % groupCount;
+				const usize tag = gk::internal::HashMapPairBitmask(mixed).value & 0b01111111;
+				groupOccupancy[group]++;
+				u64& tagBits = groupTags[(group * 2) + (tag / 64)];
+				if (tagBits & (1ULL << (tag % 64))) {
+					tagCollisions++;
+				}
+				tagBits |= 1ULL << (tag % 64);
+			}
+
+			usize mostOccupied = 0;
+			usize emptyGroups = 0;
+			for (usize occupancy : groupOccupancy) {
+				mostOccupied = occupancy > mostOccupied ? occupancy : mostOccupied;
+				emptyGroups += occupancy == 0 ? 1 : 0;
+			}
+			std::cout << "  " << mixerName
+				<< ": groups " << groupCount
+				<< ", avg occupancy " << (static_cast<double>(hashCodes.size()) / static_cast<double>(groupCount))
+				<< ", max occupancy " << mostOccupied
+				<< ", empty groups " << (100.0 * static_cast<double>(emptyGroups) / static_cast<double>(groupCount)) << "%"
+				<< ", tag collisions " << tagCollisions << '\n';
+		}
+
+		template<typename Mixer>
+		static void timeIntHashMap(const char* mixerName, const std::vector<u64>& keys) {
+			const auto start = std::chrono::steady_clock::now();
+			gk::HashMap<u64, u64, 32, gk::AllocatorRef, Mixer> map;
+			for (u64 key : keys) {
+				map.insert(key, key);
+			}
+			u64 sum = 0;
+			for (u64 key : keys) {
+				sum += *map.find(key).some();
+			}
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+			std::cout << "  " << mixerName << ": insert and find " << elapsed.count() << "us (checksum " << sum << ")\n";
+		}
+
+		static void printIntHashDistribution(const char* name, u64 firstKey, u64 stride, usize count) {
+			std::vector<usize> hashCodes;
+			hashCodes.reserve(count);
+			for (usize i = 0; i < count; i++) {
+				hashCodes.push_back(gk::hash<u64>(firstKey + (i * stride)));
+			}
+			std::cout << name << '\n';
+			printHashDistribution<gk::IdentityHashMixer>("identity", hashCodes);
+			printHashDistribution<gk::StrongHashMixer>("strong", hashCodes);
+		}
+
+		/**
+		* Compares the group and tag distribution of `gk::IdentityHashMixer` and `gk::StrongHashMixer`
+		* for key patterns that defeat weak hashes.
+		*/
+		static void runHashBenchmark() {
+			constexpr usize KEY_COUNT = 1 << 20;
+			printIntHashDistribution("sequential u64", 0, 1, KEY_COUNT);
+			printIntHashDistribution("u64 stride 64", 0, 64, KEY_COUNT);
+			printIntHashDistribution("u64 stride 4096", 0, 4096, KEY_COUNT);
+			printIntHashDistribution("u64 high bits only", 1ULL << 32, 1ULL << 32, KEY_COUNT);
+			printIntHashDistribution("16 byte aligned pointers", 0x000001F2A4C30000ULL, 16, KEY_COUNT);
+
+			std::vector<usize> hashCodes;
+			hashCodes.reserve(KEY_COUNT);
+			for (usize i = 0; i < KEY_COUNT; i++) {
+				hashCodes.push_back(gk::String::fromUint(i).hash());
+			}
+			std::cout << "decimal strings\n";
+			printHashDistribution<gk::IdentityHashMixer>("identity", hashCodes);
+			printHashDistribution<gk::StrongHashMixer>("strong", hashCodes);
+
+			// Only sequential keys are timed, as the strided keys can fill a single group with the identity mixer,
+			// growing the map without bound.
+			std::vector<u64> keys;
+			keys.reserve(KEY_COUNT);
+			for (usize i = 0; i < KEY_COUNT; i++) {
+				keys.push_back(i);
+			}
+			std::cout << "sequential u64 HashMap\n";
+			timeIntHashMap<gk::IdentityHashMixer>("identity", keys);
+			timeIntHashMap<gk::StrongHashMixer>("strong", keys);
+		}
+	}
+}
+
+// Prints rather than checks, so it's skipped by default. Run the test executable with `--no-skip --test-case=HashMixerBenchmark`.
+test_case("HashMixerBenchmark" * doctest::skip()) {
+	gk::unitTests::runHashBenchmark();
+}
+
+#endif
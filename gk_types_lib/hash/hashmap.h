@@ -4,7 +4,9 @@
 #include "../doctest/doctest_proxy.h"
 #include "../option/option.h"
 #include "../allocator/allocator.h"
+#include "../array/array_list.h"
 #include "../utility.h"
+#include <intrin.h>
 
 namespace gk
 {
@@ -13,6 +15,54 @@ namespace gk
 		struct HashMapGroup;
 	}
 
+	/**
+	* How the entries of a `gk::HashMap` are spread over it's groups, for tuning `GROUP_ALLOC_SIZE`, `reserve()`,
+	* and key hashes from real data. See `HashMap::stats()`.
+	* Can be converted to a `gk::JsonObject` with `gk::serialize()`.
+	*/
+	struct HashMapStats {
+		/**
+		* Number of groups, including the old groups that haven't been moved yet by an incremental rehash.
+		*/
+		usize groupCount;
+
+		/**
+		* Sum of the capacity of every group. Groups that have never held an entry have no capacity.
+		*/
+		usize slotCount;
+
+		usize elementCount;
+
+		/**
+		* Element `i` is the number of groups holding exactly `i` pairs.
+		* Has `GROUP_ALLOC_SIZE + 1` elements, or more if a group grew past `GROUP_ALLOC_SIZE`.
+		*/
+		ArrayList<usize> pairCountHistogram;
+
+		/**
+		* Average number of keys compared by `find()` of a key in the map. Every slot in the key's group
+		* with the same tag is compared, up to and including the key's own slot.
+		*/
+		double averageScanLength;
+
+		/**
+		* Most keys compared by `find()` of a key in the map.
+		*/
+		usize maxScanLength;
+
+		/**
+		* Fraction of the key comparisons counted by `averageScanLength` that weren't equal,
+		* because another key in the group has the same tag.
+		*/
+		double tagFalsePositiveRate;
+
+		/**
+		* Bytes allocated by the map. Includes the groups, their tags and pairs,
+		* and the separate allocation of each entry whose key or value is too big to store in place.
+		*/
+		usize totalBytes;
+	};
+
 	/**
 	* A general purpose HashMap implementation, utilizing SIMD, and compile time chosen
 	* in-place entry storage for appropriate types for optimal cache access.
@@ -30,9 +80,14 @@ namespace gk
 	* @param Value: Has no restrictions.
 	* @param GROUP_ALLOC_SIZE: Amount of pairs to reserve per group of pairs.
 	* Must be a multiple of 16
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	* @param Mixer: Scrambles gk::hash<>() before choosing a group and tag. See `gk::HashMixer`.
+	* Defaults to `gk::DefaultHashMixerFor<Key>`, which is `StrongHashMixer` for integer, float, and pointer keys.
+	* Use `IdentityHashMixer` to keep dense sequential integer ids in neighbouring groups.
 	*/
-	template<typename Key, typename Value, usize GROUP_ALLOC_SIZE = 32>
-		requires (GROUP_ALLOC_SIZE % 16 == 0 && Hashable<Key>)
+	template<typename Key, typename Value, usize GROUP_ALLOC_SIZE = 32, typename Allocator = GlobalHeapStaticAllocator, typename Mixer = DefaultHashMixerFor<Key>>
+		requires (GROUP_ALLOC_SIZE % 16 == 0 && Hashable<Key> && AllocatorPolicy<Allocator> && HashMixer<Mixer>)
 	struct HashMap
 	{
 	private:
@@ -41,6 +96,27 @@ namespace gk
 
 		static constexpr usize hashKey(const Key& key);
 
+		template<typename Lookup>
+		static constexpr usize hashLookup(const Lookup& key) { return Mixer::mix(static_cast<usize>(HashLookup<Key, Lookup>::hash(key))); }
+
+		/**
+		* In place pairs don't store their hash code, so it's recalculated.
+		*/
+		static constexpr usize pairHashCode(const typename GroupT::PairT& pair);
+
+		template<typename LookupKey>
+		constexpr Option<Value*> findImpl(const LookupKey& key, usize hashCode);
+
+		template<typename LookupKey>
+		constexpr Option<const Value*> findImpl(const LookupKey& key, usize hashCode) const;
+
+		template<typename LookupKey>
+		constexpr bool eraseImpl(const LookupKey& key, usize hashCode);
+
+		// Shares the hash code it chose a shard with, rather than hashing twice.
+		template<typename ShardKey, typename ShardValue, usize SHARD_COUNT>
+		friend struct ConcurrentHashMap;
+
 	public:
 
 		/**
@@ -78,7 +154,7 @@ namespace gk
 		*
 		* @return Immutable reference to the allocator used by this HashMap.
 		*/
-		[[nodiscard]] const AllocatorRef& allocator() const { return _allocator; }
+		[[nodiscard]] const Allocator& allocator() const { return _allocator; }
 
 		/**
 		* Finds an entry within the HashMap, returning an optional mutable value.
@@ -100,6 +176,46 @@ namespace gk
 		*/
 		[[nodiscard]] constexpr Option<const Value*> find(const Key& key) const;
 
+		/**
+		* Finds an entry within the HashMap using a different type than `Key`, returning an optional mutable value.
+		* Avoids constructing a `Key`, such as searching `gk::String` keys with a `gk::Str`. See `gk::HashLookup`.
+		*
+		* NOTE: The HashMap does not have pointer stability. Subsequent mutation operations on the HashMap may
+		* invalidate the returned Some pointer due to the underlying data being moved to a new location.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] constexpr Option<Value*> find(const Lookup& key);
+
+		/**
+		* Finds an entry within the HashMap using a different type than `Key`, returning an optional immutable value.
+		* Avoids constructing a `Key`, such as searching `gk::String` keys with a `gk::Str`. See `gk::HashLookup`.
+		*
+		* NOTE: The HashMap does not have pointer stability. Subsequent mutation operations on the HashMap may
+		* invalidate the returned Some pointer due to the underlying data being moved to a new location.
+		*
+		* @return Some if the key exists in the map, or None if it doesn't
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] constexpr Option<const Value*> find(const Lookup& key) const;
+
+		/**
+		* @return `true` if the key exists in the HashMap, or `false` if it doesn't.
+		*/
+		[[nodiscard]] constexpr bool contains(const Key& key) const { return find(key).isSome(); }
+
+		/**
+		* Checks for a key using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists in the HashMap, or `false` if it doesn't.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] constexpr bool contains(const Lookup& key) const { return find(key).isSome(); }
+
 		/**
 		* Invalidates any iterators.
 		* Inserts an entry into the HashMap if it DOES NOT exist.
@@ -161,6 +277,56 @@ namespace gk
 		*/
 		constexpr bool erase(const Key& key);
 
+		/**
+		* Invalidates any iterators.
+		* Erases an entry from the HashMap using a different type than `Key`,
+		* without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the HashMap.
+		* Can be ignored.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		constexpr bool erase(const Lookup& key);
+
+		/**
+		* Finds many entries within the HashMap at once, writing an optional mutable value for each key into `out`.
+		* Keys are processed in batches, where every key's group is prefetched before any of them are compared,
+		* so the cache misses of independent lookups overlap instead of happening one after another.
+		* Prefer this over many calls to `find()` when the HashMap is much larger than the CPU caches.
+		*
+		* NOTE: The HashMap does not have pointer stability. Subsequent mutation operations on the HashMap may
+		* invalidate the returned Some pointers due to the underlying data being moved to a new location.
+		*
+		* @param keys: Keys to find. Must point to at least `count` keys.
+		* @param count: Number of keys to find.
+		* @param out: Result for each key in order. Must point to at least `count` options.
+		*/
+		constexpr void findMany(const Key* keys, usize count, Option<Value*>* out);
+
+		/**
+		* Finds many entries within the HashMap at once, writing an optional immutable value for each key into `out`.
+		* See the mutable `findMany()`.
+		*
+		* @param keys: Keys to find. Must point to at least `count` keys.
+		* @param count: Number of keys to find.
+		* @param out: Result for each key in order. Must point to at least `count` options.
+		*/
+		constexpr void findMany(const Key* keys, usize count, Option<const Value*>* out) const;
+
+		/**
+		* Invalidates any iterators.
+		* Inserts copies of many entries into the HashMap, for each key that DOES NOT already exist.
+		* Reserves space for all of them up front, and prefetches in batches like `findMany()`.
+		* Existing entries keep their current value.
+		*
+		* @param keys: Keys to insert. Must point to at least `count` keys.
+		* @param values: Value for each key. Must point to at least `count` values.
+		* @param count: Number of entries to insert.
+		* @return The number of entries that were added. Can be ignored.
+		*/
+		constexpr usize insertMany(const Key* keys, const Value* values, usize count);
+
 		/**
 		* Reserves additional capacity in the HashMap. If it decides to reallocate,
 		* all keys will be rehashed. The HashMap will be able to store at LEAST
@@ -170,6 +336,38 @@ namespace gk
 		*/
 		constexpr void reserve(usize additional);
 
+		/**
+		* Enables or disables incremental rehashing. By default, growing the HashMap moves every entry
+		* into the new groups at once, which for large maps stalls the single `insert()` or `reserve()` that grew it.
+		* When enabled, growing only allocates the new groups, and leaves the entries where they are.
+		* Each following `insert()` and `erase()` then moves the entries of `internal::HASH_MAP_REHASH_GROUPS_PER_STEP`
+		* old groups, while lookups check both the new group and the not yet moved old group of a key.
+		* `find()` never moves entries, so it doesn't invalidate previously found values.
+		*
+		* Disabling finishes any rehash in progress. Has no effect in constexpr.
+		*
+		* @param enable: Whether to rehash incrementally.
+		*/
+		constexpr void setIncrementalRehash(bool enable);
+
+		/**
+		* @return If growing the HashMap rehashes incrementally. See `setIncrementalRehash()`.
+		*/
+		[[nodiscard]] constexpr bool incrementalRehash() const { return _incrementalRehash; }
+
+		/**
+		* @return If an incremental rehash is in progress, meaning some entries are still in the old groups.
+		*/
+		[[nodiscard]] constexpr bool isRehashing() const { return _oldGroups != nullptr; }
+
+		/**
+		* Walks every group to measure how the entries are spread out. Linear in the capacity of the map,
+		* so it's meant for profiling and tuning, not for hot paths.
+		*
+		* @return Occupancy, scan length, and memory statistics of the HashMap.
+		*/
+		[[nodiscard]] HashMapStats stats() const;
+
 		struct Iterator;
 		struct ConstIterator;
 
@@ -236,6 +434,11 @@ namespace gk
 		private:
 
 			constexpr Iterator() : _map(nullptr), _currentGroup(nullptr), _currentElementIndex(0) {}
+
+			/**
+			* Steps forward until the current slot holds an entry, or the end is reached.
+			*/
+			constexpr void skipEmptySlots();
 			HashMap* _map;
 			internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>* _currentGroup;
 			usize _currentElementIndex;
@@ -260,6 +463,11 @@ namespace gk
 		private:
 
 			constexpr ConstIterator() : _map(nullptr), _currentGroup(nullptr), _currentElementIndex(0) {}
+
+			/**
+			* Steps forward until the current slot holds an entry, or the end is reached.
+			*/
+			constexpr void skipEmptySlots();
 			const HashMap* _map;
 			const internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>* _currentGroup;
 			usize _currentElementIndex;
@@ -273,14 +481,60 @@ namespace gk
 
 		constexpr void reallocate(usize requiredCapacity);
 
+		/**
+		* Requires at least one group.
+		*/
+		constexpr Option<Value*> insertWithHashCode(Key&& key, Value&& value, usize hashCode);
+
+		/**
+		* Hashes each key, and prefetches the group each one belongs to.
+		* Requires at least one group, and `count <= internal::HASH_MAP_BATCH_SIZE`.
+		*/
+		void prefetchBatch(const Key* keys, usize count, usize* hashCodesOut, usize* groupIndicesOut) const;
+
+		/**
+		* @return The old group `hashCode` belonged to if it's entries haven't been moved yet, or nullptr.
+		*/
+		constexpr GroupT* unmovedOldGroup(usize hashCode) const;
+
+		/**
+		* Moves every entry of `oldGroup` into the current groups, and frees it.
+		*/
+		constexpr void moveGroupEntries(GroupT& oldGroup);
+
+		/**
+		* Moves the entries of the next `internal::HASH_MAP_REHASH_GROUPS_PER_STEP` old groups, if rehashing.
+		*/
+		constexpr void rehashStep();
+
+		constexpr void finishRehash();
+
+		/**
+		* Frees every group, including any old groups that haven't been moved yet.
+		*/
+		constexpr void freeGroups();
+
+		/**
+		* Inserts a copy of every entry of `otherGroup`. Requires at least one group.
+		*/
+		constexpr void copyGroupEntries(const GroupT& otherGroup);
+
 	private:
 
 		GroupT* _groups;
 		usize _groupCount;
 		usize _elementCount;
-		AllocatorRef _allocator;
+		// Only non-null while incrementally rehashing. The groups before `_movedGroupCount` have been freed.
+		GroupT* _oldGroups;
+		usize _oldGroupCount;
+		usize _movedGroupCount;
+		bool _incrementalRehash;
+		no_unique_address_member Allocator _allocator;
 	};
 
+	template<typename Key, typename Value, usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	struct is_trivially_relocatable<HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>> : is_trivially_relocatable<Allocator> {};
+
 	namespace internal
 	{
 		/**
@@ -295,14 +549,17 @@ namespace gk
 		};
 
 		/**
-		* Determines the key's index within a group. It's the lowest 7 bits, or'ed with 0b10000000.
+		* Determines the key's tag within a group. It's the highest 7 bits of the hash code multiplied by a
+		* 64 bit odd constant, or'ed with 0b10000000. Every bit of the hash code feeds into the tag, so keys whose
+		* hashes only differ above the low 7 bits, such as the unmixed integer hashes, don't all share a tag.
 		*/
 		struct HashMapPairBitmask {
 			static constexpr i8 BITMASK = 0b01111111;
+			static constexpr usize TAG_MULTIPLIER = 0x9E3779B97F4A7C15ULL;
 			i8 value;
 
 			constexpr HashMapPairBitmask(const usize hashCode)
-				: value((hashCode& BITMASK) | 0b10000000) {}
+				: value(((hashCode * TAG_MULTIPLIER) >> 57) | 0b10000000) {}
 		};
 
 #pragma region Pair_Containers
@@ -321,14 +578,15 @@ namespace gk
 			constexpr Value* getValue() { return &value; }
 			constexpr const Key* getKey() const { return &key; }
 			constexpr const Value* getValue() const { return &value; }
-			constexpr usize hashCode() const { return gk::hash<Key>(key); }
 
-			constexpr void erase(AllocatorRef* allocator);
-			constexpr void insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorRef* allocator);
+			template<typename AllocatorT>
+			constexpr void erase(AllocatorT* allocator);
+			template<typename AllocatorT>
+			constexpr void insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorT* allocator);
 
 		private:
 			Key key;
-			Value value;
+			no_unique_address_member Value value;
 		};
 
 		template<typename Key, typename Value>
@@ -336,7 +594,7 @@ namespace gk
 		{
 			struct Pair {
 				Key key;
-				Value value;
+				no_unique_address_member Value value;
 				usize hashCode;
 			};
 
@@ -353,17 +611,43 @@ namespace gk
 			constexpr const Value* getValue() const { return &pair->value; }
 			constexpr usize hashCode() const { return pair->hashCode; }
 
-			constexpr void erase(AllocatorRef* allocator);
-			constexpr void insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorRef* allocator);
+			template<typename AllocatorT>
+			constexpr void erase(AllocatorT* allocator);
+			template<typename AllocatorT>
+			constexpr void insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorT* allocator);
 
 			Pair* pair;
 		};
 
 #pragma endregion
 
+		/**
+		* Number of keys `HashMap::findMany()` and `HashMap::insertMany()` hash and prefetch before comparing any of them.
+		*/
+		constexpr usize HASH_MAP_BATCH_SIZE = 16;
+
+		/**
+		* Number of old groups each `HashMap::insert()` and `HashMap::erase()` moves into the new groups
+		* while an incremental rehash is in progress. See `HashMap::setIncrementalRehash()`.
+		*/
+		constexpr usize HASH_MAP_REHASH_GROUPS_PER_STEP = 2;
+
 		template<typename T>
 		inline static constexpr bool CAN_T_IN_PLACE() { return sizeof(T) <= (sizeof(gk::usize) / 2); }
 
+		/**
+		* A Value without members takes no space in the pair, such as in `gk::HashSet`, so the key alone can be a full usize.
+		*/
+		template<typename Key, typename Value>
+		inline static constexpr bool CAN_PAIR_IN_PLACE() {
+			if constexpr (std::is_empty_v<Value>) {
+				return sizeof(Key) <= sizeof(gk::usize);
+			}
+			else {
+				return CAN_T_IN_PLACE<Key>() && CAN_T_IN_PLACE<Value>();
+			}
+		}
+
 		template<typename Key, typename Value>
 		static constexpr usize calculateGroupAllocAlignment(usize groupAllocSize);
 
@@ -385,7 +669,7 @@ namespace gk
 		template<typename Key, typename Value, usize GROUP_ALLOC_SIZE>
 		struct HashMapGroup {
 
-			using PairT = std::conditional_t<CAN_T_IN_PLACE<Key>() && CAN_T_IN_PLACE<Value>(),
+			using PairT = std::conditional_t<CAN_PAIR_IN_PLACE<Key, Value>(),
 				HashPairInPlace<Key, Value>,	// Keys and values in place
 				HashPairOnHeap<Key, Value>>;	// Keys and values in heap
 
@@ -404,33 +688,45 @@ namespace gk
 			constexpr HashMapGroup& operator = (HashMapGroup&& other) noexcept;
 			constexpr ~HashMapGroup();
 
-			constexpr void defaultInit(AllocatorRef* allocator);
+			template<typename AllocatorT>
+			constexpr void defaultInit(AllocatorT* allocator);
 
-			constexpr void free(AllocatorRef* allocator);
+			template<typename AllocatorT>
+			constexpr void free(AllocatorT* allocator);
 
-			constexpr Option<Value*> find(const Key& key, usize hashCode);
+			template<typename LookupKey>
+			constexpr Option<Value*> find(const LookupKey& key, usize hashCode);
 
-			constexpr Option<const Value*> find(const Key& key, usize hashCode) const;
+			template<typename LookupKey>
+			constexpr Option<const Value*> find(const LookupKey& key, usize hashCode) const;
 
-			constexpr Option<Value*> insert(Key&& key, Value&& value, usize hashCode, AllocatorRef* allocator);
+			template<typename AllocatorT>
+			constexpr Option<Value*> insert(Key&& key, Value&& value, usize hashCode, AllocatorT* allocator);
 
-			constexpr bool erase(const Key& key, usize hashCode, AllocatorRef* allocator);
+			template<typename LookupKey, typename AllocatorT>
+			constexpr bool erase(const LookupKey& key, usize hashCode, AllocatorT* allocator);
 
 			//private:
 
-			constexpr Option<usize> findIndexOfKey(const Key& key, usize hashCode) const;
+			template<typename LookupKey>
+			constexpr Option<usize> findIndexOfKey(const LookupKey& key, usize hashCode) const;
 
-			Option<usize> findIndexOfKeyRuntime(const Key& key, usize hashCode) const;
+			template<typename LookupKey>
+			Option<usize> findIndexOfKeyRuntime(const LookupKey& key, usize hashCode) const;
 
-			Option<usize> findIndexOfKeyRuntime16(const Key& key, usize hashCode) const;
+			template<typename LookupKey>
+			Option<usize> findIndexOfKeyRuntime16(const LookupKey& key, usize hashCode) const;
 
-			Option<usize> findIndexOfKeyRuntime32(const Key& key, usize hashCode) const;
+			template<typename LookupKey>
+			Option<usize> findIndexOfKeyRuntime32(const LookupKey& key, usize hashCode) const;
 
-			Option<usize> findIndexOfKeyRuntime64(const Key& key, usize hashCode) const;
+			template<typename LookupKey>
+			Option<usize> findIndexOfKeyRuntime64(const LookupKey& key, usize hashCode) const;
 
 			constexpr Option<usize> firstAvailableGroupSlot() const;
 
-			constexpr void reallocate(usize newCapacity, AllocatorRef* allocator);
+			template<typename AllocatorT>
+			constexpr void reallocate(usize newCapacity, AllocatorT* allocator);
 
 		}; // struct HashMapGroup
 
@@ -468,14 +764,16 @@ inline constexpr gk::usize gk::internal::calculateHashMapGroupRuntimeAllocationS
 }
 
 template<typename Key, typename Value>
-inline constexpr void gk::internal::HashPairInPlace<Key, Value>::erase(AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashPairInPlace<Key, Value>::erase(AllocatorT* allocator)
 {
 	key.~Key();
 	value.~Value();
 }
 
 template<typename Key, typename Value>
-inline constexpr void gk::internal::HashPairInPlace<Key, Value>::insert(Key&& inKey, Value&& inValue, usize inHashCode, gk::AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashPairInPlace<Key, Value>::insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorT* allocator)
 {
 	if (std::is_constant_evaluated()) {
 		key = std::move(inKey);
@@ -504,7 +802,8 @@ inline constexpr gk::internal::HashPairOnHeap<Key, Value>& gk::internal::HashPai
 }
 
 template<typename Key, typename Value>
-inline constexpr void gk::internal::HashPairOnHeap<Key, Value>::erase(AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashPairOnHeap<Key, Value>::erase(AllocatorT* allocator)
 {
 	if (std::is_constant_evaluated()) {
 		delete pair;
@@ -516,7 +815,8 @@ inline constexpr void gk::internal::HashPairOnHeap<Key, Value>::erase(AllocatorR
 }
 
 template<typename Key, typename Value>
-inline constexpr void gk::internal::HashPairOnHeap<Key, Value>::insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashPairOnHeap<Key, Value>::insert(Key&& inKey, Value&& inValue, usize inHashCode, AllocatorT* allocator)
 {
 	check(pair == nullptr);
 	if (std::is_constant_evaluated()) {
@@ -526,7 +826,7 @@ inline constexpr void gk::internal::HashPairOnHeap<Key, Value>::insert(Key&& inK
 		pair->hashCode = inHashCode;
 	}
 	else {
-		pair = allocator->mallocObject<Pair>().ok();
+		pair = allocator->template mallocObject<Pair>().ok();
 		new (&pair->key) Key(std::move(inKey));
 		new (&pair->value) Value(std::move(inValue));
 		pair->hashCode = inHashCode;
@@ -572,7 +872,8 @@ inline constexpr gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::~Hash
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::defaultInit(AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::defaultInit(AllocatorT* allocator)
 {
 	check_eq(pairs, nullptr);
 
@@ -587,7 +888,7 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 	else {
 		constexpr usize INITIAL_ALLOCATION_SIZE = calculateHashMapGroupRuntimeAllocationSize<PairT>(GROUP_ALLOC_SIZE);
 
-		i8* memory = allocator->mallocAlignedBuffer<i8>(INITIAL_ALLOCATION_SIZE, ALLOC_ALIGNMENT).ok();
+		i8* memory = allocator->template mallocAlignedBuffer<i8>(INITIAL_ALLOCATION_SIZE, ALLOC_ALIGNMENT).ok();
 		memset(memory, 0, INITIAL_ALLOCATION_SIZE);
 
 		hashMasks = memory;
@@ -597,12 +898,13 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::free(AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::free(AllocatorT* allocator)
 {
 	if (std::is_constant_evaluated()) {
 		for (usize i = 0; i < capacity; i++) {
 			if (hashMasks[i] == 0) continue;
-			pairs[i].erase(nullptr);
+			pairs[i].erase(allocator);
 		}
 		delete[] hashMasks;
 		delete[] pairs;
@@ -611,6 +913,10 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 		return;
 	}
 
+	if (hashMasks == nullptr) {
+		return; // never inserted into
+	}
+
 	for (usize i = 0; i < capacity; i++) {
 		if (hashMasks[i] != 0) {
 			pairs[i].erase(allocator);
@@ -618,13 +924,14 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 	}
 
 	const usize currentAllocationSize = calculateHashMapGroupRuntimeAllocationSize<PairT>(capacity);
-	allocator->freeAlignedBuffer<i8>(hashMasks, currentAllocationSize, ALLOC_ALIGNMENT);
+	allocator->template freeAlignedBuffer<i8>(hashMasks, currentAllocationSize, ALLOC_ALIGNMENT);
 	pairs = nullptr;
 	check_eq(hashMasks, nullptr);
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::find(const Key& key, usize hashCode)
+template<typename LookupKey>
+inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::find(const LookupKey& key, usize hashCode)
 {
 	Option<usize> index = findIndexOfKey(key, hashCode);
 	if (index.none()) {
@@ -634,7 +941,8 @@ inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr gk::Option<const Value*> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::find(const Key& key, usize hashCode) const
+template<typename LookupKey>
+inline constexpr gk::Option<const Value*> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::find(const LookupKey& key, usize hashCode) const
 {
 	Option<usize> index = findIndexOfKey(key, hashCode);
 	if (index.none()) {
@@ -644,7 +952,8 @@ inline constexpr gk::Option<const Value*> gk::internal::HashMapGroup<Key, Value,
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::insert(Key&& key, Value&& value, usize hashCode, AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::insert(Key&& key, Value&& value, usize hashCode, AllocatorT* allocator)
 {
 	Option<Value*> existingValue = /*((gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>*)this)->*/
 		find(key, hashCode);
@@ -653,7 +962,10 @@ inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP
 		return existingValue;
 	}
 
-	if (pairCount == capacity) {
+	if (capacity == 0) {
+		defaultInit(allocator);
+	}
+	else if (pairCount == capacity) {
 		reallocate(capacity * 2, allocator);
 	}
 
@@ -665,7 +977,8 @@ inline constexpr gk::Option<Value*> gk::internal::HashMapGroup<Key, Value, GROUP
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr bool gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::erase(const Key& key, usize hashCode, AllocatorRef* allocator)
+template<typename LookupKey, typename AllocatorT>
+inline constexpr bool gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::erase(const LookupKey& key, usize hashCode, AllocatorT* allocator)
 {
 	Option<usize> foundIndex = findIndexOfKey(key, hashCode);
 	if (foundIndex.none()) {
@@ -680,7 +993,8 @@ inline constexpr bool gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKey(const Key& key, usize hashCode) const
+template<typename LookupKey>
+inline constexpr gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKey(const LookupKey& key, usize hashCode) const
 {
 	if (!std::is_constant_evaluated()) {
 		return findIndexOfKeyRuntime(key, hashCode);
@@ -689,7 +1003,7 @@ inline constexpr gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GR
 	const internal::HashMapPairBitmask hashBitmask = hashCode;
 	for (usize i = 0; i < capacity; i++) {
 		if (hashMasks[i] == hashBitmask.value) {
-			if (*pairs[i].getKey() == key) {
+			if (hashKeysEqual(*pairs[i].getKey(), key)) {
 				return Option<usize>(i);
 			}
 		}
@@ -698,7 +1012,8 @@ inline constexpr gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GR
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime(const Key& key, usize hashCode) const
+template<typename LookupKey>
+inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime(const LookupKey& key, usize hashCode) const
 {
 	if constexpr (GROUP_ALLOC_SIZE == 16) {
 		return findIndexOfKeyRuntime16(key, hashCode);
@@ -712,7 +1027,8 @@ inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime16(const Key& key, usize hashCode) const
+template<typename LookupKey>
+inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime16(const LookupKey& key, usize hashCode) const
 {
 	const usize iterationCount = capacity / 16;
 
@@ -724,7 +1040,7 @@ inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_
 
 			const usize index = indexOption.someCopy() + (i * 16);
 
-			if (*pairs[index].getKey() == key) {
+			if (hashKeysEqual(*pairs[index].getKey(), key)) {
 				return Option<usize>(index);
 			}
 		}
@@ -733,7 +1049,8 @@ inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime32(const Key& key, usize hashCode) const
+template<typename LookupKey>
+inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime32(const LookupKey& key, usize hashCode) const
 {
 	const usize iterationCount = capacity / 32;
 
@@ -745,7 +1062,7 @@ inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_
 
 			const usize index = indexOption.someCopy() + (i * 32);
 
-			if (*pairs[index].getKey() == key) {
+			if (hashKeysEqual(*pairs[index].getKey(), key)) {
 				return Option<usize>(index);
 			}
 		}
@@ -754,7 +1071,8 @@ inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime64(const Key& key, usize hashCode) const
+template<typename LookupKey>
+inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::findIndexOfKeyRuntime64(const LookupKey& key, usize hashCode) const
 {
 	const usize iterationCount = capacity / 64;
 
@@ -766,7 +1084,7 @@ inline gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_
 
 			const usize index = indexOption.someCopy() + (i * 64);
 
-			if (*pairs[index].getKey() == key) {
+			if (hashKeysEqual(*pairs[index].getKey(), key)) {
 				return Option<usize>(index);
 			}
 		}
@@ -799,7 +1117,8 @@ inline constexpr gk::Option<gk::usize> gk::internal::HashMapGroup<Key, Value, GR
 }
 
 template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::reallocate(usize newCapacity, AllocatorRef* allocator)
+template<typename AllocatorT>
+inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::reallocate(usize newCapacity, AllocatorT* allocator)
 {
 	check_eq((newCapacity % 16), 0);
 	if (newCapacity < capacity) {
@@ -838,7 +1157,21 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 	else {
 		const usize allocationSize = calculateHashMapGroupRuntimeAllocationSize<PairT>(newCapacity);
 
-		i8* memory = allocator->mallocAlignedBuffer<i8>(allocationSize, ALLOC_ALIGNMENT).ok();
+		if constexpr (std::is_trivially_copyable_v<PairT>) {
+			const usize currentAllocationSize = calculateHashMapGroupRuntimeAllocationSize<PairT>(capacity);
+			if (hashMasks != nullptr && allocator->template tryResizeAlignedBuffer<i8>(hashMasks, currentAllocationSize, allocationSize, ALLOC_ALIGNMENT)) {
+				// The pairs sit directly after the hash masks, so shift them up to make room for the new masks.
+				PairT* newPairs = reinterpret_cast<PairT*>(hashMasks + newCapacity);
+				memmove((void*)newPairs, (const void*)pairs, sizeof(PairT) * capacity);
+				memset(hashMasks + capacity, 0, newCapacity - capacity);
+				memset((void*)(newPairs + capacity), 0, sizeof(PairT) * (newCapacity - capacity));
+				pairs = newPairs;
+				capacity = newCapacity;
+				return;
+			}
+		}
+
+		i8* memory = allocator->template mallocAlignedBuffer<i8>(allocationSize, ALLOC_ALIGNMENT).ok();
 		memset(memory, 0, allocationSize);
 
 		i8* newHashMasks = memory;
@@ -854,7 +1187,7 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 		}
 
 		const usize currentAllocationSize = calculateHashMapGroupRuntimeAllocationSize<PairT>(capacity);
-		allocator->freeAlignedBuffer<i8>(hashMasks, currentAllocationSize, ALLOC_ALIGNMENT);
+		allocator->template freeAlignedBuffer<i8>(hashMasks, currentAllocationSize, ALLOC_ALIGNMENT);
 		pairs = nullptr;
 		check_eq(hashMasks, nullptr);
 
@@ -864,39 +1197,55 @@ inline constexpr void gk::internal::HashMapGroup<Key, Value, GROUP_ALLOC_SIZE>::
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::hashKey(const Key& key)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::hashKey(const Key& key)
 {
 	if constexpr (!std::is_pointer<Key>::value) {
-		return gk::hash<Key>(key);
+		return Mixer::mix(gk::hash<Key>(key));
 	}
 	else {
 		if (std::is_constant_evaluated()) {
 			throw std::invalid_argument("Cannot use pointer type for HashMap Key in constexpr contexts");
 		}
 		const usize ptrAsNum = reinterpret_cast<usize>(key);
-		return ptrAsNum;
+		return Mixer::mix(ptrAsNum);
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::HashMap()
-	: _groups(nullptr), _groupCount(0), _elementCount(0)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::pairHashCode(const typename GroupT::PairT& pair)
 {
-	if (!std::is_constant_evaluated()) {
-		new (&_allocator) AllocatorRef(globalHeapAllocatorRef());
+	if constexpr (std::is_same_v<typename GroupT::PairT, internal::HashPairInPlace<Key, Value>>) {
+		return hashKey(*pair.getKey());
+	}
+	else {
+		return pair.hashCode();
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::HashMap(const HashMap& other)
-	: _groups(nullptr), _groupCount(0), _elementCount(0)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::HashMap()
+	: _groups(nullptr), _groupCount(0), _elementCount(0), _oldGroups(nullptr), _oldGroupCount(0), _movedGroupCount(0), _incrementalRehash(false)
 {
-	if (!std::is_constant_evaluated()) {
-		new (&_allocator) AllocatorRef(globalHeapAllocatorRef());
+	if constexpr (!StaticAllocator<Allocator>) {
+		if (!std::is_constant_evaluated()) {
+			new (&_allocator) AllocatorRef(globalHeapAllocatorRef());
+		}
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::HashMap(const HashMap& other)
+	: _groups(nullptr), _groupCount(0), _elementCount(0), _oldGroups(nullptr), _oldGroupCount(0), _movedGroupCount(0), _incrementalRehash(other._incrementalRehash)
+{
+	if constexpr (!StaticAllocator<Allocator>) {
+		if (!std::is_constant_evaluated()) {
+			new (&_allocator) AllocatorRef(globalHeapAllocatorRef());
+		}
 	}
 	if (other._groupCount == 0) {
 		return;
@@ -905,318 +1254,388 @@ inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::HashMap(const HashMa
 	reallocate(other._elementCount);
 
 	for (usize i = 0; i < other._groupCount; i++) {
-		const GroupT& otherGroup = other._groups[i];
-
-		for (usize groupPairIter = 0; groupPairIter < otherGroup.capacity; groupPairIter++) {
-			if (otherGroup.hashMasks[groupPairIter] == 0) {
-				continue;
-			}
-
-			typename GroupT::PairT& pair = otherGroup.pairs[groupPairIter];
-
-			const usize hashCode = pair.hashCode();
-			const Key* key = pair.getKey();
-			const Value* value = pair.getValue();
-
-			const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
-			const usize groupIndex = groupBitmask.value % _groupCount;
-			GroupT& group = _groups[groupIndex];
-			group.insert(Key(*key), Value(*value), hashCode, &_allocator);
-			_elementCount++;
+		copyGroupEntries(other._groups[i]);
+	}
+	if (other._oldGroups != nullptr) {
+		for (usize i = other._movedGroupCount; i < other._oldGroupCount; i++) {
+			copyGroupEntries(other._oldGroups[i]);
 		}
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::HashMap(HashMap&& other) noexcept
-	: _groups(other._groups), _groupCount(other._groupCount), _elementCount(other._elementCount), _allocator(std::move(other._allocator))
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::HashMap(HashMap&& other) noexcept
+	: _groups(other._groups), _groupCount(other._groupCount), _elementCount(other._elementCount),
+	_oldGroups(other._oldGroups), _oldGroupCount(other._oldGroupCount), _movedGroupCount(other._movedGroupCount),
+	_incrementalRehash(other._incrementalRehash), _allocator(std::move(other._allocator))
 {
 	other._groups = nullptr;
+	other._groupCount = 0;
+	other._elementCount = 0;
+	other._oldGroups = nullptr;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::~HashMap()
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::~HashMap()
 {
-	if (_groups == nullptr) return;
-
-	for (usize i = 0; i < _groupCount; i++) {
-		_groups[i].free(&_allocator);
-	}
-	if (std::is_constant_evaluated()) {
-		delete[] _groups;
-	}
-	else {
-		_allocator.freeBuffer<GroupT>(_groups, _groupCount);
-	}
+	freeGroups();
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::operator=(const HashMap& other)
-{
-	if (_groups != nullptr) {
-		for (usize i = 0; i < _groupCount; i++) {
-			GroupT& group = _groups[i];
-			for (usize pairIter = 0; pairIter < group.capacity; pairIter++) {
-				if (group.hashMasks[pairIter] != 0) {
-					group.pairs[i].erase(&_allocator);
-					group.hashMasks[i] = 0;
-				}
-			}
-		}
-		if (other._elementCount == 0) {
-			for (usize i = 0; i < _groupCount; i++) {
-				_groups[i].free(&_allocator);
-			}
-			if (std::is_constant_evaluated()) {
-				delete[] _groups;
-			}
-			else {
-				_allocator.freeBuffer<GroupT>(_groups, _groupCount);
-			}
-			return *this;
-		}
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::operator=(const HashMap& other)
+{
+	if (this == &other) {
+		return *this;
 	}
+
+	freeGroups();
+	_groups = nullptr;
+	_groupCount = 0;
 	_elementCount = 0;
 
-	if (shouldReallocate(other._elementCount)) {
-		reallocate(other._elementCount);
+	if (other._elementCount == 0) {
+		return *this;
 	}
 
-	for (usize i = 0; i < other._groupCount; i++) {
-		const GroupT& otherGroup = other._groups[i];
-
-		for (usize groupPairIter = 0; groupPairIter < otherGroup.capacity; groupPairIter++) {
-			if (otherGroup.hashMasks[groupPairIter] == 0) {
-				continue;
-			}
-
-			typename GroupT::PairT& pair = otherGroup.pairs[groupPairIter];
-
-			const usize hashCode = pair.hashCode();
-			const Key* key = pair.getKey();
-			const Value* value = pair.getValue();
+	reallocate(other._elementCount);
 
-			const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
-			const usize groupIndex = groupBitmask.value % _groupCount;
-			GroupT& group = _groups[groupIndex];
-			group.insert(Key(*key), Value(*value), hashCode, &_allocator);
-			_elementCount++;
+	for (usize i = 0; i < other._groupCount; i++) {
+		copyGroupEntries(other._groups[i]);
+	}
+	if (other._oldGroups != nullptr) {
+		for (usize i = other._movedGroupCount; i < other._oldGroupCount; i++) {
+			copyGroupEntries(other._oldGroups[i]);
 		}
 	}
 	return *this;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::operator=(HashMap&& other) noexcept
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::operator=(HashMap&& other) noexcept
 {
-	if (_groups != nullptr) {
-		for (usize i = 0; i < _groupCount; i++) {
-			_groups[i].free(&_allocator);
-		}
-		if (std::is_constant_evaluated()) {
-			delete[] _groups;
-		}
-		else {
-			_allocator.freeBuffer<GroupT>(_groups, _groupCount);
-		}
+	if (this == &other) {
+		return *this;
 	}
 
+	freeGroups();
+
 	_groups = other._groups;
 	_groupCount = other._groupCount;
 	_elementCount = other._elementCount;
+	_oldGroups = other._oldGroups;
+	_oldGroupCount = other._oldGroupCount;
+	_movedGroupCount = other._movedGroupCount;
+	_incrementalRehash = other._incrementalRehash;
 	_allocator = std::move(other._allocator);
 	other._groups = nullptr;
+	other._groupCount = 0;
+	other._elementCount = 0;
+	other._oldGroups = nullptr;
 	return *this;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::find(const Key& key)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename LookupKey>
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::findImpl(const LookupKey& key, usize hashCode)
 {
-	if (_elementCount == 0) {
-		return Option<Value*>();
-	}
-
-	const usize hashCode = hashKey(key);
+	check_ne(_groupCount, 0);
 	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
 	const usize groupIndex = groupBitmask.value % _groupCount;
 
 	GroupT& group = _groups[groupIndex];
-	return group.find(key, hashCode);
+	Option<Value*> found = group.find(key, hashCode);
+	if (found.none()) {
+		if (GroupT* oldGroup = unmovedOldGroup(hashCode)) {
+			return oldGroup->find(key, hashCode);
+		}
+	}
+	return found;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::Option<const Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::find(const Key& key) const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename LookupKey>
+inline constexpr gk::Option<const Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::findImpl(const LookupKey& key, usize hashCode) const
 {
-	if (_elementCount == 0) {
-		return Option<const Value*>();
-	}
-
-	const usize hashCode = hashKey(key);
+	check_ne(_groupCount, 0);
 	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
 	const usize groupIndex = groupBitmask.value % _groupCount;
 
 	const GroupT& group = _groups[groupIndex];
-	return group.find(key, hashCode);
+	Option<const Value*> found = group.find(key, hashCode);
+	if (found.none()) {
+		if (const GroupT* oldGroup = unmovedOldGroup(hashCode)) {
+			return oldGroup->find(key, hashCode);
+		}
+	}
+	return found;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::insert(Key&& key, Value&& value)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename LookupKey>
+inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::eraseImpl(const LookupKey& key, usize hashCode)
 {
-	const usize hashCode = hashKey(key);
+	check_ne(_groupCount, 0);
+	rehashStep();
 	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
+	const usize groupIndex = groupBitmask.value % _groupCount;
 
-	if (_elementCount != 0) {
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		Option<Value*> foundValue = group.insert(std::move(key), std::move(value), hashCode, &_allocator);
-		if (foundValue.isSome()) {
-			return foundValue; // already exists
-		}
-		else {
-			_elementCount++;
-			return Option<Value*>();
+	GroupT& group = _groups[groupIndex];
+	if (!group.erase(key, hashCode, &_allocator)) {
+		GroupT* oldGroup = unmovedOldGroup(hashCode);
+		if (oldGroup == nullptr || !oldGroup->erase(key, hashCode, &_allocator)) {
+			return false;
 		}
 	}
+	_elementCount--;
+	return true;
+}
 
-	if (shouldReallocate(_elementCount + 1)) {
-		reallocate(_elementCount + 1); // reallocate handles allocating extra space
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::find(const Key& key)
+{
+	if (_elementCount == 0) {
+		return Option<Value*>();
 	}
+	return findImpl(key, hashKey(key));
+}
 
-	{
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		group.insert(std::move(key), std::move(value), hashCode, &_allocator);
-		_elementCount++;
-		return Option<Value*>();
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<const Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::find(const Key& key) const
+{
+	if (_elementCount == 0) {
+		return Option<const Value*>();
 	}
+	return findImpl(key, hashKey(key));
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::insert(const Key& key, Value&& value)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::find(const Lookup& key)
 {
-	const usize hashCode = hashKey(key);
-	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
+	if (_elementCount == 0) {
+		return Option<Value*>();
+	}
+	return findImpl(key, hashLookup(key));
+}
 
-	if (_elementCount != 0) {
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		Option<Value*> foundValue = group.insert(Key(key), std::move(value), hashCode, &_allocator);
-		if (foundValue.isSome()) {
-			return foundValue; // already exists
-		}
-		else {
-			_elementCount++;
-			return Option<Value*>();
-		}
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline constexpr gk::Option<const Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::find(const Lookup& key) const
+{
+	if (_elementCount == 0) {
+		return Option<const Value*>();
 	}
+	return findImpl(key, hashLookup(key));
+}
 
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::insert(Key&& key, Value&& value)
+{
+	const usize hashCode = hashKey(key);
 	if (shouldReallocate(_elementCount + 1)) {
 		reallocate(_elementCount + 1); // reallocate handles allocating extra space
 	}
+	return insertWithHashCode(std::move(key), std::move(value), hashCode);
+}
 
-	{
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		group.insert(Key(key), std::move(value), hashCode, &_allocator);
-		_elementCount++;
-		return Option<Value*>();
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::insert(const Key& key, Value&& value)
+{
+	const usize hashCode = hashKey(key);
+	if (shouldReallocate(_elementCount + 1)) {
+		reallocate(_elementCount + 1); // reallocate handles allocating extra space
 	}
+	return insertWithHashCode(Key(key), std::move(value), hashCode);
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::insert(Key&& key, const Value& value)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::insert(Key&& key, const Value& value)
 {
 	const usize hashCode = hashKey(key);
-	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
-
-	if (_elementCount != 0) {
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		Option<Value*> foundValue = group.insert(std::move(key), Value(value), hashCode, &_allocator);
-		if (foundValue.isSome()) {
-			return foundValue; // already exists
-		}
-		else {
-			_elementCount++;
-			return Option<Value*>();
-		}
+	if (shouldReallocate(_elementCount + 1)) {
+		reallocate(_elementCount + 1); // reallocate handles allocating extra space
 	}
+	return insertWithHashCode(std::move(key), Value(value), hashCode);
+}
 
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::insert(const Key& key, const Value& value)
+{
+	const usize hashCode = hashKey(key);
 	if (shouldReallocate(_elementCount + 1)) {
 		reallocate(_elementCount + 1); // reallocate handles allocating extra space
 	}
+	return insertWithHashCode(Key(key), Value(value), hashCode);
+}
 
-	{
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		group.insert(std::move(key), Value(value), hashCode, &_allocator);
-		_elementCount++;
-		return Option<Value*>();
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::erase(const Key& key)
+{
+	if (_elementCount == 0) {
+		return false;
 	}
+	return eraseImpl(key, hashKey(key));
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::insert(const Key& key, const Value& value)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename Lookup>
+	requires gk::HashLookupFor<Lookup, Key>
+inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::erase(const Lookup& key)
 {
-	const usize hashCode = hashKey(key);
-	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
+	if (_elementCount == 0) {
+		return false;
+	}
+	return eraseImpl(key, hashLookup(key));
+}
 
-	if (_elementCount != 0) {
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		Option<Value*> foundValue = group.insert(Key(key), Value(value), hashCode, &_allocator);
-		if (foundValue.isSome()) {
-			return foundValue; // already exists
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::findMany(const Key* keys, usize count, Option<Value*>* out)
+{
+	// While rehashing, a key may be in either of two groups, so prefetching only it's new group would not help.
+	if (_elementCount == 0 || isRehashing() || std::is_constant_evaluated()) {
+		for (usize i = 0; i < count; i++) {
+			out[i] = find(keys[i]);
 		}
-		else {
-			_elementCount++;
-			return Option<Value*>();
+		return;
+	}
+
+	usize hashCodes[internal::HASH_MAP_BATCH_SIZE];
+	usize groupIndices[internal::HASH_MAP_BATCH_SIZE];
+	for (usize batchStart = 0; batchStart < count; batchStart += internal::HASH_MAP_BATCH_SIZE) {
+		const usize remaining = count - batchStart;
+		const usize batchCount = remaining < internal::HASH_MAP_BATCH_SIZE ? remaining : internal::HASH_MAP_BATCH_SIZE;
+		prefetchBatch(keys + batchStart, batchCount, hashCodes, groupIndices);
+		for (usize i = 0; i < batchCount; i++) {
+			out[batchStart + i] = _groups[groupIndices[i]].find(keys[batchStart + i], hashCodes[i]);
 		}
 	}
+}
 
-	if (shouldReallocate(_elementCount + 1)) {
-		reallocate(_elementCount + 1); // reallocate handles allocating extra space
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::findMany(const Key* keys, usize count, Option<const Value*>* out) const
+{
+	if (_elementCount == 0 || isRehashing() || std::is_constant_evaluated()) {
+		for (usize i = 0; i < count; i++) {
+			out[i] = find(keys[i]);
+		}
+		return;
 	}
 
-	{
-		const usize groupIndex = groupBitmask.value % _groupCount;
-		GroupT& group = _groups[groupIndex];
-		group.insert(Key(key), Value(value), hashCode, &_allocator);
-		_elementCount++;
-		return Option<Value*>();
+	usize hashCodes[internal::HASH_MAP_BATCH_SIZE];
+	usize groupIndices[internal::HASH_MAP_BATCH_SIZE];
+	for (usize batchStart = 0; batchStart < count; batchStart += internal::HASH_MAP_BATCH_SIZE) {
+		const usize remaining = count - batchStart;
+		const usize batchCount = remaining < internal::HASH_MAP_BATCH_SIZE ? remaining : internal::HASH_MAP_BATCH_SIZE;
+		prefetchBatch(keys + batchStart, batchCount, hashCodes, groupIndices);
+		for (usize i = 0; i < batchCount; i++) {
+			const GroupT& group = _groups[groupIndices[i]];
+			out[batchStart + i] = group.find(keys[batchStart + i], hashCodes[i]);
+		}
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::erase(const Key& key)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::insertMany(const Key* keys, const Value* values, usize count)
 {
-	if (_elementCount == 0) {
-		return false;
+	if (count == 0) {
+		return 0;
+	}
+
+	const usize oldElementCount = _elementCount;
+	reserve(count);
+
+	if (std::is_constant_evaluated()) {
+		for (usize i = 0; i < count; i++) {
+			insert(keys[i], values[i]);
+		}
+		return _elementCount - oldElementCount;
+	}
+
+	usize hashCodes[internal::HASH_MAP_BATCH_SIZE];
+	usize groupIndices[internal::HASH_MAP_BATCH_SIZE];
+	for (usize batchStart = 0; batchStart < count; batchStart += internal::HASH_MAP_BATCH_SIZE) {
+		const usize remaining = count - batchStart;
+		const usize batchCount = remaining < internal::HASH_MAP_BATCH_SIZE ? remaining : internal::HASH_MAP_BATCH_SIZE;
+		prefetchBatch(keys + batchStart, batchCount, hashCodes, groupIndices);
+		for (usize i = 0; i < batchCount; i++) {
+			insertWithHashCode(Key(keys[batchStart + i]), Value(values[batchStart + i]), hashCodes[i]);
+		}
+	}
+	return _elementCount - oldElementCount;
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::Option<Value*> gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::insertWithHashCode(Key&& key, Value&& value, usize hashCode)
+{
+	check_ne(_groupCount, 0);
+	rehashStep();
+	if (GroupT* oldGroup = unmovedOldGroup(hashCode)) {
+		Option<Value*> existingValue = oldGroup->find(key, hashCode);
+		if (existingValue.isSome()) {
+			return existingValue;
+		}
 	}
 
-	const usize hashCode = hashKey(key);
 	const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
 	const usize groupIndex = groupBitmask.value % _groupCount;
-
 	GroupT& group = _groups[groupIndex];
-	_elementCount--;
-	return group.erase(key, hashCode, &_allocator);
+	Option<Value*> foundValue = group.insert(std::move(key), std::move(value), hashCode, &_allocator);
+	if (foundValue.isSome()) {
+		return foundValue; // already exists
+	}
+	_elementCount++;
+	return Option<Value*>();
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::reserve(usize additional)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::prefetchBatch(const Key* keys, usize count, usize* hashCodesOut, usize* groupIndicesOut) const
+{
+	check_ne(_groupCount, 0);
+	check_le(count, internal::HASH_MAP_BATCH_SIZE);
+
+	// The group itself holds the pointers to its hash masks and pairs, so it has to arrive first.
+	for (usize i = 0; i < count; i++) {
+		const usize hashCode = hashKey(keys[i]);
+		const usize groupIndex = internal::HashMapGroupBitmask(hashCode).value % _groupCount;
+		hashCodesOut[i] = hashCode;
+		groupIndicesOut[i] = groupIndex;
+		_mm_prefetch(reinterpret_cast<const char*>(&_groups[groupIndex]), _MM_HINT_T0);
+	}
+
+	for (usize i = 0; i < count; i++) {
+		const GroupT& group = _groups[groupIndicesOut[i]];
+		_mm_prefetch(reinterpret_cast<const char*>(group.hashMasks), _MM_HINT_T0);
+		_mm_prefetch(reinterpret_cast<const char*>(group.pairs), _MM_HINT_T0);
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::reserve(usize additional)
 {
 	const usize requiredCapacity = _elementCount + additional;
 	if (shouldReallocate(requiredCapacity)) {
@@ -1224,37 +1643,37 @@ inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::reserve(usize a
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::begin()
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::begin()
 {
 	return Iterator::iterBegin(this);
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::end()
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::end()
 {
 	return Iterator::iterEnd(this);
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::begin() const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::begin() const
 {
 	return ConstIterator::iterBegin(this);
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::end() const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::end() const
 {
 	return ConstIterator::iterEnd(this);
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::calculateNewGroupCount(usize requiredCapacity)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::calculateNewGroupCount(usize requiredCapacity)
 {
 	if (requiredCapacity <= GROUP_ALLOC_SIZE) {
 		return 1;
@@ -1266,9 +1685,9 @@ inline constexpr gk::usize gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::calculateN
 	}
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::shouldReallocate(usize requiredCapacity) const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::shouldReallocate(usize requiredCapacity) const
 {
 	if (_groupCount == 0) {
 		return true;
@@ -1277,100 +1696,279 @@ inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::shouldReallocat
 	return requiredCapacity > loadFactorScaledPairCount;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::reallocate(usize requiredCapacity)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::reallocate(usize requiredCapacity)
 {
 	const usize newGroupCount = calculateNewGroupCount(requiredCapacity);
 	if (newGroupCount <= _groupCount) {
 		return;
 	}
 
+	// Only one rehash can be in progress at a time.
+	finishRehash();
+
+	// Groups only allocate their pairs once something is inserted into them.
 	GroupT* newGroupCollection = [&]() {
 		if (std::is_constant_evaluated()) {
-			GroupT* newGroups = new GroupT[newGroupCount];
-			for (usize i = 0; i < newGroupCount; i++) {
-				newGroups[i].defaultInit(nullptr);
-			}
-			return newGroups;
+			return new GroupT[newGroupCount];
 		}
 		else {
-			GroupT* memory = _allocator.mallocBuffer<GroupT>(newGroupCount).ok();
+			GroupT* memory = _allocator.template mallocBuffer<GroupT>(newGroupCount).ok();
 			for (usize i = 0; i < newGroupCount; i++) {
 				new (memory + i) GroupT();
-				memory[i].defaultInit(&_allocator);
 			}
 			return memory;
 		}
 	}();
 
-	// Loop through the old buckets, and move their data to the new buckets
+	GroupT* oldGroups = _groups;
+	const usize oldGroupCount = _groupCount;
+	_groups = newGroupCollection;
+	_groupCount = newGroupCount;
+
+	if (oldGroups == nullptr) {
+		return;
+	}
+
+	if (_incrementalRehash && !std::is_constant_evaluated()) {
+		_oldGroups = oldGroups;
+		_oldGroupCount = oldGroupCount;
+		_movedGroupCount = 0;
+		return;
+	}
+
+	for (usize oldGroupIndex = 0; oldGroupIndex < oldGroupCount; oldGroupIndex++) {
+		moveGroupEntries(oldGroups[oldGroupIndex]);
+	}
+	if (std::is_constant_evaluated()) {
+		delete[] oldGroups;
+	}
+	else {
+		_allocator.template freeBuffer<GroupT>(oldGroups, oldGroupCount);
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr typename gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::GroupT* gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::unmovedOldGroup(usize hashCode) const
+{
+	if (_oldGroups == nullptr) {
+		return nullptr;
+	}
+	const usize oldGroupIndex = internal::HashMapGroupBitmask(hashCode).value % _oldGroupCount;
+	if (oldGroupIndex < _movedGroupCount) {
+		return nullptr;
+	}
+	return _oldGroups + oldGroupIndex;
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::moveGroupEntries(GroupT& oldGroup)
+{
 	// For non-in-place stored pairs, their hash code is already stored.
 	// For in-place stored pairs, their hash codes need to be recalculated, 
 	// but it should be very cheap for those types
-	for (usize oldGroupIndex = 0; oldGroupIndex < _groupCount; oldGroupIndex++) {
-		GroupT& oldGroup = _groups[oldGroupIndex];
-		for (usize i = 0; i < oldGroup.capacity; i++) {
-			if (oldGroup.hashMasks[i] == 0) {
-				continue;
-			}
+	for (usize i = 0; i < oldGroup.capacity; i++) {
+		if (oldGroup.hashMasks[i] == 0) {
+			continue;
+		}
 
-			typename GroupT::PairT& pair = oldGroup.pairs[i];
+		typename GroupT::PairT& pair = oldGroup.pairs[i];
 
-			const usize hashCode = pair.hashCode();
-			const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
-			const usize newGroupIndex = groupBitmask.value % newGroupCount;
+		const usize hashCode = pairHashCode(pair);
+		const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
+		const usize newGroupIndex = groupBitmask.value % _groupCount;
 
-			GroupT& newGroup = newGroupCollection[newGroupIndex];
-			if (newGroup.pairCount == newGroup.capacity) {
-				newGroup.reallocate(newGroup.capacity * 2, &_allocator);
-			}
-			check_lt(newGroup.pairCount, newGroup.capacity);
+		GroupT& newGroup = _groups[newGroupIndex];
+		if (newGroup.capacity == 0) {
+			newGroup.defaultInit(&_allocator);
+		}
+		else if (newGroup.pairCount == newGroup.capacity) {
+			newGroup.reallocate(newGroup.capacity * 2, &_allocator);
+		}
+		check_lt(newGroup.pairCount, newGroup.capacity);
 
-			newGroup.hashMasks[newGroup.pairCount] = oldGroup.hashMasks[i];
-			if (std::is_constant_evaluated()) {
-				newGroup.pairs[newGroup.pairCount] = std::move(pair);
-			}
-			else {
-				new (newGroup.pairs + newGroup.pairCount) typename GroupT::PairT(std::move(pair));
-			}
+		// While incrementally rehashing, the new group may have had entries erased out of the middle of it.
+		const usize newIndex = newGroup.firstAvailableGroupSlot().some();
+		newGroup.hashMasks[newIndex] = oldGroup.hashMasks[i];
+		if (std::is_constant_evaluated()) {
+			newGroup.pairs[newIndex] = std::move(pair);
+		}
+		else {
+			new (newGroup.pairs + newIndex) typename GroupT::PairT(std::move(pair));
+		}
+
+		newGroup.pairCount++;
+		oldGroup.hashMasks[i] = 0;
+	}
+	oldGroup.free(&_allocator);
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::rehashStep()
+{
+	if (_oldGroups == nullptr) {
+		return;
+	}
+
+	const usize remaining = _oldGroupCount - _movedGroupCount;
+	const usize stepCount = remaining < internal::HASH_MAP_REHASH_GROUPS_PER_STEP ? remaining : internal::HASH_MAP_REHASH_GROUPS_PER_STEP;
+	for (usize i = 0; i < stepCount; i++) {
+		moveGroupEntries(_oldGroups[_movedGroupCount]);
+		_movedGroupCount++;
+	}
+
+	if (_movedGroupCount == _oldGroupCount) {
+		_allocator.template freeBuffer<GroupT>(_oldGroups, _oldGroupCount);
+		_oldGroups = nullptr;
+		_oldGroupCount = 0;
+		_movedGroupCount = 0;
+	}
+}
 
-			newGroup.pairCount++;
-			oldGroup.hashMasks[i] = 0;
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::finishRehash()
+{
+	while (_oldGroups != nullptr) {
+		rehashStep();
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::freeGroups()
+{
+	if (_oldGroups != nullptr) {
+		for (usize i = _movedGroupCount; i < _oldGroupCount; i++) {
+			_oldGroups[i].free(&_allocator);
 		}
-		oldGroup.free(&_allocator);
+		_allocator.template freeBuffer<GroupT>(_oldGroups, _oldGroupCount);
+		_oldGroups = nullptr;
+		_oldGroupCount = 0;
+		_movedGroupCount = 0;
 	}
-	if (_groups) {
-		if (std::is_constant_evaluated()) {
-			delete[] _groups;
+
+	if (_groups == nullptr) return;
+
+	for (usize i = 0; i < _groupCount; i++) {
+		_groups[i].free(&_allocator);
+	}
+	if (std::is_constant_evaluated()) {
+		delete[] _groups;
+	}
+	else {
+		_allocator.template freeBuffer<GroupT>(_groups, _groupCount);
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::copyGroupEntries(const GroupT& otherGroup)
+{
+	for (usize groupPairIter = 0; groupPairIter < otherGroup.capacity; groupPairIter++) {
+		if (otherGroup.hashMasks[groupPairIter] == 0) {
+			continue;
 		}
-		else {
-			_allocator.freeBuffer<GroupT>(_groups, _groupCount);
+
+		typename GroupT::PairT& pair = otherGroup.pairs[groupPairIter];
+
+		const usize hashCode = pairHashCode(pair);
+		const Key* key = pair.getKey();
+		const Value* value = pair.getValue();
+
+		const internal::HashMapGroupBitmask groupBitmask = internal::HashMapGroupBitmask(hashCode);
+		const usize groupIndex = groupBitmask.value % _groupCount;
+		GroupT& group = _groups[groupIndex];
+		group.insert(Key(*key), Value(*value), hashCode, &_allocator);
+		_elementCount++;
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::setIncrementalRehash(bool enable)
+{
+	_incrementalRehash = enable;
+	if (!enable) {
+		finishRehash();
+	}
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline gk::HashMapStats gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::stats() const
+{
+	HashMapStats out{};
+	out.elementCount = _elementCount;
+
+	const GroupT* ranges[2] = { _oldGroups != nullptr ? _oldGroups + _movedGroupCount : nullptr, _groups };
+	const usize rangeCounts[2] = { _oldGroups != nullptr ? _oldGroupCount - _movedGroupCount : 0, _groupCount };
+
+	usize largestCapacity = GROUP_ALLOC_SIZE;
+	for (usize range = 0; range < 2; range++) {
+		for (usize i = 0; i < rangeCounts[range]; i++) {
+			largestCapacity = ranges[range][i].capacity > largestCapacity ? ranges[range][i].capacity : largestCapacity;
 		}
 	}
+	out.pairCountHistogram.resize(largestCapacity + 1, 0);
 
-	_groups = newGroupCollection;
-	_groupCount = newGroupCount;
+	out.totalBytes = (_groupCount + _oldGroupCount) * sizeof(GroupT);
+	if constexpr (std::is_same_v<typename GroupT::PairT, internal::HashPairOnHeap<Key, Value>>) {
+		out.totalBytes += _elementCount * sizeof(typename GroupT::PairT::Pair);
+	}
+
+	usize scanLengthSum = 0;
+	for (usize range = 0; range < 2; range++) {
+		for (usize i = 0; i < rangeCounts[range]; i++) {
+			const GroupT& group = ranges[range][i];
+			out.groupCount++;
+			out.slotCount += group.capacity;
+			out.pairCountHistogram[group.pairCount]++;
+			if (group.capacity == 0) {
+				continue;
+			}
+			out.totalBytes += internal::calculateHashMapGroupRuntimeAllocationSize<typename GroupT::PairT>(group.capacity);
+
+			// findIndexOfKeyRuntime() compares the keys of matching tags in slot order,
+			// so the scan length of a key is how many times it's tag has been seen so far.
+			usize tagsSeen[128] = {};
+			for (usize slot = 0; slot < group.capacity; slot++) {
+				if (group.hashMasks[slot] == 0) {
+					continue;
+				}
+				const usize scanLength = ++tagsSeen[group.hashMasks[slot] & internal::HashMapPairBitmask::BITMASK];
+				scanLengthSum += scanLength;
+				out.maxScanLength = scanLength > out.maxScanLength ? scanLength : out.maxScanLength;
+			}
+		}
+	}
+
+	if (scanLengthSum != 0) {
+		out.averageScanLength = static_cast<double>(scanLengthSum) / static_cast<double>(_elementCount);
+		out.tagFalsePositiveRate = static_cast<double>(scanLengthSum - _elementCount) / static_cast<double>(scanLengthSum);
+	}
+	return out;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::iterBegin(HashMap* map)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::iterBegin(HashMap* map)
 {
 	Iterator iter;
 	iter._map = map;
-	iter._currentGroup = map->_groups;
-	if (iter._currentGroup != nullptr) {
-		if (iter._currentGroup->hashMasks[0] == 0) { // step forward if slot doesnt have an entry
-			iter.operator++();
-		}
-	}
+	// The old groups that haven't been moved yet come first, followed by the current groups.
+	iter._currentGroup = map->_oldGroups != nullptr ? map->_oldGroups + map->_movedGroupCount : map->_groups;
+	iter.skipEmptySlots();
 	return iter;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::iterEnd(HashMap* map)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::iterEnd(HashMap* map)
 {
 	Iterator iter;
 	iter._map = map;
@@ -1378,16 +1976,16 @@ inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator gk::HashMap
 	return iter;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::operator==(const Iterator& other) const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::operator==(const Iterator& other) const
 {
 	return _currentGroup == other._currentGroup && _currentElementIndex == other._currentElementIndex;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::Pair gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::operator*() const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::Pair gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::operator*() const
 {
 	auto& pair = _currentGroup->pairs[_currentElementIndex];
 	Pair out = {
@@ -1396,47 +1994,55 @@ inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::Pair gk::H
 	return out;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::Iterator::operator++()
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::operator++()
 {
-	while (true) {
-		_currentElementIndex++;
+	_currentElementIndex++;
+	skipEmptySlots();
+	return *this;
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::Iterator::skipEmptySlots()
+{
+	const auto groupsEnd = _map->_groups + _map->_groupCount;
+	while (_currentGroup != groupsEnd) {
+		// Groups that were never inserted into have no capacity.
 		if (_currentElementIndex == _currentGroup->capacity) {
 			_currentElementIndex = 0;
 			_currentGroup++;
-		}
-
-		if (_currentGroup == _map->_groups + _map->_groupCount) {
-			return *this;
+			if (_map->_oldGroups != nullptr && _currentGroup == _map->_oldGroups + _map->_oldGroupCount) {
+				_currentGroup = _map->_groups;
+			}
+			continue;
 		}
 
 		if (_currentGroup->hashMasks[_currentElementIndex] != 0) {
-			return *this;
+			return;
 		}
+		_currentElementIndex++;
 	}
 }
 
 
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::iterBegin(const HashMap* map)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::iterBegin(const HashMap* map)
 {
 	ConstIterator iter;
 	iter._map = map;
-	iter._currentGroup = map->_groups;
-	if (iter._currentGroup != nullptr) {
-		if (iter._currentGroup->hashMasks[0] == 0) { // step forward if slot doesnt have an entry
-			iter.operator++();
-		}
-	}
+	// The old groups that haven't been moved yet come first, followed by the current groups.
+	iter._currentGroup = map->_oldGroups != nullptr ? map->_oldGroups + map->_movedGroupCount : map->_groups;
+	iter.skipEmptySlots();
 	return iter;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::iterEnd(const HashMap* map)
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::iterEnd(const HashMap* map)
 {
 	ConstIterator iter;
 	iter._map = map;
@@ -1444,16 +2050,16 @@ inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator gk::Ha
 	return iter;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::operator==(const ConstIterator& other) const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr bool gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::operator==(const ConstIterator& other) const
 {
 	return _currentGroup == other._currentGroup && _currentElementIndex == other._currentElementIndex;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::Pair gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::operator*() const
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::Pair gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::operator*() const
 {
 	const auto& pair = _currentGroup->pairs[_currentElementIndex];
 	Pair out = {
@@ -1462,23 +2068,34 @@ inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::Pair
 	return out;
 }
 
-template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE>
-	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key>)
-inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE>::ConstIterator::operator++()
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator& gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::operator++()
 {
-	while (true) {
-		_currentElementIndex++;
+	_currentElementIndex++;
+	skipEmptySlots();
+	return *this;
+}
+
+template<typename Key, typename Value, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashMap<Key, Value, GROUP_ALLOC_SIZE, Allocator, Mixer>::ConstIterator::skipEmptySlots()
+{
+	const auto groupsEnd = _map->_groups + _map->_groupCount;
+	while (_currentGroup != groupsEnd) {
+		// Groups that were never inserted into have no capacity.
 		if (_currentElementIndex == _currentGroup->capacity) {
 			_currentElementIndex = 0;
 			_currentGroup++;
-		}
-
-		if (_currentGroup == _map->_groups + _map->_groupCount) {
-			return *this;
+			if (_map->_oldGroups != nullptr && _currentGroup == _map->_oldGroups + _map->_oldGroupCount) {
+				_currentGroup = _map->_groups;
+			}
+			continue;
 		}
 
 		if (_currentGroup->hashMasks[_currentElementIndex] != 0) {
-			return *this;
+			return;
 		}
+		_currentElementIndex++;
 	}
 }
@@ -0,0 +1,184 @@
+#include "hashset.h"
+
+#if GK_TYPES_LIB_TEST
+
+#include "../string/string.h"
+
+using gk::HashSet;
+using gk::ArrayList;
+using gk::usize;
+using gk::i32;
+using gk::u64;
+
+test_case("HashSet default construct") {
+	HashSet<i32> set;
+	check_eq(set.size(), 0);
+	check(!set.contains(0));
+	check(!set.erase(0));
+	check(set.begin() == set.end());
+}
+
+test_case("HashSet insert, contains, and erase ints") {
+	HashSet<u64> set;
+	for (u64 i = 0; i < 1000; i++) {
+		check(set.insert(i * 3));
+	}
+	check(!set.insert(3));
+	check_eq(set.size(), 1000);
+	for (u64 i = 0; i < 3000; i++) {
+		check_eq(set.contains(i), i % 3 == 0);
+	}
+
+	for (u64 i = 0; i < 3000; i += 6) {
+		check(set.erase(i));
+	}
+	check(!set.erase(0));
+	check_eq(set.size(), 500);
+	check(!set.contains(6));
+	check(set.contains(9));
+}
+
+test_case("HashSet stores usize keys in place") {
+	HashSet<u64> set;
+	for (u64 i = 0; i < 1000; i++) {
+		set.insert(i);
+	}
+	gk::HashMap<u64, bool> map;
+	for (u64 i = 0; i < 1000; i++) {
+		map.insert(i, true);
+	}
+	// The map allocates each of it's pairs separately, while the set stores the keys in it's groups.
+	check(set.stats().totalBytes < map.stats().totalBytes);
+}
+
+test_case("HashSet strings with Str lookup") {
+	HashSet<gk::String> set;
+	for (u64 i = 0; i < 200; i++) {
+		set.insert(gk::String::fromUint(i));
+	}
+	const char* buffer = "12345";
+	check(set.contains(gk::Str::fromSlice(buffer, 2)));
+	check(!set.contains(gk::Str::fromSlice(buffer, 4)));
+	check(set.erase(gk::Str::fromSlice(buffer + 1, 2)));
+	check(!set.contains(gk::String::fromUint(23)));
+	check_eq(set.size(), 199);
+}
+
+test_case("HashSet iterate") {
+	HashSet<i32> set;
+	for (i32 i = 0; i < 100; i++) {
+		set.insert(i);
+	}
+	i32 sum = 0;
+	usize count = 0;
+	for (const i32& key : set) {
+		sum += key;
+		count++;
+	}
+	check_eq(count, 100);
+	check_eq(sum, 99 * 50);
+}
+
+test_case("HashSet containsMany") {
+	HashSet<u64> set;
+	for (u64 i = 0; i < 1000; i += 2) {
+		set.insert(i);
+	}
+	ArrayList<u64> keys;
+	for (u64 i = 0; i < 1000; i++) {
+		keys.push(i);
+	}
+	ArrayList<bool> found = set.containsMany(keys);
+	check_eq(found.len(), 1000);
+	for (usize i = 0; i < 1000; i++) {
+		check_eq(found[i], i % 2 == 0);
+	}
+
+	HashSet<u64> emptySet;
+	ArrayList<bool> notFound = emptySet.containsMany(keys);
+	check_eq(notFound.len(), 1000);
+	check(!notFound[0]);
+}
+
+test_case("HashSet union") {
+	HashSet<i32> a;
+	HashSet<i32> b;
+	for (i32 i = 0; i < 100; i++) {
+		a.insert(i);
+	}
+	for (i32 i = 50; i < 60; i++) {
+		b.insert(i * 2);
+	}
+	HashSet<i32> aUnionB = a.unionWith(b);
+	HashSet<i32> bUnionA = b.unionWith(a);
+	check_eq(aUnionB.size(), 110);
+	check_eq(bUnionA.size(), 110);
+	for (i32 i = 0; i < 100; i++) {
+		check(aUnionB.contains(i));
+		check(bUnionA.contains(i));
+	}
+	check(aUnionB.contains(118));
+	check(!aUnionB.contains(119));
+	check_eq(a.size(), 100);
+	check_eq(b.size(), 10);
+}
+
+test_case("HashSet intersection") {
+	HashSet<i32> a;
+	HashSet<i32> b;
+	for (i32 i = 0; i < 100; i++) {
+		a.insert(i);
+	}
+	for (i32 i = 90; i < 110; i++) {
+		b.insert(i);
+	}
+	HashSet<i32> aAndB = a.intersectionWith(b);
+	HashSet<i32> bAndA = b.intersectionWith(a);
+	check_eq(aAndB.size(), 10);
+	check_eq(bAndA.size(), 10);
+	for (i32 i = 90; i < 100; i++) {
+		check(aAndB.contains(i));
+		check(bAndA.contains(i));
+	}
+	check(a.intersectionWith(HashSet<i32>()).size() == 0);
+}
+
+test_case("HashSet difference") {
+	HashSet<i32> a;
+	HashSet<i32> b;
+	for (i32 i = 0; i < 100; i++) {
+		a.insert(i);
+	}
+	for (i32 i = 90; i < 110; i++) {
+		b.insert(i);
+	}
+	// a is larger, so it's copied and b's keys are erased.
+	HashSet<i32> aMinusB = a.differenceWith(b);
+	check_eq(aMinusB.size(), 90);
+	check(aMinusB.contains(0));
+	check(!aMinusB.contains(95));
+
+	// b is smaller, so each of it's keys are checked against a.
+	HashSet<i32> bMinusA = b.differenceWith(a);
+	check_eq(bMinusA.size(), 10);
+	check(bMinusA.contains(100));
+	check(!bMinusA.contains(95));
+}
+
+test_case("HashSet copy and move") {
+	HashSet<gk::String> set;
+	for (i32 i = 0; i < 100; i++) {
+		set.insert(gk::String::fromInt(i));
+	}
+	HashSet<gk::String> copy = set;
+	check_eq(copy.size(), 100);
+	check(copy.contains(gk::String::fromInt(42)));
+
+	HashSet<gk::String> moved = std::move(set);
+	check_eq(set.size(), 0);
+	check_eq(moved.size(), 100);
+	copy.erase(gk::String::fromInt(42));
+	check(moved.contains(gk::String::fromInt(42)));
+}
+
+#endif
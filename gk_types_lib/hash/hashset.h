@@ -0,0 +1,280 @@
+#pragma once
+
+#include "hashmap.h"
+
+namespace gk
+{
+	namespace internal
+	{
+		/**
+		* Value of the HashMap a `gk::HashSet` is built on. Has no members, so it takes no space in the pairs.
+		*/
+		struct HashSetNoValue {};
+	}
+
+	/**
+	* A set of unique keys, built on the same groups and SIMD tag matching as `gk::HashMap`.
+	* Only the keys are stored, so keys up to the size of a usize, such as integers and pointers,
+	* are stored directly in the groups, rather than in a separate allocation per entry.
+	* Prefer this over `HashMap<Key, bool>`.
+	*
+	* NOTE: The keys do not have pointer stability. Any mutation to the set may move them.
+	*
+	* @param Key: Must satisy the `Hashable` concept.
+	* @param GROUP_ALLOC_SIZE: Amount of keys to reserve per group. Must be a multiple of 16
+	* @param Allocator: Either a `StaticAllocator`, defaulting to `GlobalHeapStaticAllocator` which has no allocator
+	* indirection or ref counting, or `AllocatorRef` for runtime chosen allocators.
+	* @param Mixer: Scrambles gk::hash<>() before choosing a group and tag. See `gk::HashMixer`.
+	*/
+	template<typename Key, usize GROUP_ALLOC_SIZE = 32, typename Allocator = GlobalHeapStaticAllocator, typename Mixer = DefaultHashMixerFor<Key>>
+		requires (GROUP_ALLOC_SIZE % 16 == 0 && Hashable<Key> && AllocatorPolicy<Allocator> && HashMixer<Mixer>)
+	struct HashSet
+	{
+	private:
+
+		using MapT = HashMap<Key, internal::HashSetNoValue, GROUP_ALLOC_SIZE, Allocator, Mixer>;
+
+	public:
+
+		struct ConstIterator;
+
+		constexpr HashSet() = default;
+		constexpr HashSet(const HashSet& other) = default;
+		constexpr HashSet(HashSet&& other) noexcept = default;
+		constexpr HashSet& operator = (const HashSet& other) = default;
+		constexpr HashSet& operator = (HashSet&& other) noexcept = default;
+		constexpr ~HashSet() = default;
+
+		/**
+		* @return Number of keys stored in the HashSet
+		*/
+		[[nodiscard]] constexpr usize size() const { return _map.size(); }
+
+		/**
+		* @return `true` if the key exists in the HashSet, or `false` if it doesn't.
+		*/
+		[[nodiscard]] constexpr bool contains(const Key& key) const { return _map.contains(key); }
+
+		/**
+		* Checks for a key using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists in the HashSet, or `false` if it doesn't.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		[[nodiscard]] constexpr bool contains(const Lookup& key) const { return _map.contains(key); }
+
+		/**
+		* Checks for many keys at once. Keys are processed in batches, where every key's group is prefetched
+		* before any of them are compared, like `HashMap::findMany()`.
+		* Prefer this over many calls to `contains()` when the HashSet is much larger than the CPU caches.
+		*
+		* @param keys: Keys to check for. Must point to at least `count` keys.
+		* @param count: Number of keys.
+		* @param out: Receives if each key is in the HashSet. Must point to at least `count` bools.
+		*/
+		constexpr void containsMany(const Key* keys, usize count, bool* out) const;
+
+		/**
+		* Checks for every key in `keys` at once. See the pointer overload of `containsMany()`.
+		*
+		* @return Whether each key is in the HashSet, in the same order as `keys`.
+		*/
+		template<typename ListAllocator>
+		[[nodiscard]] constexpr ArrayList<bool> containsMany(const ArrayList<Key, ListAllocator>& keys) const;
+
+		/**
+		* Invalidates any iterators.
+		* Inserts a key into the HashSet if it DOES NOT exist.
+		*
+		* @return `true` if the key was added, or `false` if it already existed. Can be ignored.
+		*/
+		constexpr bool insert(Key&& key) { return _map.insert(std::move(key), internal::HashSetNoValue()).none(); }
+
+		/**
+		* Invalidates any iterators.
+		* Inserts a copy of a key into the HashSet if it DOES NOT exist.
+		*
+		* @return `true` if the key was added, or `false` if it already existed. Can be ignored.
+		*/
+		constexpr bool insert(const Key& key) { return _map.insert(key, internal::HashSetNoValue()).none(); }
+
+		/**
+		* Invalidates any iterators.
+		* Erases a key from the HashSet.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the HashSet. Can be ignored.
+		*/
+		constexpr bool erase(const Key& key) { return _map.erase(key); }
+
+		/**
+		* Invalidates any iterators.
+		* Erases a key using a different type than `Key`, without constructing a `Key`. See `gk::HashLookup`.
+		*
+		* @return `true` if the key exists and was erased, or `false` if it wasn't in the HashSet. Can be ignored.
+		*/
+		template<typename Lookup>
+			requires HashLookupFor<Lookup, Key>
+		constexpr bool erase(const Lookup& key) { return _map.erase(key); }
+
+		/**
+		* Invalidates any iterators.
+		* Reserves additional capacity in the HashSet.
+		*
+		* @param additional: Minimum amount of keys to reserve extra capacity for.
+		*/
+		constexpr void reserve(usize additional) { _map.reserve(additional); }
+
+		/**
+		* Creates a set of the keys in either set. Copies the larger set, and inserts the keys of the smaller one.
+		*
+		* @return New HashSet of every key in `this` or `other`.
+		*/
+		[[nodiscard]] constexpr HashSet unionWith(const HashSet& other) const;
+
+		/**
+		* Creates a set of the keys in both sets, by checking each key of the smaller set against the larger one.
+		*
+		* @return New HashSet of every key in both `this` and `other`.
+		*/
+		[[nodiscard]] constexpr HashSet intersectionWith(const HashSet& other) const;
+
+		/**
+		* Creates a set of the keys in this set that aren't in `other`. If `this` is the smaller set,
+		* each of it's keys is checked against `other`. Otherwise, `this` is copied, and each key of `other` is erased.
+		*
+		* @return New HashSet of every key in `this` but not in `other`.
+		*/
+		[[nodiscard]] constexpr HashSet differenceWith(const HashSet& other) const;
+
+		/**
+		* See `HashMap::stats()`.
+		*
+		* @return Occupancy, scan length, and memory statistics of the HashSet.
+		*/
+		[[nodiscard]] HashMapStats stats() const { return _map.stats(); }
+
+		/**
+		* Begin of an Iterator over each key in the HashSet.
+		*
+		* `insert()`, `erase()`, `reserve()`, `std::move()` and other mutation operations
+		* can be assumed to invalidate the iterator.
+		*
+		* @return Begin of immutable iterator
+		*/
+		constexpr ConstIterator begin() const { return ConstIterator(_map.begin()); }
+
+		/**
+		* End of an Iterator over each key in the HashSet.
+		*
+		* `insert()`, `erase()`, `reserve()`, `std::move()` and other mutation operations
+		* can be assumed to invalidate the iterator.
+		*
+		* @return End of immutable iterator
+		*/
+		constexpr ConstIterator end() const { return ConstIterator(_map.end()); }
+
+		struct ConstIterator {
+			constexpr bool operator ==(const ConstIterator& other) const { return _iter == other._iter; }
+
+			constexpr const Key& operator*() const { return (*_iter).key; }
+
+			constexpr ConstIterator& operator++() {
+				++_iter;
+				return *this;
+			}
+
+		private:
+
+			friend struct HashSet;
+
+			constexpr ConstIterator(typename MapT::ConstIterator iter) : _iter(iter) {}
+
+			typename MapT::ConstIterator _iter;
+		}; // struct ConstIterator
+
+	private:
+
+		MapT _map;
+	};
+}
+
+template<typename Key, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr void gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer>::containsMany(const Key* keys, usize count, bool* out) const
+{
+	Option<const internal::HashSetNoValue*> found[internal::HASH_MAP_BATCH_SIZE];
+	for (usize batchStart = 0; batchStart < count; batchStart += internal::HASH_MAP_BATCH_SIZE) {
+		const usize remaining = count - batchStart;
+		const usize batchCount = remaining < internal::HASH_MAP_BATCH_SIZE ? remaining : internal::HASH_MAP_BATCH_SIZE;
+		_map.findMany(keys + batchStart, batchCount, found);
+		for (usize i = 0; i < batchCount; i++) {
+			out[batchStart + i] = found[i].isSome();
+		}
+	}
+}
+
+template<typename Key, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+template<typename ListAllocator>
+inline constexpr gk::ArrayList<bool> gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer>::containsMany(const ArrayList<Key, ListAllocator>& keys) const
+{
+	ArrayList<bool> out;
+	out.resize(keys.len(), false);
+	containsMany(keys.data(), keys.len(), out.data());
+	return out;
+}
+
+template<typename Key, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer> gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer>::unionWith(const HashSet& other) const
+{
+	const bool thisIsLarger = size() >= other.size();
+	const HashSet& larger = thisIsLarger ? *this : other;
+	const HashSet& smaller = thisIsLarger ? other : *this;
+
+	HashSet out = larger;
+	out.reserve(smaller.size());
+	for (const Key& key : smaller) {
+		out.insert(key);
+	}
+	return out;
+}
+
+template<typename Key, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer> gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer>::intersectionWith(const HashSet& other) const
+{
+	const bool thisIsLarger = size() >= other.size();
+	const HashSet& larger = thisIsLarger ? *this : other;
+	const HashSet& smaller = thisIsLarger ? other : *this;
+
+	HashSet out;
+	for (const Key& key : smaller) {
+		if (larger.contains(key)) {
+			out.insert(key);
+		}
+	}
+	return out;
+}
+
+template<typename Key, gk::usize GROUP_ALLOC_SIZE, typename Allocator, typename Mixer>
+	requires (GROUP_ALLOC_SIZE % 16 == 0 && gk::Hashable<Key> && gk::AllocatorPolicy<Allocator> && gk::HashMixer<Mixer>)
+inline constexpr gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer> gk::HashSet<Key, GROUP_ALLOC_SIZE, Allocator, Mixer>::differenceWith(const HashSet& other) const
+{
+	if (size() <= other.size()) {
+		HashSet out;
+		for (const Key& key : *this) {
+			if (!other.contains(key)) {
+				out.insert(key);
+			}
+		}
+		return out;
+	}
+
+	HashSet out = *this;
+	for (const Key& key : other) {
+		out.erase(key);
+	}
+	return out;
+}
@@ -21,6 +21,17 @@ void gk::JobSystem::wait() const
 	}
 }
 
+bool gk::JobSystem::isWorkerThread() const
+{
+	const std::thread::id currentThreadId = std::this_thread::get_id();
+	for (u32 i = 0; i < _threadCount; i++) {
+		if (_threads[i].getThreadId() == currentThreadId) {
+			return true;
+		}
+	}
+	return false;
+}
+
 gk::JobThread* gk::JobSystem::getOptimalThreadForExecution()
 {
 	const u32 oldCurrentOptimal = _currentOptimalThread.load(std::memory_order::acquire);
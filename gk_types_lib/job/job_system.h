@@ -48,6 +48,12 @@ namespace gk
 
 		void wait() const;
 
+		/**
+		* @return If the calling thread is one of this job system's worker threads, such as from within a running job.
+		* Jobs that wait on other jobs of the same system must not block from a worker thread.
+		*/
+		[[nodiscard]] bool isWorkerThread() const;
+
 	private:
 
 		/* Will atomically change the _currentOptimalThread member to be the one
@@ -128,6 +128,18 @@ namespace gk
 				jobThread->runJob(incrementMutex, (Mutex<int>*)mutex);
 			}
 		}
+
+		/// Counts the live instances, so a job argument that is destroyed twice shows up as a negative count.
+		struct JobArgumentLifetimeTracker {
+			static inline std::atomic<int> liveCount = 0;
+
+			JobArgumentLifetimeTracker() { liveCount++; }
+			JobArgumentLifetimeTracker(const JobArgumentLifetimeTracker&) { liveCount++; }
+			JobArgumentLifetimeTracker(JobArgumentLifetimeTracker&&) noexcept { liveCount++; }
+			~JobArgumentLifetimeTracker() { liveCount--; }
+		};
+
+		static void takeLifetimeTracker(JobArgumentLifetimeTracker tracker) {}
 	}
 	
 }
@@ -137,6 +149,8 @@ using gk::unitTests::freeFunctionNoReturnSleep;
 using gk::unitTests::freeFunctionReturnOnHeap;
 using gk::unitTests::incrementMutex;
 using gk::unitTests::addNestedJob;
+using gk::unitTests::JobArgumentLifetimeTracker;
+using gk::unitTests::takeLifetimeTracker;
 
 using JobThread = gk::JobThread;
 
@@ -187,4 +201,18 @@ test_case("ThreadSafeJobRun") {
 	check_eq(mutexNum, 200);
 }
 
+test_case("JobThreadDestroysEachJobOnce") {
+	JobThread* jobThread = new JobThread();
+	// Several batches, so that the active job slots are reused after their jobs have run.
+	for (int batch = 0; batch < 4; batch++) {
+		for (int i = 0; i < 100; i++) {
+			jobThread->runJob(takeLifetimeTracker, JobArgumentLifetimeTracker());
+		}
+		jobThread->wait();
+		check_eq(JobArgumentLifetimeTracker::liveCount.load(), 0);
+	}
+	delete jobThread;
+	check_eq(JobArgumentLifetimeTracker::liveCount.load(), 0);
+}
+
 #endif
\ No newline at end of file
@@ -81,7 +81,8 @@ namespace gk
 				for (size_t i = 0; i < _count; i++) {
 					JobContainer& job = _buffer[i];
 					job.invoke();
-					job.~JobContainer();
+					// Destroys the bound job and leaves the slot empty, so it isn't destroyed again when reused.
+					job = JobContainer();
 				}
 				_count = 0;
 			}
@@ -212,7 +212,7 @@ usize gk::JsonObject::calculateNewBucketCount(usize requiredCapacity)
 void gk::JsonObject::reallocateRuntime(usize requiredCapacity)
 {
 	using internal::JsonObjectBucket;
-	AllocatorRef allocator = gk::globalHeapAllocator();
+	AllocatorRef allocator = gk::globalHeapAllocatorRef();
 
 	const usize newBucketCount = calculateNewBucketCount(requiredCapacity);
 	if (newBucketCount <= bucketCount) {
@@ -251,7 +251,7 @@ void gk::JsonObject::reallocateRuntime(usize requiredCapacity)
 
 gk::Option<gk::JsonValue*> gk::JsonObject::addFieldRuntime(String&& name, JsonValue&& value)
 {
-	AllocatorRef allocator = gk::globalHeapAllocator();
+	AllocatorRef allocator = gk::globalHeapAllocatorRef();
 	const usize hashCode = name.hash();
 	const internal::JsonHashBucketBits bucketBits = internal::JsonHashBucketBits(hashCode);
 	//const internal::JsonPairHashBits pairBits = internal::JsonPairHashBits(hashCode);
@@ -281,7 +281,7 @@ gk::Option<gk::JsonValue*> gk::JsonObject::addFieldRuntime(String&& name, JsonVa
 
 bool gk::JsonObject::eraseFieldRuntime(const String& name)
 {
-	AllocatorRef allocator = gk::globalHeapAllocator();
+	AllocatorRef allocator = gk::globalHeapAllocatorRef();
 	const usize hashCode = name.hash();
 	const internal::JsonHashBucketBits bucketBits = internal::JsonHashBucketBits(hashCode);
 	//const internal::JsonPairHashBits pairBits = internal::JsonPairHashBits(hashCode);
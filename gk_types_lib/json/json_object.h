@@ -297,6 +297,9 @@ namespace gk
 
 	}; // struct JsonObject
 
+	template<>
+	struct is_trivially_relocatable<JsonObject> : std::true_type {};
+
 	namespace internal
 	{
 		union JsonValueUnion {
@@ -1002,7 +1005,7 @@ inline constexpr gk::JsonObject& gk::JsonObject::operator=(JsonObject&& other) n
 			buckets = nullptr;
 		}
 		else {
-			AllocatorRef globalAllocator = globalHeapAllocator();
+			AllocatorRef globalAllocator = globalHeapAllocatorRef();
 			for (usize i = 0; i < bucketCount; i++) {
 				buckets[i].free(&globalAllocator);
 			}
@@ -1033,7 +1036,7 @@ inline constexpr gk::JsonObject& gk::JsonObject::operator=(const JsonObject& oth
 			buckets = nullptr;
 		}
 		else {
-			AllocatorRef globalAllocator = globalHeapAllocator();
+			AllocatorRef globalAllocator = globalHeapAllocatorRef();
 			for (usize i = 0; i < bucketCount; i++) {
 				buckets[i].free(&globalAllocator);
 			}
@@ -1058,7 +1061,7 @@ inline constexpr gk::JsonObject& gk::JsonObject::operator=(const JsonObject& oth
 	}
 
 	for (usize i = 0; i < bucketCount; i++) {
-		AllocatorRef globalAllocator = globalHeapAllocator();
+		AllocatorRef globalAllocator = globalHeapAllocatorRef();
 		buckets[i].free(&globalAllocator);
 	}
 	if (shouldReallocate(other.elementCount)) {
@@ -1080,7 +1083,7 @@ constexpr gk::JsonObject::~JsonObject()
 		buckets = nullptr;
 	}
 	else {
-		AllocatorRef globalAllocator = globalHeapAllocator();
+		AllocatorRef globalAllocator = globalHeapAllocatorRef();
 		for (usize i = 0; i < bucketCount; i++) {
 			buckets[i].free(&globalAllocator);
 		}
@@ -351,4 +351,23 @@ comptime_test_case(SerializeAndDeserializeNested, {
 	check_eq(des.nested.power, 4);
 });
 
+test_case("Serialize and deserialize HashMap stats") {
+	gk::HashMap<gk::i32, gk::i32> map;
+	for (gk::i32 i = 0; i < 100; i++) {
+		map.insert(i, i);
+	}
+	const gk::HashMapStats stats = map.stats();
+	JsonObject obj = serialize(stats);
+	check_eq(obj.findField("elementCount"_str).some()->numberValue(), 100);
+	check_eq(obj.findField("groupCount"_str).some()->numberValue(), static_cast<double>(stats.groupCount));
+	check_eq(obj.findField("averageScanLength"_str).some()->numberValue(), stats.averageScanLength);
+	check_eq(obj.findField("pairCountHistogram"_str).some()->arrayValue().len(), stats.pairCountHistogram.len());
+
+	gk::HashMapStats des = deserialize<gk::HashMapStats>(obj).ok();
+	check_eq(des.groupCount, stats.groupCount);
+	check_eq(des.totalBytes, stats.totalBytes);
+	check_eq(des.maxScanLength, stats.maxScanLength);
+	check_eq(des.pairCountHistogram.len(), stats.pairCountHistogram.len());
+}
+
 #endif
\ No newline at end of file
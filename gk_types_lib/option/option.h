@@ -1,6 +1,7 @@
 #pragma once
 
 #include <type_traits>
+#include "../basic_types.h"
 #include "../doctest/doctest_proxy.h"
 #include <iostream>
 
@@ -208,4 +209,6 @@ namespace gk
 	};
 
 
+	template<typename T>
+	struct is_trivially_relocatable<Option<T>> : is_trivially_relocatable<T> {};
 }
\ No newline at end of file
@@ -203,6 +203,9 @@ namespace gk
 		mutable Inner* inner;
 
 	};
+
+	template<typename T, bool atomic>
+	struct is_trivially_relocatable<SharedPtr<T, atomic>> : std::true_type {};
 }
 
 template<typename T, bool atomic>
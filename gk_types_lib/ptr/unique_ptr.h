@@ -180,6 +180,9 @@ namespace gk
 		T* ptr;
 	};
 
+	template<typename T>
+	struct is_trivially_relocatable<UniquePtr<T>> : std::true_type {};
+
 }
 
 template<typename T>
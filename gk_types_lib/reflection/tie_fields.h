@@ -0,0 +1,77 @@
+#pragma once
+
+#include "has_n_fields.h"
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace gk
+{
+	namespace internal
+	{
+		/**
+		* Get a tuple of references to every member field of an aggregate, in declaration order.
+		* If `t` is const, the references are const.
+		* NOTE: does not work with private members, and will cause compilation errors.
+		*
+		* @param t: Reflection class/struct instance.
+		*/
+		template<typename T>
+		[[nodiscard]] constexpr auto tieFields(T& t) {
+			using BaseT = std::remove_cv_t<T>;
+			static_assert(!has_n_fields<BaseT, 0>, "Cannot tie the fields of a type with no fields");
+
+			if constexpr (has_n_fields<BaseT, 1>) {
+				auto&& [p1] = t;
+				return std::tie(p1);
+			}
+			else if constexpr (has_n_fields<BaseT, 2>) {
+				auto&& [p1, p2] = t;
+				return std::tie(p1, p2);
+			}
+			else if constexpr (has_n_fields<BaseT, 3>) {
+				auto&& [p1, p2, p3] = t;
+				return std::tie(p1, p2, p3);
+			}
+			else if constexpr (has_n_fields<BaseT, 4>) {
+				auto&& [p1, p2, p3, p4] = t;
+				return std::tie(p1, p2, p3, p4);
+			}
+			else if constexpr (has_n_fields<BaseT, 5>) {
+				auto&& [p1, p2, p3, p4, p5] = t;
+				return std::tie(p1, p2, p3, p4, p5);
+			}
+			else if constexpr (has_n_fields<BaseT, 6>) {
+				auto&& [p1, p2, p3, p4, p5, p6] = t;
+				return std::tie(p1, p2, p3, p4, p5, p6);
+			}
+			else if constexpr (has_n_fields<BaseT, 7>) {
+				auto&& [p1, p2, p3, p4, p5, p6, p7] = t;
+				return std::tie(p1, p2, p3, p4, p5, p6, p7);
+			}
+			else if constexpr (has_n_fields<BaseT, 8>) {
+				auto&& [p1, p2, p3, p4, p5, p6, p7, p8] = t;
+				return std::tie(p1, p2, p3, p4, p5, p6, p7, p8);
+			}
+			else if constexpr (has_n_fields<BaseT, 9>) {
+				auto&& [p1, p2, p3, p4, p5, p6, p7, p8, p9] = t;
+				return std::tie(p1, p2, p3, p4, p5, p6, p7, p8, p9);
+			}
+			else {
+				static_assert(has_n_fields<BaseT, 9>, "Cannot tie the fields of a type with more than 9 fields");
+			}
+		}
+
+		template<typename TieT>
+		struct FieldTypesImpl;
+
+		template<typename... Fields>
+		struct FieldTypesImpl<std::tuple<Fields...>> {
+			using Type = std::tuple<std::remove_cvref_t<Fields>...>;
+		};
+
+		/// Tuple of the value types of every member field of an aggregate, in declaration order.
+		template<typename T>
+		using FieldTypes = typename FieldTypesImpl<decltype(tieFields(std::declval<T&>()))>::Type;
+	} // namespace internal
+} // namespace gk
@@ -108,6 +108,22 @@ size_t gk::GlobalString::hash() const
 	return gk::hash(this->stringId);
 }
 
+size_t gk::GlobalString::stringHash() const
+{
+	gk::LockedReader<GlobalStringContainers> lock = getAllGlobalStrings().read();
+	const GlobalStringContainers& containers = *lock.get();
+	check_message(stringId < containers.strings.len(), "GlobalString stringId is not valid. Is outside of the range of the global strings array");
+	return containers.strings[stringId].hash();
+}
+
+bool gk::GlobalString::equalsString(const String& other) const
+{
+	gk::LockedReader<GlobalStringContainers> lock = getAllGlobalStrings().read();
+	const GlobalStringContainers& containers = *lock.get();
+	check_message(stringId < containers.strings.len(), "GlobalString stringId is not valid. Is outside of the range of the global strings array");
+	return containers.strings[stringId] == other;
+}
+
 bool gk::GlobalString::doesStringExistInGlobalMap(const String& string)
 {
 	gk::LockedReader<GlobalStringContainers> lock = getAllGlobalStrings().read();
@@ -177,6 +193,28 @@ test_case("CreateIfExistsDoesntExist") {
 	check_eq(str2.toString(), ""_str);
 }
 
+test_case("StringHashEqualsStringHash") {
+	gk::String a = "hello world with a long enough string to go on the heap!"_str;
+	gk::GlobalString str = gk::GlobalString::create(a);
+	check_eq(str.stringHash(), a.hash());
+	check(str.equalsString(a));
+	check(!str.equalsString("hello world"_str));
+}
+
+test_case("HashMapFindWithGlobalString") {
+	gk::HashMap<gk::String, int> map;
+	map.insert("first"_str, 1);
+	map.insert("second"_str, 2);
+	gk::GlobalString second = gk::GlobalString::create("second"_str);
+	gk::GlobalString third = gk::GlobalString::create("third"_str);
+	check_eq(*map.find(second).some(), 2);
+	check(map.contains(second));
+	check(!map.contains(third));
+	check(map.erase(second));
+	check(map.find(second).none());
+	check_eq(map.size(), 1);
+}
+
 test_case("MultithreadCreate") {
 	JobSystem* jobSystem = new JobSystem(8);
 
@@ -92,6 +92,19 @@ namespace gk
 		*/
 		size_t hash() const;
 
+		/**
+		* Calculate the hash value of the string referenced by this GlobalString, without copying it.
+		* Is equal to `gk::hash<gk::String>()` of `toString()`, unlike `hash()`.
+		* Will read the RwLock.
+		*/
+		size_t stringHash() const;
+
+		/**
+		* Compare the string referenced by this GlobalString with `other`, without copying it.
+		* Will read the RwLock.
+		*/
+		bool equalsString(const String& other) const;
+
 		/**
 		* Check if a string exists within the global map.
 		* This function has a relatively high cost due to thread safety, and thus should only be used when necessary.
@@ -114,6 +127,15 @@ namespace gk
 	inline size_t hash<gk::GlobalString>(const gk::GlobalString& key) {
 		return key.hash();
 	}
+
+	/**
+	* Allows HashMaps with String keys to be searched using GlobalStrings, without copying into a String.
+	*/
+	template<>
+	struct HashLookup<gk::String, gk::GlobalString> {
+		static size_t hash(const gk::GlobalString& lookup) { return lookup.stringHash(); }
+		static bool equal(const gk::String& key, const gk::GlobalString& lookup) { return lookup.equalsString(key); }
+	};
 }
 
 //namespace std
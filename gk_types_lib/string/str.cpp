@@ -152,6 +152,91 @@ namespace gk {
 	}
 }
 
+namespace gk {
+	namespace internal {
+		static u64 strHashRead8(const char* bytes) {
+			u64 out;
+			memcpy(&out, bytes, 8);
+			return out;
+		}
+
+		static u64 strHashRead4(const char* bytes) {
+			u32 out;
+			memcpy(&out, bytes, 4);
+			return out;
+		}
+
+		/// Reads 1 to 3 bytes, touching the first, middle, and last.
+		static u64 strHashRead3(const char* bytes, usize len) {
+			return (static_cast<u64>(static_cast<u8>(bytes[0])) << 16)
+				| (static_cast<u64>(static_cast<u8>(bytes[len >> 1])) << 8)
+				| static_cast<u64>(static_cast<u8>(bytes[len - 1]));
+		}
+	}
+}
+
+/*
+wyhash by Wang Yi, with a seed of 0. Every 8 bytes costs a single 64 bit multiply,
+and short strings, which are most hash map keys, never loop.
+Reads are done with memcpy, so nothing past the end of the slice is read,
+and the result doesn't depend on the alignment of the buffer.
+*/
+gk::usize gk::Str::hash() const
+{
+	const u64* secret = internal::HASH_SECRET;
+	const char* bytes = buffer;
+	constexpr u64 INITIAL_SEED = internal::hashMultiplyFold(internal::HASH_SECRET[0], internal::HASH_SECRET[1]);
+	u64 seed = INITIAL_SEED;
+	u64 a;
+	u64 b;
+
+	if (len <= 16) {
+		if (len >= 4) {
+			const usize middle = (len >> 3) << 2;
+			a = (internal::strHashRead4(bytes) << 32) | internal::strHashRead4(bytes + middle);
+			b = (internal::strHashRead4(bytes + len - 4) << 32) | internal::strHashRead4(bytes + len - 4 - middle);
+		}
+		else if (len > 0) {
+			a = internal::strHashRead3(bytes, len);
+			b = 0;
+		}
+		else {
+			a = 0;
+			b = 0;
+		}
+	}
+	else {
+		usize remaining = len;
+		if (remaining > 48) {
+			u64 seed1 = seed;
+			u64 seed2 = seed;
+			do {
+				seed = internal::hashMultiplyFold(internal::strHashRead8(bytes) ^ secret[1], internal::strHashRead8(bytes + 8) ^ seed);
+				seed1 = internal::hashMultiplyFold(internal::strHashRead8(bytes + 16) ^ secret[2], internal::strHashRead8(bytes + 24) ^ seed1);
+				seed2 = internal::hashMultiplyFold(internal::strHashRead8(bytes + 32) ^ secret[3], internal::strHashRead8(bytes + 40) ^ seed2);
+				bytes += 48;
+				remaining -= 48;
+			} while (remaining > 48);
+			seed ^= seed1 ^ seed2;
+		}
+		while (remaining > 16) {
+			seed = internal::hashMultiplyFold(internal::strHashRead8(bytes) ^ secret[1], internal::strHashRead8(bytes + 8) ^ seed);
+			bytes += 16;
+			remaining -= 16;
+		}
+		// The last 16 bytes of the slice, which may overlap bytes already hashed.
+		a = internal::strHashRead8(bytes + remaining - 16);
+		b = internal::strHashRead8(bytes + remaining - 8);
+	}
+
+	a ^= secret[1];
+	b ^= seed;
+	u64 high;
+	a = _umul128(a, b, &high);
+	b = high;
+	return internal::hashMultiplyFold(a ^ secret[0] ^ static_cast<u64>(len), b ^ secret[1]);
+}
+
 bool gk::Str::equalStr(const gk::Str& str) const
 {
 	// at this point, can be assumed that the lengths are equal.
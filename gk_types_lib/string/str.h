@@ -2,6 +2,7 @@
 #include "../basic_types.h"
 #include "../doctest/doctest_proxy.h"
 #include "../option/option.h"
+#include "../hash/hash.h"
 #include "utf8.h"
 #include <xtr1common>
 #include <string>
@@ -228,12 +229,27 @@ namespace gk
       return os.write(inStr.buffer, inStr.len);
     }
 
+    /**
+    * wyhash of the chars, which spreads over every bit of the result, so it can be used with `gk::IdentityHashMixer`.
+    * The hash is identical to `gk::String::hash()` of a String holding the same chars,
+    * allowing a `gk::HashMap` with String keys to be searched using a string slice.
+    * Never reads outside of the slice.
+    *
+    * @return the hash code of this string slice.
+    */
+    [[nodiscard]] usize hash() const;
+
   private:
 
     bool equalStr(const gk::Str& str) const;
 
     Option<usize> findChar(char c) const;
   };
+
+  template<>
+  inline size_t hash<gk::Str>(const gk::Str& key) {
+    return key.hash();
+  }
 }
 
 consteval gk::Str operator "" _str(const char* inStr, size_t length) {
@@ -14,7 +14,7 @@ char* gk::mallocCharBufferAligned(usize* capacity)
 
 	const usize mallocCapacity = *capacity;
 
-	char* buffer = globalHeapAllocator()->mallocAlignedBuffer<char>(mallocCapacity, alignment).ok();
+	char* buffer = GlobalHeapStaticAllocator::mallocAlignedBuffer<char>(mallocCapacity, alignment).ok();
 	memset(buffer, '\0', mallocCapacity);
 	return buffer;
 }
@@ -22,78 +22,12 @@ char* gk::mallocCharBufferAligned(usize* capacity)
 void gk::freeCharBufferAligned(char*& buffer, usize capacity)
 {
 	constexpr usize alignment = 64;
-	globalHeapAllocator()->freeAlignedBuffer(buffer, capacity, alignment);
+	GlobalHeapStaticAllocator::freeAlignedBuffer(buffer, capacity, alignment);
 }
 
-namespace gk {
-	static __m256i stringHashIteration(const __m256i* vec, gk::i8 num) {
-		// in the case of SSO, will ignore the 
-		const __m256i seed = _mm256_set1_epi64x(0);
-		const __m256i indices = _mm256_set_epi8(31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
-		const __m256i numVec = _mm256_set1_epi8(num);
-
-		// Checks if num is greater than each value of indices.
-		// Mask is 0xFF if greater than, and 0x00 otherwise. 
-		const __m256i mask = _mm256_cmpgt_epi8(numVec, indices);
-		const __m256i partial = _mm256_and_si256(*vec, mask);
-		return _mm256_add_epi8(partial, numVec);
-	}
-}
-
-/*
-AVX-512 would require only updating the h value
-4 at a time, rather than the full 8 of the AVX-512 buffer.
-This is because the hash XOR, multiplication, and Xorshift
-will cause a difference when doing 4 vs 8, EVEN if the
-last 4 of the 8 are unused.
-Supporting it will require some bookkeeping.
-TODO investigate if that's a good performance tradeoff.
-*/
-
 gk::usize gk::String::hash() const
 {
-	static_assert(sizeof(String) == sizeof(__m256i));
-
-	usize h = 0;
-
-	if (isSso()) {
-		h = 0 ^ (ssoLen() * HASH_MODIFIER);
-		const __m256i thisVec = _mm256_loadu_epi8((const void*)this);
-		const __m256i hashIter = stringHashIteration(&thisVec, static_cast<i8>(ssoLen()));
-
-		for (usize i = 0; i < 4; i++) {
-			h ^= hashIter.m256i_u64[i];
-			h *= HASH_MODIFIER;
-			h ^= h >> HASH_SHIFT;
-		}
-	}
-	else {
-		const usize length = rep.heap.length;
-		h = 0 ^ (length * HASH_MODIFIER);
-
-		const usize iterationsToDo = ((length) % 32 == 0 ?
-			length :
-			length + (32 - (length % 32)))
-			/ 32;
-
-		for (usize i = 0; i < iterationsToDo; i++) {
-			const __m256i* thisVec = reinterpret_cast<const __m256i*>(rep.heap.buffer);
-			const i8 num = i != (iterationsToDo - 1) ? static_cast<i8>(32) : static_cast<i8>((iterationsToDo * i) - length);
-			check_le(num, 32);
-			const __m256i hashIter = stringHashIteration(thisVec + i, num);
-
-			for (usize j = 0; j < 4; j++) {
-				h ^= hashIter.m256i_u64[j];
-				h *= HASH_MODIFIER;
-				h ^= h >> HASH_SHIFT;
-			}
-		}
-	}
-
-	h ^= h >> HASH_SHIFT;
-	h *= HASH_MODIFIER;
-	h ^= h >> HASH_SHIFT;
-	return h;
+	return asStr().hash();
 }
 
 namespace gk
@@ -498,6 +432,8 @@ gk::Option<gk::usize> gk::String::findStrInStringSimd(const gk::Str& str) const
 
 #if GK_TYPES_LIB_TEST
 
+#include "../hash/hashmap.h"
+
 namespace gk
 {
 	namespace unitTests
@@ -3103,4 +3039,38 @@ test_case("String parse float long decimal") {
 
 #pragma endregion
 
+#pragma region Hash
+
+test_case("String hash equals Str hash") {
+	const char* chars = "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz0123456789";
+	for (gk::usize length = 0; length < 72; length++) {
+		const gk::Str slice = gk::Str::fromSlice(chars, length);
+		const String a = slice;
+		check_eq(a.hash(), slice.hash());
+		check_eq(gk::hash<String>(a), gk::hash<gk::Str>(slice));
+	}
+}
+
+test_case("String hash uses every char of heap strings") {
+	String a = "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz0123456789"_str;
+	String b = "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz012345678!"_str;
+	check_ne(a.hash(), b.hash());
+}
+
+test_case("String HashMap find with Str") {
+	gk::HashMap<String, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(String::fromInt(i) + "_some_long_key_that_goes_on_the_heap"_str, i);
+	}
+	const String key = String::fromInt(42) + "_some_long_key_that_goes_on_the_heap"_str;
+	check_eq(*map.find(key.asStr()).some(), 42);
+	check(map.contains(key.asStr()));
+	check(map.find("not a key"_str).none());
+	check(map.erase(key.asStr()));
+	check(!map.contains(key.asStr()));
+	check_eq(map.size(), 99);
+}
+
+#pragma endregion
+
 #endif
\ No newline at end of file
@@ -25,11 +25,13 @@ namespace gk
 	* `mallocCharBufferAligned()`.
 	*
 	* @param buffer: Sets to nullptr. The non-null pointer to free. MUST have been allocated with
-	* `mallocCharBufferAligned` or the globalHeapAllocator's mallocAlignedBuffer() function.
+	* `mallocCharBufferAligned` or GlobalHeapStaticAllocator's mallocAlignedBuffer() function.
 	*/
 	void freeCharBufferAligned(char*& buffer, usize capacity);
 
 	/**
+	* Heap buffers always come from `GlobalHeapStaticAllocator`, so String never pays for allocator
+	* indirection or ref counting. There is no allocator parameter, as a stored allocator would not fit in the 32 byte layout.
 	*/
 	struct alignas(8) String
 	{
@@ -37,8 +39,6 @@ namespace gk
 
 		static constexpr char FLAG_BIT = static_cast<char>(0b10000000);
 		static constexpr usize MAX_SSO_LEN = 31;
-		static constexpr usize HASH_MODIFIER = 0xc6a4a7935bd1e995ULL;
-		static constexpr usize HASH_SHIFT = 47;
 
 #pragma pack(push, 1)
 		struct HeapRep {
@@ -154,8 +154,9 @@ namespace gk
 		}
 
 		/**
-		*	AVX-2 optimized hash function.
-		* The hash will be the same in the event that the SSO version and heap version of the string have equal data.
+		* wyhash of the chars, forwarding to `asStr().hash()`. Spreads over every bit of the result, so it can be used with `gk::IdentityHashMixer`.
+		* The hash will be the same in the event that the SSO version and heap version of the string have equal data,
+		* and is equal to `gk::Str::hash()` of a slice of the same chars.
 		*
 		* @return the hash code of this String.
 		*/
@@ -562,6 +563,10 @@ namespace gk
 		Option<usize> findStrInStringSimd(const gk::Str& str) const;
 
 	};// struct String
+
+	/// Heap strings only hold a pointer to their buffer, and SSO strings are plain bytes.
+	template<>
+	struct is_trivially_relocatable<String> : std::true_type {};
 } // namespace gk
 
 inline constexpr gk::String::String(const Str& str)
@@ -1657,3 +1662,12 @@ inline size_t gk::hash<gk::String>(const gk::String& key) { // Why would you eve
 	return key.hash();
 }
 
+/**
+* Allows HashMaps with String keys to be searched using string slices, without copying into a String.
+*/
+template<>
+struct gk::HashLookup<gk::String, gk::Str> {
+	static size_t hash(const gk::Str& lookup) { return lookup.hash(); }
+	static constexpr bool equal(const gk::String& key, const gk::Str& lookup) { return key == lookup; }
+};
+